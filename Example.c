@@ -235,6 +235,13 @@ int main()
     // Clean up all hooks
     BWSR_DestroyAllHooks();
 
+#if !defined( __APPLE__ )
+
+    // Release the module index cached by BWSR_ResolveSymbol()
+    BWSR_ReleaseModuleIndex();
+
+#endif
+
 #if defined( DEBUG_MODE )
 
     size_t leaks = MemoryTracker_CheckForMemoryLeaks();
@@ -187,7 +187,7 @@ int32_t
  * \param[in]           Register            Where the result of an operation is stored or where data is moved to.
  * \param[in]           Immediate           Encoded instruction
  * \param[in]           Shift               Shift of the encoded instructions. Expected as a multiple of `16`.
- * \param[in]           Op                  Move wide immediate fixed either `MOVZ` or `MOVK`
+ * \param[in]           Op                  Move wide immediate fixed `MOVZ`, `MOVN` or `MOVK`
  * \return `BWSR_STATUS`
  * \retval `ERROR_ARGUMENT_IS_NULL` if `Buffer` or `Destination` is `NULL`.
  * \retval `ERROR_MEM_ALLOC` if the reallocation of `Buffer` fails.
@@ -240,7 +240,8 @@ void
  * \param[in]           PCOffset            P
  * \return `BWSR_STATUS`
  * \retval `ERROR_ARGUMENT_IS_NULL` if `RelocationData` is `NULL`.
- * \retval `ERROR_MEM_ALLOC` if allocation of reference instruction fails.
+ * \retval `ERROR_MEMORY_OVERFLOW` if `RelocationData` has no room for another
+ * reference instruction.
  * \retval `ERROR_SUCCESS` if a reference instruction was added and updated.
  */
 static
@@ -252,6 +253,38 @@ BWSR_STATUS
         IN          const size_t                PCOffset
     );
 
+/**
+ * \brief Frees `RelocationData` unless it belongs to the arena of `Assembler`.
+ * \param[in]           Assembler           A
+ * \param[in]           RelocationData      Created by `Assembler`.
+ * \return void
+ */
+static
+void
+    INTERNAL_Assembler_ReleaseRelocationData
+    (
+        IN          const assembler_t*          Assembler,
+        IN          relocation_data_t*          RelocationData
+    );
+
+/**
+ * \brief Counts the instructions `Assembler_MOV` needs for `Immediate`.
+ * \param[in]           Immediate           Value to load
+ * \param[in]           RegisterSize        `32` or `64`
+ * \param[out]          Fill                Halfword left to the first
+ * instruction, `0` for `MOVZ` or `0xffff` for `MOVN`
+ * \return `size_t`
+ * \retval Number of `MOVZ`, `MOVN` and `MOVK` instructions, at least `1`
+ */
+static
+size_t
+    INTERNAL_Assembler_MoveWideCount
+    (
+        IN          uint64_t                    Immediate,
+        IN          int                         RegisterSize,
+        OUT         uint16_t*                   Fill
+    );
+
 // -----------------------------------------------------------------------------
 //  IMPLEMENTATION
 // -----------------------------------------------------------------------------
@@ -267,6 +300,7 @@ BWSR_STATUS
 {
     BWSR_STATUS     retVal      = ERROR_SUCCESS;
     uint32_t        capacity    = 0;
+    uint8_t*        buffer      = NULL;
 
     __NOT_NULL( Buffer, InputBuffer );
     __GREATER_THAN_0( InputBufferSize );
@@ -280,15 +314,30 @@ BWSR_STATUS
             capacity *= 2;
         } // while()
 
-        if( NULL == ( Buffer->Buffer = (uint8_t*) BwsrRealloc( Buffer->Buffer, capacity ) ) )
+        if( Buffer->Borrowed )
+        {
+            // The arena is full, move on to the heap
+            if( NULL != ( buffer = (uint8_t*) BwsrMalloc( capacity ) ) )
+            {
+                memcpy( buffer,
+                        Buffer->Buffer,
+                        Buffer->BufferSize );
+            }
+        }
+        else {
+            buffer = (uint8_t*) BwsrRealloc( Buffer->Buffer, capacity );
+        } // Buffer->Borrowed
+
+        if( NULL == buffer )
         {
             BWSR_DEBUG( LOG_ERROR, "BwsrRealloc() Failed\n" );
-            Buffer->BufferSize = 0;
             retVal = ERROR_MEM_ALLOC;
         }
         else {
-            Buffer->BufferCapacity = capacity;
-        } // BwsrRealloc()
+            Buffer->Buffer          = buffer;
+            Buffer->BufferCapacity  = capacity;
+            Buffer->Borrowed        = false;
+        } // buffer
     } // Buffer->BufferCapacity
 
     if( ERROR_SUCCESS == retVal )
@@ -573,34 +622,78 @@ BWSR_STATUS
     )
 {
     BWSR_STATUS     retVal      = ERROR_FAILURE;
-    size_t          refSize     = 0;
 
     __NOT_NULL( RelocationData )
 
-    RelocationData->ReferenceInstructionCount++;
-    refSize = RelocationData->ReferenceInstructionCount * sizeof( reference_instruct_t );
-
-    if( NULL == RelocationData->ReferenceInstructions )
+    if( RELOCATION_MAX_REFERENCES <= RelocationData->ReferenceInstructionCount )
     {
-        RelocationData->ReferenceInstructions = (reference_instruct_t*) BwsrMalloc( refSize );
+        BWSR_DEBUG( LOG_ERROR, "Too many references to a single literal\n" );
+        retVal = ERROR_MEMORY_OVERFLOW;
     }
     else {
-        RelocationData->ReferenceInstructions = (reference_instruct_t*) BwsrRealloc( RelocationData->ReferenceInstructions, refSize );
-    } // RelocationData->ReferenceInstructions
+        RelocationData->ReferenceInstructions[ RelocationData->ReferenceInstructionCount ].LinkType = LinkType;
+        RelocationData->ReferenceInstructions[ RelocationData->ReferenceInstructionCount ].Offset   = PCOffset;
+        RelocationData->ReferenceInstructionCount++;
+        retVal = ERROR_SUCCESS;
+    } // RELOCATION_MAX_REFERENCES
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_Assembler_ReleaseRelocationData
+    (
+        IN          const assembler_t*          Assembler,
+        IN          relocation_data_t*          RelocationData
+    )
+{
+    __NOT_NULL_RETURN_VOID( Assembler, RelocationData );
 
-    if( NULL == RelocationData->ReferenceInstructions )
+    if( ( NULL           == Assembler->Arena                                                      ) ||
+        ( RelocationData <  Assembler->Arena->Relocations                                         ) ||
+        ( RelocationData >= ( Assembler->Arena->Relocations + ASSEMBLER_ARENA_RELOCATION_COUNT )  ) )
     {
-        BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
-        RelocationData->ReferenceInstructionCount = 0;
-        retVal = ERROR_MEM_ALLOC;
+        BwsrFree( RelocationData );
+    }
+}
+
+static
+size_t
+    INTERNAL_Assembler_MoveWideCount
+    (
+        IN          uint64_t                    Immediate,
+        IN          int                         RegisterSize,
+        OUT         uint16_t*                   Fill
+    )
+{
+    size_t      zeros       = 0;
+    size_t      ones        = 0;
+    size_t      halfwords   = 0;
+    size_t      count       = 0;
+    int         shift       = 0;
+    uint16_t    halfword    = 0;
+
+    for( shift = 0; shift < RegisterSize; shift += 16 )
+    {
+        halfword = (uint16_t)( Immediate >> shift );
+
+        zeros   += ( 0x0000 == halfword );
+        ones    += ( 0xffff == halfword );
+        halfwords++;
+    } // for()
+
+    if( ones > zeros )
+    {
+        *Fill   = 0xffff;
+        count   = halfwords - ones;
     }
     else {
-        RelocationData->ReferenceInstructions[ RelocationData->ReferenceInstructionCount - 1 ].LinkType = LinkType;
-        RelocationData->ReferenceInstructions[ RelocationData->ReferenceInstructionCount - 1 ].Offset   = PCOffset;
-        retVal = ERROR_SUCCESS;
-    } // RelocationData->ReferenceInstructions
+        *Fill   = 0x0000;
+        count   = halfwords - zeros;
+    } // ones > zeros
 
-    return retVal;
+    return ( ( 0 == count ) ? 1 : count );
 }
 
 BWSR_STATUS
@@ -623,9 +716,11 @@ BWSR_STATUS
         Assembler->FixedAddress             = FixedAddress;
         Assembler->Buffer.BufferSize        = 0;
         Assembler->Buffer.BufferCapacity    = 64;
+        Assembler->Buffer.Borrowed          = false;
         Assembler->RelocationData           = NULL;
         Assembler->RelocationDataSize       = 0;
         Assembler->RelocationDataCapacity   = 0;
+        Assembler->Arena                    = NULL;
 
         retVal = ERROR_SUCCESS;
     } // BwsrMalloc()
@@ -633,6 +728,31 @@ BWSR_STATUS
     return retVal;
 }
 
+BWSR_STATUS
+    Assembler_InitializeWithArena
+    (
+        IN          assembler_t*                Assembler,
+        IN          uintptr_t                   FixedAddress,
+        IN          assembler_arena_t*          Arena
+    )
+{
+    __NOT_NULL( Assembler, Arena )
+
+    Arena->RelocationCount              = 0;
+
+    Assembler->FixedAddress             = FixedAddress;
+    Assembler->Buffer.Buffer            = Arena->Buffer;
+    Assembler->Buffer.BufferSize        = 0;
+    Assembler->Buffer.BufferCapacity    = sizeof( Arena->Buffer );
+    Assembler->Buffer.Borrowed          = true;
+    Assembler->RelocationData           = Arena->RelocationTable;
+    Assembler->RelocationDataSize       = 0;
+    Assembler->RelocationDataCapacity   = ARRAY_LENGTH( Arena->RelocationTable );
+    Assembler->Arena                    = Arena;
+
+    return ERROR_SUCCESS;
+}
+
 BWSR_STATUS
     Assembler_CreateRelocationData
     (
@@ -643,13 +763,46 @@ BWSR_STATUS
 {
     BWSR_STATUS             retVal              = ERROR_FAILURE;
     relocation_data_t**     relocationData      = NULL;
+    relocation_data_t*      existing            = NULL;
     size_t                  capacity            = 0;
     size_t                  refSize             = 0;
+    size_t                  i                   = 0;
 
     __NOT_NULL( Relocation, Assembler )
     __GREATER_THAN_0( Data )
 
-    if( NULL == ( *Relocation = (relocation_data_t*) BwsrMalloc( sizeof( relocation_data_t ) ) ) )
+    // Literals are bound only once the code is complete,
+    // so one holding the same value can be shared
+    for( i = 0; ( i < Assembler->RelocationDataSize ) && ( NULL == existing ); i++ )
+    {
+        existing = Assembler->RelocationData[ i ];
+
+        if( ( sizeof( uint64_t )          != existing->DataSize                     ) ||
+            ( RELOCATION_MAX_REFERENCES   <= existing->ReferenceInstructionCount    ) ||
+            ( 0                           != memcmp( existing->Data,
+                                                     &Data,
+                                                     sizeof( uint64_t ) )           ) )
+        {
+            existing = NULL;
+        }
+    } // for()
+
+    if( NULL != existing )
+    {
+        *Relocation = existing;
+        return ERROR_SUCCESS;
+    }
+
+    if( ( NULL                              != Assembler->Arena                     ) &&
+        ( ASSEMBLER_ARENA_RELOCATION_COUNT  >  Assembler->Arena->RelocationCount    ) )
+    {
+        *Relocation = &Assembler->Arena->Relocations[ Assembler->Arena->RelocationCount++ ];
+    }
+    else {
+        *Relocation = (relocation_data_t*) BwsrMalloc( sizeof( relocation_data_t ) );
+    } // Assembler->Arena
+
+    if( NULL == *Relocation )
     {
         BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
         retVal = ERROR_MEM_ALLOC;
@@ -659,6 +812,8 @@ BWSR_STATUS
                 &Data,
                 sizeof( uint64_t ) );
 
+        retVal = ERROR_SUCCESS;
+
         if( Assembler->RelocationDataSize >= Assembler->RelocationDataCapacity )
         {
             capacity = ( ( Assembler->RelocationDataCapacity == 0 )
@@ -670,22 +825,32 @@ BWSR_STATUS
             {
                 relocationData = (relocation_data_t**) BwsrMalloc( refSize );
             }
+            else if( ( NULL                     != Assembler->Arena                     ) &&
+                     ( Assembler->RelocationData == Assembler->Arena->RelocationTable   ) )
+            {
+                // The arena table is full, move on to the heap
+                if( NULL != ( relocationData = (relocation_data_t**) BwsrMalloc( refSize ) ) )
+                {
+                    memcpy( relocationData,
+                            Assembler->RelocationData,
+                            Assembler->RelocationDataSize * sizeof( relocation_data_t* ) );
+                }
+            }
             else {
                 relocationData = (relocation_data_t**) BwsrRealloc( Assembler->RelocationData, refSize );
             } // NULL == Assembler->RelocationData
 
             if( NULL == relocationData )
             {
-                BwsrFree( *Relocation );
-                capacity = 0;
+                INTERNAL_Assembler_ReleaseRelocationData( Assembler, *Relocation );
+                *Relocation = NULL;
                 retVal = ERROR_MEM_ALLOC;
             }
             else {
+                Assembler->RelocationData           = relocationData;
+                Assembler->RelocationDataCapacity   = capacity;
                 retVal = ERROR_SUCCESS;
             } // NULL == relocationData
-
-            Assembler->RelocationData           = relocationData;
-            Assembler->RelocationDataCapacity   = capacity;
         } // Assembler->RelocationDataSize
 
         if( ERROR_SUCCESS == retVal )
@@ -693,7 +858,6 @@ BWSR_STATUS
             ( *Relocation )->DataSize                   = (uint8_t) sizeof( uint64_t );
             ( *Relocation )->ReferenceInstructionCount  = 0;
             ( *Relocation )->PcOffset                   = 0;
-            ( *Relocation )->ReferenceInstructions      = NULL;
 
             Assembler->RelocationData[ Assembler->RelocationDataSize++ ] = *Relocation;
         }
@@ -766,11 +930,11 @@ BWSR_STATUS
         retVal = ERROR_SUCCESS;
     }
     else {
-
-        if( LoadStoreUnsignedOffsetFixed == ( Op & LoadStoreUnsignedOffsetFixed ) )
-        {
-            scale = GET_BITS( Op, 30, 31 );
-        }
+        // The unsigned offset is in units of the access size,
+        // 128 bit SIMD&FP registers have a size of `0b00`
+        scale   = ( GET_BIT( Op, 26 ) && GET_BIT( Op, 23 ) )
+                    ? 4
+                    : GET_BITS( Op, 30, 31 );
 
         value   = ( LoadStoreUnsignedOffsetFixed
                     | Op
@@ -783,6 +947,63 @@ BWSR_STATUS
     return retVal;
 }
 
+BWSR_STATUS
+    Assembler_LoadStorePair
+    (
+        IN  OUT     memory_buffer_t*            Buffer,
+        IN          LoadStorePairOp             Op,
+        IN          const register_data_t*      Register,
+        IN          const register_data_t*      Register2,
+        IN          const memory_operand_t*     Addr
+    )
+{
+    BWSR_STATUS     retVal      = ERROR_FAILURE;
+    int             scale       = 0;
+    uint32_t        value       = 0;
+
+    __NOT_NULL( Buffer,
+                Register,
+                Register2,
+                Addr )
+
+    // 64 bit general purpose or 128 bit SIMD&FP registers
+    scale   = ( GET_BIT( Op, 26 ) ) ? 4 : 3;
+
+    value   = ( Op
+                | BIT_SHIFT( (int64_t)( Addr->Offset >> scale ), 7, 15 )
+                | ( Register2->RegisterId << kRt2Shift )
+                | ( Addr->Base.RegisterId << kRnShift )
+                | Rt( Register ) );
+    retVal  = Assembler_Write32BitInstruction( Buffer, value );
+
+    return retVal;
+}
+
+BWSR_STATUS
+    Assembler_AddSubImmediate
+    (
+        IN  OUT     memory_buffer_t*            Buffer,
+        IN          AddSubImmediateOp           Op,
+        IN          const register_data_t*      Destination,
+        IN          const register_data_t*      Source,
+        IN          uint64_t                    Immediate
+    )
+{
+    BWSR_STATUS     retVal      = ERROR_FAILURE;
+
+    __NOT_NULL( Buffer,
+                Destination,
+                Source )
+
+    retVal = INTERNAL_Assembler_AddSubImmediate( Buffer,
+                                                 Destination,
+                                                 Source,
+                                                 &OPERAND_IMMEDIATE( (int64_t) Immediate ),
+                                                 Op );
+
+    return retVal;
+}
+
 BWSR_STATUS
     Assembler_ADRP_ADD
     (
@@ -828,53 +1049,137 @@ BWSR_STATUS
         IN          uint64_t                    Immediate
     )
 {
-    BWSR_STATUS     retVal  = ERROR_FAILURE;
-
-    const uint32_t  w0      = (uint32_t)( Immediate &  0xffffffff );
-    const uint32_t  w1      = (uint32_t)( Immediate >> 32         );
-    const uint16_t  h0      = (uint16_t)( w0        &  0xffff     );
-    const uint16_t  h1      = (uint16_t)( w0        >> 16         );
-    const uint16_t  h2      = (uint16_t)( w1        &  0xffff     );
-    const uint16_t  h3      = (uint16_t)( w1        >> 16         );
+    BWSR_STATUS             retVal      = ERROR_SUCCESS;
+    MoveWideImmediateOp     op          = MOVZ;
+    uint16_t                fill        = 0;
+    uint16_t                halfword    = 0;
+    int                     shift       = 0;
+    bool                    written     = false;
 
     __NOT_NULL( Buffer, Register )
     __GREATER_THAN_0( Immediate )
 
-    if( ERROR_SUCCESS != ( retVal = INTERNAL_Assembler_MoveWide( Buffer,
-                                                                 Register,
-                                                                 h0,
-                                                                 0,
-                                                                 MOVZ ) ) )
+    (void) INTERNAL_Assembler_MoveWideCount( Immediate,
+                                             Register->RegisterSize,
+                                             &fill );
+
+    op = ( 0 == fill ) ? MOVZ : MOVN;
+
+    for( shift = 0; ( shift < Register->RegisterSize ) && ( ERROR_SUCCESS == retVal ); shift += 16 )
     {
-        BWSR_DEBUG( LOG_ERROR, "INTERNAL_Assembler_MoveWide() Failed\n" );
-    }
-    else {
-        if( ERROR_SUCCESS != ( retVal = INTERNAL_Assembler_MoveWide( Buffer,
-                                                                     Register,
-                                                                     h1,
-                                                                     16,
-                                                                     MOVK ) ) )
+        halfword = (uint16_t)( Immediate >> shift );
+
+        if( fill == halfword )
+        {
+            // Already set by the first instruction
+        }
+        else if( false == written )
         {
-            BWSR_DEBUG( LOG_ERROR, "INTERNAL_Assembler_MoveWide() Failed\n" );
+            retVal  = INTERNAL_Assembler_MoveWide( Buffer,
+                                                   Register,
+                                                   (uint16_t)( halfword ^ fill ),
+                                                   shift,
+                                                   op );
+            written = true;
         }
         else {
-            if( ERROR_SUCCESS != ( retVal = INTERNAL_Assembler_MoveWide( Buffer,
-                                                                         Register,
-                                                                         h2,
-                                                                         32,
-                                                                         MOVK ) ) )
-            {
-                BWSR_DEBUG( LOG_ERROR, "INTERNAL_Assembler_MoveWide() Failed\n" );
-            }
-            else {
-                retVal = INTERNAL_Assembler_MoveWide( Buffer,
-                                                      Register,
-                                                      h3,
-                                                      48,
-                                                      MOVK );
-            } // Assemble_movk()
-        } // Assemble_movk()
-    } // Assemble_movz()
+            retVal  = INTERNAL_Assembler_MoveWide( Buffer,
+                                                   Register,
+                                                   halfword,
+                                                   shift,
+                                                   MOVK );
+        } // halfword
+    } // for()
+
+    if( false == written )
+    {
+        // Every halfword is `fill`
+        retVal = INTERNAL_Assembler_MoveWide( Buffer,
+                                              Register,
+                                              0,
+                                              0,
+                                              op );
+    }
+
+    return retVal;
+}
+
+BWSR_STATUS
+    Assembler_LoadAddress
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          register_data_t*            Register,
+        IN          uint64_t                    Address
+    )
+{
+    BWSR_STATUS     retVal      = ERROR_FAILURE;
+    uint64_t        pc          = 0;
+    uint64_t        pcPage      = 0;
+    uint64_t        toPage      = 0;
+    int64_t         delta       = 0;
+    int64_t         pageDelta   = 0;
+    size_t          count       = 0;
+    size_t          adrpCount   = 0;
+    uint16_t        fill        = 0;
+    uint32_t        value       = 0;
+
+    __NOT_NULL( Assembler, Register )
+    __GREATER_THAN_0( Address )
+
+    count       = INTERNAL_Assembler_MoveWideCount( Address,
+                                                    Register->RegisterSize,
+                                                    &fill );
+    pc          = Assembler->FixedAddress + Assembler->Buffer.BufferSize;
+    pcPage      = ALIGN_FLOOR( pc,      0x1000 );
+    toPage      = ALIGN_FLOOR( Address, 0x1000 );
+    delta       = (int64_t)( Address - pc );
+    pageDelta   = (int64_t)( toPage - pcPage );
+    adrpCount   = ( toPage == Address ) ? 1 : 2;
+
+    // Without a final address only position independent code can be emitted
+    if( ( 0  == Assembler->FixedAddress ) ||
+        ( 64 != Register->RegisterSize  ) ||
+        ( 1  == count                   ) )
+    {
+        retVal = Assembler_MOV( &Assembler->Buffer,
+                                Register,
+                                Address );
+    }
+    else if( ( -( 1LL << 20 ) <= delta ) &&
+             ( ( 1LL << 20 )  >  delta ) )
+    {
+        value   = ( ADR
+                    | Rd( Register )
+                    | BIT_SHIFT( GET_BITS( (uint64_t) delta, 0, 1  ), 2,  29 )
+                    | BIT_SHIFT( GET_BITS( (uint64_t) delta, 2, 20 ), 19,  5 ) );
+        retVal  = Assembler_Write32BitInstruction( &Assembler->Buffer, value );
+    }
+    else if( ( -( 1LL << 32 ) <= pageDelta  ) &&
+             ( ( 1LL << 32 )  >  pageDelta  ) &&
+             ( adrpCount      <  count      ) )
+    {
+        value   = ( ADRP
+                    | Rd( Register )
+                    | BIT_SHIFT( GET_BITS( (uint64_t) pageDelta >> 12, 0, 1  ), 2,  29 )
+                    | BIT_SHIFT( GET_BITS( (uint64_t) pageDelta >> 12, 2, 20 ), 19,  5 ) );
+
+        if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, value ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+        }
+        else if( toPage != Address )
+        {
+            retVal = INTERNAL_Assembler_ADD( &Assembler->Buffer,
+                                             Register,
+                                             Register,
+                                             (int64_t)( Address - toPage ) );
+        } // Assembler_Write32BitInstruction()
+    }
+    else {
+        retVal = Assembler_MOV( &Assembler->Buffer,
+                                Register,
+                                Address );
+    } // Assembler->FixedAddress
 
     return retVal;
 }
@@ -941,14 +1246,7 @@ BWSR_STATUS
         } // Assembler_WriteInstruction_LDR()
     } // Assembler_CreateRelocationData()
 
-    if( ERROR_SUCCESS != retVal )
-    {
-        if( NULL != relocationData )
-        {
-            BwsrFree( relocationData );
-        }
-    } // ERROR_SUCCESS != retVal
-
+    // `relocationData` belongs to `Assembler` once created
     return retVal;
 }
 
@@ -966,17 +1264,26 @@ BWSR_STATUS
     {
         while( Assembler->RelocationDataSize-- )
         {
-            BwsrFree( Assembler->RelocationData[ Assembler->RelocationDataSize ]->ReferenceInstructions );
-            BwsrFree( Assembler->RelocationData[ Assembler->RelocationDataSize ] );
+            INTERNAL_Assembler_ReleaseRelocationData( Assembler,
+                                                      Assembler->RelocationData[ Assembler->RelocationDataSize ] );
         } // while()
 
-        BwsrFree( Assembler->RelocationData );
+        if( ( NULL                      == Assembler->Arena                     ) ||
+            ( Assembler->RelocationData != Assembler->Arena->RelocationTable    ) )
+        {
+            BwsrFree( Assembler->RelocationData );
+        }
+
         Assembler->RelocationData = NULL;
     } // Assembler->RelocationData
 
     if( Assembler->Buffer.Buffer )
     {
-        BwsrFree( Assembler->Buffer.Buffer );
+        if( false == Assembler->Buffer.Borrowed )
+        {
+            BwsrFree( Assembler->Buffer.Buffer );
+        }
+
         Assembler->Buffer.Buffer = NULL;
     } // Assembler->Buffer.Buffer
 
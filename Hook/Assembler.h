@@ -12,6 +12,20 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Instructions that may load a single literal
+#define RELOCATION_MAX_REFERENCES           8
+
+// Instruction bytes an arena holds before the heap is used
+#define ASSEMBLER_ARENA_BUFFER_SIZE         1024
+
+// Literals an arena holds before the heap is used
+#define ASSEMBLER_ARENA_RELOCATION_COUNT    16
 
 // -----------------------------------------------------------------------------
 //  ENUMS
@@ -21,12 +35,16 @@ typedef enum InstructionFields {
     kRdShift                            = 0,
     kRnShift                            = 5,
     kRtShift                            = 0,
+    kRt2Shift                           = 10,
+    kRmShift                            = 16,
+    kRsShift                            = 16,
 } InstructionFields;
 
 typedef enum UnconditionalBranchToRegisterOp {
     UnconditionalBranchToRegisterFixed  = 0xD6000000,
     BR                                  = UnconditionalBranchToRegisterFixed | 0x001F0000,
     BLR                                 = UnconditionalBranchToRegisterFixed | 0x003F0000,
+    RET                                 = UnconditionalBranchToRegisterFixed | 0x005F0000,
 } UnconditionalBranchToRegisterOp;
 
 typedef enum RegisterType {
@@ -80,6 +98,7 @@ typedef enum Shift {
 
 typedef enum MoveWideImmediateOp {
     MoveWideImmediateFixed              = 0x12800000,
+    MOVN                                = 0x00000000,
     MOVZ                                = 0x40000000,
     MOVK                                = 0x60000000,
 } MoveWideImmediateOp;
@@ -88,8 +107,24 @@ typedef enum MoveWideImmediateOp {
 typedef enum LoadStoreOp {
     STR_x                               = ( 0b11 << 30 ) | ( 0b00 << 22 ),
     LDR_x                               = ( 0b11 << 30 ) | ( 0b01 << 22 ),
+    LDR_w                               = ( 0b10 << 30 ) | ( 0b01 << 22 ),
+    LDRB_w                              = ( 0b00 << 30 ) | ( 0b01 << 22 ),
+    LDRSW_x                             = ( 0b10 << 30 ) | ( 0b10 << 22 ),
+    PRFM                                = ( 0b11 << 30 ) | ( 0b10 << 22 ),
+    LDR_s                               = ( 0b10 << 30 ) | ( 0b1 << 26 ) | ( 0b01 << 22 ),
+    LDR_d                               = ( 0b11 << 30 ) | ( 0b1 << 26 ) | ( 0b01 << 22 ),
+    LDR_q                               = ( 0b00 << 30 ) | ( 0b1 << 26 ) | ( 0b11 << 22 ),
 } LoadStoreOp;
 
+// Load/store pair, signed offset
+typedef enum LoadStorePairOp {
+    LoadStorePairOffsetFixed            = 0x29000000,
+    STP_x                               = LoadStorePairOffsetFixed | ( 0b10 << 30 ) | ( 0b0 << 26 ) | ( 0b0 << 22 ),
+    LDP_x                               = LoadStorePairOffsetFixed | ( 0b10 << 30 ) | ( 0b0 << 26 ) | ( 0b1 << 22 ),
+    STP_q                               = LoadStorePairOffsetFixed | ( 0b10 << 30 ) | ( 0b1 << 26 ) | ( 0b0 << 22 ),
+    LDP_q                               = LoadStorePairOffsetFixed | ( 0b10 << 30 ) | ( 0b1 << 26 ) | ( 0b1 << 22 ),
+} LoadStorePairOp;
+
 typedef enum AddrMode {
     AddrModeOffset,
     AddrModePreIndex,
@@ -120,6 +155,8 @@ typedef struct memory_buffer_t {
     uint8_t*                Buffer;
     uint32_t                BufferSize;
     uint32_t                BufferCapacity;
+    // `Buffer` belongs to an arena, it is copied to the heap to grow
+    bool                    Borrowed;
 } memory_buffer_t;
 
 typedef struct register_data_t {
@@ -135,7 +172,7 @@ typedef struct reference_instruct_t {
 
 typedef struct relocation_data_t {
     size_t                  ReferenceInstructionCount;
-    reference_instruct_t*   ReferenceInstructions;
+    reference_instruct_t    ReferenceInstructions[ RELOCATION_MAX_REFERENCES ];
     uintptr_t               PcOffset;
     uint8_t                 Data[ 8 ];
     uint8_t                 DataSize;
@@ -148,6 +185,14 @@ typedef struct operand_t {
     int32_t                 ShiftExtendImmediate;
 } operand_t;
 
+typedef struct assembler_arena_t {
+    uint8_t                 Buffer[ ASSEMBLER_ARENA_BUFFER_SIZE ];
+    relocation_data_t       Relocations[ ASSEMBLER_ARENA_RELOCATION_COUNT ];
+    relocation_data_t*      RelocationTable[ ASSEMBLER_ARENA_RELOCATION_COUNT ];
+    // `Relocations` handed out so far
+    size_t                  RelocationCount;
+} assembler_arena_t;
+
 typedef struct assembler_t {
     uintptr_t               FixedAddress;
     uintptr_t               FixedMemoryRange;
@@ -155,6 +200,8 @@ typedef struct assembler_t {
     relocation_data_t**     RelocationData;
     size_t                  RelocationDataSize;
     size_t                  RelocationDataCapacity;
+    // Optional storage used ahead of the heap
+    assembler_arena_t*      Arena;
 } assembler_t;
 
 typedef struct memory_operand_t {
@@ -184,10 +231,31 @@ BWSR_STATUS
         IN          uintptr_t                   FixedAddress
     );
 
+/**
+ * \brief Initializes an Assembler whose buffer and relocation data live in
+ * `Arena`, typically on the caller's stack. Nothing is allocated until the
+ * arena is exhausted, the heap is used from then on.
+ * \param[in]           Assembler           A
+ * \param[in]           FixedAddress        Start of the memory range.
+ * \param[in]           Arena               Storage used ahead of the heap.
+ * Must outlive the `Assembler`.
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Assembler` or `Arena` is `NULL`.
+ * \retval `ERROR_SUCCESS` if `Assembler` was initialized.
+ */
+BWSR_STATUS
+    Assembler_InitializeWithArena
+    (
+        IN          assembler_t*                Assembler,
+        IN          uintptr_t                   FixedAddress,
+        IN          assembler_arena_t*          Arena
+    );
+
 /**
  * \brief Allocates and initializes `RelocationData` and updates it's
  * contents with `Data`. This is then appended to the
- * `Assembler->RelocationData` array.
+ * `Assembler->RelocationData` array. A literal already holding `Data` is
+ * shared instead, while it has room for another reference.
  * \param[in,out]       RelocationData      Stores `Data`.
  * \param[in]           Assembler           A
  * \param[in]           Data                Typically an address or label.
@@ -195,7 +263,8 @@ BWSR_STATUS
  * \retval `ERROR_ARGUMENT_IS_NULL` if `RelocationData` or `Assembler` is `NULL`.
  * \retval `ERROR_MEM_ALLOC` if any memory allocation fails.
  * \retval `ERROR_SUCCESS` if `RelocationData` was allocated and initialized.
- * \warning This method allocates `RelocationData` and `Assembler->RelocationData`.
+ * \warning This method allocates `RelocationData` and `Assembler->RelocationData`
+ * once the arena of `Assembler`, if any, is exhausted.
  */
 BWSR_STATUS
     Assembler_CreateRelocationData
@@ -262,6 +331,56 @@ BWSR_STATUS
         IN          const memory_operand_t*     Addr
     );
 
+/**
+ * \brief `STP`/`LDP` (Store/Load Pair) instructions store two registers to,
+ * or load two registers from, consecutive memory at a signed offset.
+ * These instructions are written into the provided `Buffer`.
+ * \param[in,out]       Buffer              Buffer to emit instruction.
+ * \param[in]           Op                  One of `LoadStorePairOp`.
+ * \param[in]           Register            First register of the pair.
+ * \param[in]           Register2           Second register of the pair.
+ * \param[in]           Addr                Base register and offset, a multiple of the register size.
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Buffer`, `Register`, `Register2`, or `Addr` is `NULL`.
+ * \retval `ERROR_MEM_ALLOC` if the reallocation of `Buffer` fails.
+ * \retval `ERROR_SUCCESS` if `Buffer` was updated with the encoded instruction.
+ * \warning Through the call chain, `Buffer` may be reallocated.
+ */
+BWSR_STATUS
+    Assembler_LoadStorePair
+    (
+        IN  OUT     memory_buffer_t*            Buffer,
+        IN          LoadStorePairOp             Op,
+        IN          const register_data_t*      Register,
+        IN          const register_data_t*      Register2,
+        IN          const memory_operand_t*     Addr
+    );
+
+/**
+ * \brief `ADD`/`SUB` (immediate) instructions add an unsigned 12 bit
+ * immediate to, or subtract it from, a register. Register `31` is `SP`.
+ * These instructions are written into the provided `Buffer`.
+ * \param[in,out]       Buffer              Buffer to emit instruction.
+ * \param[in]           Op                  One of `AddSubImmediateOp`.
+ * \param[in]           Destination         Where the result is stored.
+ * \param[in]           Source              Register the immediate is applied to.
+ * \param[in]           Immediate           Immediate of encoded instruction.
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Buffer`, `Destination`, or `Source` is `NULL`.
+ * \retval `ERROR_MEM_ALLOC` if the reallocation of `Buffer` fails.
+ * \retval `ERROR_SUCCESS` if `Buffer` was updated with the encoded instruction.
+ * \warning Through the call chain, `Buffer` may be reallocated.
+ */
+BWSR_STATUS
+    Assembler_AddSubImmediate
+    (
+        IN  OUT     memory_buffer_t*            Buffer,
+        IN          AddSubImmediateOp           Op,
+        IN          const register_data_t*      Destination,
+        IN          const register_data_t*      Source,
+        IN          uint64_t                    Immediate
+    );
+
 /**
  * \brief `ADRP` (Address of Page) and `ADD` instructions are used together
  * to calculate the address of a large memory region. The `ADRP` instruction
@@ -290,7 +409,8 @@ BWSR_STATUS
 
 /**
  * \brief `MOV` instruction is used to move (or copy) a value into a register.
- * This instruction is written into the provided `Buffer`.
+ * The shortest `MOVZ` or `MOVN` and `MOVK` sequence is written into the
+ * provided `Buffer`. Halfwords that are all zeros or all ones cost nothing.
  * \param[in,out]       Buffer              Buffer to emit instruction.
  * \param[in]           Register            Where the result of an operation is stored or where data is moved to.
  * \param[in]           Immediate           Immediate of encoded instruction.
@@ -308,6 +428,29 @@ BWSR_STATUS
         IN          uint64_t                    Immediate
     );
 
+/**
+ * \brief Loads `Address` into `Register` with the fewest instructions. Once
+ * `Assembler->FixedAddress` is known, `ADR` or `ADRP` and `ADD` are used when
+ * they are shorter than `Assembler_MOV`. The result is never longer than
+ * `Assembler_MOV` would be.
+ * These instructions are written into the provided `Assembler->Buffer`.
+ * \param[in,out]       Assembler           A
+ * \param[in]           Register            Where the address is stored.
+ * \param[in]           Address             Address to load.
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Assembler` or `Register` is `NULL`.
+ * \retval `ERROR_MEM_ALLOC` if the reallocation of `Assembler->Buffer` fails.
+ * \retval `ERROR_SUCCESS` if `Assembler->Buffer` was updated with the encoded instructions.
+ * \warning Through the call chain, `Assembler->Buffer` may be reallocated.
+ */
+BWSR_STATUS
+    Assembler_LoadAddress
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          register_data_t*            Register,
+        IN          uint64_t                    Address
+    );
+
 /**
  * \brief `LDR` (Load Register) instruction is used to load data from memory
  * into a register.
@@ -317,6 +460,8 @@ BWSR_STATUS
  * \param[in]           Relocation          Contains branching address or location of a specific label.
  * \return `BWSR_STATUS`
  * \retval `ERROR_ARGUMENT_IS_NULL` if `Buffer`, `Result`, or `Relocation` is `NULL`.
+ * \retval `ERROR_MEMORY_OVERFLOW` if `Relocation` already has
+ * `RELOCATION_MAX_REFERENCES` references.
  * \retval `ERROR_MEM_ALLOC` if any allocation fails.
  * \retval `ERROR_SUCCESS` if `Buffer` was updated with the encoded instruction.
  * \warning Through the call chain, `Buffer` may be reallocated.
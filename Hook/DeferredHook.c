@@ -0,0 +1,665 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+// `dl_iterate_phdr()` is only declared with `_GNU_SOURCE` on glibc.
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( __ANDROID__ ) || defined( __linux__ )
+    #include <pthread.h>
+    #include <elf.h>
+    #include <link.h>
+#endif
+
+#include "Hook/DeferredHook.h"
+#include "Hook/HookRegistry.h"
+#include "Hook/InlineHook.h"
+
+#include "utility/debug.h"
+#include "utility/error.h"
+#include "utility/utility.h"
+
+#include "Memory/MemoryTracker.h"
+
+#if defined( __ANDROID__ ) || defined( __linux__ )
+    #include "SymbolResolve/Linux/Elf.h"
+#endif
+
+// -----------------------------------------------------------------------------
+//  STRUCTURES & DEFINITIONS
+// -----------------------------------------------------------------------------
+
+#if defined( __ANDROID__ ) || defined( __linux__ )
+
+typedef void
+    ( *debug_state_fn_t )
+    (
+        void
+    );
+
+typedef void*
+    ( *loader_dlopen_fn_t )
+    (
+        const char*     FileName,
+        int             Flags,
+        const void*     CallerAddress
+    );
+
+typedef void*
+    ( *loader_android_dlopen_ext_fn_t )
+    (
+        const char*     FileName,
+        int             Flags,
+        const void*     ExtInfo,
+        const void*     CallerAddress
+    );
+
+typedef struct deferred_hook_t deferred_hook_t;
+
+typedef struct deferred_hook_t {
+    // `NULL` installs the hook in whichever image defines the symbol
+    const char*             ImageName;
+    const char*             SymbolName;
+    void*                   HookFunction;
+    // Written when the hook is installed
+    void**                  OutOriginalFunction;
+    deferred_hook_t*        Next;
+    // Storage of `ImageName` and `SymbolName`
+    char                    Names[];
+} deferred_hook_t;
+
+typedef struct loader_hook_t {
+    // Loader entry point to intercept
+    const char*             SymbolName;
+    void*                   HookFunction;
+    void**                  OutOriginalFunction;
+} loader_hook_t;
+
+// -----------------------------------------------------------------------------
+//  PROTOTYPES
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Installs a deferred hook if its symbol can be resolved. The hook is
+ * written right away, outside of any open hook transaction.
+ * \param[in]           Hook                Hook to install
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_NOT_FOUND` if the image or symbol is not loaded yet
+ * \retval `ERROR_SUCCESS` if the hook was installed
+ */
+static
+BWSR_STATUS
+    INTERNAL_DeferredHook_TryInstall
+    (
+        IN          const deferred_hook_t*      Hook
+    );
+
+/**
+ * \brief Installs every pending hook whose symbol has been loaded, and
+ * drops it from the pending list. A hook that fails to install stays
+ * pending and is retried after the next load. `gDeferredHooksLock` is
+ * held by the caller.
+ * \return void
+ */
+static
+void
+    INTERNAL_DeferredHook_InstallPending
+    (
+        void
+    );
+
+/**
+ * \brief Releases `gDeferredHooksLock`, after installing the pending hooks
+ * for every load that happened while it was held.
+ * \return void
+ */
+static
+void
+    INTERNAL_DeferredHook_Unlock
+    (
+        void
+    );
+
+/**
+ * \brief Called after the loader added a library.
+ * \param[in]           LoaderLocked        The loader lock is held. The
+ * pending hooks are then left to the holder of `gDeferredHooksLock`, which
+ * may be waiting for the loader lock to resolve a symbol.
+ * \return void
+ */
+static
+void
+    INTERNAL_DeferredHook_LibraryLoaded
+    (
+        IN          const bool                  LoaderLocked
+    );
+
+/**
+ * \brief Hooks the function the loader calls for debuggers on every change
+ * of its link map. Nothing the application calls is intercepted, so lookups
+ * that depend on the caller of `dlopen` are left alone.
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_NOT_FOUND` if the loader does not publish its `r_debug`
+ * \retval `ERROR_SUCCESS` if library loads are watched
+ */
+static
+BWSR_STATUS
+    INTERNAL_DeferredHook_WatchDebugState
+    (
+        void
+    );
+
+/**
+ * \brief Watches library loads if they are not watched by this file yet
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_NOT_FOUND` if no loader entry point could be found
+ * \retval `ERROR_SUCCESS` if library loads are watched
+ */
+static
+BWSR_STATUS
+    INTERNAL_DeferredHook_WatchLoader
+    (
+        void
+    );
+
+// -----------------------------------------------------------------------------
+//  GLOBALS
+// -----------------------------------------------------------------------------
+
+// Hooks whose symbol is not loaded yet
+static deferred_hook_t*     gDeferredHooks      = NULL;
+static pthread_mutex_t      gDeferredHooksLock  = PTHREAD_MUTEX_INITIALIZER;
+
+// A library was loaded while `gDeferredHooksLock` was held
+static bool                 gLoadPending        = false;
+
+// Published by the loader through `DT_DEBUG` of the executable
+static struct r_debug*      gLoaderDebug        = NULL;
+
+static debug_state_fn_t                 gOriginalDebugState             = NULL;
+static loader_dlopen_fn_t               gOriginalLoaderDlopen           = NULL;
+static loader_android_dlopen_ext_fn_t   gOriginalLoaderAndroidDlopenExt = NULL;
+
+// -----------------------------------------------------------------------------
+//  IMPLEMENTATION
+// -----------------------------------------------------------------------------
+
+static
+void
+    INTERNAL_DeferredHook_DebugState
+    (
+        void
+    )
+{
+    gOriginalDebugState();
+
+    // Called before and after every change of the link map, with the
+    // loader lock held. A library added is mapped once it is consistent.
+    if( RT_CONSISTENT == __atomic_load_n( &gLoaderDebug->r_state, __ATOMIC_ACQUIRE ) )
+    {
+        INTERNAL_DeferredHook_LibraryLoaded( true );
+    }
+}
+
+static
+void*
+    INTERNAL_DeferredHook_LoaderDlopen
+    (
+        IN          const char*     FileName,
+        IN          int             Flags,
+        IN          const void*     CallerAddress
+    )
+{
+    void*   handle  = gOriginalLoaderDlopen( FileName, Flags, CallerAddress );
+
+    if( NULL != handle )
+    {
+        INTERNAL_DeferredHook_LibraryLoaded( false );
+    }
+
+    return handle;
+}
+
+static
+void*
+    INTERNAL_DeferredHook_LoaderAndroidDlopenExt
+    (
+        IN          const char*     FileName,
+        IN          int             Flags,
+        IN          const void*     ExtInfo,
+        IN          const void*     CallerAddress
+    )
+{
+    void*   handle  = gOriginalLoaderAndroidDlopenExt( FileName, Flags, ExtInfo, CallerAddress );
+
+    if( NULL != handle )
+    {
+        INTERNAL_DeferredHook_LibraryLoaded( false );
+    }
+
+    return handle;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_DeferredHook_TryInstall
+    (
+        IN          const deferred_hook_t*      Hook
+    )
+{
+    BWSR_STATUS     retVal      = ERROR_FAILURE;
+    uintptr_t       address     = 0;
+
+    __NOT_NULL( Hook )
+
+    if( ERROR_SUCCESS != ( retVal = BWSR_ResolveSymbol( Hook->SymbolName,
+                                                        Hook->ImageName,
+                                                        &address ) ) )
+    {
+        // Not loaded yet
+        retVal = ERROR_NOT_FOUND;
+    }
+    else if( ERROR_SUCCESS != ( retVal = HookRegistry_InstallOutsideTransaction( (void*) address,
+                                                                                 Hook->HookFunction,
+                                                                                 Hook->OutOriginalFunction,
+                                                                                 false ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "HookRegistry_InstallOutsideTransaction() Failed\n" );
+    } // BWSR_ResolveSymbol()
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_DeferredHook_InstallPending
+    (
+        void
+    )
+{
+    deferred_hook_t**   link        = NULL;
+    deferred_hook_t*    hook        = NULL;
+    BWSR_STATUS         status      = ERROR_FAILURE;
+
+    // Always taken after the pending list lock, the
+    // public API never takes the pending list lock
+    HookRegistry_Lock();
+
+    link = &gDeferredHooks;
+
+    while( NULL != ( hook = *link ) )
+    {
+        if( ERROR_SUCCESS != ( status = INTERNAL_DeferredHook_TryInstall( hook ) ) )
+        {
+            if( ERROR_NOT_FOUND != status )
+            {
+                BWSR_DEBUG( LOG_WARNING,
+                            "Deferred hook of %s stays pending: %s\n",
+                            hook->SymbolName,
+                            ErrorString( status ) );
+            } // status
+
+            link = &hook->Next;
+        }
+        else {
+            *link = hook->Next;
+
+            BwsrFree( hook );
+        } // INTERNAL_DeferredHook_TryInstall()
+    } // while()
+
+    HookRegistry_Unlock();
+}
+
+static
+void
+    INTERNAL_DeferredHook_Unlock
+    (
+        void
+    )
+{
+    do
+    {
+        while( true == __atomic_exchange_n( &gLoadPending, false, __ATOMIC_SEQ_CST ) )
+        {
+            INTERNAL_DeferredHook_InstallPending();
+        } // while()
+
+        pthread_mutex_unlock( &gDeferredHooksLock );
+
+        // A load that found the lock still taken is not lost
+    } while( ( true == __atomic_load_n( &gLoadPending, __ATOMIC_SEQ_CST ) ) &&
+             ( 0    == pthread_mutex_trylock( &gDeferredHooksLock )     ) );
+}
+
+static
+void
+    INTERNAL_DeferredHook_LibraryLoaded
+    (
+        IN          const bool                  LoaderLocked
+    )
+{
+    // Set first, a hook added right now installs once it is
+    // on the list without this load seeing it there
+    __atomic_store_n( &gLoadPending, true, __ATOMIC_SEQ_CST );
+
+    // Most loads happen with nothing pending
+    if( NULL == __atomic_load_n( &gDeferredHooks, __ATOMIC_SEQ_CST ) )
+    {
+        return;
+    }
+
+    if( false == LoaderLocked )
+    {
+        pthread_mutex_lock( &gDeferredHooksLock );
+        INTERNAL_DeferredHook_Unlock();
+    }
+    else if( 0 == pthread_mutex_trylock( &gDeferredHooksLock ) )
+    {
+        INTERNAL_DeferredHook_Unlock();
+    } // LoaderLocked
+}
+
+static
+int
+    INTERNAL_DeferredHook_FindLoaderDebug_Callback
+    (
+        IN          struct dl_phdr_info*    Info,
+        IN          size_t                  Size,
+        IN  OUT     void*                   Data
+    )
+{
+    const Elf64_Dyn*    dynamic     = NULL;
+    size_t              i           = 0;
+
+    (void) Size;
+
+    for( i = 0; i < Info->dlpi_phnum; i++ )
+    {
+        if( PT_DYNAMIC == Info->dlpi_phdr[ i ].p_type )
+        {
+            dynamic = (const Elf64_Dyn*)( Info->dlpi_addr + Info->dlpi_phdr[ i ].p_vaddr );
+        }
+    } // for()
+
+    // Only the executable has it filled in
+    for( ; ( NULL != dynamic ) && ( DT_NULL != dynamic->d_tag ); dynamic++ )
+    {
+        if( ( DT_DEBUG == dynamic->d_tag   ) &&
+            ( 0        != dynamic->d_un.d_ptr ) )
+        {
+            *(struct r_debug**) Data = (struct r_debug*) dynamic->d_un.d_ptr;
+
+            return 1;
+        }
+    } // for()
+
+    return 0;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_DeferredHook_WatchDebugState
+    (
+        void
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+    struct r_debug*     debug       = NULL;
+
+    (void) dl_iterate_phdr( INTERNAL_DeferredHook_FindLoaderDebug_Callback, &debug );
+
+    if( ( NULL == debug           ) ||
+        ( 0    == debug->r_brk    ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "The loader publishes no r_debug\n" );
+        retVal = ERROR_NOT_FOUND;
+    }
+    else {
+        gLoaderDebug = debug;
+
+        // Hooks of others on it do not count, and the watcher
+        // is gone once every hook was destroyed
+        if( ERROR_SUCCESS == HookRegistry_FindHandler( (void*) debug->r_brk,
+                                                       (void*) INTERNAL_DeferredHook_DebugState ) )
+        {
+            retVal = ERROR_SUCCESS;
+        }
+        // Usually a lone `ret`, nothing but a `B` fits over it
+        else if( ERROR_SUCCESS != ( retVal = HookRegistry_InstallOutsideTransaction( (void*) debug->r_brk,
+                                                                                     (void*) INTERNAL_DeferredHook_DebugState,
+                                                                                     (void**) &gOriginalDebugState,
+                                                                                     true ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "HookRegistry_InstallOutsideTransaction() Failed\n" );
+        } // HookRegistry_FindHandler()
+    } // debug
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_DeferredHook_WatchLoader
+    (
+        void
+    )
+{
+    BWSR_STATUS     retVal      = ERROR_NOT_FOUND;
+
+#if defined( __ANDROID__ )
+    uintptr_t       address     = 0;
+    size_t          i           = 0;
+
+    // The linker picks the namespace of a library from the caller
+    // address. These entry points take it as an argument, so it is
+    // passed through untouched. Before Android 8.0 they do not exist.
+    loader_hook_t   hooks[]     = {
+        { "__loader_dlopen",
+          (void*) INTERNAL_DeferredHook_LoaderDlopen,
+          (void**) &gOriginalLoaderDlopen },
+        { "__loader_android_dlopen_ext",
+          (void*) INTERNAL_DeferredHook_LoaderAndroidDlopenExt,
+          (void**) &gOriginalLoaderAndroidDlopenExt },
+    };
+#else
+    (void) INTERNAL_DeferredHook_LoaderDlopen;
+    (void) INTERNAL_DeferredHook_LoaderAndroidDlopenExt;
+#endif
+
+    HookRegistry_Lock();
+
+#if defined( __ANDROID__ )
+    for( i = 0; i < ARRAY_LENGTH( hooks ); i++ )
+    {
+        if( ERROR_SUCCESS != BWSR_ResolveSymbol( hooks[ i ].SymbolName, NULL, &address ) )
+        {
+            continue;
+        }
+
+        // Hooks of others on the entry point do not count, and
+        // the watcher is gone once every hook was destroyed
+        if( ERROR_SUCCESS == HookRegistry_FindHandler( (void*) address,
+                                                       hooks[ i ].HookFunction ) )
+        {
+            retVal = ERROR_SUCCESS;
+        }
+        else if( ERROR_SUCCESS != HookRegistry_InstallOutsideTransaction( (void*) address,
+                                                                          hooks[ i ].HookFunction,
+                                                                          hooks[ i ].OutOriginalFunction,
+                                                                          false ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "HookRegistry_InstallOutsideTransaction() Failed on %s\n", hooks[ i ].SymbolName );
+        }
+        else {
+            retVal = ERROR_SUCCESS;
+        } // HookRegistry_FindHandler()
+    } // for()
+#endif
+
+    // glibc, and the linker before Android 8.0, only have entry points
+    // that find libraries relative to their caller
+    if( ERROR_SUCCESS != retVal )
+    {
+        retVal = INTERNAL_DeferredHook_WatchDebugState();
+    }
+
+    HookRegistry_Unlock();
+
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_DeferHook
+    (
+        IN OPTIONAL     const char*     ImageName,
+        IN              const char*     SymbolName,
+        IN              void*           HookFunction,
+        OUT OPTIONAL    void**          OutOriginalFunction
+    )
+{
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    deferred_hook_t*    hook            = NULL;
+    size_t              imageLength     = 0;
+    size_t              symbolLength    = 0;
+
+    __NOT_NULL( SymbolName, HookFunction )
+
+    if( NULL != ImageName )
+    {
+        imageLength = strlen( ImageName ) + 1;
+    }
+
+    symbolLength = strlen( SymbolName ) + 1;
+
+    if( NULL == ( hook = (deferred_hook_t*) BwsrCalloc( 1, sizeof( deferred_hook_t ) + imageLength + symbolLength ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        memcpy( hook->Names, SymbolName, symbolLength );
+        hook->SymbolName            = hook->Names;
+        hook->HookFunction          = HookFunction;
+        hook->OutOriginalFunction   = OutOriginalFunction;
+
+        if( NULL != ImageName )
+        {
+            memcpy( hook->Names + symbolLength, ImageName, imageLength );
+            hook->ImageName = hook->Names + symbolLength;
+        }
+
+        pthread_mutex_lock( &gDeferredHooksLock );
+
+        if( ERROR_NOT_FOUND != ( retVal = INTERNAL_DeferredHook_TryInstall( hook ) ) )
+        {
+            // Already loaded, nothing to defer
+            BwsrFree( hook );
+        }
+        else if( ERROR_SUCCESS != ( retVal = INTERNAL_DeferredHook_WatchLoader() ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_DeferredHook_WatchLoader() Failed\n" );
+            BwsrFree( hook );
+        }
+        else {
+            hook->Next = gDeferredHooks;
+
+            __atomic_store_n( &gDeferredHooks, hook, __ATOMIC_SEQ_CST );
+        } // INTERNAL_DeferredHook_TryInstall()
+
+        INTERNAL_DeferredHook_Unlock();
+    } // BwsrCalloc()
+
+    __DEBUG_RETVAL( retVal )
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_CancelDeferredHook
+    (
+        IN OPTIONAL     const char*     ImageName,
+        IN              const char*     SymbolName,
+        IN              void*           HookFunction
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_NOT_FOUND;
+    deferred_hook_t**   link        = NULL;
+    deferred_hook_t*    hook        = NULL;
+
+    __NOT_NULL( SymbolName, HookFunction )
+
+    pthread_mutex_lock( &gDeferredHooksLock );
+
+    link = &gDeferredHooks;
+
+    while( NULL != ( hook = *link ) )
+    {
+        if( ( HookFunction == hook->HookFunction                        ) &&
+            ( 0            == strcmp( SymbolName, hook->SymbolName )    ) &&
+            ( ( ImageName == hook->ImageName ) ||
+              ( ( NULL != ImageName                                 ) &&
+                ( NULL != hook->ImageName                           ) &&
+                ( 0    == strcmp( ImageName, hook->ImageName )      ) ) ) )
+        {
+            *link = hook->Next;
+
+            BwsrFree( hook );
+
+            retVal = ERROR_SUCCESS;
+        }
+        else {
+            link = &hook->Next;
+        } // Match
+    } // while()
+
+    pthread_mutex_unlock( &gDeferredHooksLock );
+
+    return retVal;
+}
+
+#else
+
+BWSR_API
+BWSR_STATUS
+    BWSR_DeferHook
+    (
+        IN OPTIONAL     const char*     ImageName,
+        IN              const char*     SymbolName,
+        IN              void*           HookFunction,
+        OUT OPTIONAL    void**          OutOriginalFunction
+    )
+{
+    (void) ImageName;
+    (void) SymbolName;
+    (void) HookFunction;
+    (void) OutOriginalFunction;
+
+    return ERROR_UNIMPLEMENTED;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_CancelDeferredHook
+    (
+        IN OPTIONAL     const char*     ImageName,
+        IN              const char*     SymbolName,
+        IN              void*           HookFunction
+    )
+{
+    (void) ImageName;
+    (void) SymbolName;
+    (void) HookFunction;
+
+    return ERROR_UNIMPLEMENTED;
+}
+
+#endif
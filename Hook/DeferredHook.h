@@ -0,0 +1,25 @@
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int
+    BWSR_DeferHook
+    (
+        const char* ImageName,
+        const char* SymbolName,
+        void*       HookFunction,
+        void**      OutOriginalFunction
+    );
+
+int
+    BWSR_CancelDeferredHook
+    (
+        const char* ImageName,
+        const char* SymbolName,
+        void*       HookFunction
+    );
+
+#ifdef __cplusplus
+}
+#endif
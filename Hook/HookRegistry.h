@@ -0,0 +1,81 @@
+#ifndef __HOOK_REGISTRY_H__
+#define __HOOK_REGISTRY_H__
+
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdbool.h>
+
+#include "utility/utility.h"
+#include "utility/error.h"
+
+// -----------------------------------------------------------------------------
+//  EXPORTED FUNCTIONS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Takes the lock every public hook call runs under. Recursive, hooks
+ * may be installed and removed while it is held.
+ * \return void
+ */
+void
+    HookRegistry_Lock
+    (
+        void
+    );
+
+/**
+ * \brief Releases the lock taken by `HookRegistry_Lock()`.
+ * \return void
+ */
+void
+    HookRegistry_Unlock
+    (
+        void
+    );
+
+/**
+ * \brief Hooks an address right away, even while a hook transaction is open
+ * on another thread. The hook is never staged.
+ * \param[in]           Address             Address to hook
+ * \param[in]           FakeFunction        Function called instead
+ * \param[out]          Original            Optional. Receives the original
+ * function.
+ * \param[in]           SingleInstruction   `Address` may be a function of a
+ * single instruction. Only a near `B` is written over it, never the long
+ * trampoline.
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Address` or `FakeFunction` is `NULL`.
+ * \retval `ERROR_HOOK_TRANSACTION` if `Address` is hooked by the open
+ * transaction and not written yet
+ * \retval `ERROR_SYMBOL_SIZE` if `SingleInstruction` is set and no stub can
+ * be placed within reach of a `B`
+ * \retval `ERROR_SUCCESS` if the hook is installed
+ */
+BWSR_STATUS
+    HookRegistry_InstallOutsideTransaction
+    (
+        IN          void*                       Address,
+        IN          void*                       FakeFunction,
+        OUT         void**                      Original,
+        IN          const bool                  SingleInstruction
+    );
+
+/**
+ * \brief Checks whether a hook function is one of the handlers of an address.
+ * \param[in]           Address             Hooked address
+ * \param[in]           FakeFunction        Hook function to look for
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Address` or `FakeFunction` is `NULL`.
+ * \retval `ERROR_NOT_FOUND` if `FakeFunction` does not handle `Address`
+ * \retval `ERROR_SUCCESS` if `FakeFunction` handles `Address`
+ */
+BWSR_STATUS
+    HookRegistry_FindHandler
+    (
+        IN          void*                       Address,
+        IN          void*                       FakeFunction
+    );
+
+#endif // __HOOK_REGISTRY_H__
@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "utility/utility.h"
 
 // -----------------------------------------------------------------------------
@@ -134,7 +135,7 @@ int64_t
 {
     int64_t imm = 0;
 
-    *(uint32_t*) &InstructionDecoder = Instruction;
+    memcpy( &InstructionDecoder, &Instruction, sizeof( Instruction ) );
 
     imm = InstructionDecoder.ImmLo + ( InstructionDecoder.ImmHi << 2 );
     imm = INTERNAL_SignExtend( imm, 21 );
@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stddef.h>
 #include <limits.h>
+#include <pthread.h>
 
 #if defined( __APPLE__ )
 
@@ -38,8 +39,10 @@
 #endif
 
 #include "Hook/InlineHook.h"
+#include "Hook/HookRegistry.h"
 #include "Hook/Assembler.h"
 #include "Hook/ImmediateDecoding.h"
+#include "Hook/ThreadSuspend.h"
 
 #include "utility/utility.h"
 #include "utility/error.h"
@@ -71,6 +74,22 @@
     .RegisterType   = kRegister_64          \
 }
 
+// `Q` register of size `128`
+#define Q( RegisterID ) (register_data_t)   \
+{                                           \
+    .RegisterId     = RegisterID,           \
+    .RegisterSize   = 128,                  \
+    .RegisterType   = kSIMD_FP_Register_128 \
+}
+
+// `SP` relative operand
+#define MEMOP_SP( OFFSET ) (memory_operand_t)           \
+{                                                       \
+    .Base           = X( ARM64_SP_REG_NDX ),            \
+    .Offset         = (int64_t)( OFFSET ),              \
+    .AddressMode    = AddrModeOffset                    \
+}
+
 #define MEMOP_ADDR( ADDRESS_MODE ) (memory_operand_t)   \
 {                                                       \
     .Base           = TMP_REG_0,                        \
@@ -79,6 +98,44 @@
 }
 
 #define ARM64_TMP_REG_NDX_0 17
+#define ARM64_TMP_REG_NDX_1 16
+
+// `SP` when used as a base or by `ADD`/`SUB` (immediate)
+#define ARM64_SP_REG_NDX    31
+
+// Argument and indirect result registers, `x0` - `x8`
+#define ARM64_ARG_REG_COUNT 9
+
+// Reach of `B`, +/- 128MB
+#define ARM64_B_RANGE       ( 1 << 27 )
+
+// Reach of `ADRP`, +/- 4GB
+#define ARM64_ADRP_RANGE    ( 1ULL << 32 )
+
+#define ARM64_NOP           0xD503201F
+
+// Smallest interceptor registry capacity
+#define INTERCEPTOR_REGISTRY_MIN_CAPACITY   16
+
+// Marks a deleted registry slot. The list head is never registered.
+#define INTERCEPTOR_REGISTRY_TOMBSTONE      ( &gInterceptorTracker )
+
+// Instrumented calls a thread can be nested in before
+// `OnLeave` is skipped
+#define INSTRUMENTATION_SHADOW_STACK_DEPTH  256
+
+// Call counters are spread over this many cache lines
+#define HOOK_STATISTICS_STRIPE_BITS         4
+#define HOOK_STATISTICS_STRIPES             ( 1 << HOOK_STATISTICS_STRIPE_BITS )
+
+// Lowest bit of the thread pointer folded into the stripe of a
+// call. Bits below it barely differ between threads.
+#define HOOK_STATISTICS_STRIPE_LOW_BIT      12
+
+#define CACHE_LINE_SIZE                     64
+
+// Instructions a patch over the target may span
+#define INTERCEPTOR_MAX_PATCH_INSTRUCTIONS  8
 
 // -----------------------------------------------------------------------------
 //  ENUMS
@@ -95,6 +152,7 @@ typedef enum UnconditionalBranchOp {
 typedef enum CompareBranchOp {
     CompareBranchFixed                  = 0x34000000,
     CompareBranchFixedMask              = 0x7E000000,
+    CBNZ_w                              = CompareBranchFixed | 0x01000000,
 } CompareBranchOp;
 
 typedef enum ConditionalBranchOp {
@@ -108,6 +166,55 @@ typedef enum TestBranchOp {
     TestBranchFixedMask                 = 0x7E000000,
 } TestBranchOp;
 
+// Shifted register, `Rm` shifted by `imm6` in bits 15 - 10
+typedef enum AddSubShiftedOp {
+    AddSubShiftedFixed                  = 0x0B000000,
+    ADD_x_shift                         = AddSubShiftedFixed | 0x80000000,
+} AddSubShiftedOp;
+
+typedef enum LogicalShiftedOp {
+    LogicalShiftedFixed                 = 0x0A000000,
+    EOR_x_shift                         = LogicalShiftedFixed | 0xC0000000,
+} LogicalShiftedOp;
+
+// `immr` in bits 21 - 16, `imms` in bits 15 - 10
+typedef enum BitfieldOp {
+    BitfieldFixed                       = 0x13000000,
+    UBFM_x                              = BitfieldFixed | 0xC0400000,
+} BitfieldOp;
+
+// `STXR` returns its status in `Rs`
+typedef enum LoadStoreExclusiveOp {
+    LoadStoreExclusiveFixed             = 0x08000000,
+    LDXR_x                              = LoadStoreExclusiveFixed | 0xC05F7C00,
+    STXR_x                              = LoadStoreExclusiveFixed | 0xC0007C00,
+} LoadStoreExclusiveOp;
+
+typedef enum SystemOp {
+    SystemFixed                         = 0xD5000000,
+    ISB                                 = SystemFixed | 0x00033FDF,
+    MRS                                 = SystemFixed | 0x00380000,
+} SystemOp;
+
+// Registers read by `MRS`, `op1:CRn:CRm:op2` in bits 18 - 5
+typedef enum SystemRegister {
+    CNTVCT_EL0                          = ( 3 << 16 ) | ( 14 << 12 ) | ( 0 << 8 ) | ( 2 << 5 ),
+    TPIDR_EL0                           = ( 3 << 16 ) | ( 13 << 12 ) | ( 0 << 8 ) | ( 2 << 5 ),
+    TPIDRRO_EL0                         = ( 3 << 16 ) | ( 13 << 12 ) | ( 0 << 8 ) | ( 3 << 5 ),
+} SystemRegister;
+
+// How an instruction is rewritten when it is relocated
+typedef enum InstructionClass {
+    kInstructionCopy                    = 0,
+    kInstructionUnconditionalBranch,
+    kInstructionConditionalBranch,
+    kInstructionCompareBranch,
+    kInstructionTestBranch,
+    kInstructionLiteralLoad,
+    kInstructionADR,
+    kInstructionADRP,
+} InstructionClass;
+
 // -----------------------------------------------------------------------------
 //  STRUCTURES
 // -----------------------------------------------------------------------------
@@ -115,22 +222,123 @@ typedef enum TestBranchOp {
 typedef struct intercept_routing_t      intercept_routing_t;
 typedef struct interceptor_tracker_t    interceptor_tracker_t;
 
+#if defined( __APPLE__ )
+typedef __typeof( vm_protect )*         memory_protect_fn_t;
+#elif defined( __ANDROID__ ) || defined( __linux__ )
+typedef __typeof( mprotect )*           memory_protect_fn_t;
+#endif
+
 typedef struct trampoline_t {
     memory_range_t              Buffer;
+    // Stub jumping through `Dispatch` of the entry. The patch
+    // written over the target only ever branches here.
+    memory_range_t              Dispatch;
 } trampoline_t;
 
 typedef struct relocation_context_t {
     uintptr_t                   Cursor;
     memory_range_t*             BaseAddress;
+    // Optional. Buffer offset each relocated instruction starts at.
+    uint32_t*                   InstructionOffsets;
 } relocation_context_t;
 
-typedef struct interceptor_entry_t {
+typedef struct hook_statistics_stripe_t {
+    volatile uint64_t           Calls;
+    // Keeps every stripe on its own cache line
+    uint8_t                     Padding[ CACHE_LINE_SIZE - sizeof( uint64_t ) ];
+} hook_statistics_stripe_t;
+
+typedef struct hook_statistics_t {
+    // Calls entered, each thread bumps a single stripe
+    hook_statistics_stripe_t    Stripes[ HOOK_STATISTICS_STRIPES ];
+    // `Latency[ n ]` counts calls of [ 2^n, 2^( n + 1 ) ) ticks
+    volatile uint64_t           Latency[ BWSR_LATENCY_BUCKETS ];
+    // Calls are timed, not only counted
+    volatile bool               MeasureLatency;
+} hook_statistics_t;
+
+typedef struct instrumentation_t {
+    InstrumentCallback          OnEnter;
+    InstrumentCallback          OnLeave;
+    void*                       UserData;
+    // Set for the statistics stub of an entry
+    hook_statistics_t*          Statistics;
+    // Enter stub, followed by the leave stub
+    memory_range_t              Stub;
+    // Return address handed to the instrumented function
+    uintptr_t                   LeaveStub;
+    // Target the stub was installed on, once removed it is only reused there
+    uintptr_t                   Target;
+    // Bumped each time the stub is installed. A call that entered an
+    // earlier install never reaches the callbacks of a later one.
+    volatile uint32_t           Generation;
+} instrumentation_t;
+
+typedef struct instrumentation_frame_t {
+    // Return address replaced by the leave stub
+    uintptr_t                   ReturnAddress;
+    // Tick count on entry of a call timed by statistics
+    uint64_t                    EnterTicks;
+    // `Generation` of the instrumentation the call entered
+    uint32_t                    Generation;
+} instrumentation_frame_t;
+
+// Saved by the statistics stub around its helpers, the
+// registers that may hold arguments or results
+typedef struct hook_statistics_frame_t {
+    // x0 - x8, padded to 16 bytes
+    uint64_t                    X[ ARM64_ARG_REG_COUNT + 1 ];
+    // q0 - q7
+    uint64_t                    Q[ 8 ][ 2 ];
+} hook_statistics_frame_t;
+
+typedef struct instrumentation_shadow_stack_t {
+    // Instrumented calls in progress, innermost last
+    instrumentation_frame_t     Frames[ INSTRUMENTATION_SHADOW_STACK_DEPTH ];
+    size_t                      Depth;
+} instrumentation_shadow_stack_t;
+
+typedef struct hook_handler_t hook_handler_t;
+
+typedef struct hook_handler_t {
     uintptr_t                   HookFunctionAddress;
+    // Read by the `CallNext` stub. The next older handler,
+    // or the relocated original code after the oldest one.
+    volatile uintptr_t          Next;
+    // Handed out as the original function. The oldest handler
+    // has none, nothing is ever inserted behind it.
+    memory_range_t              CallNext;
+    // Set when the handler is an instrumentation stub
+    instrumentation_t*          Instrumentation;
+    hook_handler_t*             Newer;
+    hook_handler_t*             Older;
+} hook_handler_t;
+
+typedef struct interceptor_entry_t {
     uintptr_t                   Address;
     memory_range_t              Patched;
     memory_range_t              Relocated;
     intercept_routing_t*        Routing;
     uint8_t*                    OriginalCode;
+    // Read by the dispatch stub on every call. The newest handler
+    // while enabled, the relocated original code while disabled.
+    volatile uintptr_t          Dispatch;
+    // Handlers of the address, newest first
+    hook_handler_t*             Handlers;
+    // Counts and times every call ahead of the handlers. Generated
+    // once, disabling only takes it out of the dispatch.
+    hook_handler_t*             Statistics;
+    // Where the instructions of `Patched` start in `Relocated`
+    uint32_t                    RelocatedOffsets[ INTERCEPTOR_MAX_PATCH_INSTRUCTIONS ];
+    bool                        Disabled;
+    bool                        StatisticsEnabled;
+    // Patches are held by the open hook transaction
+    bool                        Staged;
+    // The target may be a single instruction long, only
+    // a near `B` is ever written over it
+    bool                        SingleInstruction;
+    // A page holding one of its staged patches could not be written
+    bool                        CommitFailed;
 } interceptor_entry_t;
 
 typedef struct intercept_routing_t {
@@ -155,6 +363,36 @@ typedef struct interceptor_tracker_t {
     interceptor_tracker_t*      Previous;
 } interceptor_tracker_t;
 
+typedef struct interceptor_registry_t {
+    // Open addressing, linear probing. Power of two capacity.
+    interceptor_tracker_t**     Slots;
+    size_t                      Capacity;
+    size_t                      Count;
+    size_t                      Tombstones;
+} interceptor_registry_t;
+
+typedef struct staged_patch_t {
+    // Entry whose installation staged the patch
+    interceptor_entry_t*        Owner;
+    // Keeps writes to the same page in staging order
+    size_t                      Sequence;
+    uintptr_t                   Page;
+    uintptr_t                   Address;
+    uint8_t*                    Buffer;
+    uint32_t                    BufferSize;
+    memory_protect_fn_t         MemoryProtectFn;
+    CallBeforePageWrite         BeforePageWriteFn;
+    CallAfterPageWrite          AfterPageWriteFn;
+} staged_patch_t;
+
+typedef struct hook_transaction_t {
+    staged_patch_t*             Patches;
+    size_t                      PatchCount;
+    size_t                      PatchCapacity;
+    size_t                      Sequence;
+    bool                        Active;
+} hook_transaction_t;
+
 // -----------------------------------------------------------------------------
 //  GLOBALS
 // -----------------------------------------------------------------------------
@@ -163,6 +401,62 @@ static const register_data_t    TMP_REG_0           = X( ARM64_TMP_REG_NDX_0 );
 
 static memory_allocator_t       gMemoryAllocator    = { 0 };
 
+// `InstructionClass` of every A64 instruction, indexed by its top byte.
+// Each PC-relative encoding is fully identified by bits 24 to 31.
+static const uint8_t            gInstructionClasses[ 256 ] =
+{
+    // `ADR`, `immlo` in bits 29 and 30
+    [ 0x10 ] = kInstructionADR,
+    [ 0x30 ] = kInstructionADR,
+    [ 0x50 ] = kInstructionADR,
+    [ 0x70 ] = kInstructionADR,
+    // `ADRP`
+    [ 0x90 ] = kInstructionADRP,
+    [ 0xB0 ] = kInstructionADRP,
+    [ 0xD0 ] = kInstructionADRP,
+    [ 0xF0 ] = kInstructionADRP,
+    // `B`, `imm26` starts in bit 24
+    [ 0x14 ] = kInstructionUnconditionalBranch,
+    [ 0x15 ] = kInstructionUnconditionalBranch,
+    [ 0x16 ] = kInstructionUnconditionalBranch,
+    [ 0x17 ] = kInstructionUnconditionalBranch,
+    // `BL`
+    [ 0x94 ] = kInstructionUnconditionalBranch,
+    [ 0x95 ] = kInstructionUnconditionalBranch,
+    [ 0x96 ] = kInstructionUnconditionalBranch,
+    [ 0x97 ] = kInstructionUnconditionalBranch,
+    // `B.cond` and `BC.cond`
+    [ 0x54 ] = kInstructionConditionalBranch,
+    // `CBZ` and `CBNZ`, 32 and 64 bit
+    [ 0x34 ] = kInstructionCompareBranch,
+    [ 0x35 ] = kInstructionCompareBranch,
+    [ 0xB4 ] = kInstructionCompareBranch,
+    [ 0xB5 ] = kInstructionCompareBranch,
+    // `TBZ` and `TBNZ`, `b5` in bit 31
+    [ 0x36 ] = kInstructionTestBranch,
+    [ 0x37 ] = kInstructionTestBranch,
+    [ 0xB6 ] = kInstructionTestBranch,
+    [ 0xB7 ] = kInstructionTestBranch,
+    // `LDR` (literal) `W`, `X`, `LDRSW` and `PRFM`
+    [ 0x18 ] = kInstructionLiteralLoad,
+    [ 0x58 ] = kInstructionLiteralLoad,
+    [ 0x98 ] = kInstructionLiteralLoad,
+    [ 0xD8 ] = kInstructionLiteralLoad,
+    // `LDR` (literal) `S`, `D` and `Q`. `0xDC` is unallocated.
+    [ 0x1C ] = kInstructionLiteralLoad,
+    [ 0x5C ] = kInstructionLiteralLoad,
+    [ 0x9C ] = kInstructionLiteralLoad,
+};
+
+// `LDR` (unsigned offset) replacing each `LDR` (literal), indexed by `opc:V`
+static const LoadStoreOp        gLiteralLoadOps[ 8 ] =
+{
+    LDR_w,      LDR_s,
+    LDR_x,      LDR_d,
+    LDRSW_x,    LDR_q,
+    PRFM,       0
+};
+
 static interceptor_tracker_t    gInterceptorTracker =
 {
     .Entry      = NULL,
@@ -170,6 +464,29 @@ static interceptor_tracker_t    gInterceptorTracker =
     .Previous   = &gInterceptorTracker
 };
 
+static interceptor_registry_t   gInterceptorRegistry = { 0 };
+
+static hook_transaction_t       gHookTransaction    = { 0 };
+
+static __thread instrumentation_shadow_stack_t gShadowStack = { 0 };
+
+// Other threads are parked while a target is written
+static bool                     gSafePatching       = false;
+
+// Removed handlers with a `CallNext` stub, linked through `Older`. Never
+// freed, a thread inside a removed hook may call its original at any time.
+static hook_handler_t*          gRetiredHandlers    = NULL;
+
+// Serialises the public API with the hooks installed after a library
+// load. Recursive, a public call may end up in another one.
+static pthread_mutex_t          gHookRegistryLock;
+static pthread_once_t           gHookRegistryLockOnce   = PTHREAD_ONCE_INIT;
+
+// Removed instrumentation, linked through `Older`. Never freed, a call
+// may return into the leave stub long after the handler is gone. The
+// next instrumentation of the same target reuses it.
+static hook_handler_t*          gRetiredInstrumentation = NULL;
+
 // -----------------------------------------------------------------------------
 //  PROTOTYPES
 // -----------------------------------------------------------------------------
@@ -188,6 +505,78 @@ BWSR_STATUS
         IN          const uint32_t              BufferSize
     );
 
+static
+BWSR_STATUS
+    INTERNAL_SetPageProtection
+    (
+        IN          memory_protect_fn_t         MemoryProtectFn,
+        IN          const uintptr_t             Page,
+        IN          const bool                  Writable
+    );
+
+static
+void
+    INTERNAL_FlushInstructionCache
+    (
+        IN          const uintptr_t             Address,
+        IN          const size_t                Size
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_HookTransaction_StagePatch
+    (
+        IN          const intercept_routing_t*  Routing,
+        IN          const uintptr_t             Page,
+        IN          const void*                 Address,
+        IN          const uint8_t*              Buffer,
+        IN          const uint32_t              BufferSize
+    );
+
+static
+void
+    INTERNAL_HookTransaction_DropPatches
+    (
+        IN          const interceptor_entry_t*  Owner
+    );
+
+static
+int
+    INTERNAL_HookTransaction_ComparePatches
+    (
+        IN          const void*                 Left,
+        IN          const void*                 Right
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_HookTransaction_ApplyPage
+    (
+        IN          const staged_patch_t*       Patches,
+        IN          const size_t                PatchCount
+    );
+
+static
+void
+    INTERNAL_HookTransaction_FlushPatches
+    (
+        void
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_HookTransaction_RollBack
+    (
+        IN          const interceptor_entry_t*  Entry
+    );
+
+static
+void
+    INTERNAL_HookTransaction_Reset
+    (
+        void
+    );
+
 static
 BWSR_STATUS
     INTERNAL_BackupOriginalCode
@@ -204,6 +593,170 @@ BWSR_STATUS
         IN          const uintptr_t             To
     );
 
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleDispatchStub
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const uintptr_t             Slot
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_Trampoline_InitializeDispatch
+    (
+        IN  OUT     intercept_routing_t*        Routing
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleContextSave
+    (
+        IN  OUT     assembler_t*                Assembler
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleContextRestore
+    (
+        IN  OUT     assembler_t*                Assembler
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleInstrumentationCall
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const instrumentation_t*    Instrumentation,
+        IN          const uintptr_t             Helper
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleInstrumentationStub
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const hook_handler_t*       Handler,
+        OUT         size_t*                     LeaveOffset
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleInstructions
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const uint32_t*             Instructions,
+        IN          const size_t                Count
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleLoadLiteral
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const int                   RegisterId,
+        IN          const uint64_t              Value
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleSlotJump
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const uintptr_t             Slot
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleStatisticsFrame
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const bool                  Save
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleStatisticsCall
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const instrumentation_t*    Instrumentation,
+        IN          const uintptr_t             Helper,
+        IN          const bool                  PassReturnAddress
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleStatisticsStub
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const hook_handler_t*       Handler,
+        OUT         size_t*                     EnterOffset,
+        OUT         size_t*                     LeaveOffset
+    );
+
+static
+void
+    INTERNAL_Instrumentation_Enter
+    (
+        IN  OUT     bwsr_cpu_context_t*         Context,
+        IN          const instrumentation_t*    Instrumentation
+    );
+
+static
+void
+    INTERNAL_Instrumentation_Leave
+    (
+        IN  OUT     bwsr_cpu_context_t*         Context,
+        IN          const instrumentation_t*    Instrumentation
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_Instrumentation_GenerateStub
+    (
+        IN  OUT     hook_handler_t*             Handler
+    );
+
+static
+hook_handler_t*
+    INTERNAL_Instrumentation_Reuse
+    (
+        IN          const uintptr_t             Target,
+        IN          const bool                  Statistics
+    );
+
+static
+uint64_t
+    INTERNAL_ReadTickFrequency
+    (
+        void
+    );
+
+static
+uintptr_t
+    INTERNAL_HookStatistics_Enter
+    (
+        IN          const instrumentation_t*    Instrumentation,
+        IN          const uintptr_t             ReturnAddress,
+        IN          const uint64_t              Ticks
+    );
+
+static
+uintptr_t
+    INTERNAL_HookStatistics_Leave
+    (
+        IN          const instrumentation_t*    Instrumentation,
+        IN          const uint64_t              Ticks
+    );
+
+static
+void
+    INTERNAL_HookStatistics_RecordLatency
+    (
+        IN  OUT     hook_statistics_t*          Statistics,
+        IN          const uint64_t              Ticks
+    );
+
 static
 uintptr_t
     INTERNAL_GetContextCursor
@@ -291,6 +844,15 @@ BWSR_STATUS
         IN  OUT     relocation_context_t*       Context
     );
 
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleRelocated
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN  OUT     relocation_context_t*       Context,
+        IN          const bool                  Branch
+    );
+
 static
 BWSR_STATUS
     INTERNAL_CodeBuilder_AssembleAndPatch
@@ -335,7 +897,8 @@ static
 BWSR_STATUS
     INTERNAL_BuildRoutingAndActivateHook
     (
-        IN  OUT     intercept_routing_t*        Routing
+        IN  OUT     intercept_routing_t*        Routing,
+        OUT         void**                      Original
     );
 
 static
@@ -359,6 +922,48 @@ void
         IN  OUT     interceptor_tracker_t*      Tracker
     );
 
+static
+size_t
+    INTERNAL_InterceptorRegistry_Hash
+    (
+        IN          const uintptr_t             Address
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_InterceptorRegistry_Resize
+    (
+        IN          const size_t                Capacity
+    );
+
+static
+size_t
+    INTERNAL_InterceptorRegistry_FindSlot
+    (
+        IN          const uintptr_t             Address
+    );
+
+static
+interceptor_tracker_t*
+    INTERNAL_InterceptorRegistry_Find
+    (
+        IN          const uintptr_t             Address
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_InterceptorRegistry_Insert
+    (
+        IN  OUT     interceptor_tracker_t*      Tracker
+    );
+
+static
+void
+    INTERNAL_InterceptorRegistry_Remove
+    (
+        IN  OUT     interceptor_tracker_t*      Tracker
+    );
+
 static
 BWSR_STATUS
     INTERNAL_InterceptorEntry_Initialize
@@ -373,15 +978,155 @@ BWSR_STATUS
         OUT         uintptr_t*                  MemoryProtectFn
     );
 
-// -----------------------------------------------------------------------------
-//  IMPLEMENTATION
-// -----------------------------------------------------------------------------
+static
+uintptr_t
+    INTERNAL_InterceptorEntry_GetDispatch
+    (
+        IN          const interceptor_entry_t*  Entry
+    );
+
+static
+void
+    INTERNAL_InterceptorEntry_PublishDispatch
+    (
+        IN  OUT     interceptor_entry_t*        Entry
+    );
 
 static
 BWSR_STATUS
-    INTERNAL_ApplyCodePatch
+    INTERNAL_SafePatch_Begin
     (
-        IN          const intercept_routing_t*  Routing,
+        OUT         thread_suspension_t*        Suspension
+    );
+
+static
+void
+    INTERNAL_SafePatch_RelocateThreads
+    (
+        IN  OUT     thread_suspension_t*        Suspension,
+        IN          const interceptor_entry_t*  Entry,
+        IN          const bool                  Restoring
+    );
+
+static
+void
+    INTERNAL_SafePatch_End
+    (
+        IN  OUT     thread_suspension_t*        Suspension
+    );
+
+static
+uintptr_t
+    INTERNAL_HookHandler_GetOriginal
+    (
+        IN          const interceptor_entry_t*  Entry,
+        IN          const hook_handler_t*       Handler
+    );
+
+static
+void
+    INTERNAL_HookHandler_PublishOriginal
+    (
+        IN          const interceptor_entry_t*  Entry,
+        IN          const hook_handler_t*       Handler,
+        OUT         void**                      Original
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_HookHandler_Add
+    (
+        IN  OUT     interceptor_entry_t*        Entry,
+        IN  OUT     hook_handler_t*             Handler,
+        OUT         void**                      Original
+    );
+
+static
+void
+    INTERNAL_HookHandler_Release
+    (
+        IN  OUT     hook_handler_t*             Handler
+    );
+
+static
+void
+    INTERNAL_HookHandler_Retire
+    (
+        IN  OUT     hook_handler_t*             Handler
+    );
+
+static
+void
+    INTERNAL_HookHandler_Remove
+    (
+        IN  OUT     interceptor_entry_t*        Entry,
+        IN  OUT     hook_handler_t*             Handler
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_InstallHookHandler
+    (
+        IN          const uintptr_t             Address,
+        IN  OUT     hook_handler_t*             Handler,
+        OUT         void**                      Original,
+        IN          CallBeforePageWrite         BeforePageWriteFn,
+        IN          CallAfterPageWrite          AfterPageWriteFn,
+        IN          const bool                  Staged,
+        IN          const bool                  SingleInstruction
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_InlineHook
+    (
+        IN          void*                       Address,
+        IN          void*                       FakeFunction,
+        IN  OUT     void**                      Original,
+        IN          void*                       BeforePageWriteFn,
+        IN          void*                       AfterPageWriteFn,
+        IN          const bool                  Staged,
+        IN          const bool                  SingleInstruction
+    );
+
+static
+void
+    INTERNAL_HookRegistry_InitializeLock
+    (
+        void
+    );
+
+static
+void
+    INTERNAL_HookRegistry_Lock
+    (
+        void
+    );
+
+static
+void
+    INTERNAL_HookRegistry_Unlock
+    (
+        void
+    );
+
+static
+BWSR_STATUS
+    INTERNAL_SetHookEnabled
+    (
+        IN          void*                       Address,
+        IN          const bool                  Enabled
+    );
+
+// -----------------------------------------------------------------------------
+//  IMPLEMENTATION
+// -----------------------------------------------------------------------------
+
+static
+BWSR_STATUS
+    INTERNAL_ApplyCodePatch
+    (
+        IN          const intercept_routing_t*  Routing,
         IN          const void*                 Address,
         IN          const uint8_t*              Buffer,
         IN          const uint32_t              BufferSize
@@ -391,7 +1136,7 @@ BWSR_STATUS
     uint32_t        pageBoundary        = 0;
     uint32_t        crossOverBoundary   = 0;
     uintptr_t       crossOverPage       = 0;
-    int             kRet                = 0;
+    uintptr_t       writable            = 0;
 
     __NOT_NULL( Routing, Address, Buffer );
     __GREATER_THAN_0( BufferSize );
@@ -429,52 +1174,63 @@ BWSR_STATUS
 
     if( 0 == pageBoundary )
     {
-        if( NULL != Routing->BeforePageWriteFn )
+        if( ( NULL != Routing->InterceptEntry          ) &&
+            ( true == Routing->InterceptEntry->Staged ) )
         {
-            Routing->BeforePageWriteFn( (uintptr_t)remapDestPage );
+            // Written out by `BWSR_CommitHookTransaction()`
+            retVal = INTERNAL_HookTransaction_StagePatch( Routing,
+                                                          (uintptr_t) remapDestPage,
+                                                          Address,
+                                                          Buffer,
+                                                          BufferSize );
         }
-
-        if( KERN_SUCCESS != ( kRet = Routing->MemoryProtectFn( MEM_PROT_TASK
-                                                               remapDestPage,
-                                                               vm_page_size,
-#if defined( __APPLE__ )
-                                                               false,
-                                                               ( VM_PROT_READ | VM_PROT_WRITE | VM_PROT_COPY ) ) ) )
-#elif defined( __ANDROID__ ) || defined( __linux__ )
-                                                               ( PROT_READ | PROT_WRITE | PROT_EXEC ) ) ) )
-#endif
+        else if( 0 != ( writable = MemoryAllocator_GetWritableAddress( &gMemoryAllocator,
+                                                                       (uintptr_t) Address ) ) )
         {
-            BWSR_DEBUG( LOG_ERROR, "Routing->VMProtect() Failed\n" );
-            retVal = ERROR_MEMORY_PERMISSION;
-        }
-        else {
-            memcpy( (void*) ( patchPage + ( (uint64_t)Address - (uint64_t)remapDestPage ) ),
+            // Dual mapped code cache page, the protection never changes
+            memcpy( (void*) writable,
                     Buffer,
                     BufferSize );
 
-            if( KERN_SUCCESS != ( kRet = Routing->MemoryProtectFn( MEM_PROT_TASK
-                                                                   remapDestPage,
-                                                                   vm_page_size,
-#if defined( __APPLE__ )
-                                                                   false,
-                                                                   ( VM_PROT_READ | VM_PROT_EXECUTE ) ) ) )
-#elif defined( __ANDROID__ ) || defined( __linux__ )
-                                                                   ( PROT_READ | PROT_EXEC ) ) ) )
-#endif
+            INTERNAL_FlushInstructionCache( (uintptr_t) Address,
+                                            BufferSize );
+
+            retVal = ERROR_SUCCESS;
+        }
+        else {
+            if( NULL != Routing->BeforePageWriteFn )
+            {
+                Routing->BeforePageWriteFn( (uintptr_t)remapDestPage );
+            }
+
+            if( ERROR_SUCCESS != ( retVal = INTERNAL_SetPageProtection( Routing->MemoryProtectFn,
+                                                                        (uintptr_t) remapDestPage,
+                                                                        true ) ) )
             {
-                BWSR_DEBUG( LOG_ERROR, "Routing->VMProtect() Failed\n" );
-                retVal = ERROR_MEMORY_PERMISSION;
+                BWSR_DEBUG( LOG_ERROR, "INTERNAL_SetPageProtection() Failed\n" );
             }
             else {
+                memcpy( (void*) ( patchPage + ( (uint64_t)Address - (uint64_t)remapDestPage ) ),
+                        Buffer,
+                        BufferSize );
+
+                INTERNAL_FlushInstructionCache( (uintptr_t) Address,
+                                                BufferSize );
 
-                if( NULL != Routing->AfterPageWriteFn )
+                if( ERROR_SUCCESS != ( retVal = INTERNAL_SetPageProtection( Routing->MemoryProtectFn,
+                                                                            (uintptr_t) remapDestPage,
+                                                                            false ) ) )
                 {
-                    Routing->AfterPageWriteFn( (uintptr_t)remapDestPage );
+                    BWSR_DEBUG( LOG_ERROR, "INTERNAL_SetPageProtection() Failed\n" );
                 }
-
-                retVal = ERROR_SUCCESS;
-            } // Routing->MemoryProtectFn()
-        } // Routing->MemoryProtectFn()
+                else {
+                    if( NULL != Routing->AfterPageWriteFn )
+                    {
+                        Routing->AfterPageWriteFn( (uintptr_t)remapDestPage );
+                    }
+                } // INTERNAL_SetPageProtection()
+            } // INTERNAL_SetPageProtection()
+        } // Staged
     } // pageBoundary
 
     return retVal;
@@ -482,438 +1238,554 @@ BWSR_STATUS
 
 static
 BWSR_STATUS
-    INTERNAL_BackupOriginalCode
+    INTERNAL_SetPageProtection
     (
-        IN  OUT     interceptor_entry_t*        Entry
+        IN          memory_protect_fn_t         MemoryProtectFn,
+        IN          const uintptr_t             Page,
+        IN          const bool                  Writable
     )
 {
     BWSR_STATUS     retVal              = ERROR_FAILURE;
-    uint8_t*        originalCode        = NULL;
-    uint32_t        trampolineSize      = 0;
+    int             kRet                = 0;
 
-    __NOT_NULL( Entry );
+#if defined( __APPLE__ )
+    vm_prot_t       protection          = ( VM_PROT_READ | VM_PROT_EXECUTE );
 
-    originalCode   = (uint8_t*) Entry->Address;
-    trampolineSize = Entry->Patched.Size;
+    if( Writable )
+    {
+        protection = ( VM_PROT_READ | VM_PROT_WRITE | VM_PROT_COPY );
+    }
 
-    if( NULL == ( Entry->OriginalCode = (uint8_t*) BwsrMalloc( trampolineSize ) ) )
+    kRet = MemoryProtectFn( MEM_PROT_TASK
+                            (vm_address_t) Page,
+                            vm_page_size,
+                            false,
+                            protection );
+#elif defined( __ANDROID__ ) || defined( __linux__ )
+    int             protection          = ( PROT_READ | PROT_EXEC );
+
+    if( Writable )
     {
-        BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
-        retVal = ERROR_MEM_ALLOC;
+        protection = ( PROT_READ | PROT_WRITE | PROT_EXEC );
     }
-    else {
-        memcpy( Entry->OriginalCode,
-                originalCode,
-                trampolineSize );
 
+    kRet = MemoryProtectFn( MEM_PROT_TASK
+                            (void*) Page,
+                            (size_t) sysconf( _SC_PAGESIZE ),
+                            protection );
+#endif
+
+    if( KERN_SUCCESS != kRet )
+    {
+        BWSR_DEBUG( LOG_ERROR, "MemoryProtectFn() Failed\n" );
+        retVal = ERROR_MEMORY_PERMISSION;
+    }
+    else {
         retVal = ERROR_SUCCESS;
-    } // BwsrMalloc()
+    } // MemoryProtectFn()
 
     return retVal;
 }
 
+static
+void
+    INTERNAL_FlushInstructionCache
+    (
+        IN          const uintptr_t             Address,
+        IN          const size_t                Size
+    )
+{
+    // Cleans the D-cache to the point of unification and
+    // invalidates the I-cache over the range on every core
+#if defined( __APPLE__ )
+    sys_icache_invalidate( (void*) Address, Size );
+#else
+    __builtin___clear_cache( (char*) Address, (char*) ( Address + Size ) );
+#endif
+}
+
 static
 BWSR_STATUS
-    INTERNAL_Trampoline_Initialize
+    INTERNAL_HookTransaction_StagePatch
     (
-        IN  OUT     trampoline_t**              Trampoline,
-        IN          const uintptr_t             From,
-        IN          const uintptr_t             To
+        IN          const intercept_routing_t*  Routing,
+        IN          const uintptr_t             Page,
+        IN          const void*                 Address,
+        IN          const uint8_t*              Buffer,
+        IN          const uint32_t              BufferSize
     )
 {
-    BWSR_STATUS     retVal          = ERROR_FAILURE;
-    assembler_t     assembler       = { 0 };
-    uint64_t        distance        = 0;
-    uint64_t        adrpRange       = 0;
-    uint8_t*        buffer          = NULL;
-    uint32_t        value           = 0;
+    BWSR_STATUS     retVal              = ERROR_FAILURE;
+    staged_patch_t* patches             = NULL;
+    staged_patch_t* patch               = NULL;
+    size_t          capacity            = 0;
+    uint8_t*        buffer              = NULL;
 
-    __NOT_NULL( Trampoline )
-    __GREATER_THAN_0( From, To )
+    __NOT_NULL( Routing, Address, Buffer );
+    __GREATER_THAN_0( BufferSize );
+
+    retVal = ERROR_SUCCESS;
 
-    if( ERROR_SUCCESS != ( retVal = Assembler_Initialize( &assembler, From ) ) )
+    if( gHookTransaction.PatchCount == gHookTransaction.PatchCapacity )
     {
-        BWSR_DEBUG( LOG_ERROR, "Assembler_Initialize() Failed\n" );
-    }
-    else {
-        distance    = llabs( (int64_t) ( From - To ) );
-        adrpRange   = ( UINT32_MAX - 1 );
+        capacity = ( 0 == gHookTransaction.PatchCapacity )
+                    ? 16
+                    : ( gHookTransaction.PatchCapacity * 2 );
 
-        if( distance < adrpRange )
+        if( NULL == gHookTransaction.Patches )
         {
-            if( ERROR_SUCCESS != ( retVal = Assembler_ADRP_ADD( &assembler.Buffer,
-                                                                (register_data_t*) &TMP_REG_0,
-                                                                From,
-                                                                To ) ) )
-            {
-                BWSR_DEBUG( LOG_ERROR, "Assembler_ADRP_ADD() Failed\n" );
-            }
-            else {
-                value  = ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
-                retVal = Assembler_Write32BitInstruction( &assembler.Buffer, value );
-            } // Assembler_ADRP_ADD()
+            patches = (staged_patch_t*) BwsrMalloc( capacity * sizeof( staged_patch_t ) );
         }
         else {
-            retVal = Assembler_LiteralLdrBranch( &assembler, (uint64_t)To );
-        } // distance < adrp_range
+            patches = (staged_patch_t*) BwsrRealloc( gHookTransaction.Patches,
+                                                     capacity * sizeof( staged_patch_t ) );
+        } // gHookTransaction.Patches
 
-        if( ERROR_SUCCESS == retVal )
+        if( NULL == patches )
         {
-            if( ERROR_SUCCESS != ( retVal = Assembler_WriteRelocationDataToPageBuffer( &assembler ) ) )
-            {
-                BWSR_DEBUG( LOG_ERROR, "Assembler_WriteRelocationDataToPageBuffer() Failed\n" );
-            }
-            else {
-                if( NULL == ( buffer = (uint8_t*) BwsrMalloc( assembler.Buffer.BufferSize ) ) )
-                {
-                    BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
-                    retVal = ERROR_MEM_ALLOC;
-                }
-                else {
-                    memcpy( buffer,
-                            assembler.Buffer.Buffer,
-                            assembler.Buffer.BufferSize );
-
-                    if( NULL == ( *Trampoline = (trampoline_t*) BwsrMalloc( sizeof( trampoline_t ) ) ) )
-                    {
-                        BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
-                        BwsrFree( buffer );
-                        retVal = ERROR_MEM_ALLOC;
-                    }
-                    else {
-                        ( *Trampoline )->Buffer.Start = (uintptr_t)buffer;
-                        ( *Trampoline )->Buffer.Size  = assembler.Buffer.BufferSize;
-                    } // BwsrMalloc()
-                } // BwsrMalloc()
-            } // Assembler_WriteRelocationDataToPageBuffer()
-        } // SUCCESS
+            BWSR_DEBUG( LOG_ERROR, "Staged patch allocation Failed\n" );
+            retVal = ERROR_MEM_ALLOC;
+        }
+        else {
+            gHookTransaction.Patches        = patches;
+            gHookTransaction.PatchCapacity  = capacity;
+        } // BwsrRealloc()
+    } // PatchCapacity
 
-        (void) Assembler_Release( &assembler );
-    } // Assembler_Initialize()
+    if( ERROR_SUCCESS != retVal )
+    {
+        // Must exit at this point.
+    }
+    // The source buffer may be released before commit
+    else if( NULL == ( buffer = (uint8_t*) BwsrMalloc( BufferSize ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        memcpy( buffer, Buffer, BufferSize );
+
+        patch = &gHookTransaction.Patches[ gHookTransaction.PatchCount++ ];
+
+        patch->Owner                = Routing->InterceptEntry;
+        patch->Sequence             = gHookTransaction.Sequence++;
+        patch->Page                 = Page;
+        patch->Address              = (uintptr_t) Address;
+        patch->Buffer               = buffer;
+        patch->BufferSize           = BufferSize;
+        patch->MemoryProtectFn      = Routing->MemoryProtectFn;
+        patch->BeforePageWriteFn    = Routing->BeforePageWriteFn;
+        patch->AfterPageWriteFn     = Routing->AfterPageWriteFn;
+    } // BwsrMalloc()
 
     return retVal;
 }
 
 static
-uintptr_t
-    INTERNAL_GetContextCursor
+void
+    INTERNAL_HookTransaction_DropPatches
     (
-        IN          const relocation_context_t* Context
+        IN          const interceptor_entry_t*  Owner
     )
 {
-    return (uintptr_t)( Context->BaseAddress->Start + ( Context->Cursor - Context->BaseAddress->Start ) );
+    size_t          ndx                 = 0;
+    size_t          kept                = 0;
+
+    __NOT_NULL_RETURN_VOID( Owner );
+
+    for( ndx = 0; ndx < gHookTransaction.PatchCount; ndx++ )
+    {
+        if( gHookTransaction.Patches[ ndx ].Owner == Owner )
+        {
+            BwsrFree( gHookTransaction.Patches[ ndx ].Buffer );
+        }
+        else {
+            gHookTransaction.Patches[ kept++ ] = gHookTransaction.Patches[ ndx ];
+        } // Owner
+    } // for()
+
+    gHookTransaction.PatchCount = kept;
 }
 
 static
-BWSR_STATUS
-    INTERNAL_CodeBuilder_ApplyAssemblerPagePatch
+int
+    INTERNAL_HookTransaction_ComparePatches
     (
-        IN          const intercept_routing_t*  Routing,
-        IN  OUT     assembler_t*                Assembler,
-        OUT         memory_range_t*             MemoryRange
+        IN          const void*                 Left,
+        IN          const void*                 Right
     )
 {
-    BWSR_STATUS         retVal      = ERROR_FAILURE;
-    memory_range_t*     block       = NULL;
-
-    __NOT_NULL( Routing,
-                Assembler,
-                MemoryRange )
+    const staged_patch_t*   left        = (const staged_patch_t*) Left;
+    const staged_patch_t*   right       = (const staged_patch_t*) Right;
 
-    if( Assembler->FixedAddress )
+    if( left->Page != right->Page )
     {
-        retVal = ERROR_SUCCESS;
+        return ( left->Page < right->Page ) ? -1 : 1;
     }
-    else {
-        if( ERROR_SUCCESS != ( retVal = MemoryAllocator_AllocateExecutionBlock( &block,
-                                                                                &gMemoryAllocator,
-                                                                                Assembler->Buffer.BufferSize ) ) )
-        {
-            BWSR_DEBUG( LOG_ERROR, "MemoryAllocator_AllocateExecutionBlock() Failed\n" );
-        }
-        else {
-            Assembler->FixedMemoryRange = (uintptr_t)block;
-            Assembler->FixedAddress     = block->Start;
-        } // MemoryAllocator_AllocateExecutionBlock()
-    } // fixed_addr
 
-    if( ERROR_SUCCESS == retVal )
+    if( left->Sequence != right->Sequence )
     {
-        BWSR_DEBUG( LOG_NOTICE, "Patching hooked function call into function address...\n" );
-
-        if( ERROR_SUCCESS != ( retVal = INTERNAL_ApplyCodePatch( Routing,
-                                                                 (void*) Assembler->FixedAddress,
-                                                                 Assembler->Buffer.Buffer,
-                                                                 Assembler->Buffer.BufferSize ) ) )
-        {
-            BWSR_DEBUG( LOG_ERROR, "INTERNAL_ApplyCodePatch() Failed\n" );
-        }
-        else {
-            MemoryRange->Start = Assembler->FixedAddress;
-            MemoryRange->Size  = Assembler->Buffer.BufferSize;
-        } // INTERNAL_ApplyCodePatch()
+        return ( left->Sequence < right->Sequence ) ? -1 : 1;
     }
 
-    return retVal;
+    return 0;
 }
 
 static
 BWSR_STATUS
-    INTERNAL_WriteToBuffer_UnconditionalBranchFixed
+    INTERNAL_HookTransaction_ApplyPage
     (
-        IN          const relocation_context_t* Context,
-        IN  OUT     assembler_t*                Assembler,
-        IN          const uint32_t              Instruction
+        IN          const staged_patch_t*       Patches,
+        IN          const size_t                PatchCount
     )
 {
-    BWSR_STATUS             retVal              = ERROR_FAILURE;
-    uintptr_t               cursorOffset        = 0;
-    relocation_data_t*      relocationData      = NULL;
-    uint32_t                value               = 0;
+    BWSR_STATUS     retVal              = ERROR_FAILURE;
+    const uintptr_t page                = Patches->Page;
+    uintptr_t       writable            = 0;
+    size_t          ndx                 = 0;
+    size_t          prior               = 0;
 
-    __NOT_NULL( Context, Assembler )
-    __GREATER_THAN_0( Instruction )
+    __NOT_NULL( Patches );
+    __GREATER_THAN_0( PatchCount );
 
-    cursorOffset = INTERNAL_GetContextCursor( Context ) + Imm26Offset( Instruction );
+    if( 0 != ( writable = MemoryAllocator_GetWritableAddress( &gMemoryAllocator, page ) ) )
+    {
+        // Dual mapped code cache page, the protection never changes
+        for( ndx = 0; ndx < PatchCount; ndx++ )
+        {
+            memcpy( (void*) ( writable + ( Patches[ ndx ].Address - page ) ),
+                    Patches[ ndx ].Buffer,
+                    Patches[ ndx ].BufferSize );
+        } // for()
 
-    if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &relocationData,
-                                                                    Assembler,
-                                                                    cursorOffset ) ) )
+        return ERROR_SUCCESS;
+    } // MemoryAllocator_GetWritableAddress()
+
+    // Each distinct callback sees the page once
+    for( ndx = 0; ndx < PatchCount; ndx++ )
     {
-        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+        if( NULL != Patches[ ndx ].BeforePageWriteFn )
+        {
+            for( prior = 0; prior < ndx; prior++ )
+            {
+                if( Patches[ prior ].BeforePageWriteFn == Patches[ ndx ].BeforePageWriteFn )
+                {
+                    break;
+                }
+            } // for()
+
+            if( prior == ndx )
+            {
+                Patches[ ndx ].BeforePageWriteFn( page );
+            }
+        } // BeforePageWriteFn
+    } // for()
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_SetPageProtection( Patches->MemoryProtectFn,
+                                                                page,
+                                                                true ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_SetPageProtection() Failed\n" );
     }
     else {
-        if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
-                                                                        (register_data_t*) &TMP_REG_0,
-                                                                        relocationData ) ) )
+        for( ndx = 0; ndx < PatchCount; ndx++ )
         {
-            BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+            memcpy( (void*) Patches[ ndx ].Address,
+                    Patches[ ndx ].Buffer,
+                    Patches[ ndx ].BufferSize );
+        } // for()
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_SetPageProtection( Patches->MemoryProtectFn,
+                                                                    page,
+                                                                    false ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_SetPageProtection() Failed\n" );
         }
         else {
-            if( BL == ( Instruction & UnconditionalBranchMask ) )
+            for( ndx = 0; ndx < PatchCount; ndx++ )
             {
-                value = ( BLR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
-            }
-            else {
-                value = ( BR  | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
-            } // BLR or BL
+                if( NULL != Patches[ ndx ].AfterPageWriteFn )
+                {
+                    for( prior = 0; prior < ndx; prior++ )
+                    {
+                        if( Patches[ prior ].AfterPageWriteFn == Patches[ ndx ].AfterPageWriteFn )
+                        {
+                            break;
+                        }
+                    } // for()
 
-            retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, value );
-        } // Assembler_WriteInstruction_LDR()
-    } // Assembler_CreateRelocationData()
+                    if( prior == ndx )
+                    {
+                        Patches[ ndx ].AfterPageWriteFn( page );
+                    }
+                } // AfterPageWriteFn
+            } // for()
+        } // INTERNAL_SetPageProtection()
+    } // INTERNAL_SetPageProtection()
 
     return retVal;
 }
 
 static
-BWSR_STATUS
-    INTERNAL_WriteToBuffer_LiteralLoadRegisterFixed
+void
+    INTERNAL_HookTransaction_FlushPatches
     (
-        IN          const relocation_context_t* Context,
-        IN  OUT     assembler_t*                Assembler,
-        IN          const uint32_t              Instruction
+        void
     )
 {
-    BWSR_STATUS     retVal          = ERROR_FAILURE;
-    uintptr_t       cursorOffset    = 0;
-    char            opc             = 0;
-    int             rt              = 0;
-
-    __NOT_NULL( Context, Assembler )
-    __GREATER_THAN_0( Instruction )
-
-    cursorOffset = INTERNAL_GetContextCursor( Context ) + Imm19Offset( Instruction );
-    rt  = GET_BITS( Instruction, 0,  4  );
-    opc = GET_BITS( Instruction, 30, 31 );
-
-    if( ERROR_SUCCESS != ( retVal = Assembler_MOV( &Assembler->Buffer,
-                                                   (register_data_t*) &TMP_REG_0,
-                                                   cursorOffset ) ) )
+    const staged_patch_t*   patch       = NULL;
+    uintptr_t               start       = 0;
+    uintptr_t               end         = 0;
+    size_t                  ndx         = 0;
+
+    // Contiguous patches, e.g. a relocated block split
+    // across pages, are flushed as a single range
+    for( ndx = 0; ndx < gHookTransaction.PatchCount; ndx++ )
     {
-        BWSR_DEBUG( LOG_ERROR, "Assembler_MOV() Failed\n" );
-    }
-    else {
-        /**/ if( 0b00 == opc )
+        patch = &gHookTransaction.Patches[ ndx ];
+
+        if( ( start < end ) && ( patch->Address != end ) )
         {
-            retVal = Assembler_LoadStore( &Assembler->Buffer,
-                                          LDR_x,
-                                          &W( rt ),
-                                          &MEMOP_ADDR( AddrModeOffset ) );
-        }
-        else if( 0b01 == opc )
+            INTERNAL_FlushInstructionCache( start, end - start );
+            start = end;
+        } // Disjoint
+
+        if( start == end )
         {
-            retVal = Assembler_LoadStore( &Assembler->Buffer,
-                                          LDR_x,
-                                          &X( rt ),
-                                          &MEMOP_ADDR( AddrModeOffset ) );
+            start = patch->Address;
         }
-        else {
-            BWSR_DEBUG( LOG_WARNING,
-                        "Unexpected opcode: %c\n",
-                        opc );
-            retVal = ERROR_UNIMPLEMENTED;
-        } // opcode
-    } // Assembler_MOV()
 
-    return retVal;
+        end = patch->Address + patch->BufferSize;
+    } // for()
+
+    if( start < end )
+    {
+        INTERNAL_FlushInstructionCache( start, end - start );
+    }
 }
 
 static
 BWSR_STATUS
-    INTERNAL_WriteToBuffer_PCRelAddressingFixed_ADR
+    INTERNAL_HookTransaction_RollBack
     (
-        IN          const relocation_context_t* Context,
-        OUT         assembler_t*                Assembler,
-        IN          const uint32_t              Instruction
+        IN          const interceptor_entry_t*  Entry
     )
 {
-    BWSR_STATUS     retVal          = ERROR_FAILURE;
-    uintptr_t       cursorOffset    = 0;
-    int             rd              = 0;
+    intercept_routing_t     routing     = { 0 };
 
-    __NOT_NULL( Context, Assembler )
-    __GREATER_THAN_0( Instruction )
+    __NOT_NULL( Entry, Entry->Routing, Entry->OriginalCode );
 
-    cursorOffset = INTERNAL_GetContextCursor( Context ) + ImmHiImmLoOffset( Instruction );
-    rd = GET_BITS( Instruction, 0, 4 );
+    // Part of the patch may sit on a page that was written. A
+    // routing without an entry is written right away, not staged.
+    routing                 = *Entry->Routing;
+    routing.InterceptEntry  = NULL;
+
+    return INTERNAL_ApplyCodePatch( &routing,
+                                    (void*) Entry->Patched.Start,
+                                    Entry->OriginalCode,
+                                    Entry->Patched.Size );
+}
+
+static
+void
+    INTERNAL_HookTransaction_Reset
+    (
+        void
+    )
+{
+    interceptor_tracker_t*  tracker     = gInterceptorTracker.Next;
+    size_t                  ndx         = 0;
+
+    for( ndx = 0; ndx < gHookTransaction.PatchCount; ndx++ )
+    {
+        BwsrFree( gHookTransaction.Patches[ ndx ].Buffer );
+    } // for()
 
-    retVal = Assembler_MOV( &Assembler->Buffer,
-                            &X( rd ),
-                            cursorOffset );
+    BwsrFree( gHookTransaction.Patches );
 
-    return retVal;
+    while( tracker != &gInterceptorTracker )
+    {
+        if( NULL != tracker->Entry )
+        {
+            tracker->Entry->Staged = false;
+        }
+
+        tracker = tracker->Next;
+    } // while()
+
+    gHookTransaction.Patches        = NULL;
+    gHookTransaction.PatchCount     = 0;
+    gHookTransaction.PatchCapacity  = 0;
+    gHookTransaction.Sequence       = 0;
+    gHookTransaction.Active         = false;
 }
 
 static
 BWSR_STATUS
-    INTERNAL_WriteToBuffer_PCRelAddressingFixed_ADRP
+    INTERNAL_BackupOriginalCode
     (
-        IN          const relocation_context_t* Context,
-        OUT         assembler_t*                Assembler,
-        IN          const uint32_t              Instruction
+        IN  OUT     interceptor_entry_t*        Entry
     )
 {
-    BWSR_STATUS     retVal          = ERROR_FAILURE;
-    uintptr_t       cursorOffset    = 0;
-    int             rd              = 0;
+    BWSR_STATUS     retVal              = ERROR_FAILURE;
+    uint8_t*        originalCode        = NULL;
+    uint32_t        trampolineSize      = 0;
 
-    __NOT_NULL( Context, Assembler )
-    __GREATER_THAN_0( Instruction )
+    __NOT_NULL( Entry );
 
-    cursorOffset = INTERNAL_GetContextCursor( Context ) + ImmHiImmLoZero12Offset( Instruction );
-    cursorOffset = arm64_trunc_page( cursorOffset );
-    rd = GET_BITS( Instruction, 0, 4 );
+    originalCode   = (uint8_t*) Entry->Address;
+    trampolineSize = Entry->Patched.Size;
+
+    if( NULL == ( Entry->OriginalCode = (uint8_t*) BwsrMalloc( trampolineSize ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        memcpy( Entry->OriginalCode,
+                originalCode,
+                trampolineSize );
 
-    retVal = Assembler_MOV( &Assembler->Buffer,
-                            &X( rd ),
-                            cursorOffset );
+        retVal = ERROR_SUCCESS;
+    } // BwsrMalloc()
 
     return retVal;
 }
 
 static
 BWSR_STATUS
-    INTERNAL_WriteToBuffer_ConditionalBranchFixed
+    INTERNAL_Trampoline_Initialize
     (
-        IN          const relocation_context_t* Context,
-        IN  OUT     assembler_t*                Assembler,
-        IN          const uint32_t              Instruction
+        IN  OUT     trampoline_t**              Trampoline,
+        IN          const uintptr_t             From,
+        IN          const uintptr_t             To
     )
 {
-    BWSR_STATUS             retVal              = ERROR_FAILURE;
-    uintptr_t               cursorOffset        = 0;
-    uint32_t                instruction         = 0;
-    char                    bitSetPos           = 0;
-    relocation_data_t*      relocationData      = NULL;
-    uint32_t                value               = 0;
-
-    __NOT_NULL( Context, Assembler )
-    __GREATER_THAN_0( Instruction )
-
-    cursorOffset    = INTERNAL_GetContextCursor( Context ) + Imm19Offset( Instruction );
-    instruction     = Instruction;
-    bitSetPos       = GET_BITS( Instruction, 0, 3 ) ^ 1;
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    assembler_t         assembler       = { 0 };
+    assembler_arena_t   arena;
+    uint64_t            distance        = 0;
+    uint64_t            adrpRange       = 0;
+    uint8_t*            buffer          = NULL;
+    uint32_t            value           = 0;
 
-    SET_BITS( instruction, 0, 3, bitSetPos );
-    SET_BITS( instruction, 5, 23, 3 );
+    __NOT_NULL( Trampoline )
+    __GREATER_THAN_0( From, To )
 
-    if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &relocationData,
-                                                                    Assembler,
-                                                                    cursorOffset ) ) )
+    if( ERROR_SUCCESS != ( retVal = Assembler_InitializeWithArena( &assembler, From, &arena ) ) )
     {
-        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+        BWSR_DEBUG( LOG_ERROR, "Assembler_InitializeWithArena() Failed\n" );
     }
     else {
-        if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, instruction ) ) )
+        distance    = llabs( (int64_t) ( From - To ) );
+        adrpRange   = ( UINT32_MAX - 1 );
+
+        if( distance < adrpRange )
         {
-            BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+            if( ERROR_SUCCESS != ( retVal = Assembler_ADRP_ADD( &assembler.Buffer,
+                                                                (register_data_t*) &TMP_REG_0,
+                                                                From,
+                                                                To ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "Assembler_ADRP_ADD() Failed\n" );
+            }
+            else {
+                value  = ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
+                retVal = Assembler_Write32BitInstruction( &assembler.Buffer, value );
+            } // Assembler_ADRP_ADD()
         }
         else {
-            if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
-                                                                            (register_data_t*) &TMP_REG_0,
-                                                                            relocationData ) ) )
+            retVal = Assembler_LiteralLdrBranch( &assembler, (uint64_t)To );
+        } // distance < adrp_range
+
+        if( ERROR_SUCCESS == retVal )
+        {
+            if( ERROR_SUCCESS != ( retVal = Assembler_WriteRelocationDataToPageBuffer( &assembler ) ) )
             {
-                BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+                BWSR_DEBUG( LOG_ERROR, "Assembler_WriteRelocationDataToPageBuffer() Failed\n" );
             }
             else {
-                value  = ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
-                retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, value );
-            } // Assembler_WriteInstruction_LDR()
-        } // Assembler_Write32BitInstruction()
-    } // Assembler_CreateRelocationData()
+                if( NULL == ( buffer = (uint8_t*) BwsrMalloc( assembler.Buffer.BufferSize ) ) )
+                {
+                    BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+                    retVal = ERROR_MEM_ALLOC;
+                }
+                else {
+                    memcpy( buffer,
+                            assembler.Buffer.Buffer,
+                            assembler.Buffer.BufferSize );
+
+                    if( NULL == ( *Trampoline = (trampoline_t*) BwsrMalloc( sizeof( trampoline_t ) ) ) )
+                    {
+                        BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+                        BwsrFree( buffer );
+                        retVal = ERROR_MEM_ALLOC;
+                    }
+                    else {
+                        ( *Trampoline )->Buffer.Start = (uintptr_t)buffer;
+                        ( *Trampoline )->Buffer.Size  = assembler.Buffer.BufferSize;
+                        ( *Trampoline )->Dispatch.Start = 0;
+                        ( *Trampoline )->Dispatch.Size  = 0;
+                    } // BwsrMalloc()
+                } // BwsrMalloc()
+            } // Assembler_WriteRelocationDataToPageBuffer()
+        } // SUCCESS
+
+        (void) Assembler_Release( &assembler );
+    } // Assembler_InitializeWithArena()
 
     return retVal;
 }
 
 static
 BWSR_STATUS
-    INTERNAL_WriteToBuffer_CompareBranchFixed
+    INTERNAL_CodeBuilder_AssembleDispatchStub
     (
-        IN          const relocation_context_t* Context,
         IN  OUT     assembler_t*                Assembler,
-        IN          const uint32_t              Instruction
+        IN          const uintptr_t             Slot
     )
 {
-    BWSR_STATUS             retVal              = ERROR_FAILURE;
-    uintptr_t               cursorOffset        = 0;
-    uint32_t                instruction         = 0;
-    char                    op                  = 0;
-    relocation_data_t*      relocationData      = NULL;
-    uint32_t                value               = 0;
-
-    __NOT_NULL( Context, Assembler )
-    __GREATER_THAN_0( Instruction )
-
-    cursorOffset    = INTERNAL_GetContextCursor( Context ) + Imm19Offset( Instruction );
-    instruction     = Instruction;
-    op              = GET_BIT( Instruction, 24 ) ^ 1;
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    relocation_data_t*  relocationData  = NULL;
 
-    SET_BIT( instruction, 24, op );
-    SET_BITS( instruction, 5, 23, 3 );
+    __NOT_NULL( Assembler );
+    __GREATER_THAN_0( Slot );
 
+    // ldr x17, =Slot
+    // ldr x17, [x17]
+    // br  x17
+    // nop, keeps the literal 8 byte aligned
     if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &relocationData,
                                                                     Assembler,
-                                                                    cursorOffset ) ) )
+                                                                    (uint64_t) Slot ) ) )
     {
         BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
     }
-    else {
-        if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, instruction ) ) )
-        {
-            BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
-        }
-        else {
-            if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
-                                                                            (register_data_t*) &TMP_REG_0,
-                                                                            relocationData ) ) )
-            {
-                BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
-            }
-            else {
-                value  = ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
-                retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, value );
-            } // Assembler_WriteInstruction_LDR()
-        } // Assembler_Write32BitInstruction()
+    else if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
+                                                                         (register_data_t*) &TMP_REG_0,
+                                                                         relocationData ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_LoadStore( &Assembler->Buffer,
+                                                              LDR_x,
+                                                              &TMP_REG_0,
+                                                              &MEMOP_ADDR( AddrModeOffset ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStore() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                          ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                          ARM64_NOP ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+    }
+    else {
+        retVal = Assembler_WriteRelocationDataToPageBuffer( Assembler );
     } // Assembler_CreateRelocationData()
 
     return retVal;
@@ -921,581 +1793,3799 @@ BWSR_STATUS
 
 static
 BWSR_STATUS
-    INTERNAL_WriteToBuffer_TestBranchFixed
+    INTERNAL_Trampoline_InitializeDispatch
     (
-        IN          const relocation_context_t* Context,
-        IN  OUT     assembler_t*                Assembler,
-        IN          const uint32_t              Instruction
+        IN  OUT     intercept_routing_t*        Routing
     )
 {
-    BWSR_STATUS             retVal              = ERROR_FAILURE;
-    uintptr_t               cursorOffset        = 0;
-    uint32_t                instruction         = 0;
-    char                    op                  = 0;
-    relocation_data_t*      relocationData      = NULL;
-    uint32_t                value               = 0;
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    assembler_t         assembler       = { 0 };
+    assembler_arena_t   arena;
+    memory_range_t*     block           = NULL;
+    memory_range_t      dispatch        = { 0 };
+    uintptr_t           from            = 0;
+    uint32_t*           buffer          = NULL;
+    bool                near            = false;
 
-    __NOT_NULL( Context, Assembler );
-    __GREATER_THAN_0( Instruction );
+    __NOT_NULL( Routing );
 
-    cursorOffset    = INTERNAL_GetContextCursor( Context ) + Imm14Offset( Instruction );
-    instruction     = Instruction;
-    op              = GET_BIT( Instruction, 24 ) ^ 1;
+    from = Routing->InterceptEntry->Address;
 
-    SET_BIT( instruction, 24, op );
-    SET_BITS( instruction, 5, 18, 3 );
+    if( ERROR_SUCCESS != ( retVal = Assembler_InitializeWithArena( &assembler, 0, &arena ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_InitializeWithArena() Failed\n" );
+        return retVal;
+    }
 
-    if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &relocationData,
-                                                                    Assembler,
-                                                                    cursorOffset ) ) )
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleDispatchStub( &assembler,
+                                                                               (uintptr_t) &Routing->InterceptEntry->Dispatch ) ) )
     {
-        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleDispatchStub() Failed\n" );
     }
     else {
-        if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, instruction ) ) )
+        // Next to the target a single `B` reaches the stub,
+        // anywhere else it takes the long trampoline
+        if( ( 0 == ( from & 3 ) ) &&
+            ( ERROR_SUCCESS == MemoryAllocator_AllocateNearExecutionBlock( &block,
+                                                                           &gMemoryAllocator,
+                                                                           assembler.Buffer.BufferSize,
+                                                                           from,
+                                                                           ARM64_B_RANGE - sizeof( uint32_t ) ) ) )
         {
-            BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+            assembler.FixedMemoryRange  = (uintptr_t) block;
+            assembler.FixedAddress      = block->Start;
+            near                        = true;
         }
         else {
-            if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
-                                                                            (register_data_t*) &TMP_REG_0,
-                                                                            relocationData ) ) )
-            {
-                BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
-            }
-            else {
-                value  = ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
-                retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, value );
-            } // Assembler_WriteInstruction_LDR()
-        } // Assembler_Write32BitInstruction()
-    } // Assembler_CreateRelocationData()
-
-    return retVal;
-}
-
-static
-BWSR_STATUS
-    INTERNAL_CodeBuilder_AssembleBuffer
-    (
-        IN  OUT     assembler_t*                Assembler,
-        IN  OUT     relocation_context_t*       Context
-    )
-{
-    BWSR_STATUS     retVal          = ERROR_SUCCESS;
-    uint32_t        instruction     = 0;
-
-    __NOT_NULL( Assembler, Context );
-
-    while( ( ( Context->Cursor - Context->BaseAddress->Start ) < Context->BaseAddress->Size ) &&
-           ( ERROR_SUCCESS == retVal ) )
-    {
-        instruction = *(uint32_t *)INTERNAL_GetContextCursor( Context );
+            BWSR_DEBUG( LOG_NOTICE, "No near block, using the long trampoline\n" );
+        } // MemoryAllocator_AllocateNearExecutionBlock()
 
-        if( UnconditionalBranchFixed == ( instruction & UnconditionalBranchFixedMask ) )
-        {
-            retVal = INTERNAL_WriteToBuffer_UnconditionalBranchFixed( Context,
-                                                                      Assembler,
-                                                                      instruction );
-        }
-        else if( LiteralLoadRegisterFixed == ( instruction & LiteralLoadRegisterFixedMask ) )
-        {
-            retVal = INTERNAL_WriteToBuffer_LiteralLoadRegisterFixed( Context,
-                                                                      Assembler,
-                                                                      instruction );
-        }
-        else if( ( PCRelAddressingFixed == ( instruction & PCRelAddressingFixedMask ) ) &&
-                 ( ADR                  == ( instruction & PCRelAddressingMask      ) ) )
+        if( ( false == near                                         ) &&
+            ( true  == Routing->InterceptEntry->SingleInstruction   ) )
         {
-            retVal = INTERNAL_WriteToBuffer_PCRelAddressingFixed_ADR( Context,
-                                                                      Assembler,
-                                                                      instruction );
+            // The long trampoline would run past the end of the target
+            BWSR_DEBUG( LOG_ERROR, "No near block for a single instruction target\n" );
+            retVal = ERROR_SYMBOL_SIZE;
         }
-        else if( ( PCRelAddressingFixed == ( instruction & PCRelAddressingFixedMask ) ) &&
-                 ( ADRP                 == ( instruction & PCRelAddressingMask      ) ) )
+        else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_ApplyAssemblerPagePatch( Routing,
+                                                                                       &assembler,
+                                                                                       &dispatch ) ) )
         {
-            retVal = INTERNAL_WriteToBuffer_PCRelAddressingFixed_ADRP( Context,
-                                                                       Assembler,
-                                                                       instruction );
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_ApplyAssemblerPagePatch() Failed\n" );
         }
-        else if( ConditionalBranchFixed == ( instruction & ConditionalBranchFixedMask ) )
+        else if( false == near )
         {
-            retVal = INTERNAL_WriteToBuffer_ConditionalBranchFixed( Context,
-                                                                    Assembler,
-                                                                    instruction );
+            if( ERROR_SUCCESS != ( retVal = INTERNAL_Trampoline_Initialize( &Routing->Trampoline,
+                                                                            from,
+                                                                            dispatch.Start ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "INTERNAL_Trampoline_Initialize() Failed\n" );
+            }
+            else {
+                Routing->Trampoline->Dispatch = dispatch;
+            } // INTERNAL_Trampoline_Initialize()
         }
-        else if( CompareBranchFixed == ( instruction & CompareBranchFixedMask ) )
+        else if( NULL == ( buffer = (uint32_t*) BwsrMalloc( sizeof( uint32_t ) ) ) )
         {
-            retVal = INTERNAL_WriteToBuffer_CompareBranchFixed( Context,
-                                                                Assembler,
-                                                                instruction );
+            BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+            retVal = ERROR_MEM_ALLOC;
         }
-        else if( TestBranchFixed == ( instruction & TestBranchFixedMask ) )
+        else if( NULL == ( Routing->Trampoline = (trampoline_t*) BwsrMalloc( sizeof( trampoline_t ) ) ) )
         {
-            retVal = INTERNAL_WriteToBuffer_TestBranchFixed( Context,
-                                                             Assembler,
-                                                             instruction );
+            BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+            BwsrFree( buffer );
+            retVal = ERROR_MEM_ALLOC;
         }
         else {
-            retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, instruction );
+            // Only one instruction of the target gets relocated
+            *buffer = (uint32_t)( B | ( ( (uint64_t)( dispatch.Start - from ) >> 2 ) & 0x03FFFFFF ) );
+
+            Routing->Trampoline->Buffer.Start   = (uintptr_t) buffer;
+            Routing->Trampoline->Buffer.Size    = sizeof( uint32_t );
+            Routing->Trampoline->Dispatch       = dispatch;
+        } // near
+
+        if( ( ERROR_SUCCESS != retVal  ) &&
+            ( 0             != dispatch.Start ) )
+        {
+            (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator, &dispatch );
         }
+    } // INTERNAL_CodeBuilder_AssembleDispatchStub()
 
-        Context->Cursor += sizeof( uint32_t );
-    } // while()
+    (void) Assembler_Release( &assembler );
 
     return retVal;
 }
 
 static
 BWSR_STATUS
-    INTERNAL_CodeBuilder_AssembleAndPatch
+    INTERNAL_CodeBuilder_AssembleContextSave
     (
-        IN          const intercept_routing_t*  Routing,
-        IN  OUT     memory_range_t*             BaseAddress,
-        OUT         memory_range_t*             Relocated,
-        IN          const bool                  Branch
+        IN  OUT     assembler_t*                Assembler
     )
 {
-    BWSR_STATUS             retVal          = ERROR_FAILURE;
-    assembler_t             assembler       = { 0 };
-    relocation_context_t    context         = { 0 };
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    uint32_t        i               = 0;
 
-    __NOT_NULL( Routing,
-                BaseAddress,
-                Relocated )
+    __NOT_NULL( Assembler );
 
-    context.BaseAddress = BaseAddress;
-    context.Cursor      = BaseAddress->Start;
+    // sub sp, sp, #sizeof( bwsr_cpu_context_t )
+    retVal = Assembler_AddSubImmediate( &Assembler->Buffer,
+                                        SUB_x_imm,
+                                        &X( ARM64_SP_REG_NDX ),
+                                        &X( ARM64_SP_REG_NDX ),
+                                        sizeof( bwsr_cpu_context_t ) );
 
-    if( ERROR_SUCCESS != ( retVal = Assembler_Initialize( &assembler, 0 ) ) )
+    // stp x0, x1, [sp] ... stp x28, x29, [sp, #224]
+    for( i = 0; ( i < 30 ) && ( ERROR_SUCCESS == retVal ); i += 2 )
+    {
+        retVal = Assembler_LoadStorePair( &Assembler->Buffer,
+                                          STP_x,
+                                          &X( i ),
+                                          &X( i + 1 ),
+                                          &MEMOP_SP( offsetof( bwsr_cpu_context_t, X ) + ( i * sizeof( uint64_t ) ) ) );
+    } // for()
+
+    if( ERROR_SUCCESS != retVal )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStorePair() Failed\n" );
+    }
+    // str x30, [sp, #240]
+    else if( ERROR_SUCCESS != ( retVal = Assembler_LoadStore( &Assembler->Buffer,
+                                                              STR_x,
+                                                              &X( 30 ),
+                                                              &MEMOP_SP( offsetof( bwsr_cpu_context_t, X ) + ( 30 * sizeof( uint64_t ) ) ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStore() Failed\n" );
+    }
+    // add x16, sp, #sizeof( bwsr_cpu_context_t )
+    else if( ERROR_SUCCESS != ( retVal = Assembler_AddSubImmediate( &Assembler->Buffer,
+                                                                    ADD_x_imm,
+                                                                    &X( ARM64_TMP_REG_NDX_1 ),
+                                                                    &X( ARM64_SP_REG_NDX ),
+                                                                    sizeof( bwsr_cpu_context_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_AddSubImmediate() Failed\n" );
+    }
+    // str x16, [sp, #248]
+    else if( ERROR_SUCCESS != ( retVal = Assembler_LoadStore( &Assembler->Buffer,
+                                                              STR_x,
+                                                              &X( ARM64_TMP_REG_NDX_1 ),
+                                                              &MEMOP_SP( offsetof( bwsr_cpu_context_t, SP ) ) ) ) )
     {
-        BWSR_DEBUG( LOG_ERROR, "Assembler_Initialize() Failed\n" );
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStore() Failed\n" );
     }
     else {
-        if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleBuffer( &assembler, &context ) ) )
+        // stp q0, q1, [sp, #256] ... stp q6, q7, [sp, #352]
+        for( i = 0; ( i < 8 ) && ( ERROR_SUCCESS == retVal ); i += 2 )
         {
-            BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleBuffer() Failed\n" );
-        }
-        else {
-            BaseAddress->Size = ( context.Cursor - context.BaseAddress->Start );
-
-            // TODO: if last instr is unlink branch, ignore it
-            if( true == Branch )
-            {
-                retVal = Assembler_LiteralLdrBranch( &assembler, INTERNAL_GetContextCursor( &context ) );
-            }
-
-            if( ERROR_SUCCESS == retVal )
-            {
-                if( ERROR_SUCCESS != ( retVal = Assembler_WriteRelocationDataToPageBuffer( &assembler ) ) )
-                {
-                    BWSR_DEBUG( LOG_ERROR, "Assembler_WriteRelocationDataToPageBuffer() Failed\n" );
-                }
-                else {
-                    retVal = INTERNAL_CodeBuilder_ApplyAssemblerPagePatch( Routing,
-                                                                           &assembler,
-                                                                           Relocated );
-                } // Assembler_WriteRelocationDataToPageBuffer()
-            } // Assembler_LiteralLdrBranch()
-        } // INTERNAL_CodeBuilder_AssembleBuffer()
-
-        (void) Assembler_Release( &assembler );
-    } // Assembler_Initialize()
+            retVal = Assembler_LoadStorePair( &Assembler->Buffer,
+                                              STP_q,
+                                              &Q( i ),
+                                              &Q( i + 1 ),
+                                              &MEMOP_SP( offsetof( bwsr_cpu_context_t, Q ) + ( i * 2 * sizeof( uint64_t ) ) ) );
+        } // for()
+    } // Assembler_LoadStorePair()
 
     return retVal;
 }
 
 static
 BWSR_STATUS
-    INTERNAL_InterceptRouting_Initialize
+    INTERNAL_CodeBuilder_AssembleContextRestore
     (
-        OUT         intercept_routing_t**       Routing,
-        IN          interceptor_entry_t*        Entry,
-        IN          uintptr_t                   FakeFunction
+        IN  OUT     assembler_t*                Assembler
     )
 {
-    BWSR_STATUS retVal = ERROR_FAILURE;
+    BWSR_STATUS     retVal          = ERROR_SUCCESS;
+    uint32_t        i               = 0;
 
-    __NOT_NULL( Routing, Entry )
-    __GREATER_THAN_0( FakeFunction )
+    __NOT_NULL( Assembler );
 
-    if( NULL == ( *Routing = (intercept_routing_t*) BwsrMalloc( sizeof( intercept_routing_t ) ) ) )
+    // Only what the callbacks may change and the callee may read
+    // is written back. `x19` - `x29` are preserved by the helper.
+
+    // ldp q0, q1, [sp, #256] ... ldp q6, q7, [sp, #352]
+    for( i = 0; ( i < 8 ) && ( ERROR_SUCCESS == retVal ); i += 2 )
     {
-        BWSR_DEBUG( LOG_ERROR, "malloc() Failed\n" );
-        retVal = ERROR_MEM_ALLOC;
+        retVal = Assembler_LoadStorePair( &Assembler->Buffer,
+                                          LDP_q,
+                                          &Q( i ),
+                                          &Q( i + 1 ),
+                                          &MEMOP_SP( offsetof( bwsr_cpu_context_t, Q ) + ( i * 2 * sizeof( uint64_t ) ) ) );
+    } // for()
+
+    // ldp x0, x1, [sp] ... ldp x6, x7, [sp, #48]
+    for( i = 0; ( ( i + 1 ) < ARM64_ARG_REG_COUNT ) && ( ERROR_SUCCESS == retVal ); i += 2 )
+    {
+        retVal = Assembler_LoadStorePair( &Assembler->Buffer,
+                                          LDP_x,
+                                          &X( i ),
+                                          &X( i + 1 ),
+                                          &MEMOP_SP( offsetof( bwsr_cpu_context_t, X ) + ( i * sizeof( uint64_t ) ) ) );
+    } // for()
+
+    if( ERROR_SUCCESS != retVal )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStorePair() Failed\n" );
     }
-    else {
-        if( ERROR_SUCCESS != ( retVal = INTERNAL_SetMemoryProtectionFunction( (uintptr_t*) &( *Routing )->MemoryProtectFn ) ) )
-        {
-            BWSR_DEBUG( LOG_ERROR, "INTERNAL_SetMemoryProtectionFunction() Failed\n" );
-            BwsrFree( *Routing );
-        }
-        else {
-            ( *Routing )->InterceptEntry     = Entry;
-            ( *Routing )->Trampoline         = NULL;
-            ( *Routing )->HookFunction       = FakeFunction;
-        } // INTERNAL_SetMemoryProtectionFunction()
-    } // BwsrMalloc()
+    // ldr x8, [sp, #64]
+    else if( ERROR_SUCCESS != ( retVal = Assembler_LoadStore( &Assembler->Buffer,
+                                                              LDR_x,
+                                                              &X( ARM64_ARG_REG_COUNT - 1 ),
+                                                              &MEMOP_SP( offsetof( bwsr_cpu_context_t, X ) + ( ( ARM64_ARG_REG_COUNT - 1 ) * sizeof( uint64_t ) ) ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStore() Failed\n" );
+    }
+    // ldr x30, [sp, #240]
+    else if( ERROR_SUCCESS != ( retVal = Assembler_LoadStore( &Assembler->Buffer,
+                                                              LDR_x,
+                                                              &X( 30 ),
+                                                              &MEMOP_SP( offsetof( bwsr_cpu_context_t, X ) + ( 30 * sizeof( uint64_t ) ) ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStore() Failed\n" );
+    }
+    // add sp, sp, #sizeof( bwsr_cpu_context_t )
+    else if( ERROR_SUCCESS != ( retVal = Assembler_AddSubImmediate( &Assembler->Buffer,
+                                                                    ADD_x_imm,
+                                                                    &X( ARM64_SP_REG_NDX ),
+                                                                    &X( ARM64_SP_REG_NDX ),
+                                                                    sizeof( bwsr_cpu_context_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_AddSubImmediate() Failed\n" );
+    } // Assembler_LoadStorePair()
 
     return retVal;
 }
 
 static
 BWSR_STATUS
-    INTERNAL_ApplyTrampolineCodePatch
+    INTERNAL_CodeBuilder_AssembleInstrumentationCall
     (
-        IN  OUT     intercept_routing_t*        Routing
+        IN  OUT     assembler_t*                Assembler,
+        IN          const instrumentation_t*    Instrumentation,
+        IN          const uintptr_t             Helper
     )
 {
-    BWSR_STATUS     retVal              = ERROR_FAILURE;
-    size_t          trampolineSize      = 0;
-    uintptr_t       bufferStart         = 0;
-
-    __NOT_NULL( Routing );
-
-    trampolineSize  = Routing->Trampoline->Buffer.Size;
-    bufferStart     = Routing->Trampoline->Buffer.Start;
-
-    BWSR_DEBUG( LOG_NOTICE, "Patching Trampoline into Intercept Address...\n" );
-
-    retVal = INTERNAL_ApplyCodePatch( Routing,
-                                      (void*) Routing->InterceptEntry->Address,
-                                      (uint8_t*) bufferStart,
-                                      trampolineSize );
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    relocation_data_t*  record          = NULL;
+    relocation_data_t*  helper          = NULL;
+
+    __NOT_NULL( Assembler, Instrumentation );
+    __GREATER_THAN_0( Helper );
+
+    // <save context>
+    // add x0, sp, #0
+    // ldr x1, =Instrumentation
+    // ldr x17, =Helper
+    // blr x17
+    // <restore context>
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleContextSave( Assembler ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleContextSave() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_AddSubImmediate( &Assembler->Buffer,
+                                                                    ADD_x_imm,
+                                                                    &X( 0 ),
+                                                                    &X( ARM64_SP_REG_NDX ),
+                                                                    0 ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_AddSubImmediate() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &record,
+                                                                         Assembler,
+                                                                         (uint64_t) Instrumentation ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
+                                                                         &X( 1 ),
+                                                                         record ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &helper,
+                                                                         Assembler,
+                                                                         (uint64_t) Helper ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
+                                                                         (register_data_t*) &TMP_REG_0,
+                                                                         helper ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                          ( BLR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleContextRestore( Assembler ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleContextRestore() Failed\n" );
+    } // INTERNAL_CodeBuilder_AssembleContextSave()
 
     return retVal;
 }
 
 static
 BWSR_STATUS
-    INTERNAL_GenerateRelocatedCode
+    INTERNAL_CodeBuilder_AssembleInstrumentationStub
     (
-        IN  OUT     intercept_routing_t*        Routing
+        IN  OUT     assembler_t*                Assembler,
+        IN          const hook_handler_t*       Handler,
+        OUT         size_t*                     LeaveOffset
     )
 {
-    BWSR_STATUS     retVal              = ERROR_FAILURE;
-    size_t          trampolineSize      = 0;
-    uintptr_t       bufferStart         = 0;
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    relocation_data_t*  relocationData  = NULL;
+    uintptr_t           enter           = 0;
+    uintptr_t           leave           = 0;
 
-    __NOT_NULL( Routing );
+    __NOT_NULL( Assembler,
+                Handler,
+                Handler->Instrumentation,
+                LeaveOffset );
 
-    trampolineSize  = Routing->Trampoline->Buffer.Size;
-    bufferStart     = Routing->Trampoline->Buffer.Start;
+#if __has_feature( ptrauth_calls )
+    enter   = (uintptr_t) ptrauth_strip( (void*) INTERNAL_Instrumentation_Enter, ptrauth_key_asia );
+    leave   = (uintptr_t) ptrauth_strip( (void*) INTERNAL_Instrumentation_Leave, ptrauth_key_asia );
+#else
+    enter   = (uintptr_t) INTERNAL_Instrumentation_Enter;
+    leave   = (uintptr_t) INTERNAL_Instrumentation_Leave;
+#endif
 
-    if( bufferStart == 0 )
+    // Enter:
+    //  <call INTERNAL_Instrumentation_Enter()>
+    //  ldr x17, =&Handler->Next
+    //  ldr x17, [x17]
+    //  br  x17
+    // Leave, returned to by the instrumented function:
+    //  <call INTERNAL_Instrumentation_Leave()>
+    //  ret
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleInstrumentationCall( Assembler,
+                                                                                      Handler->Instrumentation,
+                                                                                      enter ) ) )
     {
-        BWSR_DEBUG( LOG_ERROR, "Routing failed. Cannot continue\n" );
-        retVal = ERROR_ROUTING_FAILURE;
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleInstrumentationCall() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &relocationData,
+                                                                         Assembler,
+                                                                         (uint64_t) &Handler->Next ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
+                                                                         (register_data_t*) &TMP_REG_0,
+                                                                         relocationData ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_LoadStore( &Assembler->Buffer,
+                                                              LDR_x,
+                                                              &TMP_REG_0,
+                                                              &MEMOP_ADDR( AddrModeOffset ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStore() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                          ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
     }
     else {
-        Routing->InterceptEntry->Patched.Start      = Routing->InterceptEntry->Address;
-        Routing->InterceptEntry->Patched.Size       = trampolineSize;
-        Routing->InterceptEntry->Relocated.Start    = 0;
-        Routing->InterceptEntry->Relocated.Size     = 0;
-
-        retVal = INTERNAL_CodeBuilder_AssembleAndPatch( Routing,
-                                                        &Routing->InterceptEntry->Patched,
-                                                        &Routing->InterceptEntry->Relocated,
-                                                        true );
+        *LeaveOffset = Assembler->Buffer.BufferSize;
 
-        if( ( ERROR_SUCCESS == retVal                                  ) &&
-            ( 0             == Routing->InterceptEntry->Relocated.Size ) )
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleInstrumentationCall( Assembler,
+                                                                                          Handler->Instrumentation,
+                                                                                          leave ) ) )
         {
-            BWSR_DEBUG( LOG_ERROR, "Routing failed. Cannot continue\n" );
-            retVal = ERROR_ROUTING_FAILURE;
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleInstrumentationCall() Failed\n" );
         }
-    }
+        else if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                              ( RET | ( 30 << kRnShift ) ) ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+        }
+        else if( ( 0 != ( Assembler->Buffer.BufferSize % sizeof( uint64_t ) ) ) &&
+                 ( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                                ARM64_NOP ) ) ) )
+        {
+            // Keeps the literals 8 byte aligned
+            BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+        }
+        else {
+            retVal = Assembler_WriteRelocationDataToPageBuffer( Assembler );
+        } // INTERNAL_CodeBuilder_AssembleInstrumentationCall()
+    } // INTERNAL_CodeBuilder_AssembleInstrumentationCall()
 
     return retVal;
 }
 
 static
 BWSR_STATUS
-    INTERNAL_GenerateTrampoline
+    INTERNAL_CodeBuilder_AssembleInstructions
     (
-        IN  OUT     intercept_routing_t*        Routing
+        IN  OUT     assembler_t*                Assembler,
+        IN          const uint32_t*             Instructions,
+        IN          const size_t                Count
     )
 {
-    BWSR_STATUS         retVal      = ERROR_FAILURE;
-    const uintptr_t     from        = Routing->InterceptEntry->Address;
-    const uintptr_t     to          = Routing->HookFunction;
+    BWSR_STATUS     retVal          = ERROR_SUCCESS;
+    size_t          i               = 0;
 
-    __NOT_NULL( Routing );
+    __NOT_NULL( Assembler, Instructions );
 
-    retVal = INTERNAL_Trampoline_Initialize( &Routing->Trampoline,
-                                             from,
-                                             to );
+    for( i = 0; ( i < Count ) && ( ERROR_SUCCESS == retVal ); i++ )
+    {
+        retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                  Instructions[ i ] );
+    } // for()
+
+    if( ERROR_SUCCESS != retVal )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+    }
 
     return retVal;
 }
 
 static
 BWSR_STATUS
-    INTERNAL_BuildRoutingAndActivateHook
+    INTERNAL_CodeBuilder_AssembleLoadLiteral
     (
-        IN  OUT     intercept_routing_t*        Routing
+        IN  OUT     assembler_t*                Assembler,
+        IN          const int                   RegisterId,
+        IN          const uint64_t              Value
     )
 {
-    BWSR_STATUS retVal = ERROR_FAILURE;
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    relocation_data_t*  relocationData  = NULL;
 
-    __NOT_NULL( Routing );
+    __NOT_NULL( Assembler );
 
-    if( ERROR_SUCCESS != ( retVal = INTERNAL_GenerateTrampoline( Routing ) ) )
+    // ldr x<RegisterId>, =Value
+    if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &relocationData,
+                                                                    Assembler,
+                                                                    Value ) ) )
     {
-        BWSR_DEBUG( LOG_ERROR, "INTERNAL_GenerateTrampoline() Failed\n" );
+        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
+                                                                         &X( RegisterId ),
+                                                                         relocationData ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+    } // Assembler_CreateRelocationData()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleSlotJump
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const uintptr_t             Slot
+    )
+{
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+
+    __NOT_NULL( Assembler );
+    __GREATER_THAN_0( Slot );
+
+    // ldr x17, =Slot
+    // ldr x17, [x17]
+    // br  x17
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleLoadLiteral( Assembler,
+                                                                              ARM64_TMP_REG_NDX_0,
+                                                                              (uint64_t) Slot ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleLoadLiteral() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_LoadStore( &Assembler->Buffer,
+                                                              LDR_x,
+                                                              &TMP_REG_0,
+                                                              &MEMOP_ADDR( AddrModeOffset ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStore() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                          ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+    } // INTERNAL_CodeBuilder_AssembleLoadLiteral()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleStatisticsFrame
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const bool                  Save
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_SUCCESS;
+    uint32_t        i               = 0;
+
+    __NOT_NULL( Assembler );
+
+    // Save:
+    //  sub sp, sp, #sizeof( hook_statistics_frame_t )
+    //  stp x0, x1, [sp] ... stp x6, x7, [sp, #48]
+    //  str x8, [sp, #64]
+    //  stp q0, q1, [sp, #80] ... stp q6, q7, [sp, #176]
+    // Restore loads the same and ends with the `add sp`
+    if( true == Save )
+    {
+        retVal = Assembler_AddSubImmediate( &Assembler->Buffer,
+                                            SUB_x_imm,
+                                            &X( ARM64_SP_REG_NDX ),
+                                            &X( ARM64_SP_REG_NDX ),
+                                            sizeof( hook_statistics_frame_t ) );
+    } // Save
+
+    for( i = 0; ( ( i + 1 ) < ARM64_ARG_REG_COUNT ) && ( ERROR_SUCCESS == retVal ); i += 2 )
+    {
+        retVal = Assembler_LoadStorePair( &Assembler->Buffer,
+                                          ( Save ) ? STP_x : LDP_x,
+                                          &X( i ),
+                                          &X( i + 1 ),
+                                          &MEMOP_SP( offsetof( hook_statistics_frame_t, X ) + ( i * sizeof( uint64_t ) ) ) );
+    } // for()
+
+    if( ERROR_SUCCESS != retVal )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStorePair() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_LoadStore( &Assembler->Buffer,
+                                                              ( Save ) ? STR_x : LDR_x,
+                                                              &X( ARM64_ARG_REG_COUNT - 1 ),
+                                                              &MEMOP_SP( offsetof( hook_statistics_frame_t, X ) + ( ( ARM64_ARG_REG_COUNT - 1 ) * sizeof( uint64_t ) ) ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStore() Failed\n" );
     }
     else {
-        if( ERROR_SUCCESS != ( retVal = INTERNAL_GenerateRelocatedCode( Routing ) ) )
+        for( i = 0; ( i < 8 ) && ( ERROR_SUCCESS == retVal ); i += 2 )
         {
-            BWSR_DEBUG( LOG_ERROR, "INTERNAL_GenerateRelocatedCode() Failed\n" );
+            retVal = Assembler_LoadStorePair( &Assembler->Buffer,
+                                              ( Save ) ? STP_q : LDP_q,
+                                              &Q( i ),
+                                              &Q( i + 1 ),
+                                              &MEMOP_SP( offsetof( hook_statistics_frame_t, Q ) + ( i * 2 * sizeof( uint64_t ) ) ) );
+        } // for()
+
+        if( ERROR_SUCCESS != retVal )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStorePair() Failed\n" );
+        }
+        else if( ( false         == Save ) &&
+                 ( ERROR_SUCCESS != ( retVal = Assembler_AddSubImmediate( &Assembler->Buffer,
+                                                                          ADD_x_imm,
+                                                                          &X( ARM64_SP_REG_NDX ),
+                                                                          &X( ARM64_SP_REG_NDX ),
+                                                                          sizeof( hook_statistics_frame_t ) ) ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Assembler_AddSubImmediate() Failed\n" );
+        } // Assembler_LoadStorePair()
+    } // Assembler_LoadStorePair()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleStatisticsCall
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const instrumentation_t*    Instrumentation,
+        IN          const uintptr_t             Helper,
+        IN          const bool                  PassReturnAddress
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    int             ticks           = ( PassReturnAddress ) ? 2 : 1;
+    uint32_t        readTicks[]     =
+    {
+        // isb
+        ISB,
+        // mrs x<ticks>, cntvct_el0
+        ( MRS | CNTVCT_EL0 | ticks )
+    };
+
+    __NOT_NULL( Assembler, Instrumentation );
+    __GREATER_THAN_0( Helper );
+
+    // <save x0 - x8, q0 - q7>
+    // ldr x0, =Instrumentation
+    // add x1, x30, #0          ; only with `PassReturnAddress`
+    // <read ticks into the next argument>
+    // ldr x17, =Helper
+    // blr x17
+    // add x30, x0, #0
+    // <restore x0 - x8, q0 - q7>
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleStatisticsFrame( Assembler, true ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleStatisticsFrame() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleLoadLiteral( Assembler,
+                                                                                   0,
+                                                                                   (uint64_t) Instrumentation ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleLoadLiteral() Failed\n" );
+    }
+    else if( ( true          == PassReturnAddress ) &&
+             ( ERROR_SUCCESS != ( retVal = Assembler_AddSubImmediate( &Assembler->Buffer,
+                                                                      ADD_x_imm,
+                                                                      &X( 1 ),
+                                                                      &X( 30 ),
+                                                                      0 ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_AddSubImmediate() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleInstructions( Assembler,
+                                                                                    readTicks,
+                                                                                    ARRAY_LENGTH( readTicks ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleInstructions() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleLoadLiteral( Assembler,
+                                                                                   ARM64_TMP_REG_NDX_0,
+                                                                                   (uint64_t) Helper ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleLoadLiteral() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                          ( BLR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_AddSubImmediate( &Assembler->Buffer,
+                                                                    ADD_x_imm,
+                                                                    &X( 30 ),
+                                                                    &X( 0 ),
+                                                                    0 ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_AddSubImmediate() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleStatisticsFrame( Assembler, false ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleStatisticsFrame() Failed\n" );
+    } // INTERNAL_CodeBuilder_AssembleStatisticsFrame()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleStatisticsStub
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN          const hook_handler_t*       Handler,
+        OUT         size_t*                     EnterOffset,
+        OUT         size_t*                     LeaveOffset
+    )
+{
+    BWSR_STATUS             retVal          = ERROR_FAILURE;
+    hook_statistics_t*      statistics      = NULL;
+    uintptr_t               enter           = 0;
+    uintptr_t               leave           = 0;
+    // Timed is the first block of the stub
+    size_t                  timed           = 0;
+    size_t                  retry           = 0;
+    uint32_t                stripe[]        =
+    {
+        // sub  sp, sp, #16
+        ( SUB_x_imm | ( 16 << 10 ) | ( ARM64_SP_REG_NDX << kRnShift ) | ARM64_SP_REG_NDX ),
+        // stp  x0, x1, [sp]
+        ( STP_x | ( 1 << kRt2Shift ) | ( ARM64_SP_REG_NDX << kRnShift ) | 0 ),
+#if defined( __APPLE__ )
+        // mrs  x0, tpidrro_el0
+        ( MRS | TPIDRRO_EL0 | 0 ),
+#else
+        // mrs  x0, tpidr_el0
+        ( MRS | TPIDR_EL0 | 0 ),
+#endif
+        // eor  x0, x0, x0, lsr #16
+        ( EOR_x_shift | ( LSR << 22 ) | ( 0 << kRmShift ) | ( 16 << 10 ) | ( 0 << kRnShift ) | 0 ),
+        // eor  x0, x0, x0, lsr #8
+        ( EOR_x_shift | ( LSR << 22 ) | ( 0 << kRmShift ) | ( 8 << 10 ) | ( 0 << kRnShift ) | 0 ),
+        // eor  x0, x0, x0, lsr #4
+        ( EOR_x_shift | ( LSR << 22 ) | ( 0 << kRmShift ) | ( 4 << 10 ) | ( 0 << kRnShift ) | 0 ),
+        // ubfx x0, x0, #12, #4
+        ( UBFM_x
+          | ( HOOK_STATISTICS_STRIPE_LOW_BIT << 16 )
+          | ( ( HOOK_STATISTICS_STRIPE_LOW_BIT + HOOK_STATISTICS_STRIPE_BITS - 1 ) << 10 )
+          | ( 0 << kRnShift )
+          | 0 ),
+    };
+    uint32_t                count[]         =
+    {
+        // add  x16, x17, x0, lsl #6
+        ( ADD_x_shift
+          | ( LSL << 22 )
+          | ( 0 << kRmShift )
+          | ( __builtin_ctz( sizeof( hook_statistics_stripe_t ) ) << 10 )
+          | ( ARM64_TMP_REG_NDX_0 << kRnShift )
+          | ARM64_TMP_REG_NDX_1 ),
+        // 1:
+        // ldxr x1, [x16]
+        ( LDXR_x | ( ARM64_TMP_REG_NDX_1 << kRnShift ) | 1 ),
+        // add  x1, x1, #1
+        ( ADD_x_imm | ( 1 << 10 ) | ( 1 << kRnShift ) | 1 ),
+        // stxr w0, x1, [x16]
+        ( STXR_x | ( 0 << kRsShift ) | ( ARM64_TMP_REG_NDX_1 << kRnShift ) | 1 ),
+    };
+    uint32_t                restore[]       =
+    {
+        // ldp  x0, x1, [sp]
+        ( LDP_x | ( 1 << kRt2Shift ) | ( ARM64_SP_REG_NDX << kRnShift ) | 0 ),
+        // add  sp, sp, #16
+        ( ADD_x_imm | ( 16 << 10 ) | ( ARM64_SP_REG_NDX << kRnShift ) | ARM64_SP_REG_NDX ),
+    };
+
+    __NOT_NULL( Assembler,
+                Handler,
+                Handler->Instrumentation,
+                Handler->Instrumentation->Statistics,
+                EnterOffset,
+                LeaveOffset );
+
+    statistics = Handler->Instrumentation->Statistics;
+
+#if __has_feature( ptrauth_calls )
+    enter   = (uintptr_t) ptrauth_strip( (void*) INTERNAL_HookStatistics_Enter, ptrauth_key_asia );
+    leave   = (uintptr_t) ptrauth_strip( (void*) INTERNAL_HookStatistics_Leave, ptrauth_key_asia );
+#else
+    enter   = (uintptr_t) INTERNAL_HookStatistics_Enter;
+    leave   = (uintptr_t) INTERNAL_HookStatistics_Leave;
+#endif
+
+    // Branches only go backwards, the blocks are laid out last to first.
+    // Timed, branched to by Enter when `MeasureLatency` is set:
+    //  <call INTERNAL_HookStatistics_Enter() with the return address and ticks>
+    //  <jump through &Handler->Next>
+    // Leave, returned to by a timed call:
+    //  <call INTERNAL_HookStatistics_Leave() with the ticks>
+    //  ret
+    // Enter, counts on the stripe picked by the thread pointer:
+    //  <push x0, x1 and fold the thread pointer into a stripe>
+    //  ldr  x17, =statistics->Stripes
+    //  <bump the stripe with ldxr / stxr>
+    //  cbnz w0, 1b
+    //  ldr  x17, =&statistics->MeasureLatency
+    //  ldrb w16, [x17]
+    //  <pop x0, x1>
+    //  cbnz w16, Timed
+    //  <jump through &Handler->Next>
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleStatisticsCall( Assembler,
+                                                                                 Handler->Instrumentation,
+                                                                                 enter,
+                                                                                 true ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleStatisticsCall() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleSlotJump( Assembler,
+                                                                                (uintptr_t) &Handler->Next ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleSlotJump() Failed\n" );
+    }
+    else {
+        *LeaveOffset = Assembler->Buffer.BufferSize;
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleStatisticsCall( Assembler,
+                                                                                     Handler->Instrumentation,
+                                                                                     leave,
+                                                                                     false ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleStatisticsCall() Failed\n" );
+        }
+        else if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                              ( RET | ( 30 << kRnShift ) ) ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
         }
         else {
-            if( ERROR_SUCCESS != ( retVal = INTERNAL_BackupOriginalCode( Routing->InterceptEntry ) ) )
+            *EnterOffset = Assembler->Buffer.BufferSize;
+
+            if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleInstructions( Assembler,
+                                                                                       stripe,
+                                                                                       ARRAY_LENGTH( stripe ) ) ) )
             {
-                BWSR_DEBUG( LOG_ERROR, "INTERNAL_BackupOriginalCode() Failed\n" );
+                BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleInstructions() Failed\n" );
+            }
+            else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleLoadLiteral( Assembler,
+                                                                                           ARM64_TMP_REG_NDX_0,
+                                                                                           (uint64_t) statistics->Stripes ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleLoadLiteral() Failed\n" );
             }
             else {
-                if( ERROR_SUCCESS != ( retVal = INTERNAL_ApplyTrampolineCodePatch( Routing ) ) )
+                // `ldxr` is the second instruction of `count`
+                retry = Assembler->Buffer.BufferSize + sizeof( uint32_t );
+
+                if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleInstructions( Assembler,
+                                                                                           count,
+                                                                                           ARRAY_LENGTH( count ) ) ) )
                 {
-                    BWSR_DEBUG( LOG_ERROR, "INTERNAL_ApplyTrampolineCodePatch() Failed\n" );
-                    BwsrFree( Routing->InterceptEntry->OriginalCode );
+                    BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleInstructions() Failed\n" );
                 }
-            } // INTERNAL_BackupOriginalCode()
-        } // INTERNAL_GenerateRelocatedCode()
+                // cbnz w0, 1b
+                else if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                                      ( CBNZ_w
+                                                                                        | ( ( ( (int64_t) retry - Assembler->Buffer.BufferSize ) >> 2 ) & 0x7FFFF ) << 5
+                                                                                        | 0 ) ) ) )
+                {
+                    BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+                }
+                else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleLoadLiteral( Assembler,
+                                                                                               ARM64_TMP_REG_NDX_0,
+                                                                                               (uint64_t) &statistics->MeasureLatency ) ) )
+                {
+                    BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleLoadLiteral() Failed\n" );
+                }
+                else if( ERROR_SUCCESS != ( retVal = Assembler_LoadStore( &Assembler->Buffer,
+                                                                          LDRB_w,
+                                                                          &W( ARM64_TMP_REG_NDX_1 ),
+                                                                          &MEMOP_ADDR( AddrModeOffset ) ) ) )
+                {
+                    BWSR_DEBUG( LOG_ERROR, "Assembler_LoadStore() Failed\n" );
+                }
+                else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleInstructions( Assembler,
+                                                                                                restore,
+                                                                                                ARRAY_LENGTH( restore ) ) ) )
+                {
+                    BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleInstructions() Failed\n" );
+                }
+                // cbnz w16, Timed
+                else if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                                      ( CBNZ_w
+                                                                                        | ( ( ( (int64_t) timed - Assembler->Buffer.BufferSize ) >> 2 ) & 0x7FFFF ) << 5
+                                                                                        | ARM64_TMP_REG_NDX_1 ) ) ) )
+                {
+                    BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+                }
+                else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleSlotJump( Assembler,
+                                                                                            (uintptr_t) &Handler->Next ) ) )
+                {
+                    BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleSlotJump() Failed\n" );
+                }
+                else if( ( 0 != ( Assembler->Buffer.BufferSize % sizeof( uint64_t ) ) ) &&
+                         ( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer,
+                                                                                        ARM64_NOP ) ) ) )
+                {
+                    // Keeps the literals 8 byte aligned
+                    BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+                }
+                else {
+                    retVal = Assembler_WriteRelocationDataToPageBuffer( Assembler );
+                } // INTERNAL_CodeBuilder_AssembleInstructions()
+            } // INTERNAL_CodeBuilder_AssembleInstructions()
+        } // INTERNAL_CodeBuilder_AssembleStatisticsCall()
+    } // INTERNAL_CodeBuilder_AssembleStatisticsCall()
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_Instrumentation_Enter
+    (
+        IN  OUT     bwsr_cpu_context_t*         Context,
+        IN          const instrumentation_t*    Instrumentation
+    )
+{
+    instrumentation_frame_t*    frame       = NULL;
+    InstrumentCallback          onEnter     = NULL;
+    InstrumentCallback          onLeave     = NULL;
+    uint32_t                    generation  = 0;
+
+    __NOT_NULL_RETURN_VOID( Context, Instrumentation );
+
+    // Cleared when the instrumentation is removed, set again when
+    // the stub is reused. Callbacks read across a reuse are dropped.
+    generation  = __atomic_load_n( &Instrumentation->Generation, __ATOMIC_ACQUIRE );
+    onEnter     = __atomic_load_n( &Instrumentation->OnEnter, __ATOMIC_ACQUIRE );
+    onLeave     = __atomic_load_n( &Instrumentation->OnLeave, __ATOMIC_ACQUIRE );
+
+    if( generation != __atomic_load_n( &Instrumentation->Generation, __ATOMIC_ACQUIRE ) )
+    {
+        onEnter = NULL;
+        onLeave = NULL;
+    }
+
+    if( NULL != onEnter )
+    {
+        onEnter( Context, Instrumentation->UserData );
+    }
+
+    if( NULL != onLeave )
+    {
+        if( INSTRUMENTATION_SHADOW_STACK_DEPTH > gShadowStack.Depth )
+        {
+            // The function returns into the leave stub, which
+            // returns to the caller through the shadow stack
+            frame = &gShadowStack.Frames[ gShadowStack.Depth++ ];
+
+            frame->ReturnAddress    = Context->X[ 30 ];
+            frame->EnterTicks       = 0;
+            frame->Generation       = generation;
+            Context->X[ 30 ]        = Instrumentation->LeaveStub;
+        }
+        else {
+            BWSR_DEBUG( LOG_WARNING, "Shadow stack exhausted, OnLeave skipped\n" );
+        } // INSTRUMENTATION_SHADOW_STACK_DEPTH
+    } // OnLeave
+}
+
+static
+void
+    INTERNAL_Instrumentation_Leave
+    (
+        IN  OUT     bwsr_cpu_context_t*         Context,
+        IN          const instrumentation_t*    Instrumentation
+    )
+{
+    instrumentation_frame_t*    frame       = NULL;
+    InstrumentCallback          onLeave     = NULL;
+
+    __NOT_NULL_RETURN_VOID( Context, Instrumentation );
+
+    // Only ever reached through a frame pushed
+    // by `INTERNAL_Instrumentation_Enter()`
+    frame               = &gShadowStack.Frames[ --gShadowStack.Depth ];
+    Context->X[ 30 ]    = frame->ReturnAddress;
+
+    // The frame is popped even when the instrumentation was removed
+    // or reused since the call entered, only the callback is skipped
+    if( ( frame->Generation == __atomic_load_n( &Instrumentation->Generation, __ATOMIC_ACQUIRE ) ) &&
+        ( NULL != ( onLeave = __atomic_load_n( &Instrumentation->OnLeave, __ATOMIC_ACQUIRE ) ) ) )
+    {
+        onLeave( Context, Instrumentation->UserData );
+    }
+}
+
+static
+BWSR_STATUS
+    INTERNAL_Instrumentation_GenerateStub
+    (
+        IN  OUT     hook_handler_t*             Handler
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    assembler_t             assembler   = { 0 };
+    assembler_arena_t       arena;
+    intercept_routing_t     routing     = { 0 };
+    size_t                  enterOffset = 0;
+    size_t                  leaveOffset = 0;
+
+    __NOT_NULL( Handler, Handler->Instrumentation );
+
+    if( ERROR_SUCCESS != ( retVal = Assembler_InitializeWithArena( &assembler, 0, &arena ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_InitializeWithArena() Failed\n" );
+    }
+    else {
+        // Nothing reaches the stub before it is published
+        // through a slot, it is never staged
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_SetMemoryProtectionFunction( (uintptr_t*) &routing.MemoryProtectFn ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_SetMemoryProtectionFunction() Failed\n" );
+        }
+        else if( ( NULL          != Handler->Instrumentation->Statistics ) &&
+                 ( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleStatisticsStub( &assembler,
+                                                                                            Handler,
+                                                                                            &enterOffset,
+                                                                                            &leaveOffset ) ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleStatisticsStub() Failed\n" );
+        }
+        else if( ( NULL          == Handler->Instrumentation->Statistics ) &&
+                 ( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleInstrumentationStub( &assembler,
+                                                                                                 Handler,
+                                                                                                 &leaveOffset ) ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleInstrumentationStub() Failed\n" );
+        }
+        else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_ApplyAssemblerPagePatch( &routing,
+                                                                                            &assembler,
+                                                                                            &Handler->Instrumentation->Stub ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_ApplyAssemblerPagePatch() Failed\n" );
+        }
+        else {
+            Handler->Instrumentation->LeaveStub = Handler->Instrumentation->Stub.Start + leaveOffset;
+            Handler->HookFunctionAddress        = Handler->Instrumentation->Stub.Start + enterOffset;
+        } // INTERNAL_SetMemoryProtectionFunction()
+
+        (void) Assembler_Release( &assembler );
+    } // Assembler_InitializeWithArena()
+
+    return retVal;
+}
+
+static
+hook_handler_t*
+    INTERNAL_Instrumentation_Reuse
+    (
+        IN          const uintptr_t             Target,
+        IN          const bool                  Statistics
+    )
+{
+    hook_handler_t*         retVal      = NULL;
+    hook_handler_t**        link        = &gRetiredInstrumentation;
+
+    while( ( NULL == retVal ) &&
+           ( NULL != *link  ) )
+    {
+        // Statistics stubs are only reused for statistics
+        if( ( Statistics == ( NULL != ( *link )->Instrumentation->Statistics ) ) &&
+            ( Target     == ( *link )->Instrumentation->Target                 ) )
+        {
+            retVal          = *link;
+            *link           = retVal->Older;
+            retVal->Older   = NULL;
+        }
+        else {
+            link = &( *link )->Older;
+        } // Target
+    } // while()
+
+    return retVal;
+}
+
+static
+uint64_t
+    INTERNAL_ReadTickFrequency
+    (
+        void
+    )
+{
+    uint64_t            retVal      = 0;
+
+#if defined( __aarch64__ )
+    __asm__ __volatile__( "mrs %0, cntfrq_el0" : "=r"( retVal ) );
+#else
+    retVal = 1000000000ULL;
+#endif
+
+    return retVal;
+}
+
+static
+uintptr_t
+    INTERNAL_HookStatistics_Enter
+    (
+        IN          const instrumentation_t*    Instrumentation,
+        IN          const uintptr_t             ReturnAddress,
+        IN          const uint64_t              Ticks
+    )
+{
+    instrumentation_frame_t*    frame       = NULL;
+    uintptr_t                   retVal      = ReturnAddress;
+
+    __NOT_NULL_RETURN_0( Instrumentation );
+
+    // Called by the statistics stub with `Ticks` read
+    // as the call entered. The call returns into the
+    // leave stub, which returns through the shadow stack.
+    if( INSTRUMENTATION_SHADOW_STACK_DEPTH > gShadowStack.Depth )
+    {
+        frame = &gShadowStack.Frames[ gShadowStack.Depth++ ];
+
+        frame->ReturnAddress    = ReturnAddress;
+        frame->EnterTicks       = Ticks;
+        frame->Generation       = 0;
+        retVal                  = Instrumentation->LeaveStub;
+    }
+    else {
+        BWSR_DEBUG( LOG_WARNING, "Shadow stack exhausted, call not timed\n" );
+    } // INSTRUMENTATION_SHADOW_STACK_DEPTH
+
+    return retVal;
+}
+
+static
+uintptr_t
+    INTERNAL_HookStatistics_Leave
+    (
+        IN          const instrumentation_t*    Instrumentation,
+        IN          const uint64_t              Ticks
+    )
+{
+    instrumentation_frame_t*    frame       = NULL;
+
+    __NOT_NULL_RETURN_0( Instrumentation );
+
+    // Only ever reached through a frame pushed
+    // by `INTERNAL_HookStatistics_Enter()`
+    frame = &gShadowStack.Frames[ --gShadowStack.Depth ];
+
+    INTERNAL_HookStatistics_RecordLatency( Instrumentation->Statistics,
+                                           Ticks - frame->EnterTicks );
+
+    return frame->ReturnAddress;
+}
+
+static
+void
+    INTERNAL_HookStatistics_RecordLatency
+    (
+        IN  OUT     hook_statistics_t*          Statistics,
+        IN          const uint64_t              Ticks
+    )
+{
+    size_t              bucket      = 0;
+
+    __NOT_NULL_RETURN_VOID( Statistics );
+
+    // floor( log2( Ticks ) ), `0` ticks land in the first bucket
+    if( 0 != Ticks )
+    {
+        bucket = ( sizeof( unsigned long long ) * CHAR_BIT ) - 1 - (size_t) __builtin_clzll( Ticks );
+    }
+
+    __atomic_fetch_add( &Statistics->Latency[ bucket ],
+                        1,
+                        __ATOMIC_RELAXED );
+}
+
+static
+uintptr_t
+    INTERNAL_GetContextCursor
+    (
+        IN          const relocation_context_t* Context
+    )
+{
+    return (uintptr_t)( Context->BaseAddress->Start + ( Context->Cursor - Context->BaseAddress->Start ) );
+}
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_ApplyAssemblerPagePatch
+    (
+        IN          const intercept_routing_t*  Routing,
+        IN  OUT     assembler_t*                Assembler,
+        OUT         memory_range_t*             MemoryRange
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+    memory_range_t*     block       = NULL;
+
+    __NOT_NULL( Routing,
+                Assembler,
+                MemoryRange )
+
+    if( Assembler->FixedAddress )
+    {
+        retVal = ERROR_SUCCESS;
+    }
+    else {
+        if( ERROR_SUCCESS != ( retVal = MemoryAllocator_AllocateExecutionBlock( &block,
+                                                                                &gMemoryAllocator,
+                                                                                Assembler->Buffer.BufferSize ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "MemoryAllocator_AllocateExecutionBlock() Failed\n" );
+        }
+        else {
+            Assembler->FixedMemoryRange = (uintptr_t)block;
+            Assembler->FixedAddress     = block->Start;
+        } // MemoryAllocator_AllocateExecutionBlock()
+    } // fixed_addr
+
+    if( ERROR_SUCCESS == retVal )
+    {
+        BWSR_DEBUG( LOG_NOTICE, "Patching hooked function call into function address...\n" );
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_ApplyCodePatch( Routing,
+                                                                 (void*) Assembler->FixedAddress,
+                                                                 Assembler->Buffer.Buffer,
+                                                                 Assembler->Buffer.BufferSize ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_ApplyCodePatch() Failed\n" );
+
+            if( 0 != Assembler->FixedMemoryRange )
+            {
+                (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator,
+                                                           (memory_range_t*) Assembler->FixedMemoryRange );
+            }
+        }
+        else {
+            MemoryRange->Start = Assembler->FixedAddress;
+            MemoryRange->Size  = Assembler->Buffer.BufferSize;
+        } // INTERNAL_ApplyCodePatch()
+    }
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_WriteToBuffer_UnconditionalBranchFixed
+    (
+        IN          const relocation_context_t* Context,
+        IN  OUT     assembler_t*                Assembler,
+        IN          const uint32_t              Instruction
+    )
+{
+    BWSR_STATUS             retVal              = ERROR_FAILURE;
+    uintptr_t               cursorOffset        = 0;
+    relocation_data_t*      relocationData      = NULL;
+    uint32_t                value               = 0;
+
+    __NOT_NULL( Context, Assembler )
+    __GREATER_THAN_0( Instruction )
+
+    cursorOffset = INTERNAL_GetContextCursor( Context ) + Imm26Offset( Instruction );
+
+    if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &relocationData,
+                                                                    Assembler,
+                                                                    cursorOffset ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+    }
+    else {
+        if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
+                                                                        (register_data_t*) &TMP_REG_0,
+                                                                        relocationData ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+        }
+        else {
+            if( BL == ( Instruction & UnconditionalBranchMask ) )
+            {
+                value = ( BLR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
+            }
+            else {
+                value = ( BR  | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
+            } // BLR or BL
+
+            retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, value );
+        } // Assembler_WriteInstruction_LDR()
+    } // Assembler_CreateRelocationData()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_WriteToBuffer_LiteralLoadRegisterFixed
+    (
+        IN          const relocation_context_t* Context,
+        IN  OUT     assembler_t*                Assembler,
+        IN          const uint32_t              Instruction
+    )
+{
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    uintptr_t           cursorOffset    = 0;
+    LoadStoreOp         op              = 0;
+    register_data_t     rt              = { 0 };
+
+    __NOT_NULL( Context, Assembler )
+    __GREATER_THAN_0( Instruction )
+
+    cursorOffset    = INTERNAL_GetContextCursor( Context ) + Imm19Offset( Instruction );
+    op              = gLiteralLoadOps[ ( GET_BITS( Instruction, 30, 31 ) << 1 ) | GET_BIT( Instruction, 26 ) ];
+    rt              = X( GET_BITS( Instruction, 0, 4 ) );
+
+    if( 0 == op )
+    {
+        // Unallocated, it faults wherever it runs
+        retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, Instruction );
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_LoadAddress( Assembler,
+                                                                (register_data_t*) &TMP_REG_0,
+                                                                cursorOffset ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_LoadAddress() Failed\n" );
+    }
+    else {
+        // `Rt` is the register, or the `PRFM` operation
+        retVal = Assembler_LoadStore( &Assembler->Buffer,
+                                      op,
+                                      &rt,
+                                      &MEMOP_ADDR( AddrModeOffset ) );
+    } // Assembler_LoadAddress()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_WriteToBuffer_PCRelAddressingFixed_ADR
+    (
+        IN          const relocation_context_t* Context,
+        OUT         assembler_t*                Assembler,
+        IN          const uint32_t              Instruction
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    uintptr_t       cursorOffset    = 0;
+    int             rd              = 0;
+
+    __NOT_NULL( Context, Assembler )
+    __GREATER_THAN_0( Instruction )
+
+    cursorOffset = INTERNAL_GetContextCursor( Context ) + ImmHiImmLoOffset( Instruction );
+    rd = GET_BITS( Instruction, 0, 4 );
+
+    retVal = Assembler_LoadAddress( Assembler,
+                                    &X( rd ),
+                                    cursorOffset );
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_WriteToBuffer_PCRelAddressingFixed_ADRP
+    (
+        IN          const relocation_context_t* Context,
+        OUT         assembler_t*                Assembler,
+        IN          const uint32_t              Instruction
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    uintptr_t       cursorOffset    = 0;
+    int             rd              = 0;
+
+    __NOT_NULL( Context, Assembler )
+    __GREATER_THAN_0( Instruction )
+
+    cursorOffset = INTERNAL_GetContextCursor( Context ) + ImmHiImmLoZero12Offset( Instruction );
+    cursorOffset = arm64_trunc_page( cursorOffset );
+    rd = GET_BITS( Instruction, 0, 4 );
+
+    retVal = Assembler_LoadAddress( Assembler,
+                                    &X( rd ),
+                                    cursorOffset );
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_WriteToBuffer_ConditionalBranchFixed
+    (
+        IN          const relocation_context_t* Context,
+        IN  OUT     assembler_t*                Assembler,
+        IN          const uint32_t              Instruction
+    )
+{
+    BWSR_STATUS             retVal              = ERROR_FAILURE;
+    uintptr_t               cursorOffset        = 0;
+    uint32_t                instruction         = 0;
+    char                    bitSetPos           = 0;
+    relocation_data_t*      relocationData      = NULL;
+    uint32_t                value               = 0;
+
+    __NOT_NULL( Context, Assembler )
+    __GREATER_THAN_0( Instruction )
+
+    cursorOffset    = INTERNAL_GetContextCursor( Context ) + Imm19Offset( Instruction );
+    instruction     = Instruction;
+    bitSetPos       = GET_BITS( Instruction, 0, 3 ) ^ 1;
+
+    // `BC.cond` keeps bit 4, the inverted branch is a hint as well
+    SET_BITS( instruction, 0, 3, bitSetPos );
+    SET_BITS( instruction, 5, 23, 3 );
+
+    if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &relocationData,
+                                                                    Assembler,
+                                                                    cursorOffset ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+    }
+    else {
+        // `AL` and `NV` both always branch, neither can be inverted
+        if( 0b1110 != ( Instruction & 0b1110 ) )
+        {
+            retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, instruction );
+        }
+
+        if( ERROR_SUCCESS != retVal )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+        }
+        else {
+            if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
+                                                                            (register_data_t*) &TMP_REG_0,
+                                                                            relocationData ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+            }
+            else {
+                value  = ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
+                retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, value );
+            } // Assembler_WriteInstruction_LDR()
+        } // Assembler_Write32BitInstruction()
+    } // Assembler_CreateRelocationData()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_WriteToBuffer_CompareBranchFixed
+    (
+        IN          const relocation_context_t* Context,
+        IN  OUT     assembler_t*                Assembler,
+        IN          const uint32_t              Instruction
+    )
+{
+    BWSR_STATUS             retVal              = ERROR_FAILURE;
+    uintptr_t               cursorOffset        = 0;
+    uint32_t                instruction         = 0;
+    char                    op                  = 0;
+    relocation_data_t*      relocationData      = NULL;
+    uint32_t                value               = 0;
+
+    __NOT_NULL( Context, Assembler )
+    __GREATER_THAN_0( Instruction )
+
+    cursorOffset    = INTERNAL_GetContextCursor( Context ) + Imm19Offset( Instruction );
+    instruction     = Instruction;
+    op              = GET_BIT( Instruction, 24 ) ^ 1;
+
+    SET_BIT( instruction, 24, op );
+    SET_BITS( instruction, 5, 23, 3 );
+
+    if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &relocationData,
+                                                                    Assembler,
+                                                                    cursorOffset ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+    }
+    else {
+        if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, instruction ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+        }
+        else {
+            if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
+                                                                            (register_data_t*) &TMP_REG_0,
+                                                                            relocationData ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+            }
+            else {
+                value  = ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
+                retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, value );
+            } // Assembler_WriteInstruction_LDR()
+        } // Assembler_Write32BitInstruction()
+    } // Assembler_CreateRelocationData()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_WriteToBuffer_TestBranchFixed
+    (
+        IN          const relocation_context_t* Context,
+        IN  OUT     assembler_t*                Assembler,
+        IN          const uint32_t              Instruction
+    )
+{
+    BWSR_STATUS             retVal              = ERROR_FAILURE;
+    uintptr_t               cursorOffset        = 0;
+    uint32_t                instruction         = 0;
+    char                    op                  = 0;
+    relocation_data_t*      relocationData      = NULL;
+    uint32_t                value               = 0;
+
+    __NOT_NULL( Context, Assembler );
+    __GREATER_THAN_0( Instruction );
+
+    cursorOffset    = INTERNAL_GetContextCursor( Context ) + Imm14Offset( Instruction );
+    instruction     = Instruction;
+    op              = GET_BIT( Instruction, 24 ) ^ 1;
+
+    SET_BIT( instruction, 24, op );
+    SET_BITS( instruction, 5, 18, 3 );
+
+    if( ERROR_SUCCESS != ( retVal = Assembler_CreateRelocationData( &relocationData,
+                                                                    Assembler,
+                                                                    cursorOffset ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_CreateRelocationData() Failed\n" );
+    }
+    else {
+        if( ERROR_SUCCESS != ( retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, instruction ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Assembler_Write32BitInstruction() Failed\n" );
+        }
+        else {
+            if( ERROR_SUCCESS != ( retVal = Assembler_WriteInstruction_LDR( &Assembler->Buffer,
+                                                                            (register_data_t*) &TMP_REG_0,
+                                                                            relocationData ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "Assembler_WriteInstruction_LDR() Failed\n" );
+            }
+            else {
+                value  = ( BR | ( ARM64_TMP_REG_NDX_0 << kRnShift ) );
+                retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, value );
+            } // Assembler_WriteInstruction_LDR()
+        } // Assembler_Write32BitInstruction()
+    } // Assembler_CreateRelocationData()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleBuffer
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN  OUT     relocation_context_t*       Context
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_SUCCESS;
+    uint32_t        instruction     = 0;
+    size_t          ndx             = 0;
+
+    __NOT_NULL( Assembler, Context );
+
+    while( ( ( Context->Cursor - Context->BaseAddress->Start ) < Context->BaseAddress->Size ) &&
+           ( ERROR_SUCCESS == retVal ) )
+    {
+        instruction = *(uint32_t *)INTERNAL_GetContextCursor( Context );
+        ndx         = ( Context->Cursor - Context->BaseAddress->Start ) / sizeof( uint32_t );
+
+        if( ( NULL != Context->InstructionOffsets        ) &&
+            ( ndx  <  INTERCEPTOR_MAX_PATCH_INSTRUCTIONS ) )
+        {
+            Context->InstructionOffsets[ ndx ] = Assembler->Buffer.BufferSize;
+        }
+
+        switch( gInstructionClasses[ instruction >> 24 ] )
+        {
+            case kInstructionUnconditionalBranch:
+            {
+                retVal = INTERNAL_WriteToBuffer_UnconditionalBranchFixed( Context,
+                                                                          Assembler,
+                                                                          instruction );
+                break;
+            }
+
+            case kInstructionLiteralLoad:
+            {
+                retVal = INTERNAL_WriteToBuffer_LiteralLoadRegisterFixed( Context,
+                                                                          Assembler,
+                                                                          instruction );
+                break;
+            }
+
+            case kInstructionADR:
+            {
+                retVal = INTERNAL_WriteToBuffer_PCRelAddressingFixed_ADR( Context,
+                                                                          Assembler,
+                                                                          instruction );
+                break;
+            }
+
+            case kInstructionADRP:
+            {
+                retVal = INTERNAL_WriteToBuffer_PCRelAddressingFixed_ADRP( Context,
+                                                                           Assembler,
+                                                                           instruction );
+                break;
+            }
+
+            case kInstructionConditionalBranch:
+            {
+                retVal = INTERNAL_WriteToBuffer_ConditionalBranchFixed( Context,
+                                                                        Assembler,
+                                                                        instruction );
+                break;
+            }
+
+            case kInstructionCompareBranch:
+            {
+                retVal = INTERNAL_WriteToBuffer_CompareBranchFixed( Context,
+                                                                    Assembler,
+                                                                    instruction );
+                break;
+            }
+
+            case kInstructionTestBranch:
+            {
+                retVal = INTERNAL_WriteToBuffer_TestBranchFixed( Context,
+                                                                 Assembler,
+                                                                 instruction );
+                break;
+            }
+
+            default:
+            {
+                retVal = Assembler_Write32BitInstruction( &Assembler->Buffer, instruction );
+                break;
+            }
+        } // switch()
+
+        Context->Cursor += sizeof( uint32_t );
+    } // while()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleRelocated
+    (
+        IN  OUT     assembler_t*                Assembler,
+        IN  OUT     relocation_context_t*       Context,
+        IN          const bool                  Branch
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+
+    __NOT_NULL( Assembler, Context )
+
+    Context->Cursor = Context->BaseAddress->Start;
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleBuffer( Assembler, Context ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleBuffer() Failed\n" );
+    }
+    else {
+        Context->BaseAddress->Size = ( Context->Cursor - Context->BaseAddress->Start );
+
+        // TODO: if last instr is unlink branch, ignore it
+        if( true == Branch )
+        {
+            retVal = Assembler_LiteralLdrBranch( Assembler, INTERNAL_GetContextCursor( Context ) );
+        }
+
+        if( ERROR_SUCCESS == retVal )
+        {
+            retVal = Assembler_WriteRelocationDataToPageBuffer( Assembler );
+        } // Assembler_LiteralLdrBranch()
+    } // INTERNAL_CodeBuilder_AssembleBuffer()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_CodeBuilder_AssembleAndPatch
+    (
+        IN          const intercept_routing_t*  Routing,
+        IN  OUT     memory_range_t*             BaseAddress,
+        OUT         memory_range_t*             Relocated,
+        IN          const bool                  Branch
+    )
+{
+    BWSR_STATUS             retVal          = ERROR_FAILURE;
+    assembler_t             assembler       = { 0 };
+    assembler_arena_t       arena;
+    relocation_context_t    context         = { 0 };
+    memory_range_t*         block           = NULL;
+
+    __NOT_NULL( Routing,
+                BaseAddress,
+                Relocated )
+
+    context.BaseAddress = BaseAddress;
+
+    if( NULL != Routing->InterceptEntry )
+    {
+        context.InstructionOffsets = Routing->InterceptEntry->RelocatedOffsets;
+    }
+
+    if( ERROR_SUCCESS != ( retVal = Assembler_InitializeWithArena( &assembler, 0, &arena ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_InitializeWithArena() Failed\n" );
+        return retVal;
+    }
+
+    // Position independent code is never shorter than the code
+    // assembled at its final address, it sizes the block
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleRelocated( &assembler,
+                                                                            &context,
+                                                                            Branch ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleRelocated() Failed\n" );
+    }
+    else if( ( ERROR_SUCCESS != MemoryAllocator_AllocateNearExecutionBlock( &block,
+                                                                            &gMemoryAllocator,
+                                                                            assembler.Buffer.BufferSize,
+                                                                            BaseAddress->Start,
+                                                                            ARM64_ADRP_RANGE - 0x1000 ) ) &&
+             ( ERROR_SUCCESS != ( retVal = MemoryAllocator_AllocateExecutionBlock( &block,
+                                                                                   &gMemoryAllocator,
+                                                                                   assembler.Buffer.BufferSize ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "MemoryAllocator_AllocateExecutionBlock() Failed\n" );
+    }
+    else {
+        (void) Assembler_Release( &assembler );
+        (void) Assembler_InitializeWithArena( &assembler, block->Start, &arena );
+
+        assembler.FixedMemoryRange = (uintptr_t) block;
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleRelocated( &assembler,
+                                                                                &context,
+                                                                                Branch ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleRelocated() Failed\n" );
+        }
+        else if( block->Size < assembler.Buffer.BufferSize )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Relocated code outgrew its block\n" );
+            retVal = ERROR_MEMORY_OVERFLOW;
+        }
+        else if( ERROR_SUCCESS != ( retVal = MemoryAllocator_ShrinkExecutionBlock( &gMemoryAllocator,
+                                                                                   block,
+                                                                                   assembler.Buffer.BufferSize ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "MemoryAllocator_ShrinkExecutionBlock() Failed\n" );
+        }
+
+        if( ERROR_SUCCESS != retVal )
+        {
+            (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator, block );
+        }
+        else {
+            // Frees `block` itself on failure
+            retVal = INTERNAL_CodeBuilder_ApplyAssemblerPagePatch( Routing,
+                                                                   &assembler,
+                                                                   Relocated );
+        } // ERROR_SUCCESS != retVal
+    } // INTERNAL_CodeBuilder_AssembleRelocated()
+
+    (void) Assembler_Release( &assembler );
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_InterceptRouting_Initialize
+    (
+        OUT         intercept_routing_t**       Routing,
+        IN          interceptor_entry_t*        Entry,
+        IN          uintptr_t                   FakeFunction
+    )
+{
+    BWSR_STATUS retVal = ERROR_FAILURE;
+
+    __NOT_NULL( Routing, Entry )
+    __GREATER_THAN_0( FakeFunction )
+
+    if( NULL == ( *Routing = (intercept_routing_t*) BwsrMalloc( sizeof( intercept_routing_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "malloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_SetMemoryProtectionFunction( (uintptr_t*) &( *Routing )->MemoryProtectFn ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_SetMemoryProtectionFunction() Failed\n" );
+            BwsrFree( *Routing );
+        }
+        else {
+            ( *Routing )->InterceptEntry     = Entry;
+            ( *Routing )->Trampoline         = NULL;
+            ( *Routing )->HookFunction       = FakeFunction;
+        } // INTERNAL_SetMemoryProtectionFunction()
+    } // BwsrMalloc()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ApplyTrampolineCodePatch
+    (
+        IN  OUT     intercept_routing_t*        Routing
+    )
+{
+    BWSR_STATUS             retVal              = ERROR_FAILURE;
+    size_t                  trampolineSize      = 0;
+    uintptr_t               bufferStart         = 0;
+    thread_suspension_t     suspension          = { 0 };
+
+    __NOT_NULL( Routing );
+
+    trampolineSize  = Routing->Trampoline->Buffer.Size;
+    bufferStart     = Routing->Trampoline->Buffer.Start;
+
+    BWSR_DEBUG( LOG_NOTICE, "Patching Trampoline into Intercept Address...\n" );
+
+    if( true == Routing->InterceptEntry->Staged )
+    {
+        // Threads are parked once the transaction commits
+        retVal = INTERNAL_ApplyCodePatch( Routing,
+                                          (void*) Routing->InterceptEntry->Address,
+                                          (uint8_t*) bufferStart,
+                                          trampolineSize );
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_SafePatch_Begin( &suspension ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_SafePatch_Begin() Failed\n" );
+    }
+    else {
+        INTERNAL_SafePatch_RelocateThreads( &suspension,
+                                            Routing->InterceptEntry,
+                                            false );
+
+        retVal = INTERNAL_ApplyCodePatch( Routing,
+                                          (void*) Routing->InterceptEntry->Address,
+                                          (uint8_t*) bufferStart,
+                                          trampolineSize );
+
+        INTERNAL_SafePatch_End( &suspension );
+    } // Staged
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_GenerateRelocatedCode
+    (
+        IN  OUT     intercept_routing_t*        Routing
+    )
+{
+    BWSR_STATUS     retVal              = ERROR_FAILURE;
+    size_t          trampolineSize      = 0;
+    uintptr_t       bufferStart         = 0;
+
+    __NOT_NULL( Routing );
+
+    trampolineSize  = Routing->Trampoline->Buffer.Size;
+    bufferStart     = Routing->Trampoline->Buffer.Start;
+
+    if( bufferStart == 0 )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Routing failed. Cannot continue\n" );
+        retVal = ERROR_ROUTING_FAILURE;
+    }
+    else {
+        Routing->InterceptEntry->Patched.Start      = Routing->InterceptEntry->Address;
+        Routing->InterceptEntry->Patched.Size       = trampolineSize;
+        Routing->InterceptEntry->Relocated.Start    = 0;
+        Routing->InterceptEntry->Relocated.Size     = 0;
+
+        retVal = INTERNAL_CodeBuilder_AssembleAndPatch( Routing,
+                                                        &Routing->InterceptEntry->Patched,
+                                                        &Routing->InterceptEntry->Relocated,
+                                                        true );
+
+        if( ( ERROR_SUCCESS == retVal                                  ) &&
+            ( 0             == Routing->InterceptEntry->Relocated.Size ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "Routing failed. Cannot continue\n" );
+            retVal = ERROR_ROUTING_FAILURE;
+        }
+    }
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_GenerateTrampoline
+    (
+        IN  OUT     intercept_routing_t*        Routing
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+
+    __NOT_NULL( Routing );
+
+    // Calls go to the handlers until the hook is disabled
+    INTERNAL_InterceptorEntry_PublishDispatch( Routing->InterceptEntry );
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_Trampoline_InitializeDispatch( Routing ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_Trampoline_InitializeDispatch() Failed\n" );
+    }
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_BuildRoutingAndActivateHook
+    (
+        IN  OUT     intercept_routing_t*        Routing,
+        OUT         void**                      Original
+    )
+{
+    BWSR_STATUS retVal = ERROR_FAILURE;
+
+    __NOT_NULL( Routing );
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_GenerateTrampoline( Routing ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_GenerateTrampoline() Failed\n" );
+    }
+    else {
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_GenerateRelocatedCode( Routing ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_GenerateRelocatedCode() Failed\n" );
+        }
+        else {
+            // The oldest handler continues into the relocated
+            // code, before any call can reach it
+            Routing->InterceptEntry->Handlers->Next = Routing->InterceptEntry->Relocated.Start;
+
+            INTERNAL_HookHandler_PublishOriginal( Routing->InterceptEntry,
+                                                  Routing->InterceptEntry->Handlers,
+                                                  Original );
+
+            if( ERROR_SUCCESS != ( retVal = INTERNAL_BackupOriginalCode( Routing->InterceptEntry ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "INTERNAL_BackupOriginalCode() Failed\n" );
+            }
+            else {
+                if( ERROR_SUCCESS != ( retVal = INTERNAL_ApplyTrampolineCodePatch( Routing ) ) )
+                {
+                    BWSR_DEBUG( LOG_ERROR, "INTERNAL_ApplyTrampolineCodePatch() Failed\n" );
+                    BwsrFree( Routing->InterceptEntry->OriginalCode );
+                }
+            } // INTERNAL_BackupOriginalCode()
+        } // INTERNAL_GenerateRelocatedCode()
+
+        if( ERROR_SUCCESS != retVal )
+        {
+            if( 0 != Routing->Trampoline->Dispatch.Start )
+            {
+                (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator,
+                                                           &Routing->Trampoline->Dispatch );
+            }
+
+            BwsrFree( (void*) Routing->Trampoline->Buffer.Start );
+            BwsrFree( Routing->Trampoline );
+        }
+    } // INTERNAL_GenerateTrampoline()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_InterceptorTracker_Initialize
+    (
+        OUT         interceptor_tracker_t**     Tracker
+    )
+{
+    BWSR_STATUS retVal = ERROR_FAILURE;
+
+    __NOT_NULL( Tracker )
+
+    if( NULL == ( *Tracker = (interceptor_tracker_t*) BwsrMalloc( sizeof( interceptor_tracker_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        if( NULL == ( ( *Tracker )->Entry = (interceptor_entry_t*) BwsrCalloc( 1, sizeof( interceptor_entry_t ) ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+            retVal = ERROR_MEM_ALLOC;
+            BwsrFree( *Tracker );
+        }
+        else {
+            ( *Tracker )->Next                  = &gInterceptorTracker;
+            ( *Tracker )->Previous              = gInterceptorTracker.Previous;
+            gInterceptorTracker.Previous->Next  = *Tracker;
+            gInterceptorTracker.Previous        = *Tracker;
+
+            retVal = ERROR_SUCCESS;
+        } // BwsrMalloc( InterceptorEntry )
+    } // BwsrMalloc( InterceptorTracker )
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_MemoryAllocator_CheckInterceptorRelease
+    (
+        void
+    )
+{
+    if( gInterceptorTracker.Next == &gInterceptorTracker )
+    {
+        // Retired stubs are never freed, their pages stay mapped
+        if( ( NULL == gRetiredHandlers        ) &&
+            ( NULL == gRetiredInstrumentation ) )
+        {
+            MemoryAllocator_Release( &gMemoryAllocator );
+        }
+
+        if( NULL != gInterceptorRegistry.Slots )
+        {
+            BwsrFree( gInterceptorRegistry.Slots );
+
+            gInterceptorRegistry.Slots      = NULL;
+            gInterceptorRegistry.Capacity   = 0;
+            gInterceptorRegistry.Count      = 0;
+            gInterceptorRegistry.Tombstones = 0;
+        } // Slots
+    } // gInterceptorTracker
+}
+
+static
+void
+    INTERNAL_InterceptorTracker_Release
+    (
+        IN  OUT     interceptor_tracker_t*      Tracker
+    )
+{
+    __NOT_NULL_RETURN_VOID( Tracker );
+
+    if( NULL != Tracker->Entry )
+    {
+        INTERNAL_InterceptorRegistry_Remove( Tracker );
+
+        if( Tracker->Entry->Staged )
+        {
+            INTERNAL_HookTransaction_DropPatches( Tracker->Entry );
+        }
+
+        if( NULL != Tracker->Entry->Routing )
+        {
+            if( NULL != Tracker->Entry->Routing->Trampoline )
+            {
+                if( Tracker->Entry->Routing->Trampoline->Dispatch.Start )
+                {
+                    (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator,
+                                                               &Tracker->Entry->Routing->Trampoline->Dispatch );
+                } // Tracker->Entry->Routing->Trampoline->Dispatch.Start
+
+                if( Tracker->Entry->Routing->Trampoline->Buffer.Start )
+                {
+                    BwsrFree( (void*)Tracker->Entry->Routing->Trampoline->Buffer.Start );
+                } // Tracker->Entry->Routing->Trampoline->Buffer.Start
+
+                BwsrFree( Tracker->Entry->Routing->Trampoline );
+                Tracker->Entry->Routing->Trampoline = NULL;
+            } // NULL != Tracker->Entry->Routing->Trampoline
+
+            BwsrFree( Tracker->Entry->Routing );
+            Tracker->Entry->Routing = NULL;
+        } // NULL != Tracker->Entry->Routing
+
+        if( NULL != Tracker->Entry->OriginalCode )
+        {
+            BwsrFree( Tracker->Entry->OriginalCode );
+            Tracker->Entry->OriginalCode = NULL;
+        } // NULL != Tracker->Entry->OriginalCode
+
+        while( NULL != Tracker->Entry->Handlers )
+        {
+            INTERNAL_HookHandler_Remove( Tracker->Entry, Tracker->Entry->Handlers );
+        } // while()
+
+        if( NULL != Tracker->Entry->Statistics )
+        {
+            INTERNAL_HookHandler_Retire( Tracker->Entry->Statistics );
+            Tracker->Entry->Statistics = NULL;
+        } // NULL != Tracker->Entry->Statistics
+
+        if( 0 != Tracker->Entry->Relocated.Start )
+        {
+            (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator,
+                                                       &Tracker->Entry->Relocated );
+        } // Tracker->Entry->Relocated.Start
+
+        BwsrFree( Tracker->Entry );
+    } // NULL != Tracker->Entry
+
+    Tracker->Previous->Next     = Tracker->Next;
+    Tracker->Next->Previous     = Tracker->Previous;
+    Tracker->Next               = NULL;
+    Tracker->Previous           = NULL;
+
+    BwsrFree( Tracker );
+
+    INTERNAL_MemoryAllocator_CheckInterceptorRelease();
+}
+
+static
+size_t
+    INTERNAL_InterceptorRegistry_Hash
+    (
+        IN          const uintptr_t             Address
+    )
+{
+    uint64_t        hash                = 0;
+
+    // Instructions are 4 byte aligned, drop the constant bits
+    hash  = (uint64_t)( Address >> 2 ) * 0x9E3779B97F4A7C15ULL;
+    hash ^= ( hash >> 29 );
+
+    return (size_t)( hash & ( gInterceptorRegistry.Capacity - 1 ) );
+}
+
+static
+BWSR_STATUS
+    INTERNAL_InterceptorRegistry_Resize
+    (
+        IN          const size_t                Capacity
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t** oldSlots    = gInterceptorRegistry.Slots;
+    size_t                  oldCapacity = gInterceptorRegistry.Capacity;
+    interceptor_tracker_t** slots       = NULL;
+    size_t                  ndx         = 0;
+    size_t                  slot        = 0;
+
+    if( NULL == ( slots = (interceptor_tracker_t**) BwsrCalloc( Capacity, sizeof( interceptor_tracker_t* ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        gInterceptorRegistry.Slots      = slots;
+        gInterceptorRegistry.Capacity   = Capacity;
+        gInterceptorRegistry.Tombstones = 0;
+
+        for( ndx = 0; ndx < oldCapacity; ndx++ )
+        {
+            if( ( NULL                           != oldSlots[ ndx ] ) &&
+                ( INTERCEPTOR_REGISTRY_TOMBSTONE != oldSlots[ ndx ] ) )
+            {
+                slot = INTERNAL_InterceptorRegistry_Hash( oldSlots[ ndx ]->Entry->Address );
+
+                while( NULL != slots[ slot ] )
+                {
+                    slot = ( slot + 1 ) & ( Capacity - 1 );
+                } // while()
+
+                slots[ slot ] = oldSlots[ ndx ];
+            } // Live slot
+        } // for()
+
+        if( NULL != oldSlots )
+        {
+            BwsrFree( oldSlots );
+        }
+
+        retVal = ERROR_SUCCESS;
+    } // BwsrCalloc()
+
+    return retVal;
+}
+
+static
+size_t
+    INTERNAL_InterceptorRegistry_FindSlot
+    (
+        IN          const uintptr_t             Address
+    )
+{
+    size_t                  retVal      = gInterceptorRegistry.Capacity;
+    size_t                  slot        = 0;
+    size_t                  probes      = 0;
+    interceptor_tracker_t*  tracker     = NULL;
+
+    if( 0 != gInterceptorRegistry.Capacity )
+    {
+        slot = INTERNAL_InterceptorRegistry_Hash( Address );
+
+        for( probes = 0; probes < gInterceptorRegistry.Capacity; probes++ )
+        {
+            if( NULL == ( tracker = gInterceptorRegistry.Slots[ slot ] ) )
+            {
+                break;
+            }
+
+            if( ( INTERCEPTOR_REGISTRY_TOMBSTONE != tracker                 ) &&
+                ( Address                        == tracker->Entry->Address ) )
+            {
+                retVal = slot;
+                break;
+            }
+
+            slot = ( slot + 1 ) & ( gInterceptorRegistry.Capacity - 1 );
+        } // for()
+    } // Capacity
+
+    // `Capacity` when not found
+    return retVal;
+}
+
+static
+interceptor_tracker_t*
+    INTERNAL_InterceptorRegistry_Find
+    (
+        IN          const uintptr_t             Address
+    )
+{
+    interceptor_tracker_t*  retVal      = NULL;
+    size_t                  slot        = 0;
+
+    if( ( slot = INTERNAL_InterceptorRegistry_FindSlot( Address ) ) < gInterceptorRegistry.Capacity )
+    {
+        retVal = gInterceptorRegistry.Slots[ slot ];
+    }
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_InterceptorRegistry_Insert
+    (
+        IN  OUT     interceptor_tracker_t*      Tracker
+    )
+{
+    BWSR_STATUS     retVal              = ERROR_FAILURE;
+    size_t          capacity            = INTERCEPTOR_REGISTRY_MIN_CAPACITY;
+    size_t          slot                = 0;
+
+    __NOT_NULL( Tracker, Tracker->Entry );
+
+    retVal = ERROR_SUCCESS;
+
+    // Keep the load, tombstones included, at one half at most
+    if( ( ( gInterceptorRegistry.Count + gInterceptorRegistry.Tombstones + 1 ) * 2 ) > gInterceptorRegistry.Capacity )
+    {
+        while( capacity < ( ( gInterceptorRegistry.Count + 1 ) * 4 ) )
+        {
+            capacity <<= 1;
+        } // while()
+
+        retVal = INTERNAL_InterceptorRegistry_Resize( capacity );
+    } // Load factor
+
+    if( ERROR_SUCCESS != retVal )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_InterceptorRegistry_Resize() Failed\n" );
+    }
+    else {
+        // Hooking a hooked address adds a handler instead,
+        // every address is registered once
+        slot = INTERNAL_InterceptorRegistry_Hash( Tracker->Entry->Address );
+
+        while( ( NULL                           != gInterceptorRegistry.Slots[ slot ] ) &&
+               ( INTERCEPTOR_REGISTRY_TOMBSTONE != gInterceptorRegistry.Slots[ slot ] ) )
+        {
+            slot = ( slot + 1 ) & ( gInterceptorRegistry.Capacity - 1 );
+        } // while()
+
+        if( INTERCEPTOR_REGISTRY_TOMBSTONE == gInterceptorRegistry.Slots[ slot ] )
+        {
+            gInterceptorRegistry.Tombstones--;
+        }
+
+        gInterceptorRegistry.Slots[ slot ] = Tracker;
+        gInterceptorRegistry.Count++;
+    } // INTERNAL_InterceptorRegistry_Resize()
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_InterceptorRegistry_Remove
+    (
+        IN  OUT     interceptor_tracker_t*      Tracker
+    )
+{
+    size_t                  slot        = 0;
+
+    __NOT_NULL_RETURN_VOID( Tracker, Tracker->Entry );
+
+    slot = INTERNAL_InterceptorRegistry_FindSlot( Tracker->Entry->Address );
+
+    // Never registered, e.g. a failed installation
+    if( ( slot                               <  gInterceptorRegistry.Capacity ) &&
+        ( gInterceptorRegistry.Slots[ slot ] == Tracker                       ) )
+    {
+        gInterceptorRegistry.Slots[ slot ] = INTERCEPTOR_REGISTRY_TOMBSTONE;
+        gInterceptorRegistry.Count--;
+        gInterceptorRegistry.Tombstones++;
+    } // Slots
+}
+
+static
+BWSR_STATUS
+    INTERNAL_InterceptorEntry_Initialize
+    (
+        OUT         interceptor_entry_t**       Entry
+    )
+{
+    BWSR_STATUS             retVal          = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker         = NULL;
+
+    __NOT_NULL( Entry )
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_InterceptorTracker_Initialize( &tracker ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_InterceptorTracker_Initialize() Failed\n" );
+    }
+    else {
+        *Entry = tracker->Entry;
+    } // INTERNAL_InterceptorTracker_Initialize()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_SetMemoryProtectionFunction
+    (
+        OUT         uintptr_t*      MemoryProtectFn
+    )
+{
+    BWSR_STATUS retVal = ERROR_FAILURE;
+
+#if defined( __APPLE__ )
+    if( ERROR_SUCCESS != ( retVal = BWSR_ResolveSymbol( "vm_protect",
+                                                        "dyld",
+                                                        MemoryProtectFn ) ) )
+    {
+        retVal = BWSR_ResolveSymbol( "_vm_protect",
+                                     "libsystem_kernel",
+                                     MemoryProtectFn );
+    } // BWSR_ResolveSymbol()
+#else
+    *MemoryProtectFn = (uintptr_t)mprotect;
+    retVal = ERROR_SUCCESS;
+#endif
+
+    return retVal;
+}
+
+static
+uintptr_t
+    INTERNAL_InterceptorEntry_GetDispatch
+    (
+        IN          const interceptor_entry_t*  Entry
+    )
+{
+    uintptr_t       retVal              = 0;
+
+    if( ( false == Entry->Disabled ) &&
+        ( NULL  != Entry->Handlers ) )
+    {
+        retVal = Entry->Handlers->HookFunctionAddress;
+    }
+    else {
+        retVal = Entry->Relocated.Start;
+    } // Disabled
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_InterceptorEntry_PublishDispatch
+    (
+        IN  OUT     interceptor_entry_t*        Entry
+    )
+{
+    uintptr_t       dispatch            = 0;
+
+    __NOT_NULL_RETURN_VOID( Entry );
+
+    dispatch = INTERNAL_InterceptorEntry_GetDispatch( Entry );
+
+    // Enabled statistics go in front of the handlers. The stub
+    // continues wherever the entry would have dispatched, also
+    // for calls that entered it before it was disabled.
+    if( NULL != Entry->Statistics )
+    {
+        __atomic_store_n( &Entry->Statistics->Next, dispatch, __ATOMIC_RELEASE );
+
+        if( true == Entry->StatisticsEnabled )
+        {
+            dispatch = Entry->Statistics->HookFunctionAddress;
+        }
+    } // Statistics
+
+    __atomic_store_n( &Entry->Dispatch, dispatch, __ATOMIC_RELEASE );
+}
+
+static
+BWSR_STATUS
+    INTERNAL_SafePatch_Begin
+    (
+        OUT         thread_suspension_t*        Suspension
+    )
+{
+    BWSR_STATUS     retVal              = ERROR_FAILURE;
+
+    __NOT_NULL( Suspension );
+
+    memset( Suspension, 0, sizeof( thread_suspension_t ) );
+
+    if( false == gSafePatching )
+    {
+        retVal = ERROR_SUCCESS;
+    }
+    else if( ERROR_SUCCESS != ( retVal = ThreadSuspend_SuspendOthers( Suspension ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "ThreadSuspend_SuspendOthers() Failed\n" );
+    } // gSafePatching
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_SafePatch_RelocateThreads
+    (
+        IN  OUT     thread_suspension_t*        Suspension,
+        IN          const interceptor_entry_t*  Entry,
+        IN          const bool                  Restoring
+    )
+{
+    uintptr_t       targets[ INTERCEPTOR_MAX_PATCH_INSTRUCTIONS ] = { 0 };
+    size_t          count               = 0;
+    size_t          ndx                 = 0;
+
+    __NOT_NULL_RETURN_VOID( Suspension, Entry );
+
+    count = Entry->Patched.Size / sizeof( uint32_t );
+
+    if( ( 0     != Suspension->ThreadCount        ) &&
+        ( count <= INTERCEPTOR_MAX_PATCH_INSTRUCTIONS ) )
+    {
+        for( ndx = 0; ndx < count; ndx++ )
+        {
+            // Restored code is entered from the top again, the patch
+            // only clobbered the intra procedure call register.
+            // Otherwise resume at the relocated copy of the instruction.
+            targets[ ndx ] = ( Restoring )
+                                ? Entry->Address
+                                : ( Entry->Relocated.Start + Entry->RelocatedOffsets[ ndx ] );
+        } // for()
+
+        (void) ThreadSuspend_RelocateThreads( Suspension,
+                                              Entry->Patched.Start,
+                                              Entry->Patched.Size,
+                                              targets );
+    } // ThreadCount
+}
+
+static
+void
+    INTERNAL_SafePatch_End
+    (
+        IN  OUT     thread_suspension_t*        Suspension
+    )
+{
+    __NOT_NULL_RETURN_VOID( Suspension );
+
+    if( NULL != Suspension->Threads )
+    {
+        ThreadSuspend_ResumeOthers( Suspension );
+    }
+}
+
+static
+uintptr_t
+    INTERNAL_HookHandler_GetOriginal
+    (
+        IN          const interceptor_entry_t*  Entry,
+        IN          const hook_handler_t*       Handler
+    )
+{
+    uintptr_t       retVal              = 0;
+
+    if( 0 != Handler->CallNext.Start )
+    {
+        retVal = Handler->CallNext.Start;
+    }
+    else if( NULL != Handler->Older )
+    {
+        // Instrumentation, the stub itself calls the next handler
+        retVal = Handler->Older->HookFunctionAddress;
+    }
+    else {
+        retVal = Entry->Relocated.Start;
+    } // CallNext
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_HookHandler_PublishOriginal
+    (
+        IN          const interceptor_entry_t*  Entry,
+        IN          const hook_handler_t*       Handler,
+        OUT         void**                      Original
+    )
+{
+    void*           original            = NULL;
+
+    // Not every caller wants the original
+    if( NULL != Original )
+    {
+        original = (void*) INTERNAL_HookHandler_GetOriginal( Entry, Handler );
+
+#if __has_feature( ptrauth_calls )
+        original = (void*) ptrauth_sign_unauthenticated( original, ptrauth_key_asia, 0 );
+#endif
+
+        // The handler may run as soon as it is reachable,
+        // it must never see its original unset
+        __atomic_store_n( Original, original, __ATOMIC_RELEASE );
+    } // Original
+}
+
+static
+BWSR_STATUS
+    INTERNAL_HookHandler_Add
+    (
+        IN  OUT     interceptor_entry_t*        Entry,
+        IN  OUT     hook_handler_t*             Handler,
+        OUT         void**                      Original
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    assembler_t             assembler   = { 0 };
+    assembler_arena_t       arena;
+    intercept_routing_t     routing     = { 0 };
+
+    __NOT_NULL( Entry, Handler );
+    __GREATER_THAN_0( Handler->HookFunctionAddress );
+
+    Handler->Older = Entry->Handlers;
+
+    if( NULL == Handler->Older )
+    {
+        // Set again once the original code is relocated
+        Handler->Next   = Entry->Relocated.Start;
+        retVal          = ERROR_SUCCESS;
+    }
+    else if( NULL != Handler->Instrumentation )
+    {
+        // The instrumentation stub already jumps through `Next`
+        Handler->Next   = Handler->Older->HookFunctionAddress;
+        retVal          = ERROR_SUCCESS;
+    }
+    else if( ERROR_SUCCESS != ( retVal = Assembler_InitializeWithArena( &assembler, 0, &arena ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Assembler_InitializeWithArena() Failed\n" );
+    }
+    else {
+        Handler->Next = Handler->Older->HookFunctionAddress;
+
+        // Nothing reaches the stub before it is published
+        // through a slot, it is never staged
+        routing                 = *Entry->Routing;
+        routing.InterceptEntry  = NULL;
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_AssembleDispatchStub( &assembler,
+                                                                                   (uintptr_t) &Handler->Next ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_AssembleDispatchStub() Failed\n" );
+        }
+        else if( ERROR_SUCCESS != ( retVal = INTERNAL_CodeBuilder_ApplyAssemblerPagePatch( &routing,
+                                                                                            &assembler,
+                                                                                            &Handler->CallNext ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_CodeBuilder_ApplyAssemblerPagePatch() Failed\n" );
+        } // INTERNAL_CodeBuilder_AssembleDispatchStub()
+
+        (void) Assembler_Release( &assembler );
+    } // Handler->Older
+
+    if( ERROR_SUCCESS != retVal )
+    {
+        Handler->Older = NULL;
+    }
+    else {
+        if( NULL != Handler->Older )
+        {
+            Handler->Older->Newer = Handler;
+        }
+
+        Entry->Handlers = Handler;
+
+        INTERNAL_HookHandler_PublishOriginal( Entry, Handler, Original );
+
+        // Calls enter the new handler from here on
+        INTERNAL_InterceptorEntry_PublishDispatch( Entry );
+    } // ERROR_SUCCESS
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_HookHandler_Release
+    (
+        IN  OUT     hook_handler_t*             Handler
+    )
+{
+    __NOT_NULL_RETURN_VOID( Handler );
+
+    if( 0 != Handler->CallNext.Start )
+    {
+        (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator,
+                                                   &Handler->CallNext );
+    }
+
+    if( NULL != Handler->Instrumentation )
+    {
+        if( 0 != Handler->Instrumentation->Stub.Start )
+        {
+            (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator,
+                                                       &Handler->Instrumentation->Stub );
+        }
+
+        if( NULL != Handler->Instrumentation->Statistics )
+        {
+            BwsrFree( Handler->Instrumentation->Statistics );
+        }
+
+        BwsrFree( Handler->Instrumentation );
+    } // Handler->Instrumentation
+
+    BwsrFree( Handler );
+}
+
+static
+void
+    INTERNAL_HookHandler_Retire
+    (
+        IN  OUT     hook_handler_t*             Handler
+    )
+{
+    __NOT_NULL_RETURN_VOID( Handler );
+
+    if( NULL != Handler->Instrumentation )
+    {
+        // Calls still in flight run through the stub
+        // without reaching the callbacks again
+        __atomic_store_n( &Handler->Instrumentation->OnEnter, NULL, __ATOMIC_RELEASE );
+        __atomic_store_n( &Handler->Instrumentation->OnLeave, NULL, __ATOMIC_RELEASE );
+
+        Handler->Newer          = NULL;
+        Handler->Older          = gRetiredInstrumentation;
+        gRetiredInstrumentation = Handler;
+    }
+    else if( 0 == Handler->CallNext.Start )
+    {
+        // No code reads the handler
+        INTERNAL_HookHandler_Release( Handler );
+    }
+    else {
+        // A thread still inside the removed hook holds the
+        // stub as its original and may call it at any time
+        Handler->Newer      = NULL;
+        Handler->Older      = gRetiredHandlers;
+        gRetiredHandlers    = Handler;
+    } // CallNext
+}
+
+static
+void
+    INTERNAL_HookHandler_Remove
+    (
+        IN  OUT     interceptor_entry_t*        Entry,
+        IN  OUT     hook_handler_t*             Handler
+    )
+{
+    uintptr_t               next        = 0;
+
+    __NOT_NULL_RETURN_VOID( Entry, Handler );
+
+    next = ( NULL != Handler->Older )
+            ? Handler->Older->HookFunctionAddress
+            : Entry->Relocated.Start;
+
+    // Whoever entered `Handler` now skips over it
+    if( NULL != Handler->Newer )
+    {
+        __atomic_store_n( &Handler->Newer->Next, next, __ATOMIC_RELEASE );
+
+        Handler->Newer->Older = Handler->Older;
+    }
+    else {
+        Entry->Handlers = Handler->Older;
+
+        INTERNAL_InterceptorEntry_PublishDispatch( Entry );
+    } // Handler->Newer
+
+    if( NULL != Handler->Older )
+    {
+        Handler->Older->Newer = Handler->Newer;
+    }
+
+    INTERNAL_HookHandler_Retire( Handler );
+}
+
+static
+BWSR_STATUS
+    INTERNAL_InstallHookHandler
+    (
+        IN          const uintptr_t             Address,
+        IN  OUT     hook_handler_t*             Handler,
+        OUT         void**                      Original,
+        IN          CallBeforePageWrite         BeforePageWriteFn,
+        IN          CallAfterPageWrite          AfterPageWriteFn,
+        IN          const bool                  Staged,
+        IN          const bool                  SingleInstruction
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker     = NULL;
+    interceptor_entry_t*    entry       = NULL;
+    intercept_routing_t*    routing     = NULL;
+
+    __NOT_NULL( Handler )
+    __GREATER_THAN_0( Address )
+
+    // A handler that fails to install is retired rather than released,
+    // a reused instrumentation stub may still run calls of its last install
+
+    if( NULL != ( tracker = INTERNAL_InterceptorRegistry_Find( Address ) ) )
+    {
+        // Already hooked, the new handler runs first and
+        // the target is left alone
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_HookHandler_Add( tracker->Entry, Handler, Original ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_HookHandler_Add() Failed\n" );
+            INTERNAL_HookHandler_Retire( Handler );
+        }
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_InterceptorEntry_Initialize( &entry ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_InterceptorEntry_Initialize() Failed\n" );
+        INTERNAL_HookHandler_Retire( Handler );
+    }
+    else {
+        entry->Address              = Address;
+        entry->Staged               = Staged;
+        entry->SingleInstruction    = SingleInstruction;
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_InterceptorRegistry_Insert( gInterceptorTracker.Previous ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_InterceptorRegistry_Insert() Failed\n" );
+            INTERNAL_HookHandler_Retire( Handler );
+        }
+        // The original is only known once the code is relocated
+        else if( ERROR_SUCCESS != ( retVal = INTERNAL_HookHandler_Add( entry, Handler, NULL ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_HookHandler_Add() Failed\n" );
+            INTERNAL_HookHandler_Retire( Handler );
+        }
+        else if( ERROR_SUCCESS != ( retVal = INTERNAL_InterceptRouting_Initialize( &routing,
+                                                                              entry,
+                                                                              Handler->HookFunctionAddress ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_InterceptRouting_Initialize() Failed\n" );
+        }
+        else {
+
+            routing->AfterPageWriteFn  = AfterPageWriteFn;
+            routing->BeforePageWriteFn = BeforePageWriteFn;
+
+            if( ERROR_SUCCESS != ( retVal = INTERNAL_BuildRoutingAndActivateHook( routing, Original ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "INTERNAL_BuildRoutingAndActivateHook() Failed\n" );
+                BwsrFree( routing );
+            }
+            else {
+                entry->Routing = routing;
+
+                retVal = ERROR_SUCCESS;
+            } // INTERNAL_BuildRoutingAndActivateHook()
+        } // INTERNAL_InterceptRouting_Initialize()
+
+        if( ERROR_SUCCESS != retVal )
+        {
+            // Releases `Handler` along with the entry once linked
+            if( gInterceptorTracker.Previous != &gInterceptorTracker )
+            {
+                INTERNAL_InterceptorTracker_Release( gInterceptorTracker.Previous );
+            } // gInterceptorTracker
+        } // deinit
+    } // INTERNAL_InterceptorRegistry_Find()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_SetHookEnabled
+    (
+        IN          void*                       Address,
+        IN          const bool                  Enabled
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker     = NULL;
+    uintptr_t               address     = 0;
+
+    __NOT_NULL( Address )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( NULL == ( tracker = INTERNAL_InterceptorRegistry_Find( address ) ) )
+    {
+        retVal = ERROR_NOT_FOUND;
+    }
+    else {
+        tracker->Entry->Disabled = ( false == Enabled );
+
+        // The stub loads the slot with a single aligned `LDR`, a
+        // call sees either the old or the new target. No code changes.
+        INTERNAL_InterceptorEntry_PublishDispatch( tracker->Entry );
+
+        retVal = ERROR_SUCCESS;
+    } // INTERNAL_InterceptorRegistry_Find()
+
+    INTERNAL_HookRegistry_Unlock();
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_HookRegistry_InitializeLock
+    (
+        void
+    )
+{
+    pthread_mutexattr_t     attributes;
+
+    (void) pthread_mutexattr_init( &attributes );
+    (void) pthread_mutexattr_settype( &attributes, PTHREAD_MUTEX_RECURSIVE );
+    (void) pthread_mutex_init( &gHookRegistryLock, &attributes );
+    (void) pthread_mutexattr_destroy( &attributes );
+}
+
+static
+void
+    INTERNAL_HookRegistry_Lock
+    (
+        void
+    )
+{
+    (void) pthread_once( &gHookRegistryLockOnce, INTERNAL_HookRegistry_InitializeLock );
+    (void) pthread_mutex_lock( &gHookRegistryLock );
+}
+
+static
+void
+    INTERNAL_HookRegistry_Unlock
+    (
+        void
+    )
+{
+    (void) pthread_mutex_unlock( &gHookRegistryLock );
+}
+
+static
+BWSR_STATUS
+    INTERNAL_InlineHook
+    (
+        IN          void*                       Address,
+        IN          void*                       FakeFunction,
+        IN  OUT     void**                      Original,
+        IN          void*                       BeforePageWriteFn,
+        IN          void*                       AfterPageWriteFn,
+        IN          const bool                  Staged,
+        IN          const bool                  SingleInstruction
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    hook_handler_t*         handler     = NULL;
+    uintptr_t               address     = 0;
+    void*                   previous    = NULL;
+
+    __NOT_NULL( Address, FakeFunction )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+#endif
+
+    if( NULL == ( handler = (hook_handler_t*) BwsrCalloc( 1, sizeof( hook_handler_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+
+#if __has_feature( ptrauth_calls )
+        handler->HookFunctionAddress = (uintptr_t) ptrauth_strip( FakeFunction, ptrauth_key_asia );
+#else
+        handler->HookFunctionAddress = (uintptr_t) FakeFunction;
+#endif
+
+        if( NULL != Original )
+        {
+            previous = *Original;
+        }
+
+        // `Original` is set before the handler can be reached
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_InstallHookHandler( address,
+                                                                     handler,
+                                                                     Original,
+                                                                     (CallBeforePageWrite) BeforePageWriteFn,
+                                                                     (CallAfterPageWrite) AfterPageWriteFn,
+                                                                     Staged,
+                                                                     SingleInstruction ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_InstallHookHandler() Failed\n" );
+
+            if( NULL != Original )
+            {
+                *Original = previous;
+            }
+        } // INTERNAL_InstallHookHandler()
+    } // BwsrCalloc()
+
+    return retVal;
+}
+
+BWSR_STATUS
+    HookRegistry_InstallOutsideTransaction
+    (
+        IN          void*                       Address,
+        IN          void*                       FakeFunction,
+        OUT         void**                      Original,
+        IN          const bool                  SingleInstruction
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker     = NULL;
+    uintptr_t               address     = 0;
+
+    __NOT_NULL( Address, FakeFunction )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( ( NULL != ( tracker = INTERNAL_InterceptorRegistry_Find( address ) ) ) &&
+        ( true == tracker->Entry->Staged ) )
+    {
+        // Joining the staged hook would tie the handler to a commit
+        retVal = ERROR_HOOK_TRANSACTION;
+    }
+    else {
+        retVal = INTERNAL_InlineHook( Address,
+                                      FakeFunction,
+                                      Original,
+                                      NULL,
+                                      NULL,
+                                      false,
+                                      SingleInstruction );
+    } // Staged
+
+    INTERNAL_HookRegistry_Unlock();
+
+    return retVal;
+}
+
+BWSR_STATUS
+    HookRegistry_FindHandler
+    (
+        IN          void*                       Address,
+        IN          void*                       FakeFunction
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_NOT_FOUND;
+    interceptor_tracker_t*  tracker     = NULL;
+    hook_handler_t*         handler     = NULL;
+    uintptr_t               address     = 0;
+    uintptr_t               hook        = 0;
+
+    __NOT_NULL( Address, FakeFunction )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+    hook    = (uintptr_t) ptrauth_strip( FakeFunction, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+    hook    = (uintptr_t) FakeFunction;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( NULL != ( tracker = INTERNAL_InterceptorRegistry_Find( address ) ) )
+    {
+        for( handler = tracker->Entry->Handlers; NULL != handler; handler = handler->Older )
+        {
+            if( hook == handler->HookFunctionAddress )
+            {
+                retVal = ERROR_SUCCESS;
+            }
+        } // for()
+    } // INTERNAL_InterceptorRegistry_Find()
+
+    INTERNAL_HookRegistry_Unlock();
+
+    return retVal;
+}
+
+void
+    HookRegistry_Lock
+    (
+        void
+    )
+{
+    INTERNAL_HookRegistry_Lock();
+}
+
+void
+    HookRegistry_Unlock
+    (
+        void
+    )
+{
+    INTERNAL_HookRegistry_Unlock();
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_InlineHook
+    (
+        IN          void*           Address,
+        IN          void*           FakeFunction,
+        IN  OUT     void**          Original,
+        IN          void*           BeforePageWriteFn,
+        IN          void*           AfterPageWriteFn
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+
+    INTERNAL_HookRegistry_Lock();
+
+    retVal = INTERNAL_InlineHook( Address,
+                                  FakeFunction,
+                                  Original,
+                                  BeforePageWriteFn,
+                                  AfterPageWriteFn,
+                                  gHookTransaction.Active,
+                                  false );
+
+    INTERNAL_HookRegistry_Unlock();
+
+    __DEBUG_RETVAL( retVal );
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_FindHook
+    (
+        IN          void*           Address,
+        OUT         void**          Original
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker     = NULL;
+    uintptr_t               address     = 0;
+
+    __NOT_NULL( Address )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( NULL == ( tracker = INTERNAL_InterceptorRegistry_Find( address ) ) )
+    {
+        retVal = ERROR_NOT_FOUND;
+    }
+    else {
+        if( NULL != Original )
+        {
+            *Original = (void*) INTERNAL_HookHandler_GetOriginal( tracker->Entry,
+                                                                  tracker->Entry->Handlers );
+
+#if __has_feature( ptrauth_calls )
+            *Original = (void*) ptrauth_sign_unauthenticated( *Original, ptrauth_key_asia, 0 );
+#endif
+
+        }
+
+        retVal = ERROR_SUCCESS;
+    } // INTERNAL_InterceptorRegistry_Find()
+
+    INTERNAL_HookRegistry_Unlock();
+
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_EnableHook
+    (
+        IN          void*           Address
+    )
+{
+    return INTERNAL_SetHookEnabled( Address, true );
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_DisableHook
+    (
+        IN          void*           Address
+    )
+{
+    return INTERNAL_SetHookEnabled( Address, false );
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_DestroyHook
+    (
+        IN          void*           Address
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker     = NULL;
+    uintptr_t               address     = 0;
+    thread_suspension_t     suspension  = { 0 };
+
+    __NOT_NULL( Address )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( NULL == ( tracker = INTERNAL_InterceptorRegistry_Find( address ) ) )
+    {
+        retVal = ERROR_NOT_FOUND;
+    }
+    else {
+        // Every handler goes with the hook, `BWSR_RemoveHookHandler`
+        // removes a single one
+        if( tracker->Entry->Staged )
+        {
+            // Never written, dropping the staged patches is enough
+            retVal = ERROR_SUCCESS;
+
+            INTERNAL_InterceptorTracker_Release( tracker );
+        }
+        else if( ERROR_SUCCESS != ( retVal = INTERNAL_SafePatch_Begin( &suspension ) ) )
+        {
+            // Nothing was written, the hook stays in place
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_SafePatch_Begin() Failed\n" );
+        }
+        else {
+            INTERNAL_SafePatch_RelocateThreads( &suspension,
+                                                tracker->Entry,
+                                                true );
+
+            retVal = INTERNAL_ApplyCodePatch( tracker->Entry->Routing,
+                                              (void*) tracker->Entry->Patched.Start,
+                                              tracker->Entry->OriginalCode,
+                                              tracker->Entry->Patched.Size );
+
+            INTERNAL_SafePatch_End( &suspension );
+
+            INTERNAL_InterceptorTracker_Release( tracker );
+        } // Staged
+    } // INTERNAL_InterceptorRegistry_Find()
+
+    INTERNAL_HookRegistry_Unlock();
+
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_RemoveHookHandler
+    (
+        IN          void*           Address,
+        IN          void*           FakeFunction
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker     = NULL;
+    hook_handler_t*         handler     = NULL;
+    uintptr_t               address     = 0;
+    uintptr_t               hook        = 0;
+
+    __NOT_NULL( Address, FakeFunction )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+    hook    = (uintptr_t) ptrauth_strip( FakeFunction, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+    hook    = (uintptr_t) FakeFunction;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( NULL != ( tracker = INTERNAL_InterceptorRegistry_Find( address ) ) )
+    {
+        handler = tracker->Entry->Handlers;
+
+        while( ( NULL != handler                      ) &&
+               ( hook != handler->HookFunctionAddress ) )
+        {
+            handler = handler->Older;
+        } // while()
+    } // INTERNAL_InterceptorRegistry_Find()
+
+    if( NULL == handler )
+    {
+        retVal = ERROR_NOT_FOUND;
+    }
+    else if( ( NULL == handler->Newer ) &&
+             ( NULL == handler->Older ) )
+    {
+        // Last handler, unhook the address
+        retVal = BWSR_DestroyHook( Address );
+    }
+    else {
+        INTERNAL_HookHandler_Remove( tracker->Entry, handler );
+
+        retVal = ERROR_SUCCESS;
+    } // handler
+
+    INTERNAL_HookRegistry_Unlock();
+
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_InstrumentFunction
+    (
+        IN          void*                   Address,
+        IN          InstrumentCallback      OnEnter,
+        IN          InstrumentCallback      OnLeave,
+        IN          void*                   UserData
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    hook_handler_t*         handler     = NULL;
+    uintptr_t               address     = 0;
+
+    __NOT_NULL( Address )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( ( NULL == OnEnter ) &&
+        ( NULL == OnLeave ) )
+    {
+        retVal = ERROR_INVALID_ARGUMENT_VALUE;
+    }
+    else if( NULL != ( handler = INTERNAL_Instrumentation_Reuse( address, false ) ) )
+    {
+        // Removed from this target before, its stub is still mapped
+        retVal = ERROR_SUCCESS;
+    }
+    else if( NULL == ( handler = (hook_handler_t*) BwsrCalloc( 1, sizeof( hook_handler_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else if( NULL == ( handler->Instrumentation = (instrumentation_t*) BwsrCalloc( 1, sizeof( instrumentation_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        BwsrFree( handler );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        handler->Instrumentation->Target = address;
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_Instrumentation_GenerateStub( handler ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_Instrumentation_GenerateStub() Failed\n" );
+            INTERNAL_HookHandler_Release( handler );
+        }
+    } // BwsrCalloc()
+
+    if( ERROR_SUCCESS == retVal )
+    {
+        // A call still in the stub from its last install
+        // sees the new generation and skips the callbacks
+        __atomic_add_fetch( &handler->Instrumentation->Generation, 1, __ATOMIC_RELEASE );
+
+        handler->Instrumentation->UserData = UserData;
+
+        __atomic_store_n( &handler->Instrumentation->OnEnter, OnEnter, __ATOMIC_RELEASE );
+        __atomic_store_n( &handler->Instrumentation->OnLeave, OnLeave, __ATOMIC_RELEASE );
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_InstallHookHandler( address,
+                                                                     handler,
+                                                                     NULL,
+                                                                     NULL,
+                                                                     NULL,
+                                                                     gHookTransaction.Active,
+                                                                     false ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_InstallHookHandler() Failed\n" );
+        } // INTERNAL_InstallHookHandler()
+    } // ERROR_SUCCESS
+
+    INTERNAL_HookRegistry_Unlock();
+
+    __DEBUG_RETVAL( retVal );
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_RemoveInstrumentation
+    (
+        IN          void*                   Address,
+        IN          InstrumentCallback      OnEnter,
+        IN          InstrumentCallback      OnLeave,
+        IN          void*                   UserData
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker     = NULL;
+    hook_handler_t*         handler     = NULL;
+    uintptr_t               address     = 0;
+
+    __NOT_NULL( Address )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( NULL != ( tracker = INTERNAL_InterceptorRegistry_Find( address ) ) )
+    {
+        handler = tracker->Entry->Handlers;
+
+        while( ( NULL != handler ) &&
+               ( ( NULL     == handler->Instrumentation           ) ||
+                 ( OnEnter  != handler->Instrumentation->OnEnter  ) ||
+                 ( OnLeave  != handler->Instrumentation->OnLeave  ) ||
+                 ( UserData != handler->Instrumentation->UserData ) ) )
+        {
+            handler = handler->Older;
+        } // while()
+    } // INTERNAL_InterceptorRegistry_Find()
+
+    if( NULL == handler )
+    {
+        retVal = ERROR_NOT_FOUND;
+    }
+    else if( ( NULL == handler->Newer ) &&
+             ( NULL == handler->Older ) )
+    {
+        // Last handler, unhook the address
+        retVal = BWSR_DestroyHook( Address );
+    }
+    else {
+        INTERNAL_HookHandler_Remove( tracker->Entry, handler );
+
+        retVal = ERROR_SUCCESS;
+    } // handler
+
+    INTERNAL_HookRegistry_Unlock();
+
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_EnableHookStatistics
+    (
+        IN          void*                   Address,
+        IN          int                     MeasureLatency
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker     = NULL;
+    hook_handler_t*         handler     = NULL;
+    uintptr_t               address     = 0;
+
+    __NOT_NULL( Address )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( NULL == ( tracker = INTERNAL_InterceptorRegistry_Find( address ) ) )
+    {
+        retVal = ERROR_NOT_FOUND;
+    }
+    else if( NULL != ( handler = tracker->Entry->Statistics ) )
+    {
+        // The stub is kept while disabled, and so are the counts
+        retVal = ERROR_SUCCESS;
+    }
+    else if( NULL != ( handler = INTERNAL_Instrumentation_Reuse( address, true ) ) )
+    {
+        // Left by an earlier hook on the address, counting starts over
+        memset( (void*) handler->Instrumentation->Statistics, 0, sizeof( hook_statistics_t ) );
+
+        retVal = ERROR_SUCCESS;
+    }
+    else if( NULL == ( handler = (hook_handler_t*) BwsrCalloc( 1, sizeof( hook_handler_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else if( NULL == ( handler->Instrumentation = (instrumentation_t*) BwsrCalloc( 1, sizeof( instrumentation_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        BwsrFree( handler );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else if( NULL == ( handler->Instrumentation->Statistics = (hook_statistics_t*) BwsrCalloc( 1, sizeof( hook_statistics_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        INTERNAL_HookHandler_Release( handler );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        handler->Instrumentation->Target = address;
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_Instrumentation_GenerateStub( handler ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_Instrumentation_GenerateStub() Failed\n" );
+            INTERNAL_HookHandler_Release( handler );
+        }
+    } // INTERNAL_InterceptorRegistry_Find()
+
+    if( ERROR_SUCCESS == retVal )
+    {
+        handler->Instrumentation->Statistics->MeasureLatency    = ( 0 != MeasureLatency );
+        tracker->Entry->Statistics                              = handler;
+        tracker->Entry->StatisticsEnabled                       = true;
+
+        INTERNAL_InterceptorEntry_PublishDispatch( tracker->Entry );
+    } // ERROR_SUCCESS
+
+    INTERNAL_HookRegistry_Unlock();
+
+    __DEBUG_RETVAL( retVal );
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_DisableHookStatistics
+    (
+        IN          void*                   Address
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker     = NULL;
+    uintptr_t               address     = 0;
+
+    __NOT_NULL( Address )
+
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( ( NULL  == ( tracker = INTERNAL_InterceptorRegistry_Find( address ) ) ) ||
+        ( false == tracker->Entry->StatisticsEnabled ) )
+    {
+        retVal = ERROR_NOT_FOUND;
+    }
+    else {
+        // Only the dispatch slot changes. The stub stays with the
+        // entry for the next enable, timed calls in flight still
+        // return through it.
+        tracker->Entry->StatisticsEnabled = false;
 
-        if( ERROR_SUCCESS != retVal )
-        {
-            BwsrFree( (void*) Routing->Trampoline->Buffer.Start );
-            BwsrFree( Routing->Trampoline );
-        }
-    } // INTERNAL_GenerateTrampoline()
+        INTERNAL_InterceptorEntry_PublishDispatch( tracker->Entry );
+
+        retVal = ERROR_SUCCESS;
+    } // INTERNAL_InterceptorRegistry_Find()
+
+    INTERNAL_HookRegistry_Unlock();
 
     return retVal;
 }
 
-static
+BWSR_API
 BWSR_STATUS
-    INTERNAL_InterceptorTracker_Initialize
+    BWSR_GetHookStatistics
     (
-        OUT         interceptor_tracker_t**     Tracker
+        IN          void*                   Address,
+        OUT         bwsr_hook_stats_t*      Statistics,
+        IN          int                     Reset
     )
 {
-    BWSR_STATUS retVal = ERROR_FAILURE;
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    interceptor_tracker_t*  tracker     = NULL;
+    hook_statistics_t*      statistics  = NULL;
+    uintptr_t               address     = 0;
+    size_t                  i           = 0;
 
-    __NOT_NULL( Tracker )
+    __NOT_NULL( Address, Statistics )
 
-    if( NULL == ( *Tracker = (interceptor_tracker_t*) BwsrMalloc( sizeof( interceptor_tracker_t ) ) ) )
+#if __has_feature( ptrauth_calls )
+    address = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
+#else
+    address = (uintptr_t) Address;
+#endif
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( ( NULL == ( tracker = INTERNAL_InterceptorRegistry_Find( address ) ) ) ||
+        ( NULL == tracker->Entry->Statistics ) )
     {
-        BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
-        retVal = ERROR_MEM_ALLOC;
+        retVal = ERROR_NOT_FOUND;
     }
     else {
-        if( NULL == ( ( *Tracker )->Entry = (interceptor_entry_t*) BwsrMalloc( sizeof( interceptor_entry_t ) ) ) )
+        statistics = tracker->Entry->Statistics->Instrumentation->Statistics;
+
+        memset( Statistics, 0, sizeof( bwsr_hook_stats_t ) );
+
+        // Exchanging the counters while reading them
+        // loses no call made in between
+        for( i = 0; i < HOOK_STATISTICS_STRIPES; i++ )
         {
-            BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
-            retVal = ERROR_MEM_ALLOC;
-            BwsrFree( *Tracker );
-        }
-        else {
-            ( *Tracker )->Next                  = &gInterceptorTracker;
-            ( *Tracker )->Previous              = gInterceptorTracker.Previous;
-            gInterceptorTracker.Previous->Next  = *Tracker;
-            gInterceptorTracker.Previous        = *Tracker;
+            Statistics->Calls += ( 0 != Reset )
+                                    ? __atomic_exchange_n( &statistics->Stripes[ i ].Calls, 0, __ATOMIC_RELAXED )
+                                    : __atomic_load_n( &statistics->Stripes[ i ].Calls, __ATOMIC_RELAXED );
+        } // for()
 
-            retVal = ERROR_SUCCESS;
-        } // BwsrMalloc( InterceptorEntry )
-    } // BwsrMalloc( InterceptorTracker )
+        for( i = 0; i < BWSR_LATENCY_BUCKETS; i++ )
+        {
+            Statistics->Latency[ i ] = ( 0 != Reset )
+                                        ? __atomic_exchange_n( &statistics->Latency[ i ], 0, __ATOMIC_RELAXED )
+                                        : __atomic_load_n( &statistics->Latency[ i ], __ATOMIC_RELAXED );
+        } // for()
+
+        Statistics->TicksPerSecond = INTERNAL_ReadTickFrequency();
+
+        retVal = ERROR_SUCCESS;
+    } // INTERNAL_InterceptorRegistry_Find()
+
+    INTERNAL_HookRegistry_Unlock();
 
     return retVal;
 }
 
-static
+BWSR_API
 void
-    INTERNAL_MemoryAllocator_CheckInterceptorRelease
+    BWSR_DestroyAllHooks
     (
         void
     )
 {
-    if( gInterceptorTracker.Next == &gInterceptorTracker )
-    {
-        if( NULL != gMemoryAllocator.Allocators )
-        {
-            BwsrFree( gMemoryAllocator.Allocators );
+    interceptor_tracker_t*  tracker     = NULL;
+    thread_suspension_t     suspension  = { 0 };
 
-            gMemoryAllocator.Allocators     = NULL;
-            gMemoryAllocator.AllocatorCount = 0;
-        } // Allocators
-    } // gInterceptorTracker
-}
+    INTERNAL_HookRegistry_Lock();
 
-static
-void
-    INTERNAL_InterceptorTracker_Release
-    (
-        IN  OUT     interceptor_tracker_t*      Tracker
-    )
-{
-    __NOT_NULL_RETURN_VOID( Tracker );
+    tracker = gInterceptorTracker.Next;
 
-    if( NULL != Tracker->Entry )
+    // Every target is restored under a single suspension. The
+    // hooks are released afterwards, freeing may need the heap
+    // lock of a parked thread. Targets are restored regardless
+    // of whether the other threads could be parked.
+    (void) INTERNAL_SafePatch_Begin( &suspension );
+
+    while( tracker != &gInterceptorTracker && tracker != NULL )
     {
-        if( NULL != Tracker->Entry->Routing )
+        if( ( NULL  != tracker->Entry         ) &&
+            ( false == tracker->Entry->Staged ) )
         {
-            if( NULL != Tracker->Entry->Routing->Trampoline )
-            {
-                if( Tracker->Entry->Routing->Trampoline->Buffer.Start )
-                {
-                    BwsrFree( (void*)Tracker->Entry->Routing->Trampoline->Buffer.Start );
-                } // Tracker->Entry->Routing->Trampoline->Buffer.Start
+            INTERNAL_SafePatch_RelocateThreads( &suspension,
+                                                tracker->Entry,
+                                                true );
 
-                BwsrFree( Tracker->Entry->Routing->Trampoline );
-                Tracker->Entry->Routing->Trampoline = NULL;
-            } // NULL != Tracker->Entry->Routing->Trampoline
+            (void) INTERNAL_ApplyCodePatch( tracker->Entry->Routing,
+                                            (void*) tracker->Entry->Patched.Start,
+                                            tracker->Entry->OriginalCode,
+                                            tracker->Entry->Patched.Size );
+        } // tracker->Entry
 
-            BwsrFree( Tracker->Entry->Routing );
-            Tracker->Entry->Routing = NULL;
-        } // NULL != Tracker->Entry->Routing
+        tracker = tracker->Next;
+    } // while()
 
-        if( NULL != Tracker->Entry->OriginalCode )
+    INTERNAL_SafePatch_End( &suspension );
+
+    tracker = gInterceptorTracker.Next;
+
+    while( tracker != &gInterceptorTracker && tracker != NULL )
+    {
+        if( NULL != tracker->Entry )
         {
-            BwsrFree( Tracker->Entry->OriginalCode );
-            Tracker->Entry->OriginalCode = NULL;
-        } // NULL != Tracker->Entry->OriginalCode
+            INTERNAL_InterceptorTracker_Release( tracker );
+        } // tracker->Entry
 
-        BwsrFree( Tracker->Entry );
-    } // NULL != Tracker->Entry
+        tracker = gInterceptorTracker.Next;
+    } // while()
 
-    Tracker->Previous->Next     = Tracker->Next;
-    Tracker->Next->Previous     = Tracker->Previous;
-    Tracker->Next               = NULL;
-    Tracker->Previous           = NULL;
+    // Retired stubs are never freed, their pages stay mapped
+    if( ( NULL == gRetiredHandlers        ) &&
+        ( NULL == gRetiredInstrumentation ) )
+    {
+        MemoryAllocator_Release( &gMemoryAllocator );
+    }
 
-    BwsrFree( Tracker );
+    // Nothing is left to commit
+    INTERNAL_HookTransaction_Reset();
 
-    INTERNAL_MemoryAllocator_CheckInterceptorRelease();
+    INTERNAL_HookRegistry_Unlock();
 }
 
-static
+BWSR_API
 BWSR_STATUS
-    INTERNAL_InterceptorEntry_Initialize
+    BWSR_BeginHookTransaction
     (
-        OUT         interceptor_entry_t**       Entry
+        void
     )
 {
-    BWSR_STATUS             retVal          = ERROR_FAILURE;
-    interceptor_tracker_t*  tracker         = NULL;
+    BWSR_STATUS     retVal      = ERROR_FAILURE;
 
-    __NOT_NULL( Entry )
+    INTERNAL_HookRegistry_Lock();
 
-    if( ERROR_SUCCESS != ( retVal = INTERNAL_InterceptorTracker_Initialize( &tracker ) ) )
+    if( gHookTransaction.Active )
     {
-        BWSR_DEBUG( LOG_ERROR, "INTERNAL_InterceptorTracker_Initialize() Failed\n" );
+        BWSR_DEBUG( LOG_ERROR, "Hook transaction already open\n" );
+        retVal = ERROR_HOOK_TRANSACTION;
     }
     else {
-        *Entry = tracker->Entry;
-    } // INTERNAL_InterceptorTracker_Initialize()
-
-    return retVal;
-}
-
-static
-BWSR_STATUS
-    INTERNAL_SetMemoryProtectionFunction
-    (
-        OUT         uintptr_t*      MemoryProtectFn
-    )
-{
-    BWSR_STATUS retVal = ERROR_FAILURE;
+        gHookTransaction.Active = true;
+        retVal                  = ERROR_SUCCESS;
+    } // Active
 
-#if defined( __APPLE__ )
-    if( ERROR_SUCCESS != ( retVal = BWSR_ResolveSymbol( "vm_protect",
-                                                        "dyld",
-                                                        MemoryProtectFn ) ) )
-    {
-        retVal = BWSR_ResolveSymbol( "_vm_protect",
-                                     "libsystem_kernel",
-                                     MemoryProtectFn );
-    } // BWSR_ResolveSymbol()
-#else
-    *MemoryProtectFn = (uintptr_t)mprotect;
-    retVal = ERROR_SUCCESS;
-#endif
+    INTERNAL_HookRegistry_Unlock();
 
+    __DEBUG_RETVAL( retVal );
     return retVal;
 }
 
 BWSR_API
 BWSR_STATUS
-    BWSR_InlineHook
+    BWSR_CommitHookTransaction
     (
-        IN          void*           Address,
-        IN          void*           FakeFunction,
-        IN  OUT     void**          Original,
-        IN          void*           BeforePageWriteFn,
-        IN          void*           AfterPageWriteFn
+        void
     )
 {
     BWSR_STATUS             retVal      = ERROR_FAILURE;
-    interceptor_entry_t*    entry       = NULL;
-    intercept_routing_t*    routing     = NULL;
+    BWSR_STATUS             pageRetVal  = ERROR_FAILURE;
+    size_t                  first       = 0;
+    size_t                  last        = 0;
+    size_t                  ndx         = 0;
+    interceptor_tracker_t*  tracker     = NULL;
+    interceptor_tracker_t*  next        = NULL;
+    thread_suspension_t     suspension  = { 0 };
 
-    __NOT_NULL( Address, FakeFunction )
+    INTERNAL_HookRegistry_Lock();
 
-    if( ERROR_SUCCESS != ( retVal = INTERNAL_InterceptorEntry_Initialize( &entry ) ) )
+    if( false == gHookTransaction.Active )
     {
-        BWSR_DEBUG( LOG_ERROR, "INTERNAL_InterceptorEntry_Initialize() Failed\n" );
+        BWSR_DEBUG( LOG_ERROR, "No hook transaction open\n" );
+        retVal = ERROR_HOOK_TRANSACTION;
     }
     else {
+        qsort( gHookTransaction.Patches,
+               gHookTransaction.PatchCount,
+               sizeof( staged_patch_t ),
+               INTERNAL_HookTransaction_ComparePatches );
 
-#if __has_feature( ptrauth_calls )
-        entry->Address              = (uintptr_t) ptrauth_strip( Address, ptrauth_key_asia );
-        entry->HookFunctionAddress  = (uintptr_t) ptrauth_strip( FakeFunction, ptrauth_key_asia );
-#else
-        entry->Address              = (uintptr_t) Address;
-        entry->HookFunctionAddress  = (uintptr_t) FakeFunction;
-#endif
-
-        if( ERROR_SUCCESS != ( retVal = INTERNAL_InterceptRouting_Initialize( &routing,
-                                                                              entry,
-                                                                              (uintptr_t) FakeFunction ) ) )
+        // Every patch is written under a single suspension
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_SafePatch_Begin( &suspension ) ) )
         {
-            BWSR_DEBUG( LOG_ERROR, "INTERNAL_InterceptRouting_Initialize() Failed\n" );
+            // Nothing was written, the transaction stays open
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_SafePatch_Begin() Failed\n" );
         }
         else {
-
-            routing->AfterPageWriteFn  = (CallAfterPageWrite)AfterPageWriteFn;
-            routing->BeforePageWriteFn = (CallBeforePageWrite)BeforePageWriteFn;
-
-            if( ERROR_SUCCESS != ( retVal = INTERNAL_BuildRoutingAndActivateHook( routing ) ) )
+            // One permission flip per page, whatever the number of patches on it
+            for( first = 0; first < gHookTransaction.PatchCount; first = last )
             {
-                BWSR_DEBUG( LOG_ERROR, "INTERNAL_BuildRoutingAndActivateHook() Failed\n" );
-                BwsrFree( routing );
-            }
-            else {
-                entry->Routing = routing;
+                last = first + 1;
 
-                if( NULL != Original )
+                while( ( last < gHookTransaction.PatchCount ) &&
+                       ( gHookTransaction.Patches[ last ].Page == gHookTransaction.Patches[ first ].Page ) )
                 {
-                    *Original = (void*) entry->Relocated.Start;
+                    last++;
+                } // while()
 
-#if __has_feature( ptrauth_calls )
-                    *Original = (void*) ptrauth_strip( *Original, ptrauth_key_asia );
-                    *Original = (void*) ptrauth_sign_unauthenticated( *Original, ptrauth_key_asia, 0 );
-#endif
+                if( ERROR_SUCCESS != ( pageRetVal = INTERNAL_HookTransaction_ApplyPage( &gHookTransaction.Patches[ first ],
+                                                                                        last - first ) ) )
+                {
+                    // Keep going, report the first failure
+                    if( ERROR_SUCCESS == retVal )
+                    {
+                        retVal = pageRetVal;
+                    }
 
+                    // Every hook with a patch on the page is taken out again
+                    for( ndx = first; ndx < last; ndx++ )
+                    {
+                        gHookTransaction.Patches[ ndx ].Owner->CommitFailed = true;
+                    } // for()
+                } // INTERNAL_HookTransaction_ApplyPage()
+            } // for()
+
+            // Threads are parked, moving them after the writes is the same
+            // as before. Only hooks that were fully written are entered.
+            tracker = gInterceptorTracker.Next;
+
+            while( tracker != &gInterceptorTracker )
+            {
+                if( ( NULL  != tracker->Entry               ) &&
+                    ( true  == tracker->Entry->Staged       ) &&
+                    ( true  == tracker->Entry->CommitFailed ) )
+                {
+                    (void) INTERNAL_HookTransaction_RollBack( tracker->Entry );
                 }
+                else if( ( NULL != tracker->Entry         ) &&
+                         ( true == tracker->Entry->Staged ) )
+                {
+                    INTERNAL_SafePatch_RelocateThreads( &suspension,
+                                                        tracker->Entry,
+                                                        false );
+                } // Staged
 
-                retVal = ERROR_SUCCESS;
-            } // INTERNAL_BuildRoutingAndActivateHook()
-        } // INTERNAL_InterceptRouting_Initialize()
+                tracker = tracker->Next;
+            } // while()
 
-        if( ERROR_SUCCESS != retVal )
-        {
-            if( gInterceptorTracker.Previous != &gInterceptorTracker )
+            // Once for the whole transaction, after every page is written
+            INTERNAL_HookTransaction_FlushPatches();
+
+            INTERNAL_SafePatch_End( &suspension );
+
+            // Released once the threads run again, freeing
+            // may need the heap lock of a parked thread
+            tracker = gInterceptorTracker.Next;
+
+            while( tracker != &gInterceptorTracker )
             {
-                INTERNAL_InterceptorTracker_Release( gInterceptorTracker.Previous );
-            } // gInterceptorTracker
-        } // deinit
-    } // INTERNAL_InterceptorEntry_Initialize()
+                next = tracker->Next;
+
+                if( ( NULL != tracker->Entry               ) &&
+                    ( true == tracker->Entry->Staged       ) &&
+                    ( true == tracker->Entry->CommitFailed ) )
+                {
+                    INTERNAL_InterceptorTracker_Release( tracker );
+                } // CommitFailed
+
+                tracker = next;
+            } // while()
+
+            INTERNAL_HookTransaction_Reset();
+        } // INTERNAL_SafePatch_Begin()
+    } // Active
+
+    INTERNAL_HookRegistry_Unlock();
 
     __DEBUG_RETVAL( retVal );
     return retVal;
@@ -1503,71 +5593,104 @@ BWSR_STATUS
 
 BWSR_API
 BWSR_STATUS
-    BWSR_DestroyHook
+    BWSR_AbortHookTransaction
     (
-        IN          void*           Address
+        void
     )
 {
     BWSR_STATUS             retVal      = ERROR_FAILURE;
-    interceptor_tracker_t*  tracker     = gInterceptorTracker.Next;
-
-    __NOT_NULL( Address )
+    interceptor_tracker_t*  tracker     = NULL;
+    interceptor_tracker_t*  next        = NULL;
 
-    retVal = ERROR_NOT_FOUND;
+    INTERNAL_HookRegistry_Lock();
 
-    while( ( tracker         != &gInterceptorTracker ) &&
-           ( ERROR_NOT_FOUND == retVal               ) )
+    if( false == gHookTransaction.Active )
     {
-        if( NULL != tracker->Entry )
+        BWSR_DEBUG( LOG_ERROR, "No hook transaction open\n" );
+        retVal = ERROR_HOOK_TRANSACTION;
+    }
+    else {
+        // Hooks installed since begin were never written
+        tracker = gInterceptorTracker.Next;
+
+        while( tracker != &gInterceptorTracker )
         {
-            if( tracker->Entry->Patched.Start == (uintptr_t)Address )
-            {
-                retVal = INTERNAL_ApplyCodePatch( tracker->Entry->Routing,
-                                                  (void*) tracker->Entry->Patched.Start,
-                                                  tracker->Entry->OriginalCode,
-                                                  tracker->Entry->Patched.Size );
+            next = tracker->Next;
 
+            if( ( NULL != tracker->Entry  ) &&
+                ( tracker->Entry->Staged ) )
+            {
                 INTERNAL_InterceptorTracker_Release( tracker );
-            }
-        }
+            } // Staged
 
-        tracker = tracker->Next;
-    } // while()
+            tracker = next;
+        } // while()
 
-    INTERNAL_MemoryAllocator_CheckInterceptorRelease();
+        INTERNAL_HookTransaction_Reset();
+
+        retVal = ERROR_SUCCESS;
+    } // Active
+
+    INTERNAL_HookRegistry_Unlock();
 
+    __DEBUG_RETVAL( retVal );
     return retVal;
 }
 
 BWSR_API
-void
-    BWSR_DestroyAllHooks
+BWSR_STATUS
+    BWSR_GetCodeCacheStatistics
     (
-        void
+        OUT         bwsr_code_cache_stats_t*    Statistics
     )
 {
-    interceptor_tracker_t* tracker = gInterceptorTracker.Next;
+    BWSR_STATUS                 retVal      = ERROR_FAILURE;
+    memory_allocator_stats_t    stats       = { 0 };
 
-    while( tracker != &gInterceptorTracker && tracker != NULL )
+    __NOT_NULL( Statistics )
+
+    INTERNAL_HookRegistry_Lock();
+
+    if( ERROR_SUCCESS != ( retVal = MemoryAllocator_GetStatistics( &gMemoryAllocator, &stats ) ) )
     {
-        if( NULL != tracker->Entry )
-        {
-            (void) INTERNAL_ApplyCodePatch( tracker->Entry->Routing,
-                                            (void*) tracker->Entry->Patched.Start,
-                                            tracker->Entry->OriginalCode,
-                                            tracker->Entry->Patched.Size );
+        BWSR_DEBUG( LOG_ERROR, "MemoryAllocator_GetStatistics() Failed\n" );
+    }
+    else {
+        Statistics->PageCount           = stats.PageCount;
+        Statistics->BytesMapped         = stats.BytesMapped;
+        Statistics->BytesInUse          = stats.BytesInUse;
+        Statistics->BytesFree           = stats.BytesFree;
+        Statistics->BytesWasted         = stats.BytesWasted;
+        Statistics->LargestFreeBlock    = stats.LargestFreeBlock;
+    } // MemoryAllocator_GetStatistics()
 
-            INTERNAL_InterceptorTracker_Release( tracker );
-        } // tracker->Entry
+    INTERNAL_HookRegistry_Unlock();
 
-        tracker = gInterceptorTracker.Next;
-    } // while()
+    return retVal;
+}
 
-    if( NULL != gMemoryAllocator.Allocators )
-    {
-        BwsrFree( gMemoryAllocator.Allocators );
+BWSR_API
+BWSR_STATUS
+    BWSR_SetSafePatching
+    (
+        IN          int             Enabled
+    )
+{
+    BWSR_STATUS     retVal      = ERROR_FAILURE;
 
-        gMemoryAllocator.Allocators     = NULL;
-        gMemoryAllocator.AllocatorCount = 0;
-    } // gMemoryAllocator.Allocators
-}
\ No newline at end of file
+#if defined( __ANDROID__ ) || defined( __linux__ )
+    INTERNAL_HookRegistry_Lock();
+
+    gSafePatching   = ( 0 != Enabled );
+    retVal          = ERROR_SUCCESS;
+
+    INTERNAL_HookRegistry_Unlock();
+#else
+    (void) Enabled;
+
+    BWSR_DEBUG( LOG_ERROR, "Safe patching is not supported on this platform\n" );
+    retVal = ERROR_UNIMPLEMENTED;
+#endif
+
+    return retVal;
+}
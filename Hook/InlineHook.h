@@ -15,6 +15,50 @@ typedef void
         uintptr_t   AlignedPageAddress
     );
 
+typedef struct bwsr_code_cache_stats_t {
+    // Executable pages currently mapped
+    size_t          PageCount;
+    // Bytes currently mapped
+    size_t          BytesMapped;
+    // Bytes of trampolines and relocated code in use
+    size_t          BytesInUse;
+    // Bytes available for new blocks
+    size_t          BytesFree;
+    // Bytes lost to block alignment
+    size_t          BytesWasted;
+    // Largest block available without mapping a new page
+    size_t          LargestFreeBlock;
+} bwsr_code_cache_stats_t;
+
+typedef struct bwsr_cpu_context_t {
+    // x0 - x30, x30 being the link register
+    uint64_t        X[ 31 ];
+    // Stack pointer of the caller
+    uint64_t        SP;
+    // q0 - q7, low 64 bits first
+    uint64_t        Q[ 8 ][ 2 ];
+} bwsr_cpu_context_t;
+
+// Buckets of the latency histogram of a hook
+#define BWSR_LATENCY_BUCKETS    64
+
+typedef struct bwsr_hook_stats_t {
+    // Calls entered through the hook
+    uint64_t        Calls;
+    // Calls returned, `Latency[ n ]` counts those that took
+    // [ 2^n, 2^( n + 1 ) ) ticks. `0` ticks count in `Latency[ 0 ]`.
+    uint64_t        Latency[ BWSR_LATENCY_BUCKETS ];
+    // Frequency of the tick counter
+    uint64_t        TicksPerSecond;
+} bwsr_hook_stats_t;
+
+typedef void
+    ( *InstrumentCallback )
+    (
+        bwsr_cpu_context_t*     Context,
+        void*                   UserData
+    );
+
 int
     BWSR_InlineHook
     (
@@ -25,18 +69,117 @@ int
         void*       AfterPageWriteFn
     );
 
+int
+    BWSR_FindHook
+    (
+        void*       Address,
+        void**      OutOriginalFunction
+    );
+
+int
+    BWSR_EnableHook
+    (
+        void*       Address
+    );
+
+int
+    BWSR_DisableHook
+    (
+        void*       Address
+    );
+
 int
     BWSR_DestroyHook
     (
         void*       Address
     );
 
+int
+    BWSR_RemoveHookHandler
+    (
+        void*       Address,
+        void*       HookFunction
+    );
+
+int
+    BWSR_InstrumentFunction
+    (
+        void*                   Address,
+        InstrumentCallback      OnEnter,
+        InstrumentCallback      OnLeave,
+        void*                   UserData
+    );
+
+// The stub of removed instrumentation is never freed, a call may still
+// return into it. It is reused by the next `BWSR_InstrumentFunction` on the
+// same address, so an address keeps as many stubs as it ever had installed
+// at once. While any are kept the code cache is not unmapped.
+int
+    BWSR_RemoveInstrumentation
+    (
+        void*                   Address,
+        InstrumentCallback      OnEnter,
+        InstrumentCallback      OnLeave,
+        void*                   UserData
+    );
+
+int
+    BWSR_EnableHookStatistics
+    (
+        void*                   Address,
+        int                     MeasureLatency
+    );
+
+int
+    BWSR_DisableHookStatistics
+    (
+        void*                   Address
+    );
+
+int
+    BWSR_GetHookStatistics
+    (
+        void*                   Address,
+        bwsr_hook_stats_t*      Statistics,
+        int                     Reset
+    );
+
 void
     BWSR_DestroyAllHooks
     (
         void
     );
 
+int
+    BWSR_BeginHookTransaction
+    (
+        void
+    );
+
+int
+    BWSR_CommitHookTransaction
+    (
+        void
+    );
+
+int
+    BWSR_AbortHookTransaction
+    (
+        void
+    );
+
+int
+    BWSR_GetCodeCacheStatistics
+    (
+        bwsr_code_cache_stats_t*    Statistics
+    );
+
+int
+    BWSR_SetSafePatching
+    (
+        int                     Enabled
+    );
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,773 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <string.h>
+
+#if defined( __ANDROID__ ) || defined( __linux__ )
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sched.h>
+    #include <signal.h>
+    #include <time.h>
+    #include <ucontext.h>
+    #include <unistd.h>
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <sys/uio.h>
+#endif
+
+#include "Hook/ThreadSuspend.h"
+
+#include "Memory/MemoryTracker.h"
+
+// -----------------------------------------------------------------------------
+//  STRUCTURES & DEFINITIONS
+// -----------------------------------------------------------------------------
+
+#if defined( __ANDROID__ ) || defined( __linux__ )
+
+// Delivered to a thread to park it
+#define THREAD_SUSPEND_SIGNAL           ( SIGRTMIN + 6 )
+
+// How long a thread may take to park before it is given up on
+#define THREAD_SUSPEND_TIMEOUT_NS       ( 1000000000ULL )
+
+// Granularity of the wait for parked threads
+#define THREAD_SUSPEND_POLL_NS          ( 1000000L )
+
+// Threads slots to start with
+#define THREAD_SUSPEND_MIN_CAPACITY     64
+
+// Thread lists read before giving up on a process
+// that keeps spawning threads
+#define THREAD_SUSPEND_LIST_ROUNDS      16
+
+#define ARM64_INSTRUCTION_SIZE          4
+
+// Frame records followed up the stack of a parked thread
+#define THREAD_SUSPEND_FRAME_DEPTH      256
+
+typedef struct linux_dirent64_t {
+    uint64_t            d_ino;
+    int64_t             d_off;
+    unsigned short      d_reclen;
+    unsigned char       d_type;
+    char                d_name[];
+} linux_dirent64_t;
+
+// -----------------------------------------------------------------------------
+//  GLOBALS
+// -----------------------------------------------------------------------------
+
+// Suspension the handler parks threads for, `NULL` otherwise
+static thread_suspension_t*     gActiveSuspension   = NULL;
+
+// Set while parked threads are being let go
+static uint32_t                 gResuming           = 0;
+
+// Threads parked so far, the suspending thread waits on it
+static uint32_t                 gArrivedCount       = 0;
+
+// Handlers currently running, stale signals included
+static uint32_t                 gHandlersRunning    = 0;
+
+static bool                     gHandlerInstalled   = false;
+
+// -----------------------------------------------------------------------------
+//  PROTOTYPES
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Waits on a futex word while it holds `Expected`.
+ * \param[in]           Address             Futex word
+ * \param[in]           Expected            Value to wait on
+ * \param[in]           Timeout             Relative timeout, `NULL` to wait forever
+ * \return void
+ */
+static
+void
+    INTERNAL_Futex_Wait
+    (
+        IN          uint32_t*                   Address,
+        IN          const uint32_t              Expected,
+        IN          const struct timespec*      Timeout
+    );
+
+/**
+ * \brief Wakes every thread waiting on a futex word.
+ * \param[in]           Address             Futex word
+ * \return void
+ */
+static
+void
+    INTERNAL_Futex_WakeAll
+    (
+        IN          uint32_t*                   Address
+    );
+
+/**
+ * \brief Signal handler parking a thread until the suspension is resumed.
+ * Only async signal safe calls are made.
+ * \param[in]           Signal              Signal number
+ * \param[in]           Info                Signal information
+ * \param[in]           Context             `ucontext_t` of the interrupted thread
+ * \return void
+ */
+static
+void
+    INTERNAL_ThreadSuspend_Handler
+    (
+        IN          int                         Signal,
+        IN          siginfo_t*                  Info,
+        IN          void*                       Context
+    );
+
+#if defined( __aarch64__ )
+
+/**
+ * \brief Follows the frame record chain of a parked thread and rewrites saved
+ * link registers that lie within a range. Records are read and written with
+ * `process_vm_readv`/`process_vm_writev` on the own process, so a frame pointer
+ * that does not point to a record ends the walk instead of faulting.
+ * \param[in]           FramePointer        `x29` of the parked thread
+ * \param[in]           StackPointer        `sp` of the parked thread
+ * \param[in]           Start               First byte of the range
+ * \param[in]           Size                Size of the range in bytes
+ * \param[in]           Targets             Where a return to instruction `n`
+ * of the range continues
+ * \return `size_t`
+ * \retval Number of saved link registers that were moved
+ */
+static
+size_t
+    INTERNAL_ThreadSuspend_RelocateFrames
+    (
+        IN          const uintptr_t             FramePointer,
+        IN          const uintptr_t             StackPointer,
+        IN          const uintptr_t             Start,
+        IN          const size_t                Size,
+        IN          const uintptr_t*            Targets
+    );
+
+#endif
+
+/**
+ * \brief Installs the signal handler on first use.
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_THREAD_SUSPEND` if `sigaction` fails
+ * \retval `ERROR_SUCCESS` if the handler is installed
+ */
+static
+BWSR_STATUS
+    INTERNAL_ThreadSuspend_InstallHandler
+    (
+        void
+    );
+
+/**
+ * \brief Reads `/proc/self/task` and signals every thread not yet in
+ * `Suspension`. Only system calls are made, nothing is allocated or logged.
+ * \param[in,out]       Suspension          Threads signalled so far
+ * \param[out]          Added               Threads signalled by this call
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_FILE_IO` if the task directory could not be read
+ * \retval `ERROR_MEMORY_OVERFLOW` if `Suspension` has no room for a thread
+ * \retval `ERROR_SUCCESS` if every listed thread was signalled
+ */
+static
+BWSR_STATUS
+    INTERNAL_ThreadSuspend_SignalNewThreads
+    (
+        IN  OUT     thread_suspension_t*        Suspension,
+        OUT         size_t*                     Added
+    );
+
+/**
+ * \brief Waits until every signalled thread is parked. Threads that exit
+ * meanwhile are dropped.
+ * \param[in,out]       Suspension          Signalled threads
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_THREAD_SUSPEND` if a live thread did not park in time
+ * \retval `ERROR_SUCCESS` if every live thread is parked
+ */
+static
+BWSR_STATUS
+    INTERNAL_ThreadSuspend_WaitForThreads
+    (
+        IN  OUT     thread_suspension_t*        Suspension
+    );
+
+// -----------------------------------------------------------------------------
+//  IMPLEMENTATION
+// -----------------------------------------------------------------------------
+
+static
+void
+    INTERNAL_Futex_Wait
+    (
+        IN          uint32_t*                   Address,
+        IN          const uint32_t              Expected,
+        IN          const struct timespec*      Timeout
+    )
+{
+    (void) syscall( SYS_futex,
+                    Address,
+                    FUTEX_WAIT | FUTEX_PRIVATE_FLAG,
+                    Expected,
+                    Timeout,
+                    NULL,
+                    0 );
+}
+
+static
+void
+    INTERNAL_Futex_WakeAll
+    (
+        IN          uint32_t*                   Address
+    )
+{
+    (void) syscall( SYS_futex,
+                    Address,
+                    FUTEX_WAKE | FUTEX_PRIVATE_FLAG,
+                    INT32_MAX,
+                    NULL,
+                    NULL,
+                    0 );
+}
+
+static
+void
+    INTERNAL_ThreadSuspend_Handler
+    (
+        IN          int                         Signal,
+        IN          siginfo_t*                  Info,
+        IN          void*                       Context
+    )
+{
+    thread_suspension_t*    suspension  = NULL;
+    pid_t                   tid         = 0;
+    uint32_t                generation  = 0;
+    size_t                  i           = 0;
+    int                     savedErrno  = errno;
+
+    (void) Signal;
+    (void) Info;
+
+    __atomic_add_fetch( &gHandlersRunning, 1, __ATOMIC_SEQ_CST );
+
+    // A signal arriving after its suspension gave up finds nothing to do
+    if( NULL != ( suspension = __atomic_load_n( &gActiveSuspension, __ATOMIC_ACQUIRE ) ) )
+    {
+        tid = (pid_t) syscall( SYS_gettid );
+
+        for( i = 0; i < __atomic_load_n( &suspension->ThreadCount, __ATOMIC_ACQUIRE ); i++ )
+        {
+            if( ( tid == suspension->Threads[ i ].Tid     ) &&
+                ( 0   == suspension->Threads[ i ].Arrived ) )
+            {
+                // Read before `gResuming`, the generation only changes after it is set
+                generation = __atomic_load_n( &suspension->Generation, __ATOMIC_ACQUIRE );
+
+                suspension->Threads[ i ].Context = Context;
+
+                __atomic_store_n( &suspension->Threads[ i ].Arrived, 1, __ATOMIC_RELEASE );
+                __atomic_add_fetch( &gArrivedCount, 1, __ATOMIC_SEQ_CST );
+
+                INTERNAL_Futex_WakeAll( &gArrivedCount );
+
+                while( ( 0          == __atomic_load_n( &gResuming, __ATOMIC_SEQ_CST ) ) &&
+                       ( generation == __atomic_load_n( &suspension->Generation, __ATOMIC_ACQUIRE ) ) )
+                {
+                    INTERNAL_Futex_Wait( &suspension->Generation, generation, NULL );
+                } // while()
+
+                break;
+            } // Tid
+        } // for()
+    } // gActiveSuspension
+
+    __atomic_sub_fetch( &gHandlersRunning, 1, __ATOMIC_RELEASE );
+
+    errno = savedErrno;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ThreadSuspend_InstallHandler
+    (
+        void
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+    struct sigaction    action      = { 0 };
+
+    if( true == gHandlerInstalled )
+    {
+        retVal = ERROR_SUCCESS;
+    }
+    else {
+        action.sa_sigaction = INTERNAL_ThreadSuspend_Handler;
+        action.sa_flags     = SA_SIGINFO | SA_RESTART;
+
+        // Nothing else interrupts a parked thread
+        (void) sigfillset( &action.sa_mask );
+
+        // Kept for good, a late signal must never reach
+        // the default action and end the process
+        if( 0 != sigaction( THREAD_SUSPEND_SIGNAL, &action, NULL ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "sigaction() Failed\n" );
+            retVal = ERROR_THREAD_SUSPEND;
+        }
+        else {
+            gHandlerInstalled   = true;
+            retVal              = ERROR_SUCCESS;
+        } // sigaction()
+    } // gHandlerInstalled
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ThreadSuspend_SignalNewThreads
+    (
+        IN  OUT     thread_suspension_t*        Suspension,
+        OUT         size_t*                     Added
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    linux_dirent64_t*       entry       = NULL;
+    char                    buffer[ 4096 ] __attribute__( ( aligned( 8 ) ) );
+    long                    length      = 0;
+    long                    offset      = 0;
+    pid_t                   pid         = 0;
+    pid_t                   self        = 0;
+    pid_t                   tid         = 0;
+    size_t                  i           = 0;
+    const char*             name        = NULL;
+    int                     fd          = -1;
+
+    __NOT_NULL( Suspension, Added )
+
+    *Added  = 0;
+    pid     = getpid();
+    self    = (pid_t) syscall( SYS_gettid );
+
+    // `opendir()` allocates, other threads may already be parked
+    if( 0 > ( fd = open( "/proc/self/task", O_RDONLY | O_DIRECTORY | O_CLOEXEC ) ) )
+    {
+        retVal = ERROR_FILE_IO;
+    }
+    else {
+        retVal = ERROR_SUCCESS;
+
+        while( ( ERROR_SUCCESS == retVal ) &&
+               ( 0 < ( length = syscall( SYS_getdents64, fd, buffer, sizeof( buffer ) ) ) ) )
+        {
+            for( offset = 0; ( offset < length ) && ( ERROR_SUCCESS == retVal ); offset += entry->d_reclen )
+            {
+                entry   = (linux_dirent64_t*)( buffer + offset );
+                tid     = 0;
+
+                for( name = entry->d_name; ( '0' <= *name ) && ( '9' >= *name ); name++ )
+                {
+                    tid = ( tid * 10 ) + ( *name - '0' );
+                } // for()
+
+                if( ( 0    == tid ) ||
+                    ( self == tid ) )
+                {
+                    continue;
+                }
+
+                for( i = 0; ( i < Suspension->ThreadCount ) && ( tid != Suspension->Threads[ i ].Tid ); i++ )
+                {
+                } // for()
+
+                if( i < Suspension->ThreadCount )
+                {
+                    // Signalled in an earlier round
+                    continue;
+                }
+
+                if( Suspension->ThreadCount >= Suspension->ThreadCapacity )
+                {
+                    retVal = ERROR_MEMORY_OVERFLOW;
+                }
+                else {
+                    // Visible to the handler before the signal is sent
+                    Suspension->Threads[ Suspension->ThreadCount ].Tid      = tid;
+                    Suspension->Threads[ Suspension->ThreadCount ].Arrived  = 0;
+                    Suspension->Threads[ Suspension->ThreadCount ].Context  = NULL;
+
+                    __atomic_store_n( &Suspension->ThreadCount,
+                                      Suspension->ThreadCount + 1,
+                                      __ATOMIC_RELEASE );
+
+                    if( 0 != syscall( SYS_tgkill, pid, tid, THREAD_SUSPEND_SIGNAL ) )
+                    {
+                        // Exited since the directory was read
+                        Suspension->Threads[ Suspension->ThreadCount - 1 ].Tid = 0;
+                    }
+                    else {
+                        ( *Added )++;
+                    } // syscall()
+                } // ThreadCapacity
+            } // for()
+        } // while()
+
+        if( ( ERROR_SUCCESS == retVal ) &&
+            ( 0             >  length ) )
+        {
+            retVal = ERROR_FILE_IO;
+        }
+
+        (void) close( fd );
+    } // open()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ThreadSuspend_WaitForThreads
+    (
+        IN  OUT     thread_suspension_t*        Suspension
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    const struct timespec   poll        = { .tv_sec = 0, .tv_nsec = THREAD_SUSPEND_POLL_NS };
+    uint64_t                waited      = 0;
+    uint32_t                arrived     = 0;
+    size_t                  expected    = 0;
+    size_t                  i           = 0;
+    pid_t                   pid         = 0;
+
+    __NOT_NULL( Suspension )
+
+    pid = getpid();
+
+    while( ( ERROR_SUCCESS        != retVal ) &&
+           ( ERROR_THREAD_SUSPEND != retVal ) )
+    {
+        arrived     = __atomic_load_n( &gArrivedCount, __ATOMIC_SEQ_CST );
+        expected    = 0;
+
+        for( i = 0; i < Suspension->ThreadCount; i++ )
+        {
+            if( 0 != Suspension->Threads[ i ].Tid )
+            {
+                expected++;
+            }
+        } // for()
+
+        if( arrived >= expected )
+        {
+            retVal = ERROR_SUCCESS;
+        }
+        else if( THREAD_SUSPEND_TIMEOUT_NS <= waited )
+        {
+            retVal = ERROR_THREAD_SUSPEND;
+        }
+        else {
+            INTERNAL_Futex_Wait( &gArrivedCount, arrived, &poll );
+
+            waited += THREAD_SUSPEND_POLL_NS;
+
+            // A thread that exited will never park
+            for( i = 0; i < Suspension->ThreadCount; i++ )
+            {
+                if( ( 0 != Suspension->Threads[ i ].Tid                                   ) &&
+                    ( 0 == __atomic_load_n( &Suspension->Threads[ i ].Arrived, __ATOMIC_ACQUIRE ) ) &&
+                    ( 0 != syscall( SYS_tgkill, pid, Suspension->Threads[ i ].Tid, 0 )    ) &&
+                    ( ESRCH == errno                                                       ) )
+                {
+                    Suspension->Threads[ i ].Tid = 0;
+                }
+            } // for()
+        } // arrived
+    } // while()
+
+    return retVal;
+}
+
+BWSR_STATUS
+    ThreadSuspend_SuspendOthers
+    (
+        OUT         thread_suspension_t*        Suspension
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    size_t          capacity        = THREAD_SUSPEND_MIN_CAPACITY;
+    size_t          added           = 0;
+    size_t          round           = 0;
+
+    __NOT_NULL( Suspension )
+
+    memset( Suspension, 0, sizeof( thread_suspension_t ) );
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_ThreadSuspend_InstallHandler() ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_ThreadSuspend_InstallHandler() Failed\n" );
+    }
+
+    while( ERROR_SUCCESS == retVal )
+    {
+        // Allocated up front, parked threads may hold the heap lock
+        if( NULL == ( Suspension->Threads = (suspended_thread_t*) BwsrCalloc( capacity, sizeof( suspended_thread_t ) ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+            retVal = ERROR_MEM_ALLOC;
+            break;
+        }
+
+        Suspension->ThreadCapacity  = capacity;
+        Suspension->ThreadCount     = 0;
+
+        __atomic_store_n( &gArrivedCount, 0, __ATOMIC_SEQ_CST );
+        __atomic_store_n( &gResuming, 0, __ATOMIC_SEQ_CST );
+        __atomic_store_n( &gActiveSuspension, Suspension, __ATOMIC_SEQ_CST );
+
+        // Threads spawned while the first ones park show
+        // up in the next read of the task directory
+        round = 0;
+
+        do
+        {
+            // Nothing is logged while threads are parked,
+            // the logger may be locked by one of them
+            if( ERROR_SUCCESS == ( retVal = INTERNAL_ThreadSuspend_SignalNewThreads( Suspension, &added ) ) )
+            {
+                retVal = INTERNAL_ThreadSuspend_WaitForThreads( Suspension );
+            }
+
+            if( ( ERROR_SUCCESS              == retVal  ) &&
+                ( THREAD_SUSPEND_LIST_ROUNDS <= ++round ) )
+            {
+                retVal = ERROR_THREAD_SUSPEND;
+            }
+        } while( ( ERROR_SUCCESS == retVal ) &&
+                 ( 0             <  added  ) );
+
+        if( ERROR_SUCCESS == retVal )
+        {
+            break;
+        }
+
+        ThreadSuspend_ResumeOthers( Suspension );
+
+        if( ERROR_MEMORY_OVERFLOW == retVal )
+        {
+            // Try again with room for every thread
+            capacity    *= 2;
+            retVal      = ERROR_SUCCESS;
+        }
+        else {
+            BWSR_DEBUG( LOG_ERROR, "Failed to park every thread: %s\n", ErrorString( retVal ) );
+        } // ERROR_MEMORY_OVERFLOW
+    } // while()
+
+    return retVal;
+}
+
+#if defined( __aarch64__ )
+
+static
+size_t
+    INTERNAL_ThreadSuspend_RelocateFrames
+    (
+        IN          const uintptr_t             FramePointer,
+        IN          const uintptr_t             StackPointer,
+        IN          const uintptr_t             Start,
+        IN          const size_t                Size,
+        IN          const uintptr_t*            Targets
+    )
+{
+    size_t          retVal          = 0;
+    size_t          depth           = 0;
+    uintptr_t       frame           = FramePointer;
+    uintptr_t       record[ 2 ]     = { 0 };
+    struct iovec    local           = { 0 };
+    struct iovec    remote          = { 0 };
+    pid_t           pid             = getpid();
+
+    // A record is { previous x29, saved x30 }. Records only ever lie
+    // further up the stack, which bounds the walk on a corrupt chain.
+    while( ( depth          <  THREAD_SUSPEND_FRAME_DEPTH ) &&
+           ( 0              != frame                     ) &&
+           ( 0              == ( frame & 7 )             ) &&
+           ( StackPointer   <= frame                     ) )
+    {
+        local.iov_base  = record;
+        local.iov_len   = sizeof( record );
+        remote.iov_base = (void*) frame;
+        remote.iov_len  = sizeof( record );
+
+        if( sizeof( record ) != (size_t) syscall( SYS_process_vm_readv, pid, &local, 1, &remote, 1, 0 ) )
+        {
+            break;
+        }
+
+        // Signed return addresses carry a PAC and never match
+        if( ( Start          <  record[ 1 ] ) &&
+            ( ( Start + Size ) >  record[ 1 ] ) )
+        {
+            record[ 1 ]     = Targets[ ( record[ 1 ] - Start ) / ARM64_INSTRUCTION_SIZE ];
+            local.iov_base  = &record[ 1 ];
+            local.iov_len   = sizeof( record[ 1 ] );
+            remote.iov_base = (void*) ( frame + sizeof( record[ 0 ] ) );
+            remote.iov_len  = sizeof( record[ 1 ] );
+
+            if( sizeof( record[ 1 ] ) == (size_t) syscall( SYS_process_vm_writev, pid, &local, 1, &remote, 1, 0 ) )
+            {
+                retVal++;
+            }
+        } // record[ 1 ]
+
+        if( record[ 0 ] <= frame )
+        {
+            break;
+        }
+
+        frame = record[ 0 ];
+        depth++;
+    } // while()
+
+    return retVal;
+}
+
+#endif
+
+size_t
+    ThreadSuspend_RelocateThreads
+    (
+        IN  OUT     thread_suspension_t*        Suspension,
+        IN          const uintptr_t             Start,
+        IN          const size_t                Size,
+        IN          const uintptr_t*            Targets
+    )
+{
+    size_t          retVal          = 0;
+    size_t          i               = 0;
+
+    __NOT_NULL_RETURN_0( Suspension, Targets )
+
+#if defined( __aarch64__ )
+    ucontext_t*     context         = NULL;
+    uintptr_t*      registers[ 2 ]  = { NULL };
+    size_t          j               = 0;
+
+    for( i = 0; i < Suspension->ThreadCount; i++ )
+    {
+        if( ( 0    == Suspension->Threads[ i ].Tid     ) ||
+            ( NULL == Suspension->Threads[ i ].Context ) )
+        {
+            continue;
+        }
+
+        context         = (ucontext_t*) Suspension->Threads[ i ].Context;
+        registers[ 0 ]  = (uintptr_t*) &context->uc_mcontext.pc;
+        // A call made from inside the range returns into it
+        registers[ 1 ]  = (uintptr_t*) &context->uc_mcontext.regs[ 30 ];
+
+        for( j = 0; j < ARRAY_LENGTH( registers ); j++ )
+        {
+            // Right at the start the thread simply runs the new code
+            if( ( Start          <  *registers[ j ] ) &&
+                ( ( Start + Size ) >  *registers[ j ] ) )
+            {
+                *registers[ j ] = Targets[ ( *registers[ j ] - Start ) / ARM64_INSTRUCTION_SIZE ];
+                retVal++;
+            }
+        } // for()
+
+        // Return addresses spilled by callers further up the stack
+        retVal += INTERNAL_ThreadSuspend_RelocateFrames( (uintptr_t) context->uc_mcontext.regs[ 29 ],
+                                                         (uintptr_t) context->uc_mcontext.sp,
+                                                         Start,
+                                                         Size,
+                                                         Targets );
+    } // for()
+#else
+    (void) i;
+    (void) Start;
+    (void) Size;
+#endif
+
+    return retVal;
+}
+
+void
+    ThreadSuspend_ResumeOthers
+    (
+        IN  OUT     thread_suspension_t*        Suspension
+    )
+{
+    __NOT_NULL_RETURN_VOID( Suspension )
+
+    // No new handler picks up the suspension from here on, the ones
+    // running see `gResuming` or the new generation and return
+    __atomic_store_n( &gActiveSuspension, NULL, __ATOMIC_SEQ_CST );
+    __atomic_store_n( &gResuming, 1, __ATOMIC_SEQ_CST );
+    __atomic_add_fetch( &Suspension->Generation, 1, __ATOMIC_SEQ_CST );
+
+    INTERNAL_Futex_WakeAll( &Suspension->Generation );
+
+    // The handlers still read `Suspension`
+    while( 0 != __atomic_load_n( &gHandlersRunning, __ATOMIC_ACQUIRE ) )
+    {
+        (void) sched_yield();
+    } // while()
+
+    BwsrFree( Suspension->Threads );
+
+    Suspension->Threads         = NULL;
+    Suspension->ThreadCount     = 0;
+    Suspension->ThreadCapacity  = 0;
+}
+
+#else
+
+BWSR_STATUS
+    ThreadSuspend_SuspendOthers
+    (
+        OUT         thread_suspension_t*        Suspension
+    )
+{
+    __NOT_NULL( Suspension )
+
+    memset( Suspension, 0, sizeof( thread_suspension_t ) );
+
+    return ERROR_UNIMPLEMENTED;
+}
+
+size_t
+    ThreadSuspend_RelocateThreads
+    (
+        IN  OUT     thread_suspension_t*        Suspension,
+        IN          const uintptr_t             Start,
+        IN          const size_t                Size,
+        IN          const uintptr_t*            Targets
+    )
+{
+    (void) Suspension;
+    (void) Start;
+    (void) Size;
+    (void) Targets;
+
+    return 0;
+}
+
+void
+    ThreadSuspend_ResumeOthers
+    (
+        IN  OUT     thread_suspension_t*        Suspension
+    )
+{
+    (void) Suspension;
+}
+
+#endif
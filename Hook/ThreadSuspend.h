@@ -0,0 +1,98 @@
+#ifndef __THREAD_SUSPEND_H__
+#define __THREAD_SUSPEND_H__
+
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#include "utility/utility.h"
+#include "utility/error.h"
+
+// -----------------------------------------------------------------------------
+//  STRUCTURES & DEFINITIONS
+// -----------------------------------------------------------------------------
+
+typedef struct suspended_thread_t {
+    // Kernel thread id
+    pid_t                   Tid;
+    // Parked in the suspend handler
+    volatile uint32_t       Arrived;
+    // `ucontext_t` saved by the kernel for the parked thread.
+    // Registers written here are live once the thread resumes.
+    void*                   Context;
+} suspended_thread_t;
+
+typedef struct thread_suspension_t {
+    // Every other thread of the process
+    suspended_thread_t*     Threads;
+    size_t                  ThreadCount;
+    size_t                  ThreadCapacity;
+    // Parked threads wait for this to change
+    uint32_t                Generation;
+} thread_suspension_t;
+
+// -----------------------------------------------------------------------------
+//  EXPORTED FUNCTIONS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Parks every other thread of the process in a signal handler. The
+ * calling thread keeps running. Nothing is allocated while threads are
+ * parked, a parked thread may hold any lock.
+ * \param[out]          Suspension          Threads that were parked
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Suspension` is `NULL`.
+ * \retval `ERROR_MEM_ALLOC` on allocation failure
+ * \retval `ERROR_FILE_IO` if `/proc/self/task` could not be read
+ * \retval `ERROR_THREAD_SUSPEND` if a thread did not park in time. No thread
+ * is left parked.
+ * \retval `ERROR_UNIMPLEMENTED` on platforms other than Android/Linux
+ * \retval `ERROR_SUCCESS` if every other thread is parked
+ */
+BWSR_STATUS
+    ThreadSuspend_SuspendOthers
+    (
+        OUT         thread_suspension_t*        Suspension
+    );
+
+/**
+ * \brief Moves parked threads whose program counter or link register lies
+ * within a range that is about to be rewritten. Link registers saved in the
+ * frame record chain of a thread are moved too. A frame pointer that does
+ * not point to a valid record ends the walk.
+ * \param[in,out]       Suspension          Parked threads
+ * \param[in]           Start               First byte of the range
+ * \param[in]           Size                Size of the range in bytes
+ * \param[in]           Targets             Where a thread at instruction `n` of
+ * the range continues, one entry per instruction. A thread at the first
+ * instruction is left alone.
+ * \return `size_t`
+ * \retval Number of registers that were moved
+ */
+size_t
+    ThreadSuspend_RelocateThreads
+    (
+        IN  OUT     thread_suspension_t*        Suspension,
+        IN          const uintptr_t             Start,
+        IN          const size_t                Size,
+        IN          const uintptr_t*            Targets
+    );
+
+/**
+ * \brief Lets every parked thread run again and waits until each one has left
+ * the signal handler.
+ * \param[in,out]       Suspension          Threads to resume
+ * \return void
+ */
+void
+    ThreadSuspend_ResumeOthers
+    (
+        IN  OUT     thread_suspension_t*        Suspension
+    );
+
+#endif // __THREAD_SUSPEND_H__
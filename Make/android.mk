@@ -42,6 +42,17 @@ GCCFLAGS_android_debug :=           \
 
 GCCFLAGS_android_release := $(ANDROID_GCCFLAGS)
 
+# Shared library for `LD_PRELOAD`, only `BWSR_API` symbols are exported
+GCCFLAGS_android_release-fast :=            \
+    $(filter-out -Os,$(ANDROID_GCCFLAGS))   \
+    -O2                                     \
+    -flto=thin                              \
+    -fPIC                                   \
+    -fvisibility=hidden
+
+SHARED_LDFLAGS_android :=           \
+    -ldl
+
 GCC_android := $(ANDROID_TOOLCHAIN)
 
 android_example_release:                    \
@@ -56,11 +67,15 @@ android_release:                            \
 android_debug:                              \
     build/android/debug/arm64/libBwsrHook
 
+android_release_fast:                       \
+    build/android/release-fast/arm64/libBwsrHook.so
+
 else
 
 android_example_release:
 android_example_debug:
 android_release:
 android_debug:
+android_release_fast:
 
 endif
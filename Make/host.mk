@@ -0,0 +1,140 @@
+
+UNAME        := $(shell uname -s)
+
+ifeq ($(UNAME),Linux)
+
+# Builds the library for the machine running `make` with its own compiler.
+# The assembler, relocator and ELF resolver only work on byte buffers, so
+# they compile and can be exercised on any Linux host. Hooks themselves only
+# work on arm64.
+HOST_TOOLCHAIN := cc
+AR_host        := ar
+HOST_ARCHS     := $(shell uname -m)
+HOST_PLATFORMS := host
+
+HOST_DIRS :=                \
+	Memory                  \
+	Hook                    \
+	SymbolResolve/Linux
+
+HOST_GCCFLAGS :=            \
+	-Os                     \
+	-Wall                   \
+	-Wextra                 \
+	-Werror
+
+GCCFLAGS_host_debug :=      \
+	$(HOST_GCCFLAGS)        \
+	-DDEBUG_MODE
+
+GCCFLAGS_host_release := $(HOST_GCCFLAGS)
+
+# `cc` may be GCC, which has no ThinLTO
+GCCFLAGS_host_release-fast :=               \
+	$(filter-out -Os,$(HOST_GCCFLAGS))      \
+	-O2                                     \
+	-flto                                   \
+	-fPIC                                   \
+	-fvisibility=hidden
+
+SHARED_LDFLAGS_host :=      \
+	-pthread                \
+	-ldl
+GCC_host := $(HOST_TOOLCHAIN)
+
+host_release:                                       \
+	$(BUILD_DIR)/host/release/$(HOST_ARCHS)/libBwsrHook
+
+host_debug:                                         \
+	$(BUILD_DIR)/host/debug/$(HOST_ARCHS)/libBwsrHook
+
+host_release_fast:                                  \
+	$(BUILD_DIR)/host/release-fast/$(HOST_ARCHS)/libBwsrHook.so
+
+# Unit tests and benchmarks in `Tests`, linked with the host objects.
+# `make test HOST_TEST_DEPLOYMENT=debug` also checks for leaks.
+HOST_TEST_DEPLOYMENT    ?= release
+HOST_BENCH_DEPLOYMENT   := release-fast
+
+HOST_TEST_DIR   := $(BUILD_DIR)/host/$(HOST_TEST_DEPLOYMENT)/$(HOST_ARCHS)/Tests
+HOST_BENCH_DIR  := $(BUILD_DIR)/host/$(HOST_BENCH_DEPLOYMENT)/$(HOST_ARCHS)/Tests
+
+HOST_TESTS :=               \
+	AssemblerTest           \
+	RelocatorTest           \
+	HookChainTest           \
+	HookStatisticsTest      \
+	HookStressTest
+
+# Too slow for every run, `make test-slow`
+HOST_SLOW_TESTS :=          \
+	ClassifierTest
+
+HOST_BENCHES :=             \
+	HookBench               \
+	RelocationBench         \
+	InstrumentationBench    \
+	SymbolBench
+
+# Sources a test includes to reach their static functions. Their objects are
+# left out of its link.
+HOST_INCLUDES_RelocatorTest     := Hook/InlineHook.c
+HOST_INCLUDES_ClassifierTest    := Hook/InlineHook.c
+HOST_INCLUDES_RelocationBench   := Hook/InlineHook.c
+
+# Arguments of a benchmark
+HOST_ARGS_SymbolBench           := $(HOST_BENCH_DIR)/libFixture.so
+
+HOST_SRCS := $(foreach dir,                         \
+               $(HOST_DIRS),                        \
+               $(wildcard $(dir)/*.c))
+
+# Host objects of a deployment, without the sources in $(2)
+host_objects = $(patsubst %.c,                                  \
+                 $(BUILD_DIR)/host/$(1)/$(HOST_ARCHS)/%.o,      \
+                 $(filter-out $(2),$(HOST_SRCS)))
+
+# Test or benchmark $(1) in deployment $(2)
+define host_test_rules
+$(BUILD_DIR)/host/$(2)/$(HOST_ARCHS)/Tests/$(1): Tests/$(1).c \
+$(wildcard Tests/*.h) $(HOST_INCLUDES_$(1)) \
+$(call host_objects,$(2),$(HOST_INCLUDES_$(1)))
+	@echo "Compiling $(1) for host in $(2)..."
+	@mkdir -p $$(dir $$@)
+	@$$(GCC_host) $$(GCCFLAGS_host_$(2)) -I. -o $$@ $$< $$(filter %.o,$$^) $$(SHARED_LDFLAGS_host)
+endef
+
+$(foreach test,$(HOST_TESTS) $(HOST_SLOW_TESTS), \
+	$(eval $(call host_test_rules,$(test),$(HOST_TEST_DEPLOYMENT))) \
+)
+
+$(foreach bench,$(HOST_BENCHES), \
+	$(eval $(call host_test_rules,$(bench),$(HOST_BENCH_DEPLOYMENT))) \
+)
+
+# Exports the symbols resolved by SymbolBench
+$(HOST_BENCH_DIR)/libFixture.so: Tests/Fixture.c
+	@echo "Compiling symbol fixture for host..."
+	@mkdir -p $(dir $@)
+	@$(GCC_host) -O2 -shared -fPIC -o $@ $<
+
+test: $(addprefix $(HOST_TEST_DIR)/,$(HOST_TESTS))
+	@$(foreach test,$^,echo "Running $(notdir $(test))..." && $(test) &&) true
+
+test-slow: $(addprefix $(HOST_TEST_DIR)/,$(HOST_SLOW_TESTS))
+	@$(foreach test,$^,echo "Running $(notdir $(test))..." && $(test) &&) true
+
+bench: $(addprefix $(HOST_BENCH_DIR)/,$(HOST_BENCHES)) $(HOST_ARGS_SymbolBench)
+	@$(foreach bench,$(HOST_BENCHES),echo "Running $(bench)..." && \
+		$(HOST_BENCH_DIR)/$(bench) $(HOST_ARGS_$(bench)) &&) true
+
+else
+
+host_release:
+host_debug:
+host_release_fast:
+test:
+test-slow:
+bench:
+
+endif
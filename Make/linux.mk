@@ -20,13 +20,27 @@ LINUX_GCCFLAGS :=           \
 	-Wextra                 \
 	-Werror
 
-EXAMPLE_LDFLAGS_linux :=
+EXAMPLE_LDFLAGS_linux :=   \
+	-pthread
 
 GCCFLAGS_linux_debug :=     \
 	$(LINUX_GCCFLAGS)       \
 	-DDEBUG_MODE
 
 GCCFLAGS_linux_release := $(LINUX_GCCFLAGS)
+
+# Shared library for `LD_PRELOAD`, only `BWSR_API` symbols are exported
+GCCFLAGS_linux_release-fast :=              \
+	$(filter-out -Os,$(LINUX_GCCFLAGS))     \
+	-O2                                     \
+	-flto=thin                              \
+	-fPIC                                   \
+	-fvisibility=hidden
+
+SHARED_LDFLAGS_linux :=     \
+	-fuse-ld=lld            \
+	-pthread                \
+	-ldl
 GCC_linux := $(LINUX_TOOLCHAIN)
 
 $(eval CLANG_ARCH := $(shell clang -dumpmachine | cut -d '-' -f 1))
@@ -47,11 +61,15 @@ linux_release:                                      \
 linux_debug:                                        \
 	$(BUILD_DIR)/linux/debug/arm64/libBwsrHook
 
+linux_release_fast:                                 \
+	$(BUILD_DIR)/linux/release-fast/arm64/libBwsrHook.so
+
 else
 
 linux_example_release:
 linux_example_debug:
 linux_release:
 linux_debug:
+linux_release_fast:
 
 endif
@@ -3,6 +3,8 @@
 //  INCLUDES
 // -----------------------------------------------------------------------------
 
+#include <stdbool.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/mman.h>
 
@@ -10,15 +12,17 @@
     #include <mach/mach.h>
 #endif
 
+#if defined( __linux__ ) || defined( __ANDROID__ )
+    #include <fcntl.h>
+    #include <sys/syscall.h>
+#endif
+
 #include "Memory/Memory.h"
 
 // -----------------------------------------------------------------------------
 //  STRUCTURES & DEFINITIONS
 // -----------------------------------------------------------------------------
 
-#define ALIGN_CEIL( ADDRESS, RANGE ) \
-    ( ( (uintptr_t) ADDRESS + (uintptr_t) RANGE - 1 ) & ~( (uintptr_t)RANGE - 1 ) )
-
 /**
  * \brief Enforces adherence to memory protection range.
  */
@@ -46,6 +50,27 @@ typedef enum MemoryPermission {
 
 const int kMmapFdOffset = 0;
 
+// Distance between two address hints when probing for near pages
+#define NEAR_PROBE_STEP     ( 1024 * 1024 )
+
+// Rescans of the address space when another thread takes the gap first
+#define NEAR_GAP_ATTEMPTS   3
+
+// Lowest address handed out from a gap, at or above `vm.mmap_min_addr`
+#define NEAR_GAP_FLOOR      ( 64 * 1024 )
+
+#if ( defined( __linux__ ) || defined( __ANDROID__ ) ) && !defined( MAP_FIXED_NOREPLACE )
+    #define MAP_FIXED_NOREPLACE     0x100000
+#endif
+
+#if defined( __NR_memfd_create ) && !defined( MFD_CLOEXEC )
+    #define MFD_CLOEXEC     0x0001U
+#endif
+
+// Set once the kernel refuses dual mapped pages so later
+// pages go straight to the anonymous mapping
+static bool gDualMappingUnavailable = false;
+
 // -----------------------------------------------------------------------------
 //  PROTOTYPES
 // -----------------------------------------------------------------------------
@@ -64,15 +89,75 @@ int
     );
 
 /**
- * \brief Initializes an Allocator.
+ * \brief Gets the size class of a free extent or of a request.
+ * \param[in]           Size                Size in bytes, a multiple of the granule
+ * \return size_t
+ * \retval Index into `FreeLists`
+ */
+static
+size_t
+    INTERNAL_GetSizeClass
+    (
+        IN          const size_t                Size
+    );
+
+/**
+ * \brief Pushes a free extent on the free list of its size class.
+ * \param[in,out]       Allocator           Allocator owning the free lists
+ * \param[in,out]       Extent              Extent to insert
+ * \return void
+ */
+static
+void
+    INTERNAL_FreeList_Insert
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN  OUT     free_extent_t*              Extent
+    );
+
+/**
+ * \brief Unlinks a free extent from the free list of its size class.
+ * \param[in,out]       Allocator           Allocator owning the free lists
+ * \param[in,out]       Extent              Extent to remove
+ * \return void
+ */
+static
+void
+    INTERNAL_FreeList_Remove
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN  OUT     free_extent_t*              Extent
+    );
+
+/**
+ * \brief Unlinks a free extent from its page and its free list, then frees it.
+ * \param[in,out]       Allocator           Allocator owning the free lists
+ * \param[in,out]       Page                Allocator of the page holding `Extent`
+ * \param[in,out]       Extent              Extent to destroy
+ * \return void
+ */
+static
+void
+    INTERNAL_Allocator_DestroyExtent
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN  OUT     allocator_t*                Page,
+        IN  OUT     free_extent_t*              Extent
+    );
+
+/**
+ * \brief Initializes an Allocator with a single free extent covering the page.
  * \param[in,out]       Allocator           Allocator instance to initialize.
  * \param[in]           VMPage              The Allocated virtual page
  * \param[in]           Capacity            The size of the virtual page
  * \param[in]           Alignment           The byte alignment of the page
- * \return void
+ * \return BWSR_STATUS
+ * \retval ERROR_ARGUMENT_IS_NULL if `Allocator` is `NULL`.
+ * \retval ERROR_MEM_ALLOC on allocation failure
+ * \retval ERROR_SUCCESS if the allocator is ready for use
  */
 static
-void
+BWSR_STATUS
     INTERNAL_AllocatorInitialize
     (
         OUT         allocator_t*                Allocator,
@@ -82,25 +167,52 @@ void
     );
 
 /**
- * \brief Gets the next page offset in the buffer of the allocator.
- * \param[in,out]       Data                Pointer to update with the page offset
- * \param[in]           Allocator           The allocator holding page buffers
- * \param[in]           BufferSize          The size needed by `Data`
- * \param[in]           Alignment           The byte alignment of the virtual page.
- * \return BWSR_STATUS
- * \retval ERROR_MEMORY_OVERFLOW if the allocator does not have enough memory available
- * \retval ERROR_ARGUMENT_IS_NULL If `Data` or `Allocator` is `NULL`.
- * \retval ERROR_INVALID_ARGUMENT_VALUE If `BufferSize` is not greater than `0`.
- * \retval ERROR_SUCCESS if `Data` now points to a region of `Alloctor`'s buffer
+ * \brief Carves a block from the front of a free extent.
+ * \param[out]          Data                Start of the block
+ * \param[in,out]       Allocator           Allocator owning the free lists
+ * \param[in,out]       Page                Allocator of the page holding `Extent`
+ * \param[in,out]       Extent              Extent large enough for `Size`
+ * \param[in]           Size                Size of the block, a multiple of the granule
+ * \return void
  */
 static
-BWSR_STATUS
-    INTERNAL_Allocator_GetNextOffsetInBuffer
+void
+    INTERNAL_Allocator_TakeFromExtent
     (
         OUT         uint8_t**                   Data,
-        IN  OUT     allocator_t*                Allocator,
-        IN          const uint32_t              BufferSize,
-        IN          const uint32_t              Alignment
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN  OUT     allocator_t*                Page,
+        IN  OUT     free_extent_t*              Extent,
+        IN          const uint32_t              Size
+    );
+
+/**
+ * \brief Finds the page holding an address.
+ * \param[in]           Allocator           Allocator to search
+ * \param[in]           Address             Address within the page
+ * \return size_t
+ * \retval Index of the page, `AllocatorCount` when not found
+ */
+static
+size_t
+    INTERNAL_MemoryAllocator_FindPage
+    (
+        IN          const memory_allocator_t*   Allocator,
+        IN          const uintptr_t             Address
+    );
+
+/**
+ * \brief Unmaps an unused page and drops it from the allocator.
+ * \param[in,out]       Allocator           Allocator owning the page
+ * \param[in]           Index               Index of the page
+ * \return void
+ */
+static
+void
+    INTERNAL_MemoryAllocator_ReleasePage
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN          const size_t                Index
     );
 
 /**
@@ -144,6 +256,161 @@ BWSR_STATUS
         IN          void*                       FixedAddress
     );
 
+/**
+ * \brief Checks that a whole region lies within `Range` bytes of `Target`
+ * \param[in]           Address             Start of the region
+ * \param[in]           Size                Size of the region
+ * \param[in]           Target              Address the region must be near
+ * \param[in]           Range               Maximum distance from `Target`
+ * \return bool
+ * \retval true if every byte of the region is within range
+ */
+static
+bool
+    INTERNAL_IsWithinRange
+    (
+        IN          const uintptr_t             Address,
+        IN          const size_t                Size,
+        IN          const uintptr_t             Target,
+        IN          const size_t                Range
+    );
+
+#if defined( __linux__ ) || defined( __ANDROID__ )
+
+/**
+ * \brief Finds the free gap in `/proc/self/maps` closest to `Target`
+ * \param[out]          Address             Start of the free range found
+ * \param[in]           MappingLength       Length the free range must hold
+ * \param[in]           Target              Address the range must be near
+ * \param[in]           Range               Maximum distance from `Target`
+ * \return BWSR_STATUS
+ * \retval ERROR_ARGUMENT_IS_NULL if `Address` is `NULL`.
+ * \retval ERROR_FILE_IO if the memory map could not be read.
+ * \retval ERROR_MEMORY_MAPPING if no gap within range is large enough.
+ * \retval ERROR_SUCCESS if `Address` holds a free, page aligned range
+ */
+static
+BWSR_STATUS
+    INTERNAL_FindNearGap
+    (
+        OUT         uintptr_t*                  Address,
+        IN          const size_t                MappingLength,
+        IN          const uintptr_t             Target,
+        IN          const size_t                Range
+    );
+
+#endif
+
+/**
+ * \brief Probes the address space around `Target` for a free page
+ * \param[in,out]       MemoryRegion        Address of mapped memory region
+ * \param[in]           MappingLength       Length of the mapping
+ * \param[in]           Target              Address the mapping must be near
+ * \param[in]           Range               Maximum distance from `Target`
+ * \param[in]           CodeFd              Code memory to map read/execute, `-1`
+ *                                          for an anonymous `PROT_NONE` page
+ * \return BWSR_STATUS
+ * \retval ERROR_ARGUMENT_IS_NULL if `MemoryRegion` is `NULL`.
+ * \retval ERROR_MEMORY_MAPPING if no free page was found within range.
+ * \retval ERROR_SUCCESS if a page was mapped within range
+ */
+static
+BWSR_STATUS
+    INTERNAL_AllocateNearVirtualPage
+    (
+        OUT         void**                      MemoryRegion,
+        IN          const size_t                MappingLength,
+        IN          const uintptr_t             Target,
+        IN          const size_t                Range,
+        IN          const int                   CodeFd
+    );
+
+/**
+ * \brief Creates an anonymous shared memory object to back a code page
+ * \param[out]          CodeFd              Descriptor of the memory object
+ * \param[in]           Length              Size of the memory object
+ * \return BWSR_STATUS
+ * \retval ERROR_ARGUMENT_IS_NULL if `CodeFd` is `NULL`.
+ * \retval ERROR_MEMORY_MAPPING if the memory object could not be created
+ * \retval ERROR_SUCCESS if `CodeFd` must be closed by the caller
+ */
+static
+BWSR_STATUS
+    INTERNAL_CreateCodeMemory
+    (
+        OUT         int*                        CodeFd,
+        IN          const size_t                Length
+    );
+
+/**
+ * \brief Maps the same code page twice, once read/execute and once
+ * read/write, so it can be written without changing its protection.
+ * \param[out]          Page                Read/execute view of the page
+ * \param[out]          Writable            Read/write view of the page
+ * \param[in]           PageSize            Size of the page
+ * \param[in]           Target              Address the page must be near
+ * \param[in]           Range               Maximum distance from `Target`, `0`
+ *                                          to map the page anywhere
+ * \return BWSR_STATUS
+ * \retval ERROR_ARGUMENT_IS_NULL if `Page` or `Writable` is `NULL`.
+ * \retval ERROR_MEMORY_MAPPING if the page could not be dual mapped
+ * \retval ERROR_SUCCESS if both views were mapped
+ */
+static
+BWSR_STATUS
+    INTERNAL_AllocateDualMappedPage
+    (
+        OUT         void**                      Page,
+        OUT         void**                      Writable,
+        IN          const size_t                PageSize,
+        IN          const uintptr_t             Target,
+        IN          const size_t                Range
+    );
+
+/**
+ * \brief Makes a freshly mapped page executable and hands it to a new allocator
+ * \param[in,out]       Allocator           Allocator receiving the page
+ * \param[in]           Page                The mapped page, unmapped on failure
+ * \param[in]           Writable            Read/write view of `Page` or `NULL`.
+ *                                          `Page` is already executable when set.
+ * \param[in]           PageSize            Size of the page
+ * \param[in,out]       Result              Block of `BufferSize` taken from the page
+ * \param[in]           BufferSize          Size of the block, a multiple of the granule
+ * \return BWSR_STATUS
+ * \retval ERROR_MEMORY_PERMISSION if the page permission could not be set
+ * \retval ERROR_MEM_ALLOC on allocation failure
+ * \retval ERROR_SUCCESS if `Result` points into the new page
+ */
+static
+BWSR_STATUS
+    INTERNAL_MemoryAllocator_AddPage
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN          void*                       Page,
+        IN          void*                       Writable,
+        IN          const size_t                PageSize,
+        OUT         uint8_t**                   Result,
+        IN          const size_t                BufferSize
+    );
+
+/**
+ * \brief Wraps an allocated block into a new `memory_range_t`
+ * \param[in,out]       MemoryRange         Range describing the block
+ * \param[in]           Block               Start of the block
+ * \param[in]           BufferSize          Size of the block
+ * \return BWSR_STATUS
+ * \retval ERROR_MEM_ALLOC on allocation failure
+ * \retval ERROR_SUCCESS if `MemoryRange` was created
+ */
+static
+BWSR_STATUS
+    INTERNAL_MemoryAllocator_CreateRange
+    (
+        OUT         memory_range_t**            MemoryRange,
+        IN          uint8_t*                    Block,
+        IN          const size_t                BufferSize
+    );
+
 // -----------------------------------------------------------------------------
 //  IMPLEMENTATION
 // -----------------------------------------------------------------------------
@@ -173,8 +440,113 @@ int
     return prot;
 }
 
+static
+size_t
+    INTERNAL_GetSizeClass
+    (
+        IN          const size_t                Size
+    )
+{
+    size_t          sizeClass       = 0;
+
+    sizeClass = ( Size / MEMORY_ALLOCATOR_GRANULE );
+
+    if( 0 != sizeClass )
+    {
+        sizeClass--;
+    }
+
+    if( sizeClass >= MEMORY_ALLOCATOR_SIZE_CLASSES )
+    {
+        sizeClass = ( MEMORY_ALLOCATOR_SIZE_CLASSES - 1 );
+    }
+
+    return sizeClass;
+}
+
+static
+void
+    INTERNAL_FreeList_Insert
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN  OUT     free_extent_t*              Extent
+    )
+{
+    size_t          sizeClass       = 0;
+
+    __NOT_NULL_RETURN_VOID( Allocator, Extent );
+
+    sizeClass = INTERNAL_GetSizeClass( Extent->Size );
+
+    Extent->Previous = NULL;
+    Extent->Next     = Allocator->FreeLists[ sizeClass ];
+
+    if( NULL != Extent->Next )
+    {
+        Extent->Next->Previous = Extent;
+    }
+
+    Allocator->FreeLists[ sizeClass ] = Extent;
+}
+
+static
+void
+    INTERNAL_FreeList_Remove
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN  OUT     free_extent_t*              Extent
+    )
+{
+    __NOT_NULL_RETURN_VOID( Allocator, Extent );
+
+    if( NULL != Extent->Previous )
+    {
+        Extent->Previous->Next = Extent->Next;
+    }
+    else {
+        Allocator->FreeLists[ INTERNAL_GetSizeClass( Extent->Size ) ] = Extent->Next;
+    } // Extent->Previous
+
+    if( NULL != Extent->Next )
+    {
+        Extent->Next->Previous = Extent->Previous;
+    }
+
+    Extent->Next     = NULL;
+    Extent->Previous = NULL;
+}
+
 static
 void
+    INTERNAL_Allocator_DestroyExtent
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN  OUT     allocator_t*                Page,
+        IN  OUT     free_extent_t*              Extent
+    )
+{
+    __NOT_NULL_RETURN_VOID( Allocator, Page, Extent );
+
+    INTERNAL_FreeList_Remove( Allocator, Extent );
+
+    if( NULL != Extent->PagePrevious )
+    {
+        Extent->PagePrevious->PageNext = Extent->PageNext;
+    }
+    else {
+        Page->FreeExtents = Extent->PageNext;
+    } // Extent->PagePrevious
+
+    if( NULL != Extent->PageNext )
+    {
+        Extent->PageNext->PagePrevious = Extent->PagePrevious;
+    }
+
+    BwsrFree( Extent );
+}
+
+static
+BWSR_STATUS
     INTERNAL_AllocatorInitialize
     (
         OUT         allocator_t*                Allocator,
@@ -183,51 +555,124 @@ void
         IN          uint32_t                    Alignment
     )
 {
-    __NOT_NULL_RETURN_VOID( Allocator );
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    free_extent_t*  extent          = NULL;
+
+    __NOT_NULL( Allocator );
+
+    if( NULL == ( extent = (free_extent_t*) BwsrCalloc( 1, sizeof( free_extent_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        extent->Page                = VMPage;
+        extent->Offset              = 0;
+        extent->Size                = Capacity;
+
+        Allocator->Buffer           = VMPage;
+        Allocator->Capacity         = Capacity;
+        Allocator->BuiltinAlignment = Alignment;
+        Allocator->Size             = 0;
+        Allocator->FreeExtents      = extent;
+
+        retVal = ERROR_SUCCESS;
+    } // BwsrCalloc()
 
-    Allocator->Buffer           = VMPage;
-    Allocator->Capacity         = Capacity;
-    Allocator->BuiltinAlignment = Alignment;
-    Allocator->Size             = 0;
+    return retVal;
 }
 
 static
-BWSR_STATUS
-    INTERNAL_Allocator_GetNextOffsetInBuffer
+void
+    INTERNAL_Allocator_TakeFromExtent
     (
         OUT         uint8_t**                   Data,
-        IN  OUT     allocator_t*                Allocator,
-        IN          const uint32_t              BufferSize,
-        IN          const uint32_t              Alignment
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN  OUT     allocator_t*                Page,
+        IN  OUT     free_extent_t*              Extent,
+        IN          const uint32_t              Size
     )
 {
-    BWSR_STATUS     retVal          = ERROR_FAILURE;
-    uint32_t        alignment       = 0;
-    uintptr_t       pageCeiling     = 0;
-
-    __NOT_NULL( Data, Allocator );
-    __GREATER_THAN_0( BufferSize );
-
-    alignment   = ( ( Alignment != 0 )
-                    ? Alignment
-                    : Allocator->BuiltinAlignment );
-    pageCeiling = (uintptr_t)( Allocator->Buffer + Allocator->Size );
+    __NOT_NULL_RETURN_VOID( Data, Allocator, Page, Extent );
 
-    Allocator->Size += ( ALIGN_CEIL( pageCeiling, alignment ) - pageCeiling );
+    *Data       = ( Page->Buffer + Extent->Offset );
+    Page->Size += Size;
 
-    if( ( Allocator->Size + BufferSize ) > Allocator->Capacity )
+    if( Extent->Size == Size )
     {
-        BWSR_DEBUG( LOG_WARNING, "Allocator not large enough!\n" );
-        retVal = ERROR_MEMORY_OVERFLOW;
+        INTERNAL_Allocator_DestroyExtent( Allocator, Page, Extent );
     }
     else {
-        *Data = (uint8_t*)( Allocator->Buffer + Allocator->Size );
-        Allocator->Size += BufferSize;
+        // Shrinking may move the extent to a smaller size class
+        INTERNAL_FreeList_Remove( Allocator, Extent );
 
-        retVal = ERROR_SUCCESS;
+        Extent->Offset += Size;
+        Extent->Size   -= Size;
+
+        INTERNAL_FreeList_Insert( Allocator, Extent );
+    } // Extent->Size
+}
+
+static
+size_t
+    INTERNAL_MemoryAllocator_FindPage
+    (
+        IN          const memory_allocator_t*   Allocator,
+        IN          const uintptr_t             Address
+    )
+{
+    size_t          ndx             = 0;
+    uintptr_t       buffer          = 0;
+
+    for( ndx = 0; ndx < Allocator->AllocatorCount; ndx++ )
+    {
+        buffer = (uintptr_t) Allocator->Allocators[ ndx ].Buffer;
+
+        if( ( Address >= buffer ) &&
+            ( Address <  ( buffer + Allocator->Allocators[ ndx ].Capacity ) ) )
+        {
+            break;
+        }
+    } // for()
+
+    return ndx;
+}
+
+static
+void
+    INTERNAL_MemoryAllocator_ReleasePage
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN          const size_t                Index
+    )
+{
+    allocator_t*    page            = NULL;
+
+    __NOT_NULL_RETURN_VOID( Allocator );
+
+    page = &Allocator->Allocators[ Index ];
+
+    while( NULL != page->FreeExtents )
+    {
+        INTERNAL_Allocator_DestroyExtent( Allocator, page, page->FreeExtents );
+    } // while()
+
+    (void) munmap( page->Buffer, page->Capacity );
+
+    if( NULL != page->Writable )
+    {
+        (void) munmap( page->Writable, page->Capacity );
     }
 
-    return retVal;
+    // Extents point at pages, not allocators, so the order can change
+    Allocator->AllocatorCount--;
+    Allocator->Allocators[ Index ] = Allocator->Allocators[ Allocator->AllocatorCount ];
+
+    if( 0 == Allocator->AllocatorCount )
+    {
+        BwsrFree( Allocator->Allocators );
+        Allocator->Allocators = NULL;
+    }
 }
 
 static
@@ -302,25 +747,581 @@ BWSR_STATUS
     return retVal;
 }
 
-BWSR_STATUS
-    MemoryAllocator_AllocateExecutionBlock
+static
+bool
+    INTERNAL_IsWithinRange
     (
-        IN  OUT     memory_range_t**            MemoryRange,
-        IN  OUT     memory_allocator_t*         Allocator,
+        IN          const uintptr_t             Address,
+        IN          const size_t                Size,
+        IN          const uintptr_t             Target,
+        IN          const size_t                Range
+    )
+{
+    uintptr_t       lowest          = 0;
+    uintptr_t       highest         = UINTPTR_MAX;
+
+    if( Target > Range )
+    {
+        lowest = Target - Range;
+    }
+
+    if( ( UINTPTR_MAX - Target ) > Range )
+    {
+        highest = Target + Range;
+    }
+
+    return ( ( Address                  >= lowest  ) &&
+             ( Address                  <  highest ) &&
+             ( ( highest - Address )    >= Size    ) );
+}
+
+#if defined( __linux__ ) || defined( __ANDROID__ )
+
+static
+BWSR_STATUS
+    INTERNAL_FindNearGap
+    (
+        OUT         uintptr_t*                  Address,
+        IN          const size_t                MappingLength,
+        IN          const uintptr_t             Target,
+        IN          const size_t                Range
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_MEMORY_MAPPING;
+    char            buffer[ 4096 ];
+    ssize_t         count           = 0;
+    ssize_t         i               = 0;
+    int             fd              = -1;
+    int             field           = 0;
+    int             digit           = 0;
+    uintptr_t       values[ 2 ]     = { 0, 0 };
+    uintptr_t       gapStart        = NEAR_GAP_FLOOR;
+    uintptr_t       gapEnd          = 0;
+    uintptr_t       lowest          = NEAR_GAP_FLOOR;
+    uintptr_t       highest         = UINTPTR_MAX;
+    uintptr_t       preferred       = 0;
+    uintptr_t       candidate       = 0;
+    uintptr_t       distance        = 0;
+    uintptr_t       bestDistance    = UINTPTR_MAX;
+
+    __NOT_NULL( Address );
+
+    if( ( Target > Range ) && ( ( Target - Range ) > lowest ) )
+    {
+        lowest = Target - Range;
+    }
+
+    if( ( UINTPTR_MAX - Target ) > Range )
+    {
+        highest = Target + Range;
+    }
+
+    lowest      = ALIGN_CEIL( lowest, MappingLength );
+    highest     = ALIGN_FLOOR( highest, MappingLength );
+    preferred   = ALIGN_FLOOR( Target, MappingLength );
+
+    if( -1 == ( fd = open( "/proc/self/maps", ( O_RDONLY | O_CLOEXEC ) ) ) )
+    {
+        BWSR_DEBUG( LOG_WARNING, "open() Failed\n" );
+        return ERROR_FILE_IO;
+    }
+
+    // Each line starts with "start-end " in hex, lines are sorted by
+    // address, so the space between the previous end and the next start
+    // is unmapped. Parsed as a stream since lines span reads.
+    while( 0 < ( count = read( fd, buffer, sizeof( buffer ) ) ) )
+    {
+        for( i = 0; i < count; i++ )
+        {
+            if( '\n' == buffer[ i ] )
+            {
+                field       = 0;
+                values[ 0 ] = 0;
+                values[ 1 ] = 0;
+                continue;
+            }
+
+            if( 2 <= field )
+            {
+                continue;
+            }
+
+            if( ( '0' <= buffer[ i ] ) && ( buffer[ i ] <= '9' ) )
+            {
+                digit = buffer[ i ] - '0';
+            }
+            else if( ( 'a' <= buffer[ i ] ) && ( buffer[ i ] <= 'f' ) )
+            {
+                digit = buffer[ i ] - 'a' + 10;
+            }
+            else {
+                // '-' ends the start address, ' ' the end address
+                field++;
+
+                if( 2 != field )
+                {
+                    continue;
+                }
+
+                gapEnd = values[ 0 ];
+
+                if( gapEnd > gapStart )
+                {
+                    candidate = preferred;
+
+                    if( candidate < gapStart )
+                    {
+                        candidate = gapStart;
+                    }
+
+                    if( candidate > ( gapEnd - MappingLength ) )
+                    {
+                        candidate = gapEnd - MappingLength;
+                    }
+
+                    if( ( ( gapEnd - gapStart )    >= MappingLength   ) &&
+                        ( candidate                 >= lowest          ) &&
+                        ( candidate                 <  highest         ) &&
+                        ( ( highest - candidate )   >= MappingLength   ) )
+                    {
+                        distance = ( candidate > Target )
+                                        ? ( candidate - Target )
+                                        : ( Target - candidate );
+
+                        if( distance < bestDistance )
+                        {
+                            bestDistance    = distance;
+                            *Address        = candidate;
+                            retVal          = ERROR_SUCCESS;
+                        }
+                    } // fits
+                } // gap
+
+                if( values[ 1 ] > gapStart )
+                {
+                    gapStart = values[ 1 ];
+                }
+
+                continue;
+            } // digit
+
+            values[ field ] = ( values[ field ] << 4 ) | (uintptr_t) digit;
+        } // for()
+    } // while()
+
+    (void) close( fd );
+
+    if( 0 > count )
+    {
+        BWSR_DEBUG( LOG_WARNING, "read() Failed\n" );
+        retVal = ERROR_FILE_IO;
+    }
+
+    return retVal;
+}
+
+#endif
+
+static
+BWSR_STATUS
+    INTERNAL_AllocateNearVirtualPage
+    (
+        OUT         void**                      MemoryRegion,
+        IN          const size_t                MappingLength,
+        IN          const uintptr_t             Target,
+        IN          const size_t                Range,
+        IN          const int                   CodeFd
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_MEMORY_MAPPING;
+    uintptr_t       base            = 0;
+    uintptr_t       hint            = 0;
+    size_t          distance        = 0;
+    int             direction       = 0;
+    int             protection      = PROT_NONE;
+    int             flags           = ( MAP_PRIVATE | MAP_ANONYMOUS );
+    int             fd              = kMmapFd;
+    void*           region          = NULL;
+#if defined( __linux__ ) || defined( __ANDROID__ )
+    int             attempt         = 0;
+#endif
+
+    __NOT_NULL( MemoryRegion );
+
+    if( -1 != CodeFd )
+    {
+        protection  = ( PROT_READ | PROT_EXEC );
+        flags       = MAP_SHARED;
+        fd          = CodeFd;
+    }
+
+#if defined( __linux__ ) || defined( __ANDROID__ )
+    // Place the page in the closest free gap. MAP_FIXED_NOREPLACE fails
+    // when another thread mapped the gap since the scan, and kernels
+    // before 4.17 treat it as a hint, so the address is checked as well.
+    for( attempt = 0; ( attempt < NEAR_GAP_ATTEMPTS ) && ( ERROR_SUCCESS != retVal ); attempt++ )
+    {
+        if( ERROR_SUCCESS != INTERNAL_FindNearGap( &hint, MappingLength, Target, Range ) )
+        {
+            break;
+        }
+
+        region = mmap( (void*) hint,
+                       MappingLength,
+                       protection,
+                       ( flags | MAP_FIXED_NOREPLACE ),
+                       fd,
+                       kMmapFdOffset );
+
+        if( (void*) hint == region )
+        {
+            *MemoryRegion   = region;
+            retVal          = ERROR_SUCCESS;
+        }
+        else if( MAP_FAILED != region )
+        {
+            (void) munmap( region, MappingLength );
+        } // region
+    } // for()
+#endif
+
+    base = ALIGN_FLOOR( Target, MappingLength );
+
+    // Falls back to hints when the memory map could not be used.
+    // Closest hints first, alternating below and above the target.
+    // The kernel only honours a hint when the range there is free.
+    for( distance = NEAR_PROBE_STEP;
+         ( distance < Range ) && ( ERROR_SUCCESS != retVal );
+         distance += NEAR_PROBE_STEP )
+    {
+        for( direction = 0; ( direction < 2 ) && ( ERROR_SUCCESS != retVal ); direction++ )
+        {
+            if( 0 == direction )
+            {
+                if( base <= distance )
+                {
+                    continue;
+                }
+
+                hint = base - distance;
+            }
+            else {
+                if( ( UINTPTR_MAX - base ) <= ( distance + MappingLength ) )
+                {
+                    continue;
+                }
+
+                hint = base + distance;
+            } // direction
+
+            region = mmap( (void*) hint,
+                           MappingLength,
+                           protection,
+                           flags,
+                           fd,
+                           kMmapFdOffset );
+
+            if( MAP_FAILED == region )
+            {
+                continue;
+            }
+
+            if( INTERNAL_IsWithinRange( (uintptr_t) region, MappingLength, Target, Range ) )
+            {
+                *MemoryRegion   = region;
+                retVal          = ERROR_SUCCESS;
+            }
+            else {
+                (void) munmap( region, MappingLength );
+            } // INTERNAL_IsWithinRange()
+        } // for()
+    } // for()
+
+    if( ERROR_SUCCESS != retVal )
+    {
+        BWSR_DEBUG( LOG_WARNING, "No free page within range of %p\n", (void*) Target );
+    }
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_CreateCodeMemory
+    (
+        OUT         int*                        CodeFd,
+        IN          const size_t                Length
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_MEMORY_MAPPING;
+
+    __NOT_NULL( CodeFd );
+
+    *CodeFd = -1;
+
+#if defined( __NR_memfd_create )
+    // Called through syscall() since older libc and bionic
+    // releases do not wrap memfd_create
+    if( -1 == ( *CodeFd = (int) syscall( __NR_memfd_create,
+                                         "bwsr-code",
+                                         MFD_CLOEXEC ) ) )
+    {
+        BWSR_DEBUG( LOG_WARNING, "memfd_create() Failed\n" );
+    }
+    else if( 0 != ftruncate( *CodeFd, (off_t) Length ) )
+    {
+        BWSR_DEBUG( LOG_WARNING, "ftruncate() Failed\n" );
+
+        (void) close( *CodeFd );
+        *CodeFd = -1;
+    }
+    else {
+        retVal = ERROR_SUCCESS;
+    } // memfd_create()
+#else
+    (void) Length;
+#endif
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_AllocateDualMappedPage
+    (
+        OUT         void**                      Page,
+        OUT         void**                      Writable,
+        IN          const size_t                PageSize,
+        IN          const uintptr_t             Target,
+        IN          const size_t                Range
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_MEMORY_MAPPING;
+    void*           executable      = MAP_FAILED;
+    int             codeFd          = -1;
+
+    __NOT_NULL( Page, Writable );
+
+    if( gDualMappingUnavailable )
+    {
+        retVal = ERROR_MEMORY_MAPPING;
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_CreateCodeMemory( &codeFd, PageSize ) ) )
+    {
+        gDualMappingUnavailable = true;
+    }
+    else {
+        if( 0 != Range )
+        {
+            if( ERROR_SUCCESS != ( retVal = INTERNAL_AllocateNearVirtualPage( &executable,
+                                                                              PageSize,
+                                                                              Target,
+                                                                              Range,
+                                                                              codeFd ) ) )
+            {
+                executable = MAP_FAILED;
+
+                // Running out of near address space says nothing about
+                // the kernel, so only latch when an unconstrained
+                // executable view of the same object is refused as well
+                if( MAP_FAILED == ( executable = mmap( NULL,
+                                                       PageSize,
+                                                       ( PROT_READ | PROT_EXEC ),
+                                                       MAP_SHARED,
+                                                       codeFd,
+                                                       kMmapFdOffset ) ) )
+                {
+                    BWSR_DEBUG( LOG_WARNING, "mmap() Failed\n" );
+                    gDualMappingUnavailable = true;
+                }
+                else {
+                    (void) munmap( executable, PageSize );
+                    executable = MAP_FAILED;
+                } // mmap()
+            } // INTERNAL_AllocateNearVirtualPage()
+        }
+        else if( MAP_FAILED == ( executable = mmap( NULL,
+                                                    PageSize,
+                                                    ( PROT_READ | PROT_EXEC ),
+                                                    MAP_SHARED,
+                                                    codeFd,
+                                                    kMmapFdOffset ) ) )
+        {
+            // Usually a policy forbidding executable shared memory
+            BWSR_DEBUG( LOG_WARNING, "mmap() Failed\n" );
+            gDualMappingUnavailable = true;
+            retVal                  = ERROR_MEMORY_MAPPING;
+        } // Range
+
+        if( MAP_FAILED == executable )
+        {
+            retVal = ERROR_MEMORY_MAPPING;
+        }
+        else if( MAP_FAILED == ( *Writable = mmap( NULL,
+                                                   PageSize,
+                                                   ( PROT_READ | PROT_WRITE ),
+                                                   MAP_SHARED,
+                                                   codeFd,
+                                                   kMmapFdOffset ) ) )
+        {
+            BWSR_DEBUG( LOG_WARNING, "mmap() Failed\n" );
+            (void) munmap( executable, PageSize );
+            gDualMappingUnavailable = true;
+            retVal                  = ERROR_MEMORY_MAPPING;
+        }
+        else {
+            *Page   = executable;
+            retVal  = ERROR_SUCCESS;
+        } // mmap()
+
+        // Both views keep the memory object alive
+        (void) close( codeFd );
+    } // INTERNAL_CreateCodeMemory()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_MemoryAllocator_AddPage
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN          void*                       Page,
+        IN          void*                       Writable,
+        IN          const size_t                PageSize,
+        OUT         uint8_t**                   Result,
+        IN          const size_t                BufferSize
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    allocator_t*    allocators      = NULL;
+    allocator_t*    page            = NULL;
+    size_t          allocatorSize   = 0;
+    bool            owned           = false;
+
+    __NOT_NULL( Allocator, Page, Result );
+
+    if( NULL != Writable )
+    {
+        retVal = ERROR_SUCCESS;
+    }
+    else {
+        retVal = INTERNAL_SetPagePermission( Page,
+                                             PageSize,
+                                             kReadExecute );
+    } // Writable
+
+    if( ERROR_SUCCESS != retVal )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_SetPagePermission() Failed\n" );
+    }
+    else {
+        allocatorSize = ( Allocator->AllocatorCount + 1 ) * sizeof( allocator_t );
+
+        if( NULL == Allocator->Allocators )
+        {
+            allocators = (allocator_t*) BwsrMalloc( allocatorSize );
+        }
+        else {
+            allocators = (allocator_t*) BwsrRealloc( Allocator->Allocators, allocatorSize );
+        }
+
+        if( NULL == allocators )
+        {
+            BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+            retVal = ERROR_MEM_ALLOC;
+        }
+        else {
+            Allocator->Allocators   = allocators;
+            page                    = &Allocator->Allocators[ Allocator->AllocatorCount ];
+
+            if( ERROR_SUCCESS != ( retVal = INTERNAL_AllocatorInitialize( page,
+                                                                          (uint8_t*) Page,
+                                                                          (uint32_t) PageSize,
+                                                                          MEMORY_ALLOCATOR_GRANULE ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "INTERNAL_AllocatorInitialize() Failed\n" );
+            }
+            else {
+                page->Writable = (uint8_t*) Writable;
+
+                Allocator->AllocatorCount++;
+                owned = true;
+
+                INTERNAL_FreeList_Insert( Allocator, page->FreeExtents );
+
+                INTERNAL_Allocator_TakeFromExtent( Result,
+                                                   Allocator,
+                                                   page,
+                                                   page->FreeExtents,
+                                                   (uint32_t) BufferSize );
+            } // INTERNAL_AllocatorInitialize()
+        } // BwsrMalloc()
+    } // INTERNAL_SetPagePermission()
+
+    if( false == owned )
+    {
+        (void) munmap( Page, PageSize );
+
+        if( NULL != Writable )
+        {
+            (void) munmap( Writable, PageSize );
+        }
+    } // owned
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_MemoryAllocator_CreateRange
+    (
+        OUT         memory_range_t**            MemoryRange,
+        IN          uint8_t*                    Block,
+        IN          const size_t                BufferSize
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+
+    __NOT_NULL( MemoryRange, Block );
+
+    if( NULL == ( *MemoryRange = (memory_range_t*) BwsrMalloc( sizeof( memory_range_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        ( *MemoryRange )->Start = (uintptr_t) Block;
+        ( *MemoryRange )->Size  = BufferSize;
+
+        retVal = ERROR_SUCCESS;
+    } // BwsrMalloc()
+
+    return retVal;
+}
+
+BWSR_STATUS
+    MemoryAllocator_AllocateExecutionBlock
+    (
+        IN  OUT     memory_range_t**            MemoryRange,
+        IN  OUT     memory_allocator_t*         Allocator,
         IN          size_t                      BufferSize
     )
 {
     BWSR_STATUS     retVal          = ERROR_FAILURE;
     uint8_t*        result          = NULL;
     void*           page            = NULL;
-    size_t          i               = 0;
-    size_t          allocatorSize   = 0;
+    void*           writable        = NULL;
+    free_extent_t*  extent          = NULL;
+    size_t          sizeClass       = 0;
+    size_t          blockSize       = 0;
     size_t          pageSize        = 0;
 
     __NOT_NULL( Allocator, MemoryRange );
     __GREATER_THAN_0( BufferSize );
 
-    pageSize = (size_t)sysconf( _SC_PAGESIZE );
+    pageSize    = (size_t)sysconf( _SC_PAGESIZE );
+    blockSize   = ALIGN_CEIL( BufferSize, MEMORY_ALLOCATOR_GRANULE );
 
     if( BufferSize > pageSize )
     {
@@ -330,74 +1331,398 @@ BWSR_STATUS
         return ERROR_MEMORY_OVERFLOW;
     } // dummy check
 
-    for( i = 0; ( i < Allocator->AllocatorCount ) && ( ERROR_SUCCESS != retVal ); i++ )
+    // Every extent of an exact size class fits, only the
+    // last class has to be searched
+    for( sizeClass = INTERNAL_GetSizeClass( blockSize );
+         ( sizeClass < MEMORY_ALLOCATOR_SIZE_CLASSES ) && ( NULL == extent );
+         sizeClass++ )
     {
-        retVal = INTERNAL_Allocator_GetNextOffsetInBuffer( &result,
-                                                           &Allocator->Allocators[ i ],
-                                                           BufferSize,
-                                                           0 );
+        extent = Allocator->FreeLists[ sizeClass ];
+
+        while( ( NULL != extent ) && ( extent->Size < blockSize ) )
+        {
+            extent = extent->Next;
+        } // while()
     } // for()
 
-    if( !result )
+    if( NULL != extent )
+    {
+        INTERNAL_Allocator_TakeFromExtent( &result,
+                                           Allocator,
+                                           &Allocator->Allocators[ INTERNAL_MemoryAllocator_FindPage( Allocator,
+                                                                                                     (uintptr_t) extent->Page ) ],
+                                           extent,
+                                           (uint32_t) blockSize );
+        retVal = ERROR_SUCCESS;
+    }
+    else if( ERROR_SUCCESS == INTERNAL_AllocateDualMappedPage( &page,
+                                                               &writable,
+                                                               pageSize,
+                                                               0,
+                                                               0 ) )
+    {
+        retVal = INTERNAL_MemoryAllocator_AddPage( Allocator,
+                                                   page,
+                                                   writable,
+                                                   pageSize,
+                                                   &result,
+                                                   blockSize );
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_AllocateVirtualPage( &page,
+                                                                       pageSize,
+                                                                       kNoAccess,
+                                                                       NULL ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_AllocateVirtualPage() Failed\n" );
+    }
+    else {
+        retVal = INTERNAL_MemoryAllocator_AddPage( Allocator,
+                                                   page,
+                                                   NULL,
+                                                   pageSize,
+                                                   &result,
+                                                   blockSize );
+    } // extent
+
+    if( ERROR_SUCCESS == retVal )
+    {
+        Allocator->BytesRequested += BufferSize;
+
+        retVal = INTERNAL_MemoryAllocator_CreateRange( MemoryRange,
+                                                       result,
+                                                       BufferSize );
+    } // result
+
+    return retVal;
+}
+
+BWSR_STATUS
+    MemoryAllocator_AllocateNearExecutionBlock
+    (
+        IN  OUT     memory_range_t**            MemoryRange,
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN          size_t                      BufferSize,
+        IN          uintptr_t                   Target,
+        IN          size_t                      Range
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    uint8_t*        result          = NULL;
+    void*           page            = NULL;
+    void*           writable        = NULL;
+    allocator_t*    allocator       = NULL;
+    free_extent_t*  extent          = NULL;
+    size_t          i               = 0;
+    size_t          blockSize       = 0;
+    size_t          pageSize        = 0;
+
+    __NOT_NULL( Allocator, MemoryRange );
+    __GREATER_THAN_0( BufferSize, Range );
+
+    pageSize    = (size_t)sysconf( _SC_PAGESIZE );
+    blockSize   = ALIGN_CEIL( BufferSize, MEMORY_ALLOCATOR_GRANULE );
+
+    if( BufferSize > pageSize )
     {
-        if( ERROR_SUCCESS != ( retVal = INTERNAL_AllocateVirtualPage( &page,
-                                                                      pageSize,
-                                                                      kNoAccess,
-                                                                      NULL ) ) )
+        BWSR_DEBUG( LOG_ERROR,
+                    "Requested Size is too large: %zu\n",
+                    BufferSize );
+        return ERROR_MEMORY_OVERFLOW;
+    } // dummy check
+
+    // Pages already mapped near the target are shared
+    for( i = 0; ( i < Allocator->AllocatorCount ) && ( NULL == result ); i++ )
+    {
+        allocator = &Allocator->Allocators[ i ];
+
+        if( INTERNAL_IsWithinRange( (uintptr_t) allocator->Buffer,
+                                    allocator->Capacity,
+                                    Target,
+                                    Range ) )
         {
-            BWSR_DEBUG( LOG_ERROR, "INTERNAL_AllocateVirtualPage() Failed\n" );
+            extent = allocator->FreeExtents;
+
+            while( ( NULL != extent ) && ( extent->Size < blockSize ) )
+            {
+                extent = extent->PageNext;
+            } // while()
+
+            if( NULL != extent )
+            {
+                INTERNAL_Allocator_TakeFromExtent( &result,
+                                                   Allocator,
+                                                   allocator,
+                                                   extent,
+                                                   (uint32_t) blockSize );
+            }
+        } // INTERNAL_IsWithinRange()
+    } // for()
+
+    if( NULL != result )
+    {
+        retVal = ERROR_SUCCESS;
+    }
+    else if( ERROR_SUCCESS == INTERNAL_AllocateDualMappedPage( &page,
+                                                               &writable,
+                                                               pageSize,
+                                                               Target,
+                                                               Range ) )
+    {
+        retVal = INTERNAL_MemoryAllocator_AddPage( Allocator,
+                                                   page,
+                                                   writable,
+                                                   pageSize,
+                                                   &result,
+                                                   blockSize );
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_AllocateNearVirtualPage( &page,
+                                                                           pageSize,
+                                                                           Target,
+                                                                           Range,
+                                                                           -1 ) ) )
+    {
+        BWSR_DEBUG( LOG_WARNING, "INTERNAL_AllocateNearVirtualPage() Failed\n" );
+    }
+    else {
+        retVal = INTERNAL_MemoryAllocator_AddPage( Allocator,
+                                                   page,
+                                                   NULL,
+                                                   pageSize,
+                                                   &result,
+                                                   blockSize );
+    } // INTERNAL_AllocateNearVirtualPage()
+
+    if( ERROR_SUCCESS == retVal )
+    {
+        Allocator->BytesRequested += BufferSize;
+
+        retVal = INTERNAL_MemoryAllocator_CreateRange( MemoryRange,
+                                                       result,
+                                                       BufferSize );
+    } // result
+
+    return retVal;
+}
+
+BWSR_STATUS
+    MemoryAllocator_FreeExecutionBlock
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN          const memory_range_t*       MemoryRange
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    allocator_t*    page            = NULL;
+    free_extent_t*  previous        = NULL;
+    free_extent_t*  next            = NULL;
+    free_extent_t*  extent          = NULL;
+    size_t          index           = 0;
+    uint32_t        offset          = 0;
+    uint32_t        blockSize       = 0;
+
+    __NOT_NULL( Allocator, MemoryRange );
+
+    blockSize = (uint32_t) ALIGN_CEIL( MemoryRange->Size, MEMORY_ALLOCATOR_GRANULE );
+
+    if( Allocator->AllocatorCount == ( index = INTERNAL_MemoryAllocator_FindPage( Allocator, MemoryRange->Start ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "Block is not owned by the allocator\n" );
+        retVal = ERROR_NOT_FOUND;
+    }
+    else {
+        page    = &Allocator->Allocators[ index ];
+        offset  = (uint32_t)( MemoryRange->Start - (uintptr_t) page->Buffer );
+        next    = page->FreeExtents;
+
+        while( ( NULL != next ) && ( next->Offset < offset ) )
+        {
+            previous    = next;
+            next        = next->PageNext;
+        } // while()
+
+        retVal = ERROR_SUCCESS;
+
+        if( ( NULL != previous ) && ( ( previous->Offset + previous->Size ) == offset ) )
+        {
+            // Grow the extent in front of the block
+            INTERNAL_FreeList_Remove( Allocator, previous );
+            previous->Size += blockSize;
+            extent          = previous;
+        }
+        else if( NULL == ( extent = (free_extent_t*) BwsrCalloc( 1, sizeof( free_extent_t ) ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+            retVal = ERROR_MEM_ALLOC;
         }
         else {
-            if( ERROR_SUCCESS != ( retVal = INTERNAL_SetPagePermission( page,
-                                                                        pageSize,
-                                                                        kReadExecute ) ) )
+            extent->Page            = page->Buffer;
+            extent->Offset          = offset;
+            extent->Size            = blockSize;
+            extent->PagePrevious    = previous;
+            extent->PageNext        = next;
+
+            if( NULL != previous )
             {
-                BWSR_DEBUG( LOG_ERROR, "OSMemory_SetPermission() Failed\n" );
+                previous->PageNext = extent;
             }
             else {
-                Allocator->AllocatorCount++;
-                allocatorSize = Allocator->AllocatorCount * sizeof( allocator_t );
+                page->FreeExtents = extent;
+            } // previous
 
-                if( NULL == Allocator->Allocators )
-                {
-                    Allocator->Allocators = (allocator_t*) BwsrMalloc( allocatorSize );
-                }
-                else {
-                    Allocator->Allocators = (allocator_t*) BwsrRealloc( Allocator->Allocators, allocatorSize );
-                }
+            if( NULL != next )
+            {
+                next->PagePrevious = extent;
+            }
+        } // Coalesce previous
 
-                if( NULL == Allocator->Allocators )
-                {
-                    BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
-                    retVal = ERROR_MEM_ALLOC;
-                }
-                else {
-                    INTERNAL_AllocatorInitialize( &Allocator->Allocators[ Allocator->AllocatorCount - 1 ],
-                                                  (uint8_t*) page,
-                                                  (uint32_t) sysconf( _SC_PAGESIZE ),
-                                                  8 );
-
-                    retVal = INTERNAL_Allocator_GetNextOffsetInBuffer( &result,
-                                                                       &Allocator->Allocators[ Allocator->AllocatorCount - 1 ],
-                                                                       BufferSize,
-                                                                       0 );
-                } // BwsrMalloc()
-            } // OSMemory_SetPermission()
-        } // INTERNAL_AllocateVirtualPage()
-    } // !result
+        if( ERROR_SUCCESS == retVal )
+        {
+            if( ( NULL != next ) && ( ( extent->Offset + extent->Size ) == next->Offset ) )
+            {
+                // Swallow the extent behind the block
+                extent->Size += next->Size;
+                INTERNAL_Allocator_DestroyExtent( Allocator, page, next );
+            } // Coalesce next
+
+            INTERNAL_FreeList_Insert( Allocator, extent );
+
+            page->Size                  -= blockSize;
+            Allocator->BytesRequested   -= MemoryRange->Size;
+
+            if( 0 == page->Size )
+            {
+                INTERNAL_MemoryAllocator_ReleasePage( Allocator, index );
+            }
+        } // ERROR_SUCCESS
+    } // INTERNAL_MemoryAllocator_FindPage()
+
+    return retVal;
+}
+
+BWSR_STATUS
+    MemoryAllocator_ShrinkExecutionBlock
+    (
+        IN  OUT     memory_allocator_t*         Allocator,
+        IN  OUT     memory_range_t*             MemoryRange,
+        IN          size_t                      BufferSize
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    memory_range_t  tail            = { 0 };
+    size_t          blockSize       = 0;
+    size_t          keptSize        = 0;
+
+    __NOT_NULL( Allocator, MemoryRange );
+    __GREATER_THAN_0( BufferSize );
+
+    blockSize   = ALIGN_CEIL( MemoryRange->Size, MEMORY_ALLOCATOR_GRANULE );
+    keptSize    = ALIGN_CEIL( BufferSize, MEMORY_ALLOCATOR_GRANULE );
+
+    if( BufferSize > MemoryRange->Size )
+    {
+        BWSR_DEBUG( LOG_ERROR,
+                    "Cannot grow a block: %zu > %zu\n",
+                    BufferSize,
+                    MemoryRange->Size );
+        retVal = ERROR_INVALID_ARGUMENT_VALUE;
+    }
+    else if( keptSize == blockSize )
+    {
+        retVal = ERROR_SUCCESS;
+    }
+    else {
+        // The tail is released like a block of its own
+        tail.Start  = MemoryRange->Start + keptSize;
+        tail.Size   = blockSize - keptSize;
+
+        retVal = MemoryAllocator_FreeExecutionBlock( Allocator, &tail );
+    } // BufferSize
 
     if( ERROR_SUCCESS == retVal )
     {
-        if( NULL == ( *MemoryRange = (memory_range_t*) BwsrMalloc( sizeof( memory_range_t ) ) ) )
+        Allocator->BytesRequested   += tail.Size;
+        Allocator->BytesRequested   -= ( MemoryRange->Size - BufferSize );
+        MemoryRange->Size            = BufferSize;
+    }
+
+    return retVal;
+}
+
+BWSR_STATUS
+    MemoryAllocator_GetStatistics
+    (
+        IN          const memory_allocator_t*   Allocator,
+        OUT         memory_allocator_stats_t*   Statistics
+    )
+{
+    const free_extent_t*    extent      = NULL;
+    size_t                  ndx         = 0;
+    size_t                  used        = 0;
+
+    __NOT_NULL( Allocator, Statistics );
+
+    memset( Statistics, 0, sizeof( memory_allocator_stats_t ) );
+
+    for( ndx = 0; ndx < Allocator->AllocatorCount; ndx++ )
+    {
+        Statistics->PageCount++;
+        Statistics->BytesMapped += Allocator->Allocators[ ndx ].Capacity;
+        used                    += Allocator->Allocators[ ndx ].Size;
+
+        for( extent = Allocator->Allocators[ ndx ].FreeExtents; NULL != extent; extent = extent->PageNext )
         {
-            BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
-            retVal = ERROR_MEM_ALLOC;
+            Statistics->BytesFree += extent->Size;
+
+            if( extent->Size > Statistics->LargestFreeBlock )
+            {
+                Statistics->LargestFreeBlock = extent->Size;
+            }
+        } // for()
+    } // for()
+
+    Statistics->BytesInUse  = Allocator->BytesRequested;
+    Statistics->BytesWasted = ( used - Allocator->BytesRequested );
+
+    return ERROR_SUCCESS;
+}
+
+uintptr_t
+    MemoryAllocator_GetWritableAddress
+    (
+        IN          const memory_allocator_t*   Allocator,
+        IN          const uintptr_t             Address
+    )
+{
+    uintptr_t       writable        = 0;
+    size_t          index           = 0;
+    allocator_t*    page            = NULL;
+
+    if( ( NULL != Allocator ) &&
+        ( Allocator->AllocatorCount != ( index = INTERNAL_MemoryAllocator_FindPage( Allocator, Address ) ) ) )
+    {
+        page = &Allocator->Allocators[ index ];
+
+        if( NULL != page->Writable )
+        {
+            writable = (uintptr_t) page->Writable + ( Address - (uintptr_t) page->Buffer );
         }
-        else {
-            ( *MemoryRange )->Start = (uintptr_t)result;
-            ( *MemoryRange )->Size  = BufferSize;
-        } // BwsrMalloc()
-    } // INTERNAL_Allocator_GetNextOffsetInBuffer()
+    } // INTERNAL_MemoryAllocator_FindPage()
 
-    return retVal;
-}
\ No newline at end of file
+    return writable;
+}
+
+void
+    MemoryAllocator_Release
+    (
+        IN  OUT     memory_allocator_t*         Allocator
+    )
+{
+    __NOT_NULL_RETURN_VOID( Allocator );
+
+    while( 0 != Allocator->AllocatorCount )
+    {
+        INTERNAL_MemoryAllocator_ReleasePage( Allocator, Allocator->AllocatorCount - 1 );
+    } // while()
+
+    Allocator->BytesRequested = 0;
+}
@@ -15,6 +15,15 @@
 //  STRUCTURES & DEFINITIONS
 // -----------------------------------------------------------------------------
 
+// Blocks are handed out in multiples of this many bytes
+#define MEMORY_ALLOCATOR_GRANULE        8
+
+// Free extents of `( n + 1 ) * MEMORY_ALLOCATOR_GRANULE` bytes are kept in
+// size class `n`. The last size class holds every larger extent.
+#define MEMORY_ALLOCATOR_SIZE_CLASSES   16
+
+typedef struct free_extent_t free_extent_t;
+
 typedef struct memory_range_t {
     // Starting address of the memory range
     uintptr_t           Start;
@@ -22,15 +31,36 @@ typedef struct memory_range_t {
     size_t              Size;
 } memory_range_t;
 
+typedef struct free_extent_t {
+    // Page holding the extent
+    uint8_t*            Page;
+    // Offset of the extent in the page
+    uint32_t            Offset;
+    // Size of the extent in bytes
+    uint32_t            Size;
+    // Size class free list
+    free_extent_t*      Next;
+    free_extent_t*      Previous;
+    // Free extents of the same page, sorted by offset
+    free_extent_t*      PageNext;
+    free_extent_t*      PagePrevious;
+} free_extent_t;
+
 typedef struct allocator_t {
     // Pointer to the allocated memory buffer
     uint8_t*            Buffer;
-    // Current size of the allocated buffer in bytes
+    // Bytes of the buffer handed out
     uint32_t            Size;
     // Total capacity of the allocated buffer in bytes
     uint32_t            Capacity;
     // Page alignment requirement for allocations (typically 8 or 0)
     uint32_t            BuiltinAlignment;
+    // Free extents of the buffer, sorted by offset. Kept out of band
+    // since the buffer itself is not writable.
+    free_extent_t*      FreeExtents;
+    // Read/write view of the same memory as `Buffer`. `NULL` when the
+    // page is not dual mapped and has to be flipped with `mprotect`.
+    uint8_t*            Writable;
 } allocator_t;
 
 typedef struct memory_allocator_t {
@@ -38,8 +68,27 @@ typedef struct memory_allocator_t {
     allocator_t*        Allocators;
     // Current amount of allocators
     size_t              AllocatorCount;
+    // Free extents of every allocator, by size class
+    free_extent_t*      FreeLists[ MEMORY_ALLOCATOR_SIZE_CLASSES ];
+    // Bytes requested by the blocks currently handed out
+    size_t              BytesRequested;
 } memory_allocator_t;
 
+typedef struct memory_allocator_stats_t {
+    // Pages currently mapped
+    size_t              PageCount;
+    // Bytes currently mapped
+    size_t              BytesMapped;
+    // Bytes requested by live blocks
+    size_t              BytesInUse;
+    // Bytes available for new blocks
+    size_t              BytesFree;
+    // Bytes lost to rounding live blocks up to the granule
+    size_t              BytesWasted;
+    // Largest block that can be handed out without mapping a page
+    size_t              LargestFreeBlock;
+} memory_allocator_stats_t;
+
 // -----------------------------------------------------------------------------
 //  EXPORTED FUNCTIONS
 // -----------------------------------------------------------------------------
@@ -67,4 +116,112 @@ BWSR_STATUS
         IN          size_t                  BufferSize
     );
 
+/**
+ * \brief Creates a memory block of a given size with `PROT_READ` and
+ * `PROT_EXEC` permission whose start lies within `Range` bytes of `Target`.
+ * \param[in,out]       MemoryRange         Block of allocated memory
+ * \param[in,out]       Allocator           Allocator used to hold the memory
+ * \param[in]           BufferSize          Size required of the memory block
+ * \param[in]           Target              Address the block must be near
+ * \param[in]           Range               Maximum distance from `Target` in bytes
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Allocator` or `MemoryRange` is `NULL`.
+ * \retval `ERROR_INVALID_ARGUMENT_VALUE` if `BufferSize` or `Range` is not greater than `0`.
+ * \retval `ERROR_MEMORY_MAPPING` if no free address space was found within `Range`.
+ * \retval `ERROR_MEMORY_PERMISSION` if the page permission could not be set
+ * \retval `ERROR_MEM_ALLOC` on allocation failure
+ * \retval `ERROR_MEMORY_OVERFLOW` if `BufferSize` is larger than a page
+ * \retval `ERROR_SUCCESS` if `MemoryRange` was allocated near `Target`
+ */
+BWSR_STATUS
+    MemoryAllocator_AllocateNearExecutionBlock
+    (
+        IN  OUT     memory_range_t**        MemoryRange,
+        IN  OUT     memory_allocator_t*     Allocator,
+        IN          size_t                  BufferSize,
+        IN          uintptr_t               Target,
+        IN          size_t                  Range
+    );
+
+/**
+ * \brief Returns a block to its allocator. Neighbouring free extents are
+ * coalesced and the page is unmapped once nothing in it is in use.
+ * \param[in,out]       Allocator           Allocator the block came from
+ * \param[in]           MemoryRange         Block to release
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Allocator` or `MemoryRange` is `NULL`.
+ * \retval `ERROR_NOT_FOUND` if the block is not owned by `Allocator`.
+ * \retval `ERROR_MEM_ALLOC` on allocation failure
+ * \retval `ERROR_SUCCESS` if the block was released
+ */
+BWSR_STATUS
+    MemoryAllocator_FreeExecutionBlock
+    (
+        IN  OUT     memory_allocator_t*     Allocator,
+        IN          const memory_range_t*   MemoryRange
+    );
+
+/**
+ * \brief Returns the end of a block to its allocator, keeping the first
+ * `BufferSize` bytes where they are.
+ * \param[in,out]       Allocator           Allocator the block came from
+ * \param[in,out]       MemoryRange         Block to shrink. `Size` is updated.
+ * \param[in]           BufferSize          Bytes to keep
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Allocator` or `MemoryRange` is `NULL`.
+ * \retval `ERROR_INVALID_ARGUMENT_VALUE` if `BufferSize` is not greater than
+ * `0` or is larger than the block.
+ * \retval `ERROR_NOT_FOUND` if the block is not owned by `Allocator`.
+ * \retval `ERROR_MEM_ALLOC` on allocation failure
+ * \retval `ERROR_SUCCESS` if the block was shrunk
+ */
+BWSR_STATUS
+    MemoryAllocator_ShrinkExecutionBlock
+    (
+        IN  OUT     memory_allocator_t*     Allocator,
+        IN  OUT     memory_range_t*         MemoryRange,
+        IN          size_t                  BufferSize
+    );
+
+/**
+ * \brief Reports how the pages of an allocator are used.
+ * \param[in]           Allocator           Allocator to inspect
+ * \param[out]          Statistics          Filled with the current usage
+ * \return `BWSR_STATUS`
+ * \retval `ERROR_ARGUMENT_IS_NULL` if `Allocator` or `Statistics` is `NULL`.
+ * \retval `ERROR_SUCCESS` if `Statistics` was filled
+ */
+BWSR_STATUS
+    MemoryAllocator_GetStatistics
+    (
+        IN          const memory_allocator_t*   Allocator,
+        OUT         memory_allocator_stats_t*   Statistics
+    );
+
+/**
+ * \brief Translates an address inside an execution block to the read/write
+ * view of its page.
+ * \param[in]           Allocator           Allocator owning the block
+ * \param[in]           Address             Executable address to translate
+ * \return `uintptr_t`
+ * \retval Writable alias of `Address`, `0` if the page is not dual mapped
+ */
+uintptr_t
+    MemoryAllocator_GetWritableAddress
+    (
+        IN          const memory_allocator_t*   Allocator,
+        IN          const uintptr_t             Address
+    );
+
+/**
+ * \brief Unmaps every page of an allocator and resets it.
+ * \param[in,out]       Allocator           Allocator to release
+ * \return void
+ */
+void
+    MemoryAllocator_Release
+    (
+        IN  OUT     memory_allocator_t*     Allocator
+    );
+
 #endif // __MEMORY_ALLOCATOR_H__
@@ -4,6 +4,7 @@
 // -----------------------------------------------------------------------------
 
 #include <limits.h>
+#include <pthread.h>
 
 #ifdef BWSR_SECURELY_ZERO_MEMORY
 
@@ -52,6 +53,9 @@ static memory_tracker_t gMemoryTracker =
     .Previous           = &gMemoryTracker
 };
 
+// Serializes every access to `gMemoryTracker`
+static pthread_mutex_t gMemoryTrackerLock = PTHREAD_MUTEX_INITIALIZER;
+
 // -----------------------------------------------------------------------------
 //  PROTOTYPES
 // -----------------------------------------------------------------------------
@@ -179,10 +183,14 @@ void
         IN          void*                   Pointer
     )
 {
-    memory_tracker_t* tracker = gMemoryTracker.Next;
+    memory_tracker_t* tracker = NULL;
 
     __NOT_NULL_RETURN_VOID( Pointer );
 
+    pthread_mutex_lock( &gMemoryTrackerLock );
+
+    tracker = gMemoryTracker.Next;
+
     while( ( tracker          != &gMemoryTracker ) &&
            ( tracker->Address != Pointer         ) )
     {
@@ -199,6 +207,8 @@ void
         INTERNAL_MemoryTracker_Release( tracker, FREE_ALLOCATION_POINTER );
     } // dummy check
 
+    pthread_mutex_unlock( &gMemoryTrackerLock );
+
     return;
 }
 
@@ -211,12 +221,16 @@ void*
         IN          const size_t            LineNumber
     )
 {
-    memory_tracker_t*   tracker         = gMemoryTracker.Next;
+    memory_tracker_t*   tracker         = NULL;
     void*               allocation      = NULL;
 
     __NOT_NULL_RETURN_NULL( Reference, FileName );
     __GREATER_THAN_0_RETURN_NULL( AllocationSize, LineNumber );
 
+    pthread_mutex_lock( &gMemoryTrackerLock );
+
+    tracker = gMemoryTracker.Next;
+
     while( ( tracker          != &gMemoryTracker ) &&
            ( tracker->Address != Reference       ) )
     {
@@ -249,6 +263,8 @@ void*
         } // INTERNAL_MemoryTracker_Initialize()
     } // dummy check
 
+    pthread_mutex_unlock( &gMemoryTrackerLock );
+
     return allocation;
 }
 
@@ -269,6 +285,8 @@ void*
                                   AllocationSize,
                                   LineNumber );
 
+    pthread_mutex_lock( &gMemoryTrackerLock );
+
     if( ERROR_SUCCESS != INTERNAL_MemoryTracker_Initialize( &tracker,
                                                             ( AllocationSize * AllocationCount ),
                                                             FileName,
@@ -287,6 +305,8 @@ void*
         } // malloc()
     } // INTERNAL_MemoryTracker_Initialize()
 
+    pthread_mutex_unlock( &gMemoryTrackerLock );
+
     return allocation;
 }
 
@@ -304,6 +324,8 @@ void*
     __NOT_NULL_RETURN_NULL( FileName );
     __GREATER_THAN_0_RETURN_NULL( AllocationSize, LineNumber );
 
+    pthread_mutex_lock( &gMemoryTrackerLock );
+
     if( ERROR_SUCCESS != INTERNAL_MemoryTracker_Initialize( &tracker,
                                                             AllocationSize,
                                                             FileName,
@@ -322,6 +344,8 @@ void*
         } // malloc()
     } // INTERNAL_MemoryTracker_Initialize()
 
+    pthread_mutex_unlock( &gMemoryTrackerLock );
+
     return allocation;
 }
 
@@ -331,13 +355,17 @@ size_t
         void
     )
 {
-    memory_tracker_t*   tracker         = gMemoryTracker.Next;
+    memory_tracker_t*   tracker         = NULL;
     size_t              leakCount       = 0;
 
 #ifdef DEBUG_MODE
     size_t              leakAmount      = 0;
 #endif
 
+    pthread_mutex_lock( &gMemoryTrackerLock );
+
+    tracker = gMemoryTracker.Next;
+
     while( tracker != &gMemoryTracker )
     {
         leakCount++;
@@ -354,6 +382,8 @@ size_t
         tracker = tracker->Next;
     } // while()
 
+    pthread_mutex_unlock( &gMemoryTrackerLock );
+
 #ifdef DEBUG_MODE
     if( leakCount )
     {
@@ -3,19 +3,28 @@
 //  INCLUDES
 // -----------------------------------------------------------------------------
 
+// `dl_iterate_phdr()` is only declared with `_GNU_SOURCE` on glibc.
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <elf.h>
 
 #include <dlfcn.h>
+#include <link.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
 #include <limits.h>
+#include <stddef.h>
 
 #include "utility/debug.h"
 #include "utility/error.h"
@@ -23,6 +32,8 @@
 
 #include "Memory/Memory.h"
 
+#include "SymbolResolve/Linux/Elf.h"
+
 // -----------------------------------------------------------------------------
 //  STRUCTURES & DEFINITIONS
 // -----------------------------------------------------------------------------
@@ -34,6 +45,11 @@
 #define EXTENSION_LENGTH            ( 7 )
 #define MODULE_BASE_CAPACITY        ( 16 )
 
+#define BUILD_ID_MAX_SIZE           ( 64 )
+#define SYMBOL_CACHE_MAGIC          ( 0x43535742 )  // "BWSC"
+#define SYMBOL_CACHE_VERSION        ( 1 )
+#define SYMBOL_CACHE_EXTENSION      ".bwsrsym"
+
 #if defined(__LP64__)
 
     typedef Elf64_Shdr  elf_shdr_t;
@@ -42,6 +58,13 @@
     typedef Elf64_Dyn   elf_dyn_t;
     typedef Elf64_Phdr  elf_phdr_t;
     typedef Elf64_Ehdr  elf_ehdr_t;
+    typedef Elf64_Rela  elf_rela_t;
+    typedef Elf64_Rel   elf_rel_t;
+    typedef Elf64_Verneed   elf_verneed_t;
+    typedef Elf64_Vernaux   elf_vernaux_t;
+
+    #define ELF_R_SYM   ELF64_R_SYM
+    #define ELF_R_TYPE  ELF64_R_TYPE
 
 #else
 
@@ -51,14 +74,50 @@
     typedef Elf32_Dyn   elf_dyn_t;
     typedef Elf32_Phdr  elf_phdr_t;
     typedef Elf32_Ehdr  elf_ehdr_t;
+    typedef Elf32_Rela  elf_rela_t;
+    typedef Elf32_Rel   elf_rel_t;
+    typedef Elf32_Verneed   elf_verneed_t;
+    typedef Elf32_Vernaux   elf_vernaux_t;
+
+    #define ELF_R_SYM   ELF32_R_SYM
+    #define ELF_R_TYPE  ELF32_R_TYPE
+
+#endif
+
+// Relocations filling a GOT slot with the address of an imported symbol
+#if defined( __aarch64__ )
+
+    #define ELF_R_JUMP_SLOT     R_AARCH64_JUMP_SLOT
+    #define ELF_R_GLOB_DAT      R_AARCH64_GLOB_DAT
+
+#elif defined( __arm__ )
+
+    #define ELF_R_JUMP_SLOT     R_ARM_JUMP_SLOT
+    #define ELF_R_GLOB_DAT      R_ARM_GLOB_DAT
+
+#elif defined( __x86_64__ )
+
+    #define ELF_R_JUMP_SLOT     R_X86_64_JUMP_SLOT
+    #define ELF_R_GLOB_DAT      R_X86_64_GLOB_DAT
+
+#elif defined( __i386__ )
+
+    #define ELF_R_JUMP_SLOT     R_386_JMP_SLOT
+    #define ELF_R_GLOB_DAT      R_386_GLOB_DAT
 
 #endif
 
 typedef struct elf_ctx {
     void*           Header;
+    // `Header` is the image mapped by the loader rather than the file on disk
+    bool            InMemory;
 
     uintptr_t       LoadBias;
 
+    elf_phdr_t*     ProgramHeaders;
+    size_t          ProgramHeaderCount;
+    elf_dyn_t*      Dynamic;
+
     elf_shdr_t*     SymbolSh;
     elf_shdr_t*     DynamicSymbolSh;
 
@@ -67,26 +126,150 @@ typedef struct elf_ctx {
 
     const char*     DynamicStringTable;
     elf_sym_t*      DynamicSymbolTable;
+
+    // `DT_GNU_HASH` table of `DynamicSymbolTable`
+    const uint32_t* GnuHash;
+    // `DT_HASH` table of `DynamicSymbolTable`
+    const uint32_t* SysvHash;
+    // `DT_VERSYM` table of `DynamicSymbolTable`
+    const uint16_t* VersionSymbols;
+    // `DT_VERNEED` entries, naming the versions of undefined symbols
+    const uint8_t*  VersionNeeds;
+
+    // `DT_JMPREL` relocations, `DT_REL` or `DT_RELA` entries
+    // depending on `PltRelocationType`
+    const uint8_t*  PltRelocations;
+    size_t          PltRelocationsSize;
+    size_t          PltRelocationType;
+    // `DT_RELA` relocations
+    const uint8_t*  Rela;
+    size_t          RelaSize;
+    // `DT_REL` relocations
+    const uint8_t*  Rel;
+    size_t          RelSize;
 } elf_ctx_t;
 
+typedef struct module_symbol_t {
+    uintptr_t               Address;
+    size_t                  Size;
+    const char*             Name;
+} module_symbol_t;
+
+typedef struct module_symbols_t {
+    // Defined symbols of the module, sorted by address
+    module_symbol_t*        Data;
+    size_t                  Size;
+    // Mapping of the module file backing the `.symtab` names
+    uint8_t*                File;
+    size_t                  FileSize;
+} module_symbols_t;
+
+typedef struct symbol_cache_header_t {
+    uint32_t                Magic;
+    uint32_t                Version;
+    // `st_size` and `st_mtim` of the module file the cache was built from
+    uint64_t                FileSize;
+    int64_t                 FileModifiedSeconds;
+    int64_t                 FileModifiedNanoseconds;
+    uint32_t                BuildIdSize;
+    uint8_t                 BuildId[ BUILD_ID_MAX_SIZE ];
+    uint32_t                BucketCount;
+    uint32_t                EntryCount;
+    uint32_t                StringsSize;
+} symbol_cache_header_t;
+
+typedef struct symbol_cache_entry_t {
+    // `INTERNAL_GnuHash()` of the name
+    uint32_t                Hash;
+    // Index + 1 of the next entry in the bucket, 0 ends the chain
+    uint32_t                Next;
+    uint32_t                NameOffset;
+    uint32_t                Reserved;
+    // `st_value` of the symbol
+    uint64_t                Value;
+} symbol_cache_entry_t;
+
+typedef struct symbol_cache_t {
+    uint8_t*                        File;
+    size_t                          FileSize;
+    const symbol_cache_header_t*    Header;
+    // Index + 1 of the first entry of each bucket, 0 for an empty bucket
+    const uint32_t*                 Buckets;
+    const symbol_cache_entry_t*     Entries;
+    const char*                     Strings;
+} symbol_cache_t;
+
 typedef struct runtime_module_t {
-    void*     Base;
-    char      Path[ 1024 ];
+    void*                   Base;
+    // End of the highest `PT_LOAD` segment
+    void*                   End;
+    // Built on the first address lookup that lands in the module
+    module_symbols_t*       Symbols;
+    // Mapped on the first `.symtab` lookup when a cache directory is set
+    symbol_cache_t*         Cache;
+    char                    Path[ 1024 ];
 } runtime_module_t;
 
+typedef struct module_generation_t {
+    // Objects ever loaded, or a checksum of the load addresses when
+    // the loader does not report `dlpi_adds`.
+    unsigned long long      Adds;
+    // Objects ever unloaded, or the loaded object count when the
+    // loader does not report `dlpi_subs`.
+    unsigned long long      Subs;
+} module_generation_t;
+
+typedef struct module_index_t {
+    // Modules parsed from `/proc/self/maps`
+    runtime_module_t*       Data;
+    // Current amount of modules
+    size_t                  Size;
+    // Total capacity of `Data`
+    size_t                  Capacity;
+    // Loader generation the index was built against
+    module_generation_t     Generation;
+    // Outstanding references, including the one held by `gModuleIndex`.
+    // Only modified atomically.
+    size_t                  ReferenceCount;
+} module_index_t;
+
+typedef struct pending_symbol_t {
+    // Name being looked up
+    const char*                     SymbolName;
+    // Position of the request in the caller's arrays
+    size_t                          RequestIndex;
+} pending_symbol_t;
+
+typedef struct symbol_batch_t {
+    const bwsr_symbol_request_t*    Requests;
+    size_t                          Count;
+    uintptr_t*                      Addresses;
+    BWSR_STATUS*                    Statuses;
+    // Requests that are still unresolved
+    size_t                          Remaining;
+    // Unresolved requests of the current module, sorted by name
+    pending_symbol_t*               Pending;
+    size_t                          PendingCount;
+} symbol_batch_t;
+
 // -----------------------------------------------------------------------------
 //  GLOBALS
 // -----------------------------------------------------------------------------
 
-static struct {
-    runtime_module_t*   Data;
-    size_t              Size;
-    size_t              Capacity;
-} modules = {
-    NULL,
-    0,
-    0
-};
+// Published snapshot of the loaded modules. Readers take a reference under
+// the read lock and search it without holding any lock.
+static module_index_t*  gModuleIndex        = NULL;
+static pthread_rwlock_t gModuleIndexLock    = PTHREAD_RWLOCK_INITIALIZER;
+
+// Empty when the on-disk symbol cache is disabled
+static char             gSymbolCacheDirectory[ PATH_MAX ]   = { 0 };
+static pthread_rwlock_t gSymbolCacheDirectoryLock           = PTHREAD_RWLOCK_INITIALIZER;
+
+// Held for a whole `BWSR_ImportHook()`. Import hooks of one symbol from
+// several threads would otherwise hand each other's replacement back as
+// the original, or restore a RELRO page another thread is still writing.
+// Not the hook registry lock, the loader may be called while it is held.
+static pthread_mutex_t  gImportHookLock     = PTHREAD_MUTEX_INITIALIZER;
 
 // -----------------------------------------------------------------------------
 //  IMPLEMENTATION
@@ -96,6 +279,7 @@ static
 BWSR_STATUS
     INTERNAL_AppendRuntimeModule
     (
+        IN  OUT     module_index_t*         Index,
         IN          runtime_module_t        Module
     )
 {
@@ -103,12 +287,14 @@ BWSR_STATUS
     runtime_module_t*   runtimeModule   = NULL;
     size_t              allocationSize  = 0;
 
-    if( NULL == modules.Data )
+    __NOT_NULL( Index )
+
+    if( NULL == Index->Data )
     {
-        modules.Capacity    = MODULE_BASE_CAPACITY;
-        allocationSize      = modules.Capacity * sizeof( runtime_module_t );
+        Index->Capacity     = MODULE_BASE_CAPACITY;
+        allocationSize      = Index->Capacity * sizeof( runtime_module_t );
 
-        if( NULL == ( modules.Data = BwsrMalloc( allocationSize ) ) )
+        if( NULL == ( Index->Data = BwsrMalloc( allocationSize ) ) )
         {
             BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
             retVal = ERROR_MEM_ALLOC;
@@ -117,18 +303,18 @@ BWSR_STATUS
             retVal = ERROR_SUCCESS;
         } // BwsrMalloc()
     }
-    else if( modules.Size >= modules.Capacity )
+    else if( Index->Size >= Index->Capacity )
     {
-        modules.Capacity    *= 2;
-        allocationSize      = modules.Capacity * sizeof( runtime_module_t );
+        Index->Capacity     *= 2;
+        allocationSize      = Index->Capacity * sizeof( runtime_module_t );
 
-        if( NULL == ( runtimeModule = BwsrRealloc( modules.Data, allocationSize ) ) )
+        if( NULL == ( runtimeModule = BwsrRealloc( Index->Data, allocationSize ) ) )
         {
             BWSR_DEBUG( LOG_ERROR, "BwsrRealloc() Failed\n" );
             retVal = ERROR_MEM_ALLOC;
         }
         else {
-            modules.Data = runtimeModule;
+            Index->Data = runtimeModule;
             retVal = ERROR_SUCCESS;
         } // BwsrRealloc()
     }
@@ -138,30 +324,113 @@ BWSR_STATUS
 
     if( ERROR_SUCCESS == retVal )
     {
-        modules.Data[ modules.Size++ ] = Module;
+        Index->Data[ Index->Size++ ] = Module;
     }
 
     return retVal;
 }
 
+static
+void
+    INTERNAL_ReleaseModuleSymbols
+    (
+        IN          module_symbols_t*       Symbols
+    )
+{
+    if( NULL != Symbols )
+    {
+        if( NULL != Symbols->File )
+        {
+            munmap( Symbols->File, Symbols->FileSize );
+        } // Symbols->File
+
+        BwsrFree( Symbols->Data );
+        BwsrFree( Symbols );
+    } // Symbols
+}
+
+static
+void
+    INTERNAL_ReleaseSymbolCache
+    (
+        IN          symbol_cache_t*         Cache
+    )
+{
+    if( NULL != Cache )
+    {
+        munmap( Cache->File, Cache->FileSize );
+        BwsrFree( Cache );
+    } // Cache
+}
+
 static
 void
     INTERNAL_ReleaseRuntimeModules
     (
-        void
+        IN  OUT     module_index_t*         Index
+    )
+{
+    size_t          i           = 0;
+
+    __NOT_NULL_RETURN_VOID( Index )
+
+    for( i = 0; i < Index->Size; i++ )
+    {
+        INTERNAL_ReleaseModuleSymbols( Index->Data[ i ].Symbols );
+        INTERNAL_ReleaseSymbolCache( Index->Data[ i ].Cache );
+    } // for()
+
+    BwsrFree( Index->Data );
+    Index->Data      = NULL;
+    Index->Size      = 0;
+    Index->Capacity  = 0;
+}
+
+static
+void*
+    INTERNAL_GetImageEnd
+    (
+        IN          const void*             Base
     )
 {
-    BwsrFree( modules.Data );
-    modules.Data      = NULL;
-    modules.Size      = 0;
-    modules.Capacity  = 0;
+    size_t              i           = 0;
+    const elf_ehdr_t*   ehdr        = NULL;
+    const elf_phdr_t*   phdr        = NULL;
+    uintptr_t           bias        = 0;
+    bool                hasBias     = false;
+    uintptr_t           end         = 0;
+
+    ehdr = (const elf_ehdr_t*) Base;
+    phdr = (const elf_phdr_t*) ( (uintptr_t) Base + ehdr->e_phoff );
+
+    for( i = 0; i < ehdr->e_phnum; i++ )
+    {
+        if( PT_LOAD != phdr[ i ].p_type )
+        {
+            continue;
+        }
+
+        // `Base` is where the lowest segment was mapped
+        if( false == hasBias )
+        {
+            bias    = (uintptr_t) Base - ( phdr[ i ].p_vaddr - phdr[ i ].p_offset );
+            hasBias = true;
+        }
+
+        if( end < ( bias + phdr[ i ].p_vaddr + phdr[ i ].p_memsz ) )
+        {
+            end = bias + phdr[ i ].p_vaddr + phdr[ i ].p_memsz;
+        }
+    } // for()
+
+    return (void*) end;
 }
 
 static
 BWSR_STATUS
     INTERNAL_GetProcessMap_ProcSelfMaps
     (
-        void
+        IN  OUT     module_index_t*         Index
     )
 {
     BWSR_STATUS     retVal                          = ERROR_FAILURE;
@@ -176,6 +445,9 @@ BWSR_STATUS
     long            inode                           = 0;
     int             path_index                      = 0;
     char*           path_buffer                     = NULL;
+    Dl_info         info                            = { 0 };
+
+    __NOT_NULL( Index )
 
     if( NULL == ( fp = fopen( "/proc/self/maps", "r" ) ) )
     {
@@ -224,7 +496,7 @@ BWSR_STATUS
                             &path_index ) )
             {
                 BWSR_DEBUG( LOG_ERROR, "sscanf() Failed\n" );
-                INTERNAL_ReleaseRuntimeModules( );
+                INTERNAL_ReleaseRuntimeModules( Index );
                 retVal = ERROR_UNEXPECTED_FORMAT;
             }
             else {
@@ -234,6 +506,15 @@ BWSR_STATUS
                     continue;
                 }
 
+                // Only images owned by the loader. This skips the module files
+                // mapped by the resolver itself, which may be unmapped by
+                // another thread at any time.
+                if( ( 0                     == dladdr( (void*) region_start, &info ) ) ||
+                    ( (uintptr_t) info.dli_fbase != region_start                     ) )
+                {
+                    continue;
+                }
+
                 if( 0 != memcmp( ( (Elf64_Ehdr*) region_start )->e_ident,
                                 ELFMAG,
                                 SELFMAG ) )
@@ -255,15 +536,16 @@ BWSR_STATUS
                     path_buffer[ strlen( path_buffer ) - 1 ] = 0x00;
                 }
 
-                runtime_module_t module;
+                runtime_module_t module = { 0 };
 
                 strncpy( module.Path,
                         path_buffer,
                         sizeof( module.Path ) - 1 );
 
                 module.Base = (void*) region_start;
+                module.End  = INTERNAL_GetImageEnd( module.Base );
 
-                retVal = INTERNAL_AppendRuntimeModule( module );
+                retVal = INTERNAL_AppendRuntimeModule( Index, module );
             } // sscanf()
         } // while()
 
@@ -273,32 +555,255 @@ BWSR_STATUS
     return retVal;
 }
 
+static
+int
+    INTERNAL_GetLoaderGeneration_Callback
+    (
+        IN          struct dl_phdr_info*    Info,
+        IN          size_t                  Size,
+        IN  OUT     void*                   Data
+    )
+{
+    module_generation_t* generation = (module_generation_t*) Data;
+
+    if( Size >= ( offsetof( struct dl_phdr_info, dlpi_subs ) + sizeof( Info->dlpi_subs ) ) )
+    {
+        generation->Adds = Info->dlpi_adds;
+        generation->Subs = Info->dlpi_subs;
+
+        // The counters are global, the first object is enough.
+        return 1;
+    }
+
+    generation->Adds = ( generation->Adds * 31 ) + Info->dlpi_addr;
+    generation->Subs++;
+
+    return 0;
+}
+
+static
+void
+    INTERNAL_GetLoaderGeneration
+    (
+        OUT         module_generation_t*    Generation
+    )
+{
+    __NOT_NULL_RETURN_VOID( Generation )
+
+    Generation->Adds = 0;
+    Generation->Subs = 0;
+
+    (void) dl_iterate_phdr( INTERNAL_GetLoaderGeneration_Callback, Generation );
+}
+
+static
+void
+    INTERNAL_ModuleIndex_Release
+    (
+        IN  OUT     module_index_t*         Index
+    )
+{
+    __NOT_NULL_RETURN_VOID( Index )
+
+    if( 0 == __atomic_sub_fetch( &Index->ReferenceCount, 1, __ATOMIC_ACQ_REL ) )
+    {
+        INTERNAL_ReleaseRuntimeModules( Index );
+        BwsrFree( Index );
+    } // ReferenceCount
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ModuleIndex_Build
+    (
+        OUT         module_index_t**                Index,
+        IN          const module_generation_t*      Generation
+    )
+{
+    BWSR_STATUS     retVal      = ERROR_FAILURE;
+
+    __NOT_NULL( Index, Generation )
+
+    if( NULL == ( *Index = (module_index_t*) BwsrCalloc( 1, sizeof( module_index_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        ( *Index )->Generation      = *Generation;
+        ( *Index )->ReferenceCount  = 1;
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_GetProcessMap_ProcSelfMaps( *Index ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_GetProcessMap_ProcSelfMaps() Failed\n" );
+            INTERNAL_ModuleIndex_Release( *Index );
+            *Index = NULL;
+        } // INTERNAL_GetProcessMap_ProcSelfMaps()
+    } // BwsrCalloc()
+
+    return retVal;
+}
+
+static
+bool
+    INTERNAL_ModuleIndex_TryReference
+    (
+        IN          const module_generation_t*  Generation,
+        OUT         module_index_t**            Index
+    )
+{
+    // `gModuleIndexLock` is held by the caller
+    if( ( NULL              == gModuleIndex                     ) ||
+        ( Generation->Adds  != gModuleIndex->Generation.Adds    ) ||
+        ( Generation->Subs  != gModuleIndex->Generation.Subs    ) )
+    {
+        return false;
+    }
+
+    __atomic_add_fetch( &gModuleIndex->ReferenceCount, 1, __ATOMIC_RELAXED );
+    *Index = gModuleIndex;
+
+    return true;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ModuleIndex_Acquire
+    (
+        OUT         module_index_t**        Index
+    )
+{
+    BWSR_STATUS             retVal          = ERROR_FAILURE;
+    module_generation_t     generation      = { 0 };
+    module_index_t*         index           = NULL;
+    module_index_t*         stale           = NULL;
+    bool                    found           = false;
+
+    __NOT_NULL( Index )
+
+    INTERNAL_GetLoaderGeneration( &generation );
+
+    pthread_rwlock_rdlock( &gModuleIndexLock );
+    found = INTERNAL_ModuleIndex_TryReference( &generation, Index );
+    pthread_rwlock_unlock( &gModuleIndexLock );
+
+    if( found )
+    {
+        retVal = ERROR_SUCCESS;
+    }
+    else {
+        // Built outside of the lock, readers of the current snapshot are
+        // never stalled by `/proc/self/maps` parsing.
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_ModuleIndex_Build( &index, &generation ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_ModuleIndex_Build() Failed\n" );
+        }
+        else {
+            pthread_rwlock_wrlock( &gModuleIndexLock );
+
+            if( INTERNAL_ModuleIndex_TryReference( &generation, Index ) )
+            {
+                // Another thread published the same generation first
+                stale = index;
+            }
+            else {
+                stale           = gModuleIndex;
+                gModuleIndex    = index;
+
+                INTERNAL_ModuleIndex_TryReference( &generation, Index );
+            } // INTERNAL_ModuleIndex_TryReference()
+
+            pthread_rwlock_unlock( &gModuleIndexLock );
+
+            if( NULL != stale )
+            {
+                INTERNAL_ModuleIndex_Release( stale );
+            } // stale
+        } // INTERNAL_ModuleIndex_Build()
+    } // found
+
+    return retVal;
+}
+
+static
+void*
+    INTERNAL_ElfContext_VirtualToPointer
+    (
+        IN          const elf_ctx_t*    Context,
+        IN          elf_addr_t          VirtualAddress
+    )
+{
+    size_t          i               = 0;
+    elf_phdr_t*     phdr            = NULL;
+    void*           pointer         = NULL;
+
+    __NOT_NULL_RETURN_NULL( Context )
+
+    phdr = Context->ProgramHeaders;
+
+    for( i = 0; ( i < Context->ProgramHeaderCount ) && ( NULL == pointer ); i++ )
+    {
+        if( PT_LOAD != phdr[ i ].p_type )
+        {
+            continue;
+        }
+
+        if( Context->InMemory )
+        {
+            if( ( VirtualAddress >= phdr[ i ].p_vaddr                             ) &&
+                ( VirtualAddress <  ( phdr[ i ].p_vaddr + phdr[ i ].p_memsz )     ) )
+            {
+                pointer = (void*) ( Context->LoadBias + VirtualAddress );
+            }
+        }
+        else {
+            if( ( VirtualAddress >= phdr[ i ].p_vaddr                             ) &&
+                ( VirtualAddress <  ( phdr[ i ].p_vaddr + phdr[ i ].p_filesz )    ) )
+            {
+                pointer = (void*) ( (uintptr_t) Context->Header
+                                    + phdr[ i ].p_offset
+                                    + ( VirtualAddress - phdr[ i ].p_vaddr ) );
+            }
+        } // Context->InMemory
+    } // for()
+
+    return pointer;
+}
+
 static
 void
     INTERNAL_ElfContext_Initialize
     (
         OUT         elf_ctx_t*          Context,
-        IN          const void*         Header
+        IN          const void*         Header,
+        IN          const bool          InMemory
     )
 {
     size_t          i               = 0;
     elf_phdr_t*     phdr            = NULL;
+    elf_phdr_t*     dynamic_phdr    = NULL;
     elf_shdr_t*     shstr_sh        = NULL;
     char*           shstrtab        = NULL;
     elf_shdr_t*     shdr            = NULL;
     elf_ehdr_t*     ehdr            = NULL;
     elf_addr_t      ehdr_addr       = 0;
+    elf_dyn_t*      dyn             = NULL;
+    elf_addr_t      dyn_addr        = 0;
 
     __NOT_NULL_RETURN_VOID( Context, Header );
 
-    ehdr            = (elf_ehdr_t*) Header;
-    ehdr_addr       = (elf_addr_t) ehdr;
-    Context->Header = ehdr;
+    ehdr                = (elf_ehdr_t*) Header;
+    ehdr_addr           = (elf_addr_t) ehdr;
+    Context->Header     = ehdr;
+    Context->InMemory   = InMemory;
 
     // Dynamic Segment
     {
         phdr = (elf_phdr_t*) ( ehdr_addr + ehdr->e_phoff );
 
+        Context->ProgramHeaders     = phdr;
+        Context->ProgramHeaderCount = ehdr->e_phnum;
+
         for( i = 0; i < ehdr->e_phnum; i++ )
         {
             if( ( PT_LOAD == phdr[ i ].p_type  ) &&
@@ -309,11 +814,131 @@ void
             else if( PT_PHDR == phdr[ i ].p_type )
             {
                 Context->LoadBias = (elf_addr_t) phdr - phdr[ i ].p_vaddr;
+            }
+            else if( PT_DYNAMIC == phdr[ i ].p_type )
+            {
+                dynamic_phdr = &phdr[ i ];
             } // P Type
         } // for()
+
+        if( NULL != dynamic_phdr )
+        {
+            if( InMemory )
+            {
+                Context->Dynamic = (elf_dyn_t*) ( Context->LoadBias + dynamic_phdr->p_vaddr );
+            }
+            else {
+                Context->Dynamic = (elf_dyn_t*) ( ehdr_addr + dynamic_phdr->p_offset );
+            } // InMemory
+        } // dynamic_phdr
     } // Dynamic Segment
 
-    // Section
+    // Dynamic Entries
+    if( NULL != Context->Dynamic )
+    {
+        for( dyn = Context->Dynamic; DT_NULL != dyn->d_tag; dyn++ )
+        {
+            dyn_addr = dyn->d_un.d_ptr;
+
+            // glibc relocates the dynamic entries of a loaded image in place,
+            // bionic leaves them as virtual addresses.
+            if( ( InMemory                          ) &&
+                ( 0        != Context->LoadBias     ) &&
+                ( dyn_addr >= Context->LoadBias     ) )
+            {
+                dyn_addr -= Context->LoadBias;
+            } // InMemory
+
+            switch( dyn->d_tag )
+            {
+                case DT_SYMTAB:
+                {
+                    Context->DynamicSymbolTable = (elf_sym_t*) INTERNAL_ElfContext_VirtualToPointer( Context, dyn_addr );
+                    break;
+                }
+
+                case DT_STRTAB:
+                {
+                    Context->DynamicStringTable = (const char*) INTERNAL_ElfContext_VirtualToPointer( Context, dyn_addr );
+                    break;
+                }
+
+                case DT_GNU_HASH:
+                {
+                    Context->GnuHash = (const uint32_t*) INTERNAL_ElfContext_VirtualToPointer( Context, dyn_addr );
+                    break;
+                }
+
+                case DT_HASH:
+                {
+                    Context->SysvHash = (const uint32_t*) INTERNAL_ElfContext_VirtualToPointer( Context, dyn_addr );
+                    break;
+                }
+
+                case DT_VERSYM:
+                {
+                    Context->VersionSymbols = (const uint16_t*) INTERNAL_ElfContext_VirtualToPointer( Context, dyn_addr );
+                    break;
+                }
+
+                case DT_VERNEED:
+                {
+                    Context->VersionNeeds = (const uint8_t*) INTERNAL_ElfContext_VirtualToPointer( Context, dyn_addr );
+                    break;
+                }
+
+                case DT_JMPREL:
+                {
+                    Context->PltRelocations = (const uint8_t*) INTERNAL_ElfContext_VirtualToPointer( Context, dyn_addr );
+                    break;
+                }
+
+                case DT_PLTRELSZ:
+                {
+                    Context->PltRelocationsSize = dyn->d_un.d_val;
+                    break;
+                }
+
+                case DT_PLTREL:
+                {
+                    Context->PltRelocationType = dyn->d_un.d_val;
+                    break;
+                }
+
+                case DT_RELA:
+                {
+                    Context->Rela = (const uint8_t*) INTERNAL_ElfContext_VirtualToPointer( Context, dyn_addr );
+                    break;
+                }
+
+                case DT_RELASZ:
+                {
+                    Context->RelaSize = dyn->d_un.d_val;
+                    break;
+                }
+
+                case DT_REL:
+                {
+                    Context->Rel = (const uint8_t*) INTERNAL_ElfContext_VirtualToPointer( Context, dyn_addr );
+                    break;
+                }
+
+                case DT_RELSZ:
+                {
+                    Context->RelSize = dyn->d_un.d_val;
+                    break;
+                }
+
+                default:
+                {
+                    break;
+                }
+            } // switch()
+        } // for()
+    } // Dynamic Entries
+
+    // Section headers are not part of any loadable segment
+    if( false == InMemory )
     {
         shdr     = (elf_shdr_t*) ( ehdr_addr + ehdr->e_shoff );
         shstr_sh = &shdr[ ehdr->e_shstrndx ];
@@ -383,7 +1008,7 @@ BWSR_STATUS
         else {
             if( MAP_FAILED == ( *MMapBuffer = (uint8_t*) mmap( 0,
                                                                file_size,
-                                                               ( PROT_READ | PROT_WRITE ),
+                                                               PROT_READ,
                                                                MAP_PRIVATE,
                                                                fd,
                                                                0 ) ) )
@@ -408,40 +1033,205 @@ BWSR_STATUS
 }
 
 static
-BWSR_STATUS
-    INTERNAL_GetValueFromSymbolTable
+uint32_t
+    INTERNAL_GnuHash
     (
+        IN          const char*         SymbolName
+    )
+{
+    uint32_t        hash        = 5381;
+
+    for( ; 0 != *SymbolName; SymbolName++ )
+    {
+        hash = ( hash << 5 ) + hash + (uint8_t) *SymbolName;
+    } // for()
+
+    return hash;
+}
+
+static
+uint32_t
+    INTERNAL_SysvHash
+    (
+        IN          const char*         SymbolName
+    )
+{
+    uint32_t        hash        = 0;
+    uint32_t        high        = 0;
+
+    for( ; 0 != *SymbolName; SymbolName++ )
+    {
+        hash = ( hash << 4 ) + (uint8_t) *SymbolName;
+        high = ( hash & 0xF0000000 );
+
+        if( 0 != high )
+        {
+            hash ^= ( high >> 24 );
+        }
+
+        hash &= ~high;
+    } // for()
+
+    return hash;
+}
+
+static
+bool
+    INTERNAL_ElfContext_IsMatchingDynamicSymbol
+    (
+        IN          const elf_ctx_t*    Context,
+        IN          const uint32_t      SymbolIndex,
+        IN          const char*         SymbolName
+    )
+{
+    elf_sym_t*      sym         = NULL;
+
+    sym = Context->DynamicSymbolTable + SymbolIndex;
+
+    if( SHN_UNDEF == sym->st_shndx )
+    {
+        return false;
+    }
+
+    // Only the default version of a versioned symbol is visible to `dlsym()`.
+    if( ( NULL != Context->VersionSymbols                               ) &&
+        ( 0    != ( Context->VersionSymbols[ SymbolIndex ] & 0x8000 )   ) )
+    {
+        return false;
+    }
+
+    return ( 0 == strcmp( Context->DynamicStringTable + sym->st_name, SymbolName ) );
+}
+
+static
+BWSR_STATUS
+    INTERNAL_GnuHash_GetValueFromSymbolTable
+    (
+        IN          const elf_ctx_t*    Context,
         IN          const char*         SymbolName,
-        IN          elf_sym_t*          SymbolTable,
-        IN          const char*         StringTable,
-        IN          size_t              Count,
+        IN          const uint32_t      Hash,
         OUT         void**              Value
     )
 {
-    BWSR_STATUS     retVal          = ERROR_FAILURE;
-    size_t          i               = 0;
-    elf_sym_t*      sym             = NULL;
-    char*           symbol_name     = NULL;
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    const uint32_t*     table           = NULL;
+    uint32_t            bucketCount     = 0;
+    uint32_t            symbolOffset    = 0;
+    uint32_t            bloomSize       = 0;
+    uint32_t            bloomShift      = 0;
+    const elf_addr_t*   bloom           = NULL;
+    const uint32_t*     buckets         = NULL;
+    const uint32_t*     chain           = NULL;
+    elf_addr_t          bloomWord       = 0;
+    elf_addr_t          bloomMask       = 0;
+    uint32_t            symbolIndex     = 0;
+    uint32_t            chainHash       = 0;
+    const size_t        wordBits        = ( sizeof( elf_addr_t ) * 8 );
 
-    __NOT_NULL( SymbolName,
-                SymbolTable,
-                StringTable,
+    __NOT_NULL( Context,
+                Context->GnuHash,
+                SymbolName,
                 Value )
-    __GREATER_THAN_0( Count )
+
+    table           = Context->GnuHash;
+    bucketCount     = table[ 0 ];
+    symbolOffset    = table[ 1 ];
+    bloomSize       = table[ 2 ];
+    bloomShift      = table[ 3 ];
+    bloom           = (const elf_addr_t*) ( table + 4 );
+    buckets         = (const uint32_t*) ( bloom + bloomSize );
+    chain           = ( buckets + bucketCount );
+
+    retVal  = ERROR_NOT_FOUND;
+    *Value  = NULL;
+
+    if( ( 0 == bucketCount ) ||
+        ( 0 == bloomSize   ) )
+    {
+        return retVal;
+    }
+
+    // Rejects most missing symbols without touching the buckets.
+    bloomWord = bloom[ ( Hash / wordBits ) % bloomSize ];
+    bloomMask = ( ( (elf_addr_t) 1 << ( Hash % wordBits ) )
+                  | ( (elf_addr_t) 1 << ( ( Hash >> bloomShift ) % wordBits ) ) );
+
+    if( bloomMask != ( bloomWord & bloomMask ) )
+    {
+        return retVal;
+    }
+
+    symbolIndex = buckets[ Hash % bucketCount ];
+
+    if( symbolIndex < symbolOffset )
+    {
+        return retVal;
+    }
+
+    do
+    {
+        chainHash = chain[ symbolIndex - symbolOffset ];
+
+        if( ( ( Hash | 1 ) == ( chainHash | 1 ) ) &&
+            INTERNAL_ElfContext_IsMatchingDynamicSymbol( Context, symbolIndex, SymbolName ) )
+        {
+            retVal  = ERROR_SUCCESS;
+            *Value  = (void*) Context->DynamicSymbolTable[ symbolIndex ].st_value;
+        } // INTERNAL_ElfContext_IsMatchingDynamicSymbol()
+
+        symbolIndex++;
+    } while( ( ERROR_NOT_FOUND == retVal ) &&
+             ( 0               == ( chainHash & 1 ) ) );
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_SysvHash_GetValueFromSymbolTable
+    (
+        IN          const elf_ctx_t*    Context,
+        IN          const char*         SymbolName,
+        IN          const uint32_t      Hash,
+        OUT         void**              Value
+    )
+{
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    uint32_t            bucketCount     = 0;
+    uint32_t            chainCount      = 0;
+    const uint32_t*     buckets         = NULL;
+    const uint32_t*     chain           = NULL;
+    uint32_t            symbolIndex     = 0;
+
+    __NOT_NULL( Context,
+                Context->SysvHash,
+                SymbolName,
+                Value )
+
+    bucketCount     = Context->SysvHash[ 0 ];
+    chainCount      = Context->SysvHash[ 1 ];
+    buckets         = ( Context->SysvHash + 2 );
+    chain           = ( buckets + bucketCount );
 
     retVal  = ERROR_NOT_FOUND;
     *Value  = NULL;
 
-    for( i = 0; ( i < Count ) && ( ERROR_NOT_FOUND == retVal ); ++i )
+    if( 0 == bucketCount )
     {
-        sym         = SymbolTable + i;
-        symbol_name = (char*) StringTable + sym->st_name;
+        return retVal;
+    }
 
-        if( 0 == strcmp( (const char*) symbol_name, SymbolName ) )
+    for( symbolIndex = buckets[ Hash % bucketCount ];
+         ( STN_UNDEF       != symbolIndex ) &&
+         ( symbolIndex     <  chainCount  ) &&
+         ( ERROR_NOT_FOUND == retVal      );
+         symbolIndex = chain[ symbolIndex ] )
+    {
+        if( INTERNAL_ElfContext_IsMatchingDynamicSymbol( Context, symbolIndex, SymbolName ) )
         {
             retVal  = ERROR_SUCCESS;
-            *Value  = (void*) sym->st_value;
-        } // strcmp()
+            *Value  = (void*) Context->DynamicSymbolTable[ symbolIndex ].st_value;
+        } // INTERNAL_ElfContext_IsMatchingDynamicSymbol()
     } // for()
 
     return retVal;
@@ -449,144 +1239,1926 @@ BWSR_STATUS
 
 static
 BWSR_STATUS
-    INTERNAL_ElfContext_GetValueFromSymbolTable
+    INTERNAL_ElfContext_GetValueFromDynamicSymbolTable
     (
-        IN          elf_ctx_t*          Context,
+        IN          const elf_ctx_t*    Context,
         IN          const char*         SymbolName,
         OUT         void**              Result
     )
 {
     BWSR_STATUS     retVal      = ERROR_FAILURE;
-    size_t          count       = 0;
 
     __NOT_NULL( Context,
                 SymbolName,
                 Result )
 
-    if( ( NULL != Context->SymbolTable ) &&
-        ( NULL != Context->StringTable ) )
+    if( ( NULL == Context->DynamicSymbolTable ) ||
+        ( NULL == Context->DynamicStringTable ) )
+    {
+        retVal = ERROR_NOT_FOUND;
+    }
+    else if( NULL != Context->GnuHash )
+    {
+        retVal = INTERNAL_GnuHash_GetValueFromSymbolTable( Context,
+                                                           SymbolName,
+                                                           INTERNAL_GnuHash( SymbolName ),
+                                                           Result );
+    }
+    else if( NULL != Context->SysvHash )
     {
-        count   = Context->SymbolSh->sh_size / sizeof( elf_sym_t );
+        retVal = INTERNAL_SysvHash_GetValueFromSymbolTable( Context,
+                                                            SymbolName,
+                                                            INTERNAL_SysvHash( SymbolName ),
+                                                            Result );
+    }
+    else {
+        retVal = ERROR_NOT_FOUND;
+    } // Context->GnuHash
+
+    return retVal;
+}
 
-        retVal  = INTERNAL_GetValueFromSymbolTable( SymbolName,
-                                                    Context->SymbolTable,
-                                                    Context->StringTable,
-                                                    count,
-                                                    Result );
+static
+bool
+    INTERNAL_IsMatchingModule
+    (
+        IN          const runtime_module_t* Module,
+        IN          const char*             LibraryName
+    )
+{
+    if( NULL == Module->Base )
+    {
+        return false;
     }
 
-    if( ERROR_SUCCESS != retVal )
+    return ( ( NULL == LibraryName ) ||
+             ( 0    == strncmp( LibraryName,
+                                Module->Path,
+                                PATH_MAX ) ) );
+}
+
+static
+int
+    INTERNAL_PendingSymbol_Compare
+    (
+        IN          const void*             Left,
+        IN          const void*             Right
+    )
+{
+    return strcmp( ( (const pending_symbol_t*) Left  )->SymbolName,
+                   ( (const pending_symbol_t*) Right )->SymbolName );
+}
+
+static
+void
+    INTERNAL_SymbolBatch_Resolve
+    (
+        IN  OUT     symbol_batch_t*         Batch,
+        IN          const size_t            RequestIndex,
+        IN          const uintptr_t         Address
+    )
+{
+    Batch->Addresses[ RequestIndex ]    = Address;
+    Batch->Statuses[ RequestIndex ]     = ERROR_SUCCESS;
+    Batch->Remaining--;
+}
+
+static
+void
+    INTERNAL_SymbolBatch_CollectPending
+    (
+        IN  OUT     symbol_batch_t*         Batch,
+        IN          const runtime_module_t* Module
+    )
+{
+    size_t          i           = 0;
+
+    Batch->PendingCount = 0;
+
+    for( i = 0; i < Batch->Count; i++ )
+    {
+        if( ( ERROR_NOT_FOUND == Batch->Statuses[ i ]                                       ) &&
+            ( INTERNAL_IsMatchingModule( Module, Batch->Requests[ i ].ImageName )           ) )
+        {
+            Batch->Pending[ Batch->PendingCount ].SymbolName    = Batch->Requests[ i ].SymbolName;
+            Batch->Pending[ Batch->PendingCount ].RequestIndex  = i;
+            Batch->PendingCount++;
+        } // INTERNAL_IsMatchingModule()
+    } // for()
+
+    qsort( Batch->Pending,
+           Batch->PendingCount,
+           sizeof( pending_symbol_t ),
+           INTERNAL_PendingSymbol_Compare );
+}
+
+static
+void
+    INTERNAL_SymbolBatch_ScanSymbolTable
+    (
+        IN  OUT     symbol_batch_t*         Batch,
+        IN          const elf_sym_t*        SymbolTable,
+        IN          const char*             StringTable,
+        IN          const size_t            Count,
+        IN          const uintptr_t         Slide
+    )
+{
+    size_t              i           = 0;
+    const elf_sym_t*    sym         = NULL;
+    pending_symbol_t    key         = { 0 };
+    pending_symbol_t*   match       = NULL;
+    pending_symbol_t*   first       = NULL;
+    pending_symbol_t*   last        = NULL;
+
+    for( i = 0; ( i < Count ) && ( 0 < Batch->Remaining ); i++ )
     {
-        if( ( NULL != Context->DynamicSymbolTable ) &&
-            ( NULL != Context->DynamicStringTable ) )
+        sym = SymbolTable + i;
+
+        if( ( SHN_UNDEF == sym->st_shndx ) ||
+            ( 0         == sym->st_name  ) )
         {
-            count   = Context->DynamicSymbolSh->sh_size / sizeof( elf_sym_t );
+            continue;
+        }
 
-            retVal  = INTERNAL_GetValueFromSymbolTable( SymbolName,
-                                                        Context->DynamicSymbolTable,
-                                                        Context->DynamicStringTable,
-                                                        count,
-                                                        Result );
+        key.SymbolName = StringTable + sym->st_name;
+
+        if( NULL == ( match = (pending_symbol_t*) bsearch( &key,
+                                                           Batch->Pending,
+                                                           Batch->PendingCount,
+                                                           sizeof( pending_symbol_t ),
+                                                           INTERNAL_PendingSymbol_Compare ) ) )
+        {
+            continue;
         }
-    }
 
-    return retVal;
+        // The same name may have been requested more than once
+        first   = match;
+        last    = match;
+
+        while( ( first > Batch->Pending                                                 ) &&
+               ( 0     == strcmp( ( first - 1 )->SymbolName, key.SymbolName )           ) )
+        {
+            first--;
+        }
+
+        while( ( ( last + 1 ) < ( Batch->Pending + Batch->PendingCount )                ) &&
+               ( 0            == strcmp( ( last + 1 )->SymbolName, key.SymbolName )     ) )
+        {
+            last++;
+        }
+
+        for( match = first; match <= last; match++ )
+        {
+            // Keep the first definition, like a linear scan would
+            if( ERROR_NOT_FOUND == Batch->Statuses[ match->RequestIndex ] )
+            {
+                INTERNAL_SymbolBatch_Resolve( Batch,
+                                              match->RequestIndex,
+                                              (uintptr_t) sym->st_value + Slide );
+            }
+        } // for()
+    } // for()
+}
+
+static
+void
+    INTERNAL_SymbolBatch_ResolveLoadedImage
+    (
+        IN  OUT     symbol_batch_t*         Batch,
+        IN          const runtime_module_t* Module
+    )
+{
+    elf_ctx_t           context     = { 0 };
+    size_t              i           = 0;
+    void*               value       = NULL;
+
+    INTERNAL_ElfContext_Initialize( &context,
+                                    Module->Base,
+                                    true );
+
+    for( i = 0; i < Batch->PendingCount; i++ )
+    {
+        if( ERROR_SUCCESS == INTERNAL_ElfContext_GetValueFromDynamicSymbolTable( &context,
+                                                                                 Batch->Pending[ i ].SymbolName,
+                                                                                 &value ) )
+        {
+            INTERNAL_SymbolBatch_Resolve( Batch,
+                                          Batch->Pending[ i ].RequestIndex,
+                                          (uintptr_t) value + context.LoadBias );
+        } // INTERNAL_ElfContext_GetValueFromDynamicSymbolTable()
+    } // for()
 }
 
 static
 BWSR_STATUS
-    INTERNAL_ResolveSymbol
+    INTERNAL_ElfContext_GetBuildId
     (
-        IN          const char*         LibraryName,
-        IN          const char*         SymbolName,
-        OUT         uintptr_t*          Address
+        IN          const elf_ctx_t*    Context,
+        OUT         uint8_t*            BuildId,
+        OUT         uint32_t*           BuildIdSize
     )
 {
     BWSR_STATUS         retVal      = ERROR_FAILURE;
-    uint8_t*            file_mem    = NULL;
     size_t              i           = 0;
-    runtime_module_t*   module      = NULL;
-    elf_ctx_t           context     = { 0 };
+    const elf_phdr_t*   phdr        = NULL;
+    uintptr_t           note        = 0;
+    uintptr_t           noteEnd     = 0;
+    const Elf32_Nhdr*   nhdr        = NULL;
+    const char*         name        = NULL;
 
-    __NOT_NULL( SymbolName, Address )
+    __NOT_NULL( Context,
+                BuildId,
+                BuildIdSize )
 
-    *Address = 0;
+    retVal = ERROR_NOT_FOUND;
 
-    for( i = 0; ( i < modules.Size ) && ( 0 == *Address ); i++ )
+    for( i = 0; ( i < Context->ProgramHeaderCount ) && ( ERROR_NOT_FOUND == retVal ); i++ )
     {
-        module = &modules.Data[ i ];
+        phdr = &Context->ProgramHeaders[ i ];
 
-        if( ( NULL != LibraryName ) &&
-            ( 0    != strncmp( LibraryName,
-                               modules.Data[ i ].Path,
-                               PATH_MAX ) ) )
+        if( PT_NOTE != phdr->p_type )
         {
             continue;
-        } // strncmp()
+        }
 
-        if( module->Base )
+        note    = Context->LoadBias + phdr->p_vaddr;
+        noteEnd = note + phdr->p_memsz;
+
+        while( ( ( note + sizeof( Elf32_Nhdr ) ) <= noteEnd ) &&
+               ( ERROR_NOT_FOUND == retVal                  ) )
         {
-            if( ERROR_SUCCESS != ( retVal = INTERNAL_MMapModulePath( &file_mem,
-                                                                     NULL,
-                                                                     (const uint8_t*) module->Path ) ) )
+            // Elf64_Nhdr and Elf32_Nhdr share the same layout
+            nhdr = (const Elf32_Nhdr*) note;
+            name = (const char*) ( note + sizeof( Elf32_Nhdr ) );
+
+            if( ( NT_GNU_BUILD_ID   == nhdr->n_type                 ) &&
+                ( 4                 == nhdr->n_namesz               ) &&
+                ( 0                 == memcmp( name, "GNU", 4 )     ) &&
+                ( BUILD_ID_MAX_SIZE >= nhdr->n_descsz               ) )
             {
-                BWSR_DEBUG( LOG_ERROR, "INTERNAL_MMapModulePath() Failed\n" );
-            }
-            else {
-                memset( &context,
-                        0,
-                        sizeof( elf_ctx_t ) );
+                memcpy( BuildId,
+                        name + 4,
+                        nhdr->n_descsz );
 
-                INTERNAL_ElfContext_Initialize( &context, file_mem );
+                *BuildIdSize    = nhdr->n_descsz;
+                retVal          = ERROR_SUCCESS;
+            }
 
-                if( ERROR_SUCCESS != ( retVal = INTERNAL_ElfContext_GetValueFromSymbolTable( &context,
-                                                                                             SymbolName,
-                                                                                             (void**) Address ) ) )
-                {
-                    BWSR_DEBUG( LOG_WARNING, "INTERNAL_ElfContext_GetValueFromSymbolTable() Failed. Retrying.\n" );
-                }
-                else {
-                    if( *Address )
-                    {
-                        *Address = ( (uintptr_t) *Address
-                                    + (uintptr_t) module->Base
-                                    - ( (uintptr_t) file_mem - (uintptr_t) context.LoadBias ) );
-                        retVal  = ERROR_SUCCESS;
-                    } // Address
-                } // INTERNAL_ElfContext_GetValueFromSymbolTable()
-            } // INTERNAL_MMapModulePath()
-        } // module->Base
+            note += sizeof( Elf32_Nhdr )
+                    + ALIGN_CEIL( nhdr->n_namesz, 4 )
+                    + ALIGN_CEIL( nhdr->n_descsz, 4 );
+        } // while()
     } // for()
 
-    if( 0 == *Address )
+    return retVal;
+}
+
+static
+bool
+    INTERNAL_SymbolCache_IsEnabled
+    (
+        void
+    )
+{
+    bool            enabled     = false;
+
+    pthread_rwlock_rdlock( &gSymbolCacheDirectoryLock );
+    enabled = ( 0 != gSymbolCacheDirectory[ 0 ] );
+    pthread_rwlock_unlock( &gSymbolCacheDirectoryLock );
+
+    return enabled;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_SymbolCache_GetPath
+    (
+        OUT         char*               Path,
+        IN          const uint8_t*      BuildId,
+        IN          const uint32_t      BuildIdSize
+    )
+{
+    BWSR_STATUS     retVal      = ERROR_FAILURE;
+    size_t          length      = 0;
+    uint32_t        i           = 0;
+
+    __NOT_NULL( Path, BuildId )
+
+    pthread_rwlock_rdlock( &gSymbolCacheDirectoryLock );
+
+    length = strnlen( gSymbolCacheDirectory, PATH_MAX );
+    memcpy( Path, gSymbolCacheDirectory, length );
+
+    pthread_rwlock_unlock( &gSymbolCacheDirectoryLock );
+
+    if( 0 == length )
     {
         retVal = ERROR_NOT_FOUND;
-    } // Address
+    }
+    else if( PATH_MAX <= ( length + 1 + ( BuildIdSize * 2 ) + sizeof( SYMBOL_CACHE_EXTENSION ) ) )
+    {
+        retVal = ERROR_MEMORY_OVERFLOW;
+    }
+    else {
+        Path[ length++ ] = '/';
+
+        for( i = 0; i < BuildIdSize; i++ )
+        {
+            length += snprintf( Path + length,
+                                PATH_MAX - length,
+                                "%02x",
+                                BuildId[ i ] );
+        } // for()
+
+        memcpy( Path + length,
+                SYMBOL_CACHE_EXTENSION,
+                sizeof( SYMBOL_CACHE_EXTENSION ) );
+
+        retVal = ERROR_SUCCESS;
+    } // PATH_MAX
 
     return retVal;
 }
 
-BWSR_API
-BWSR_STATUS
-    BWSR_ResolveSymbol
+// Every index in a mapped cache is checked once, so lookups can follow
+// them without bounds checks. A chain only ever links to an entry that was
+// written before it, which also rules out loops.
+static
+bool
+    INTERNAL_SymbolCache_IsValid
     (
-        IN              const char*             SymbolName,
-        IN OPTIONAL     const char*             ImageName,
-        OUT             uintptr_t*              Address
+        IN          const symbol_cache_header_t*    Header,
+        IN          const uint32_t*                 Buckets,
+        IN          const symbol_cache_entry_t*     Entries,
+        IN          const char*                     Strings
     )
 {
-    BWSR_STATUS retVal = ERROR_FAILURE;
+    uint32_t        i           = 0;
 
-    __NOT_NULL( SymbolName, Address )
+    // Every name ends before the end of the strings
+    if( ( 0 != Header->EntryCount ) &&
+        ( ( 0    == Header->StringsSize                 ) ||
+          ( '\0' != Strings[ Header->StringsSize - 1 ]  ) ) )
+    {
+        return false;
+    }
 
-    INTERNAL_GetProcessMap_ProcSelfMaps();
+    for( i = 0; i < Header->BucketCount; i++ )
+    {
+        if( Header->EntryCount < Buckets[ i ] )
+        {
+            return false;
+        }
+    } // for()
 
-    retVal = INTERNAL_ResolveSymbol( ImageName,
-                                     SymbolName,
-                                     Address );
+    for( i = 0; i < Header->EntryCount; i++ )
+    {
+        if( ( i                     <  Entries[ i ].Next        ) ||
+            ( Header->StringsSize   <= Entries[ i ].NameOffset  ) )
+        {
+            return false;
+        }
+    } // for()
 
-    INTERNAL_ReleaseRuntimeModules();
+    return true;
+}
 
-    __DEBUG_RETVAL( retVal )
-    return retVal;
+static
+BWSR_STATUS
+    INTERNAL_SymbolCache_Map
+    (
+        IN          const char*                     Path,
+        IN          const symbol_cache_header_t*    Expected,
+        OUT         symbol_cache_t**                Cache
+    )
+{
+    BWSR_STATUS                     retVal          = ERROR_FAILURE;
+    int                             fd              = 0;
+    struct stat                     s               = { 0 };
+    uint8_t*                        file_mem        = NULL;
+    const symbol_cache_header_t*    header          = NULL;
+    size_t                          entriesOffset   = 0;
+    size_t                          stringsOffset   = 0;
+
+    __NOT_NULL( Path, Expected, Cache )
+
+    if( 0 > ( fd = open( Path, ( O_RDONLY | O_CLOEXEC ) ) ) )
+    {
+        retVal = ERROR_NOT_FOUND;
+    }
+    else {
+        if( ( 0 != fstat( fd, &s )                                          ) ||
+            ( sizeof( symbol_cache_header_t ) > (size_t) s.st_size          ) )
+        {
+            retVal = ERROR_UNEXPECTED_FORMAT;
+        }
+        else if( MAP_FAILED == ( file_mem = (uint8_t*) mmap( NULL,
+                                                             s.st_size,
+                                                             PROT_READ,
+                                                             MAP_PRIVATE,
+                                                             fd,
+                                                             0 ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "mmap() Failed\n" );
+            retVal = ERROR_MEMORY_MAPPING;
+        }
+        else {
+            header          = (const symbol_cache_header_t*) file_mem;
+            entriesOffset   = ALIGN_CEIL( sizeof( symbol_cache_header_t ) + ( header->BucketCount * sizeof( uint32_t ) ),
+                                        sizeof( uint64_t ) );
+            stringsOffset   = entriesOffset + ( header->EntryCount * sizeof( symbol_cache_entry_t ) );
+
+            // A stale cache belongs to a file that has since been replaced
+            if( ( SYMBOL_CACHE_MAGIC                != header->Magic                            ) ||
+                ( SYMBOL_CACHE_VERSION              != header->Version                          ) ||
+                ( Expected->FileSize                != header->FileSize                         ) ||
+                ( Expected->FileModifiedSeconds     != header->FileModifiedSeconds              ) ||
+                ( Expected->FileModifiedNanoseconds != header->FileModifiedNanoseconds          ) ||
+                ( Expected->BuildIdSize             != header->BuildIdSize                      ) ||
+                ( 0                                 != memcmp( Expected->BuildId,
+                                                               header->BuildId,
+                                                               header->BuildIdSize )            ) ||
+                ( 0                                 == header->BucketCount                      ) ||
+                ( (size_t) s.st_size                != ( stringsOffset + header->StringsSize )  ) ||
+                ( !INTERNAL_SymbolCache_IsValid( header,
+                                                 (const uint32_t*) ( file_mem + sizeof( symbol_cache_header_t ) ),
+                                                 (const symbol_cache_entry_t*) ( file_mem + entriesOffset ),
+                                                 (const char*) ( file_mem + stringsOffset ) ) ) )
+            {
+                munmap( file_mem, s.st_size );
+                retVal = ERROR_UNEXPECTED_FORMAT;
+            }
+            else if( NULL == ( *Cache = (symbol_cache_t*) BwsrCalloc( 1, sizeof( symbol_cache_t ) ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+                munmap( file_mem, s.st_size );
+                retVal = ERROR_MEM_ALLOC;
+            }
+            else {
+                ( *Cache )->File        = file_mem;
+                ( *Cache )->FileSize    = s.st_size;
+                ( *Cache )->Header      = header;
+                ( *Cache )->Buckets     = (const uint32_t*) ( file_mem + sizeof( symbol_cache_header_t ) );
+                ( *Cache )->Entries     = (const symbol_cache_entry_t*) ( file_mem + entriesOffset );
+                ( *Cache )->Strings     = (const char*) ( file_mem + stringsOffset );
+
+                retVal = ERROR_SUCCESS;
+            } // header
+        } // mmap()
+
+        close( fd );
+    } // open()
+
+    return retVal;
+}
+
+static
+bool
+    INTERNAL_SymbolCache_Insert
+    (
+        IN  OUT     symbol_cache_header_t*  Header,
+        IN  OUT     uint32_t*               Buckets,
+        IN  OUT     symbol_cache_entry_t*   Entries,
+        IN  OUT     char*                   Strings,
+        IN          const elf_sym_t*        Symbol,
+        IN          const char*             SymbolName
+    )
+{
+    uint32_t                hash        = 0;
+    uint32_t                bucket      = 0;
+    uint32_t                i           = 0;
+    symbol_cache_entry_t*   entry       = NULL;
+    size_t                  length      = 0;
+
+    hash    = INTERNAL_GnuHash( SymbolName );
+    bucket  = hash % Header->BucketCount;
+
+    // The first definition of a name wins, like a linear scan
+    for( i = Buckets[ bucket ]; 0 != i; i = Entries[ i - 1 ].Next )
+    {
+        if( ( hash == Entries[ i - 1 ].Hash                                 ) &&
+            ( 0    == strcmp( Strings + Entries[ i - 1 ].NameOffset,
+                              SymbolName )                                  ) )
+        {
+            return false;
+        }
+    } // for()
+
+    length              = strlen( SymbolName ) + 1;
+    entry               = &Entries[ Header->EntryCount ];
+    entry->Hash         = hash;
+    entry->Next         = Buckets[ bucket ];
+    entry->NameOffset   = Header->StringsSize;
+    entry->Value        = (uint64_t) Symbol->st_value;
+
+    memcpy( Strings + Header->StringsSize,
+            SymbolName,
+            length );
+
+    Header->StringsSize     += length;
+    Buckets[ bucket ]        = ++Header->EntryCount;
+
+    return true;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_SymbolCache_WriteAll
+    (
+        IN          const int           FileDescriptor,
+        IN          const void*         Buffer,
+        IN          size_t              Size
+    )
+{
+    const uint8_t*  buffer      = (const uint8_t*) Buffer;
+    ssize_t         written     = 0;
+
+    while( 0 < Size )
+    {
+        if( 0 >= ( written = write( FileDescriptor, buffer, Size ) ) )
+        {
+            return ERROR_FILE_IO;
+        }
+
+        buffer  += written;
+        Size    -= written;
+    } // while()
+
+    return ERROR_SUCCESS;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_SymbolCache_Write
+    (
+        IN          const char*             Path,
+        IN          const runtime_module_t* Module,
+        IN          symbol_cache_header_t*  Header
+    )
+{
+    BWSR_STATUS             retVal          = ERROR_FAILURE;
+    uint8_t*                file_mem        = NULL;
+    size_t                  file_size       = 0;
+    elf_ctx_t               context         = { 0 };
+    const elf_sym_t*        tables[ 2 ]     = { NULL };
+    const char*             strings[ 2 ]    = { NULL };
+    size_t                  counts[ 2 ]     = { 0 };
+    size_t                  t               = 0;
+    size_t                  i               = 0;
+    size_t                  maxEntries      = 0;
+    size_t                  maxStrings      = 0;
+    uint32_t*               buckets         = NULL;
+    symbol_cache_entry_t*   entries         = NULL;
+    char*                   names           = NULL;
+    const elf_sym_t*        sym             = NULL;
+    char                    tmpPath[ PATH_MAX + 16 ] = { 0 };
+    int                     fd              = 0;
+    const uint8_t           padding[ 8 ]    = { 0 };
+    size_t                  offset          = 0;
+
+    __NOT_NULL( Path, Module, Header )
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_MMapModulePath( &file_mem,
+                                                             &file_size,
+                                                             (const uint8_t*) Module->Path ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_MMapModulePath() Failed\n" );
+        return retVal;
+    }
+
+    INTERNAL_ElfContext_Initialize( &context,
+                                    file_mem,
+                                    false );
+
+    // Same tables, in the same order, as the uncached `.symtab` lookup
+    if( ( NULL != context.SymbolSh      ) &&
+        ( NULL != context.SymbolTable   ) &&
+        ( NULL != context.StringTable   ) )
+    {
+        tables[ 0 ]     = context.SymbolTable;
+        strings[ 0 ]    = context.StringTable;
+        counts[ 0 ]     = context.SymbolSh->sh_size / sizeof( elf_sym_t );
+    }
+
+    if( ( NULL == context.GnuHash               ) &&
+        ( NULL == context.SysvHash              ) &&
+        ( NULL != context.DynamicSymbolSh       ) &&
+        ( NULL != context.DynamicSymbolTable    ) &&
+        ( NULL != context.DynamicStringTable    ) )
+    {
+        tables[ 1 ]     = context.DynamicSymbolTable;
+        strings[ 1 ]    = context.DynamicStringTable;
+        counts[ 1 ]     = context.DynamicSymbolSh->sh_size / sizeof( elf_sym_t );
+    }
+
+    for( t = 0; t < 2; t++ )
+    {
+        for( i = 0; i < counts[ t ]; i++ )
+        {
+            sym = tables[ t ] + i;
+
+            if( ( SHN_UNDEF != sym->st_shndx ) &&
+                ( 0         != sym->st_name  ) )
+            {
+                maxEntries++;
+                maxStrings += strlen( strings[ t ] + sym->st_name ) + 1;
+            }
+        } // for()
+    } // for()
+
+    Header->BucketCount = ( 0 < maxEntries ) ? (uint32_t) maxEntries : 1;
+    Header->EntryCount  = 0;
+    Header->StringsSize = 0;
+
+    if( ( NULL == ( buckets = (uint32_t*) BwsrCalloc( Header->BucketCount, sizeof( uint32_t ) ) ) ) ||
+        ( NULL == ( entries = (symbol_cache_entry_t*) BwsrCalloc( maxEntries + 1, sizeof( symbol_cache_entry_t ) ) ) ) ||
+        ( NULL == ( names   = (char*) BwsrMalloc( maxStrings + 1 ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        for( t = 0; t < 2; t++ )
+        {
+            for( i = 0; i < counts[ t ]; i++ )
+            {
+                sym = tables[ t ] + i;
+
+                if( ( SHN_UNDEF != sym->st_shndx ) &&
+                    ( 0         != sym->st_name  ) )
+                {
+                    INTERNAL_SymbolCache_Insert( Header,
+                                                 buckets,
+                                                 entries,
+                                                 names,
+                                                 sym,
+                                                 strings[ t ] + sym->st_name );
+                }
+            } // for()
+        } // for()
+
+        // Written next to the final file and renamed over it, so a reader
+        // never maps a partial cache. The name is unique and created
+        // exclusively, the directory may be shared.
+        snprintf( tmpPath,
+                  sizeof( tmpPath ),
+                  "%s.XXXXXX",
+                  Path );
+
+        if( 0 > ( fd = mkostemp( tmpPath, O_CLOEXEC ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "mkostemp() Failed\n" );
+            retVal = ERROR_FILE_IO;
+        }
+        else if( 0 != fchmod( fd, 0644 ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "fchmod() Failed\n" );
+            close( fd );
+            unlink( tmpPath );
+            retVal = ERROR_FILE_IO;
+        }
+        else {
+            offset = sizeof( symbol_cache_header_t ) + ( Header->BucketCount * sizeof( uint32_t ) );
+
+            if( ( ERROR_SUCCESS != ( retVal = INTERNAL_SymbolCache_WriteAll( fd, Header, sizeof( symbol_cache_header_t ) ) ) ) ||
+                ( ERROR_SUCCESS != ( retVal = INTERNAL_SymbolCache_WriteAll( fd, buckets, Header->BucketCount * sizeof( uint32_t ) ) ) ) ||
+                ( ERROR_SUCCESS != ( retVal = INTERNAL_SymbolCache_WriteAll( fd, padding, ALIGN_CEIL( offset, sizeof( uint64_t ) ) - offset ) ) ) ||
+                ( ERROR_SUCCESS != ( retVal = INTERNAL_SymbolCache_WriteAll( fd, entries, Header->EntryCount * sizeof( symbol_cache_entry_t ) ) ) ) ||
+                ( ERROR_SUCCESS != ( retVal = INTERNAL_SymbolCache_WriteAll( fd, names, Header->StringsSize ) ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "write() Failed\n" );
+            }
+
+            close( fd );
+
+            if( ( ERROR_SUCCESS != retVal               ) ||
+                ( 0             != rename( tmpPath, Path ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "rename() Failed\n" );
+                unlink( tmpPath );
+                retVal = ERROR_FILE_IO;
+            }
+        } // open()
+    } // BwsrCalloc()
+
+    BwsrFree( buckets );
+    BwsrFree( entries );
+    BwsrFree( names );
+
+    munmap( file_mem, file_size );
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_SymbolCache_Open
+    (
+        IN          const runtime_module_t* Module,
+        OUT         symbol_cache_t**        Cache
+    )
+{
+    BWSR_STATUS             retVal          = ERROR_FAILURE;
+    elf_ctx_t               image           = { 0 };
+    struct stat             s               = { 0 };
+    symbol_cache_header_t   header          = { 0 };
+    char                    path[ PATH_MAX ] = { 0 };
+
+    __NOT_NULL( Module, Cache )
+
+    INTERNAL_ElfContext_Initialize( &image,
+                                    Module->Base,
+                                    true );
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_ElfContext_GetBuildId( &image,
+                                                                    header.BuildId,
+                                                                    &header.BuildIdSize ) ) )
+    {
+        BWSR_DEBUG( LOG_WARNING, "INTERNAL_ElfContext_GetBuildId() Failed\n" );
+    }
+    else if( 0 != stat( Module->Path, &s ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "stat() Failed\n" );
+        retVal = ERROR_FILE_IO;
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_SymbolCache_GetPath( path,
+                                                                       header.BuildId,
+                                                                       header.BuildIdSize ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_SymbolCache_GetPath() Failed\n" );
+    }
+    else {
+        header.Magic                    = SYMBOL_CACHE_MAGIC;
+        header.Version                  = SYMBOL_CACHE_VERSION;
+        header.FileSize                 = (uint64_t) s.st_size;
+        header.FileModifiedSeconds      = (int64_t) s.st_mtim.tv_sec;
+        header.FileModifiedNanoseconds  = (int64_t) s.st_mtim.tv_nsec;
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_SymbolCache_Map( path,
+                                                                  &header,
+                                                                  Cache ) ) )
+        {
+            if( ERROR_SUCCESS != ( retVal = INTERNAL_SymbolCache_Write( path,
+                                                                        Module,
+                                                                        &header ) ) )
+            {
+                BWSR_DEBUG( LOG_ERROR, "INTERNAL_SymbolCache_Write() Failed\n" );
+            }
+            else {
+                retVal = INTERNAL_SymbolCache_Map( path,
+                                                   &header,
+                                                   Cache );
+            } // INTERNAL_SymbolCache_Write()
+        } // INTERNAL_SymbolCache_Map()
+    } // INTERNAL_ElfContext_GetBuildId()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_SymbolCache_Get
+    (
+        IN  OUT     runtime_module_t*       Module,
+        OUT         symbol_cache_t**        Cache
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+    symbol_cache_t*     published   = NULL;
+
+    __NOT_NULL( Module, Cache )
+
+    if( NULL != ( *Cache = __atomic_load_n( &Module->Cache, __ATOMIC_ACQUIRE ) ) )
+    {
+        retVal = ERROR_SUCCESS;
+    }
+    else if( ERROR_SUCCESS == ( retVal = INTERNAL_SymbolCache_Open( Module, Cache ) ) )
+    {
+        // Keep whichever mapping was published first
+        if( !__atomic_compare_exchange_n( &Module->Cache,
+                                          &published,
+                                          *Cache,
+                                          false,
+                                          __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE ) )
+        {
+            INTERNAL_ReleaseSymbolCache( *Cache );
+            *Cache = published;
+        } // __atomic_compare_exchange_n()
+    } // Module->Cache
+
+    return retVal;
+}
+
+static
+void
+    INTERNAL_SymbolBatch_ResolveSymbolCache
+    (
+        IN  OUT     symbol_batch_t*         Batch,
+        IN          const runtime_module_t* Module,
+        IN          const symbol_cache_t*   Cache
+    )
+{
+    elf_ctx_t               image       = { 0 };
+    size_t                  i           = 0;
+    uint32_t                hash        = 0;
+    uint32_t                entry       = 0;
+    const char*             name        = NULL;
+
+    INTERNAL_ElfContext_Initialize( &image,
+                                    Module->Base,
+                                    true );
+
+    for( i = 0; i < Batch->PendingCount; i++ )
+    {
+        name = Batch->Pending[ i ].SymbolName;
+        hash = INTERNAL_GnuHash( name );
+
+        for( entry = Cache->Buckets[ hash % Cache->Header->BucketCount ];
+             0 != entry;
+             entry = Cache->Entries[ entry - 1 ].Next )
+        {
+            if( ( hash == Cache->Entries[ entry - 1 ].Hash                          ) &&
+                ( 0    == strcmp( Cache->Strings + Cache->Entries[ entry - 1 ].NameOffset,
+                                  name )                                            ) )
+            {
+                INTERNAL_SymbolBatch_Resolve( Batch,
+                                              Batch->Pending[ i ].RequestIndex,
+                                              (uintptr_t) Cache->Entries[ entry - 1 ].Value + image.LoadBias );
+                break;
+            }
+        } // for()
+    } // for()
+}
+
+static
+BWSR_STATUS
+    INTERNAL_SymbolBatch_ResolveModuleFile
+    (
+        IN  OUT     symbol_batch_t*         Batch,
+        IN  OUT     runtime_module_t*       Module
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+    uint8_t*            file_mem    = NULL;
+    size_t              file_size   = 0;
+    elf_ctx_t           context     = { 0 };
+    uintptr_t           slide       = 0;
+    symbol_cache_t*     cache       = NULL;
+
+    if( ( INTERNAL_SymbolCache_IsEnabled()                                  ) &&
+        ( ERROR_SUCCESS == INTERNAL_SymbolCache_Get( Module, &cache )       ) )
+    {
+        INTERNAL_SymbolBatch_ResolveSymbolCache( Batch, Module, cache );
+        return ERROR_SUCCESS;
+    } // INTERNAL_SymbolCache_IsEnabled()
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_MMapModulePath( &file_mem,
+                                                             &file_size,
+                                                             (const uint8_t*) Module->Path ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_MMapModulePath() Failed\n" );
+    }
+    else {
+        INTERNAL_ElfContext_Initialize( &context,
+                                        file_mem,
+                                        false );
+
+        slide = (uintptr_t) Module->Base - ( (uintptr_t) file_mem - (uintptr_t) context.LoadBias );
+
+        if( ( NULL != context.SymbolSh      ) &&
+            ( NULL != context.SymbolTable   ) &&
+            ( NULL != context.StringTable   ) )
+        {
+            INTERNAL_SymbolBatch_ScanSymbolTable( Batch,
+                                                  context.SymbolTable,
+                                                  context.StringTable,
+                                                  context.SymbolSh->sh_size / sizeof( elf_sym_t ),
+                                                  slide );
+        } // .symtab
+
+        // Without hash tables the in-memory lookup could not search `.dynsym`
+        if( ( NULL == context.GnuHash               ) &&
+            ( NULL == context.SysvHash              ) &&
+            ( NULL != context.DynamicSymbolSh       ) &&
+            ( NULL != context.DynamicSymbolTable    ) &&
+            ( NULL != context.DynamicStringTable    ) )
+        {
+            INTERNAL_SymbolBatch_CollectPending( Batch, Module );
+
+            INTERNAL_SymbolBatch_ScanSymbolTable( Batch,
+                                                  context.DynamicSymbolTable,
+                                                  context.DynamicStringTable,
+                                                  context.DynamicSymbolSh->sh_size / sizeof( elf_sym_t ),
+                                                  slide );
+        } // .dynsym
+
+        munmap( file_mem, file_size );
+    } // INTERNAL_MMapModulePath()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ResolveSymbols
+    (
+        IN          const module_index_t*           Index,
+        IN          const bwsr_symbol_request_t*    Requests,
+        IN          const size_t                    Count,
+        OUT         uintptr_t*                      Addresses,
+        OUT         BWSR_STATUS*                    Statuses
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+    size_t              i           = 0;
+    symbol_batch_t      batch       = { 0 };
+
+    __NOT_NULL( Index,
+                Requests,
+                Addresses,
+                Statuses )
+    __GREATER_THAN_0( Count )
+
+    batch.Requests  = Requests;
+    batch.Count     = Count;
+    batch.Addresses = Addresses;
+    batch.Statuses  = Statuses;
+
+    for( i = 0; i < Count; i++ )
+    {
+        Addresses[ i ] = 0;
+
+        if( NULL == Requests[ i ].SymbolName )
+        {
+            Statuses[ i ] = ERROR_ARGUMENT_IS_NULL;
+        }
+        else {
+            Statuses[ i ] = ERROR_NOT_FOUND;
+            batch.Remaining++;
+        } // SymbolName
+    } // for()
+
+    if( NULL == ( batch.Pending = (pending_symbol_t*) BwsrMalloc( Count * sizeof( pending_symbol_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        // Exported symbols are read straight from the images mapped by the loader
+        for( i = 0; ( i < Index->Size ) && ( 0 < batch.Remaining ); i++ )
+        {
+            INTERNAL_SymbolBatch_CollectPending( &batch, &Index->Data[ i ] );
+
+            if( 0 < batch.PendingCount )
+            {
+                INTERNAL_SymbolBatch_ResolveLoadedImage( &batch, &Index->Data[ i ] );
+            }
+        } // for()
+
+        // Local symbols only exist in the `.symtab` of the files on disk
+        for( i = 0; ( i < Index->Size ) && ( 0 < batch.Remaining ); i++ )
+        {
+            INTERNAL_SymbolBatch_CollectPending( &batch, &Index->Data[ i ] );
+
+            if( ( 0             <  batch.PendingCount                                               ) &&
+                ( ERROR_SUCCESS != INTERNAL_SymbolBatch_ResolveModuleFile( &batch, &Index->Data[ i ] ) ) )
+            {
+                BWSR_DEBUG( LOG_WARNING, "INTERNAL_SymbolBatch_ResolveModuleFile() Failed. Retrying.\n" );
+            }
+        } // for()
+
+        BwsrFree( batch.Pending );
+
+        retVal = ( 0 == batch.Remaining ) ? ERROR_SUCCESS : ERROR_NOT_FOUND;
+    } // BwsrMalloc()
+
+    return retVal;
+}
+
+static
+size_t
+    INTERNAL_ElfContext_GetDynamicSymbolCount
+    (
+        IN          const elf_ctx_t*    Context
+    )
+{
+    size_t              count           = 0;
+    uint32_t            bucketCount     = 0;
+    uint32_t            symbolOffset    = 0;
+    uint32_t            bloomSize       = 0;
+    const uint32_t*     buckets         = NULL;
+    const uint32_t*     chain           = NULL;
+    uint32_t            i               = 0;
+
+    if( NULL != Context->SysvHash )
+    {
+        // `nchain` equals the amount of symbols
+        count = Context->SysvHash[ 1 ];
+    }
+    else if( NULL != Context->GnuHash )
+    {
+        bucketCount     = Context->GnuHash[ 0 ];
+        symbolOffset    = Context->GnuHash[ 1 ];
+        bloomSize       = Context->GnuHash[ 2 ];
+        buckets         = (const uint32_t*) ( (const elf_addr_t*) &Context->GnuHash[ 4 ] + bloomSize );
+        chain           = buckets + bucketCount;
+
+        for( i = 0; i < bucketCount; i++ )
+        {
+            if( count < buckets[ i ] )
+            {
+                count = buckets[ i ];
+            }
+        } // for()
+
+        // Walk the last chain up to its terminator
+        if( count >= symbolOffset )
+        {
+            while( 0 == ( chain[ count - symbolOffset ] & 1 ) )
+            {
+                count++;
+            }
+
+            count++;
+        }
+        else {
+            count = symbolOffset;
+        } // count
+    } // Context->GnuHash
+
+    return count;
+}
+
+static
+void
+    INTERNAL_ModuleSymbols_Append
+    (
+        IN  OUT     module_symbols_t*   Symbols,
+        IN          const elf_sym_t*    SymbolTable,
+        IN          const char*         StringTable,
+        IN          const size_t        Count,
+        IN          const uintptr_t     Slide
+    )
+{
+    size_t              i           = 0;
+    const elf_sym_t*    sym         = NULL;
+    const char*         name        = NULL;
+    module_symbol_t*    symbol      = NULL;
+
+    for( i = 0; i < Count; i++ )
+    {
+        sym = SymbolTable + i;
+
+        if( ( SHN_UNDEF == sym->st_shndx ) ||
+            ( SHN_ABS   == sym->st_shndx ) ||
+            ( 0         == sym->st_name  ) )
+        {
+            continue;
+        }
+
+        switch( ELF64_ST_TYPE( sym->st_info ) )
+        {
+            case STT_FUNC:
+            case STT_OBJECT:
+            case STT_GNU_IFUNC:
+            case STT_NOTYPE:
+            {
+                break;
+            }
+
+            default:
+            {
+                continue;
+            }
+        } // switch()
+
+        name = StringTable + sym->st_name;
+
+        // Skip ARM mapping symbols (`$x`, `$d`, ...)
+        if( '$' == name[ 0 ] )
+        {
+            continue;
+        }
+
+        symbol          = &Symbols->Data[ Symbols->Size++ ];
+        symbol->Address = (uintptr_t) sym->st_value + Slide;
+        symbol->Size    = (size_t) sym->st_size;
+        symbol->Name    = name;
+    } // for()
+}
+
+static
+int
+    INTERNAL_ModuleSymbol_Compare
+    (
+        IN          const void*             Left,
+        IN          const void*             Right
+    )
+{
+    const module_symbol_t*  left    = (const module_symbol_t*) Left;
+    const module_symbol_t*  right   = (const module_symbol_t*) Right;
+
+    if( left->Address != right->Address )
+    {
+        return ( left->Address < right->Address ) ? -1 : 1;
+    }
+
+    // Sized definitions win over aliases and labels at the same address
+    if( left->Size != right->Size )
+    {
+        return ( left->Size > right->Size ) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ModuleSymbols_Build
+    (
+        IN          const runtime_module_t* Module,
+        OUT         module_symbols_t**      Symbols
+    )
+{
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    elf_ctx_t           image           = { 0 };
+    elf_ctx_t           file            = { 0 };
+    module_symbols_t*   symbols         = NULL;
+    size_t              dynamicCount    = 0;
+    size_t              symbolCount     = 0;
+    size_t              i               = 0;
+    size_t              unique          = 0;
+
+    __NOT_NULL( Module, Symbols )
+
+    INTERNAL_ElfContext_Initialize( &image,
+                                    Module->Base,
+                                    true );
+
+    if( ( NULL != image.DynamicSymbolTable ) &&
+        ( NULL != image.DynamicStringTable ) )
+    {
+        dynamicCount = INTERNAL_ElfContext_GetDynamicSymbolCount( &image );
+    }
+
+    if( NULL == ( symbols = (module_symbols_t*) BwsrCalloc( 1, sizeof( module_symbols_t ) ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "BwsrCalloc() Failed\n" );
+        retVal = ERROR_MEM_ALLOC;
+    }
+    else {
+        // Local symbols are only in the file. A module without one still
+        // gets its exported symbols.
+        if( ERROR_SUCCESS == INTERNAL_MMapModulePath( &symbols->File,
+                                                      &symbols->FileSize,
+                                                      (const uint8_t*) Module->Path ) )
+        {
+            INTERNAL_ElfContext_Initialize( &file,
+                                            symbols->File,
+                                            false );
+
+            if( ( NULL != file.SymbolSh     ) &&
+                ( NULL != file.SymbolTable  ) &&
+                ( NULL != file.StringTable  ) )
+            {
+                symbolCount = file.SymbolSh->sh_size / sizeof( elf_sym_t );
+            }
+            else {
+                munmap( symbols->File, symbols->FileSize );
+                symbols->File       = NULL;
+                symbols->FileSize   = 0;
+            } // .symtab
+        } // INTERNAL_MMapModulePath()
+
+        if( 0 == ( dynamicCount + symbolCount ) )
+        {
+            *Symbols    = symbols;
+            retVal      = ERROR_SUCCESS;
+        }
+        else if( NULL == ( symbols->Data = (module_symbol_t*) BwsrMalloc( ( dynamicCount + symbolCount ) * sizeof( module_symbol_t ) ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "BwsrMalloc() Failed\n" );
+            INTERNAL_ReleaseModuleSymbols( symbols );
+            retVal = ERROR_MEM_ALLOC;
+        }
+        else {
+            INTERNAL_ModuleSymbols_Append( symbols,
+                                           image.DynamicSymbolTable,
+                                           image.DynamicStringTable,
+                                           dynamicCount,
+                                           image.LoadBias );
+
+            if( 0 < symbolCount )
+            {
+                INTERNAL_ModuleSymbols_Append( symbols,
+                                               file.SymbolTable,
+                                               file.StringTable,
+                                               symbolCount,
+                                               (uintptr_t) Module->Base
+                                                - ( (uintptr_t) symbols->File - (uintptr_t) file.LoadBias ) );
+            }
+
+            qsort( symbols->Data,
+                   symbols->Size,
+                   sizeof( module_symbol_t ),
+                   INTERNAL_ModuleSymbol_Compare );
+
+            // `.dynsym` and `.symtab` overlap, keep one symbol per address
+            for( i = 0; i < symbols->Size; i++ )
+            {
+                if( ( 0                                 == unique                   ) ||
+                    ( symbols->Data[ unique - 1 ].Address != symbols->Data[ i ].Address ) )
+                {
+                    symbols->Data[ unique++ ] = symbols->Data[ i ];
+                }
+            } // for()
+
+            symbols->Size   = unique;
+            *Symbols        = symbols;
+            retVal          = ERROR_SUCCESS;
+        } // BwsrMalloc()
+    } // BwsrCalloc()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ModuleSymbols_Get
+    (
+        IN  OUT     runtime_module_t*       Module,
+        OUT         module_symbols_t**      Symbols
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+    module_symbols_t*   published   = NULL;
+
+    __NOT_NULL( Module, Symbols )
+
+    if( NULL != ( *Symbols = __atomic_load_n( &Module->Symbols, __ATOMIC_ACQUIRE ) ) )
+    {
+        retVal = ERROR_SUCCESS;
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_ModuleSymbols_Build( Module, Symbols ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_ModuleSymbols_Build() Failed\n" );
+    }
+    else {
+        // Concurrent lookups may build the same module, the first one is kept
+        if( !__atomic_compare_exchange_n( &Module->Symbols,
+                                          &published,
+                                          *Symbols,
+                                          false,
+                                          __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE ) )
+        {
+            INTERNAL_ReleaseModuleSymbols( *Symbols );
+            *Symbols = published;
+        } // __atomic_compare_exchange_n()
+    } // Module->Symbols
+
+    return retVal;
+}
+
+static
+runtime_module_t*
+    INTERNAL_ModuleIndex_FindModule
+    (
+        IN          const module_index_t*   Index,
+        IN          const uintptr_t         Address
+    )
+{
+    size_t              low         = 0;
+    size_t              high        = 0;
+    size_t              middle      = 0;
+    runtime_module_t*   module      = NULL;
+
+    // `/proc/self/maps` lists the modules in ascending address order
+    high = Index->Size;
+
+    while( low < high )
+    {
+        middle = low + ( ( high - low ) / 2 );
+
+        if( (uintptr_t) Index->Data[ middle ].Base <= Address )
+        {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    } // while()
+
+    if( ( 0       <  low                                        ) &&
+        ( Address <  (uintptr_t) Index->Data[ low - 1 ].End     ) )
+    {
+        module = &Index->Data[ low - 1 ];
+    }
+
+    return module;
+}
+
+static
+const module_symbol_t*
+    INTERNAL_ModuleSymbols_FindSymbol
+    (
+        IN          const module_symbols_t* Symbols,
+        IN          const uintptr_t         Address
+    )
+{
+    size_t              low         = 0;
+    size_t              high        = 0;
+    size_t              middle      = 0;
+
+    high = Symbols->Size;
+
+    while( low < high )
+    {
+        middle = low + ( ( high - low ) / 2 );
+
+        if( Symbols->Data[ middle ].Address <= Address )
+        {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    } // while()
+
+    return ( 0 < low ) ? &Symbols->Data[ low - 1 ] : NULL;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ElfContext_WriteImportSlot
+    (
+        IN          const elf_ctx_t*        Context,
+        IN          uintptr_t*              Slot,
+        IN          const uintptr_t         Value,
+        OUT         uintptr_t*              Previous
+    )
+{
+    BWSR_STATUS     retVal          = ERROR_FAILURE;
+    size_t          i               = 0;
+    size_t          pageSize        = 0;
+    uintptr_t       page            = 0;
+    uintptr_t       relroStart      = 0;
+    uintptr_t       relroEnd        = 0;
+    bool            relro           = false;
+
+    __NOT_NULL( Context, Slot, Previous )
+
+    pageSize    = (size_t) sysconf( _SC_PAGESIZE );
+    page        = ALIGN_FLOOR( Slot, pageSize );
+
+    // The loader only makes whole pages of `PT_GNU_RELRO` read only
+    for( i = 0; ( i < Context->ProgramHeaderCount ) && ( false == relro ); i++ )
+    {
+        if( PT_GNU_RELRO == Context->ProgramHeaders[ i ].p_type )
+        {
+            relroStart  = Context->LoadBias + Context->ProgramHeaders[ i ].p_vaddr;
+            relroEnd    = relroStart + Context->ProgramHeaders[ i ].p_memsz;
+
+            relroStart  = ALIGN_FLOOR( relroStart, pageSize );
+            relroEnd    = ALIGN_FLOOR( relroEnd, pageSize );
+            relro       = ( ( page >= relroStart ) && ( page < relroEnd ) );
+        } // PT_GNU_RELRO
+    } // for()
+
+    if( ( relro                                                                     ) &&
+        ( 0     != mprotect( (void*) page, pageSize, ( PROT_READ | PROT_WRITE ) )   ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "mprotect() Failed\n" );
+        retVal = ERROR_MEMORY_PERMISSION;
+    }
+    else {
+        // Callers going through the slot see either the old or the new
+        // value, never a torn one
+        *Previous = __atomic_exchange_n( Slot, Value, __ATOMIC_SEQ_CST );
+
+        retVal = ERROR_SUCCESS;
+
+        if( ( relro                                                 ) &&
+            ( 0     != mprotect( (void*) page, pageSize, PROT_READ )  ) )
+        {
+            BWSR_DEBUG( LOG_WARNING, "mprotect() Failed. RELRO page left writable.\n" );
+        } // relro
+    } // mprotect()
+
+    return retVal;
+}
+
+static
+const char*
+    INTERNAL_ElfContext_GetImportVersion
+    (
+        IN          const elf_ctx_t*        Context,
+        IN          const size_t            SymbolIndex
+    )
+{
+    const elf_verneed_t*    need        = NULL;
+    const elf_vernaux_t*    aux         = NULL;
+    uint16_t                version     = 0;
+    size_t                  i           = 0;
+
+    if( ( NULL == Context->VersionSymbols   ) ||
+        ( NULL == Context->VersionNeeds     ) )
+    {
+        return NULL;
+    }
+
+    // `0` is local and `1` global, neither names a version
+    if( 2 > ( version = ( Context->VersionSymbols[ SymbolIndex ] & 0x7FFF ) ) )
+    {
+        return NULL;
+    }
+
+    need = (const elf_verneed_t*) Context->VersionNeeds;
+
+    while( NULL != need )
+    {
+        aux = (const elf_vernaux_t*) ( (const uint8_t*) need + need->vn_aux );
+
+        for( i = 0; i < need->vn_cnt; i++ )
+        {
+            if( version == aux->vna_other )
+            {
+                return Context->DynamicStringTable + aux->vna_name;
+            }
+
+            aux = (const elf_vernaux_t*) ( (const uint8_t*) aux + aux->vna_next );
+        } // for()
+
+        need = ( 0 != need->vn_next )
+                ? (const elf_verneed_t*) ( (const uint8_t*) need + need->vn_next )
+                : NULL;
+    } // while()
+
+    return NULL;
+}
+
+static
+void*
+    INTERNAL_LookupImport
+    (
+        IN          void*                   Handle,
+        IN          const char*             SymbolName,
+        IN          const char*             Version
+    )
+{
+#if defined( __ANDROID__ ) && ( __ANDROID_API__ < 24 )
+    // `dlvsym()` only exists since Android 7.0
+    (void) Version;
+
+    return dlsym( Handle, SymbolName );
+#else
+    return ( NULL == Version )
+            ? dlsym( Handle, SymbolName )
+            : dlvsym( Handle, SymbolName, Version );
+#endif
+}
+
+static
+uintptr_t
+    INTERNAL_ElfContext_ResolveImport
+    (
+        IN          const elf_ctx_t*        Context,
+        IN          const runtime_module_t* Module,
+        IN          const size_t            SymbolIndex
+    )
+{
+    const char*     name        = NULL;
+    const char*     version     = NULL;
+    void*           handle      = NULL;
+    void*           address     = NULL;
+
+    name    = Context->DynamicStringTable + Context->DynamicSymbolTable[ SymbolIndex ].st_name;
+    version = INTERNAL_ElfContext_GetImportVersion( Context, SymbolIndex );
+
+    // As the loader binds it: the version the module was linked
+    // against, from the global scope first and then from the
+    // dependencies loaded along with the module
+    if( ( NULL == ( address = INTERNAL_LookupImport( RTLD_DEFAULT, name, version ) ) ) &&
+        ( NULL != ( handle = dlopen( Module->Path, RTLD_LAZY | RTLD_NOLOAD ) ) ) )
+    {
+        address = INTERNAL_LookupImport( handle, name, version );
+
+        (void) dlclose( handle );
+    } // RTLD_DEFAULT
+
+    return (uintptr_t) address;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ElfContext_ReplaceImports
+    (
+        IN          const elf_ctx_t*        Context,
+        IN          const runtime_module_t* Module,
+        IN          const uint8_t*          Relocations,
+        IN          const size_t            RelocationsSize,
+        IN          const size_t            RelocationSize,
+        IN          const char*             SymbolName,
+        IN          const uintptr_t         Replacement,
+        IN  OUT     uintptr_t*              Original,
+        IN  OUT     size_t*                 Replaced
+    )
+{
+    BWSR_STATUS         retVal          = ERROR_SUCCESS;
+    size_t              offset          = 0;
+    const elf_rel_t*    relocation      = NULL;
+    size_t              type            = 0;
+    size_t              symbolIndex     = 0;
+    uintptr_t           previous        = 0;
+
+    __NOT_NULL( Context, Module, SymbolName, Original, Replaced )
+
+    if( ( NULL == Relocations                ) ||
+        ( NULL == Context->DynamicSymbolTable ) ||
+        ( NULL == Context->DynamicStringTable ) )
+    {
+        return ERROR_SUCCESS;
+    }
+
+    // `r_offset` and `r_info` lead both `REL` and `RELA` entries
+    for( offset = 0;
+         ( ( offset + RelocationSize ) <= RelocationsSize ) && ( ERROR_SUCCESS == retVal );
+         offset += RelocationSize )
+    {
+        relocation  = (const elf_rel_t*) ( Relocations + offset );
+        type        = ELF_R_TYPE( relocation->r_info );
+        symbolIndex = ELF_R_SYM( relocation->r_info );
+
+        if( ( ( ELF_R_JUMP_SLOT != type ) &&
+              ( ELF_R_GLOB_DAT  != type ) ) ||
+            ( 0 == symbolIndex            ) )
+        {
+            continue;
+        }
+
+        if( 0 != strcmp( Context->DynamicStringTable + Context->DynamicSymbolTable[ symbolIndex ].st_name,
+                         SymbolName ) )
+        {
+            continue;
+        }
+
+        if( ERROR_SUCCESS != ( retVal = INTERNAL_ElfContext_WriteImportSlot( Context,
+                                                                             (uintptr_t*) ( Context->LoadBias + relocation->r_offset ),
+                                                                             Replacement,
+                                                                             &previous ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_ElfContext_WriteImportSlot() Failed\n" );
+        }
+        else {
+            // A lazily bound slot still points at the PLT of the module.
+            // The replaced slot is never bound, the symbol is looked up instead.
+            if( ( ELF_R_JUMP_SLOT           == type     ) &&
+                ( (uintptr_t) Module->Base  <= previous ) &&
+                ( (uintptr_t) Module->End   >  previous ) )
+            {
+                previous = INTERNAL_ElfContext_ResolveImport( Context, Module, symbolIndex );
+            } // Lazy binding
+
+            if( 0 == *Original )
+            {
+                *Original = previous;
+            }
+
+            ( *Replaced )++;
+        } // INTERNAL_ElfContext_WriteImportSlot()
+    } // for()
+
+    return retVal;
+}
+
+static
+BWSR_STATUS
+    INTERNAL_ReplaceModuleImports
+    (
+        IN          const runtime_module_t* Module,
+        IN          const char*             SymbolName,
+        IN          const uintptr_t         Replacement,
+        IN  OUT     uintptr_t*              Original,
+        IN  OUT     size_t*                 Replaced
+    )
+{
+    BWSR_STATUS         retVal          = ERROR_FAILURE;
+    elf_ctx_t           context         = { 0 };
+    size_t              pltEntrySize    = 0;
+
+    __NOT_NULL( Module, SymbolName, Original, Replaced )
+
+    INTERNAL_ElfContext_Initialize( &context,
+                                    Module->Base,
+                                    true );
+
+    pltEntrySize = ( DT_REL == context.PltRelocationType )
+                        ? sizeof( elf_rel_t )
+                        : sizeof( elf_rela_t );
+
+    // Calls through the PLT
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_ElfContext_ReplaceImports( &context,
+                                                                        Module,
+                                                                        context.PltRelocations,
+                                                                        context.PltRelocationsSize,
+                                                                        pltEntrySize,
+                                                                        SymbolName,
+                                                                        Replacement,
+                                                                        Original,
+                                                                        Replaced ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_ElfContext_ReplaceImports() Failed\n" );
+    }
+    // Calls and address loads straight from the GOT
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_ElfContext_ReplaceImports( &context,
+                                                                             Module,
+                                                                             context.Rela,
+                                                                             context.RelaSize,
+                                                                             sizeof( elf_rela_t ),
+                                                                             SymbolName,
+                                                                             Replacement,
+                                                                             Original,
+                                                                             Replaced ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_ElfContext_ReplaceImports() Failed\n" );
+    }
+    else if( ERROR_SUCCESS != ( retVal = INTERNAL_ElfContext_ReplaceImports( &context,
+                                                                             Module,
+                                                                             context.Rel,
+                                                                             context.RelSize,
+                                                                             sizeof( elf_rel_t ),
+                                                                             SymbolName,
+                                                                             Replacement,
+                                                                             Original,
+                                                                             Replaced ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_ElfContext_ReplaceImports() Failed\n" );
+    } // INTERNAL_ElfContext_ReplaceImports()
+
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_ResolveSymbol
+    (
+        IN              const char*             SymbolName,
+        IN OPTIONAL     const char*             ImageName,
+        OUT             uintptr_t*              Address
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    module_index_t*         index       = NULL;
+    bwsr_symbol_request_t   request     = { 0 };
+    BWSR_STATUS             status      = ERROR_FAILURE;
+
+    __NOT_NULL( SymbolName, Address )
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_ModuleIndex_Acquire( &index ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_ModuleIndex_Acquire() Failed\n" );
+    }
+    else {
+        request.SymbolName  = SymbolName;
+        request.ImageName   = ImageName;
+
+        if( ERROR_SUCCESS == ( retVal = INTERNAL_ResolveSymbols( index,
+                                                                 &request,
+                                                                 1,
+                                                                 Address,
+                                                                 &status ) ) )
+        {
+            retVal = status;
+        } // INTERNAL_ResolveSymbols()
+
+        INTERNAL_ModuleIndex_Release( index );
+    } // INTERNAL_ModuleIndex_Acquire()
+
+    __DEBUG_RETVAL( retVal )
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_ResolveSymbols
+    (
+        IN          const bwsr_symbol_request_t*    Requests,
+        IN          size_t                          Count,
+        OUT         uintptr_t*                      Addresses,
+        OUT         BWSR_STATUS*                    Statuses
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+    module_index_t*     index       = NULL;
+
+    __NOT_NULL( Requests,
+                Addresses,
+                Statuses )
+    __GREATER_THAN_0( Count )
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_ModuleIndex_Acquire( &index ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_ModuleIndex_Acquire() Failed\n" );
+    }
+    else {
+        retVal = INTERNAL_ResolveSymbols( index,
+                                          Requests,
+                                          Count,
+                                          Addresses,
+                                          Statuses );
+
+        INTERNAL_ModuleIndex_Release( index );
+    } // INTERNAL_ModuleIndex_Acquire()
+
+    __DEBUG_RETVAL( retVal )
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_LookupAddress
+    (
+        IN          uintptr_t               Address,
+        OUT         bwsr_address_info_t*    Info
+    )
+{
+    BWSR_STATUS             retVal      = ERROR_FAILURE;
+    module_index_t*         index       = NULL;
+    runtime_module_t*       module      = NULL;
+    module_symbols_t*       symbols     = NULL;
+    const module_symbol_t*  symbol      = NULL;
+
+    __NOT_NULL( Info )
+
+    memset( Info, 0, sizeof( bwsr_address_info_t ) );
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_ModuleIndex_Acquire( &index ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_ModuleIndex_Acquire() Failed\n" );
+    }
+    else {
+        if( NULL == ( module = INTERNAL_ModuleIndex_FindModule( index, Address ) ) )
+        {
+            retVal = ERROR_NOT_FOUND;
+        }
+        else if( ERROR_SUCCESS != ( retVal = INTERNAL_ModuleSymbols_Get( module, &symbols ) ) )
+        {
+            BWSR_DEBUG( LOG_ERROR, "INTERNAL_ModuleSymbols_Get() Failed\n" );
+        }
+        else {
+            // Copied, the index may be rebuilt once it is released
+            (void) snprintf( Info->ImageName,
+                             sizeof( Info->ImageName ),
+                             "%s",
+                             module->Path );
+
+            Info->ImageBase = (uintptr_t) module->Base;
+            Info->Offset    = Address - (uintptr_t) module->Base;
+
+            if( NULL != ( symbol = INTERNAL_ModuleSymbols_FindSymbol( symbols, Address ) ) )
+            {
+                (void) snprintf( Info->SymbolName,
+                                 sizeof( Info->SymbolName ),
+                                 "%s",
+                                 symbol->Name );
+
+                Info->SymbolAddress = symbol->Address;
+                Info->Offset        = Address - symbol->Address;
+            } // INTERNAL_ModuleSymbols_FindSymbol()
+
+            retVal = ERROR_SUCCESS;
+        } // INTERNAL_ModuleIndex_FindModule()
+
+        INTERNAL_ModuleIndex_Release( index );
+    } // INTERNAL_ModuleIndex_Acquire()
+
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_ImportHook
+    (
+        IN OPTIONAL     const char*             ImageName,
+        IN              const char*             SymbolName,
+        IN              void*                   Replacement,
+        OUT OPTIONAL    void**                  Original
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+    module_index_t*     index       = NULL;
+    size_t              i           = 0;
+    uintptr_t           original    = 0;
+    size_t              replaced    = 0;
+    Dl_info             self        = { 0 };
+
+    __NOT_NULL( SymbolName, Replacement )
+
+    pthread_mutex_lock( &gImportHookLock );
+
+    // BWSR's own calls, `mprotect()` among them, must keep
+    // reaching the real function when every image is hooked
+    if( NULL == ImageName )
+    {
+        (void) dladdr( (void*) BWSR_ImportHook, &self );
+    }
+
+    if( ERROR_SUCCESS != ( retVal = INTERNAL_ModuleIndex_Acquire( &index ) ) )
+    {
+        BWSR_DEBUG( LOG_ERROR, "INTERNAL_ModuleIndex_Acquire() Failed\n" );
+    }
+    else {
+        for( i = 0; ( i < index->Size ) && ( ERROR_SUCCESS == retVal ); i++ )
+        {
+            if( ( INTERNAL_IsMatchingModule( &index->Data[ i ], ImageName ) ) &&
+                ( self.dli_fbase != index->Data[ i ].Base                   ) )
+            {
+                retVal = INTERNAL_ReplaceModuleImports( &index->Data[ i ],
+                                                        SymbolName,
+                                                        (uintptr_t) Replacement,
+                                                        &original,
+                                                        &replaced );
+            } // INTERNAL_IsMatchingModule()
+        } // for()
+
+        if( ( ERROR_SUCCESS == retVal   ) &&
+            ( 0             == replaced ) )
+        {
+            retVal = ERROR_NOT_FOUND;
+        }
+
+        if( ( ERROR_SUCCESS == retVal   ) &&
+            ( NULL          != Original ) )
+        {
+            *Original = (void*) original;
+        }
+
+        INTERNAL_ModuleIndex_Release( index );
+    } // INTERNAL_ModuleIndex_Acquire()
+
+    pthread_mutex_unlock( &gImportHookLock );
+
+    __DEBUG_RETVAL( retVal )
+    return retVal;
+}
+
+BWSR_API
+BWSR_STATUS
+    BWSR_SetSymbolCacheDirectory
+    (
+        IN OPTIONAL     const char*             Directory
+    )
+{
+    BWSR_STATUS         retVal      = ERROR_FAILURE;
+
+    if( ( NULL                              != Directory                        ) &&
+        ( sizeof( gSymbolCacheDirectory )   <= strnlen( Directory, PATH_MAX )   ) )
+    {
+        retVal = ERROR_INVALID_ARGUMENT_VALUE;
+    }
+    else {
+        pthread_rwlock_wrlock( &gSymbolCacheDirectoryLock );
+
+        memset( gSymbolCacheDirectory,
+                0,
+                sizeof( gSymbolCacheDirectory ) );
+
+        if( NULL != Directory )
+        {
+            strncpy( gSymbolCacheDirectory,
+                     Directory,
+                     sizeof( gSymbolCacheDirectory ) - 1 );
+        } // Directory
+
+        pthread_rwlock_unlock( &gSymbolCacheDirectoryLock );
+
+        retVal = ERROR_SUCCESS;
+    } // Directory
+
+    __DEBUG_RETVAL( retVal )
+    return retVal;
+}
+
+BWSR_API
+void
+    BWSR_ReleaseModuleIndex
+    (
+        void
+    )
+{
+    module_index_t*     index       = NULL;
+
+    pthread_rwlock_wrlock( &gModuleIndexLock );
+
+    index           = gModuleIndex;
+    gModuleIndex    = NULL;
+
+    pthread_rwlock_unlock( &gModuleIndexLock );
+
+    // Callers still holding a reference keep the snapshot alive
+    if( NULL != index )
+    {
+        INTERNAL_ModuleIndex_Release( index );
+    } // index
 }
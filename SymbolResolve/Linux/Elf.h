@@ -1,6 +1,28 @@
 #ifndef __ELF_H__
 #define __ELF_H__
 
+typedef struct bwsr_symbol_request_t {
+    // Name of the symbol to resolve
+    const char*             SymbolName;
+    // Optional path of the image to search, `NULL` searches every image
+    const char*             ImageName;
+} bwsr_symbol_request_t;
+
+// Size of the names copied into `bwsr_address_info_t`, longer names are
+// truncated
+#define BWSR_ADDRESS_INFO_NAME_SIZE     1024
+
+typedef struct bwsr_address_info_t {
+    // Path of the image containing the address
+    char                    ImageName[ BWSR_ADDRESS_INFO_NAME_SIZE ];
+    uintptr_t               ImageBase;
+    // Nearest symbol at or below the address, empty when there is none
+    char                    SymbolName[ BWSR_ADDRESS_INFO_NAME_SIZE ];
+    uintptr_t               SymbolAddress;
+    // Distance from `SymbolAddress`, or from `ImageBase` without a symbol
+    uintptr_t               Offset;
+} bwsr_address_info_t;
+
 int
     BWSR_ResolveSymbol
     (
@@ -9,4 +31,41 @@ int
         uintptr_t*              Address
     );
 
-#endif // __MACHO_H__
\ No newline at end of file
+int
+    BWSR_ResolveSymbols
+    (
+        const bwsr_symbol_request_t*    Requests,
+        size_t                          Count,
+        uintptr_t*                      Addresses,
+        int*                            Statuses
+    );
+
+int
+    BWSR_LookupAddress
+    (
+        uintptr_t               Address,
+        bwsr_address_info_t*    Info
+    );
+
+int
+    BWSR_ImportHook
+    (
+        const char*             ImageName,
+        const char*             SymbolName,
+        void*                   Replacement,
+        void**                  Original
+    );
+
+int
+    BWSR_SetSymbolCacheDirectory
+    (
+        const char*             Directory
+    );
+
+void
+    BWSR_ReleaseModuleIndex
+    (
+        void
+    );
+
+#endif // __MACHO_H__
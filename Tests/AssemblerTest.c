@@ -0,0 +1,293 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include "Hook/Assembler.h"
+
+#include "Memory/MemoryTracker.h"
+
+#include "Tests/Test.h"
+#include "Tests/Emulator.h"
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Address the position dependent tests assemble at
+#define TEST_FIXED_ADDRESS      0x7F00001000ULL
+
+// -----------------------------------------------------------------------------
+//  GLOBALS
+// -----------------------------------------------------------------------------
+
+static register_data_t  gX1     = { 1,  64, kRegister_64 };
+static register_data_t  gW2     = { 2,  32, kRegister_32 };
+static register_data_t  gX3     = { 3,  64, kRegister_64 };
+static register_data_t  gX17    = { 17, 64, kRegister_64 };
+
+// -----------------------------------------------------------------------------
+//  TESTS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief `Assembler_MOV()` loads every value with the fewest `MOVZ`, `MOVN`
+ * and `MOVK` instructions.
+ */
+static
+void
+    Test_MOV
+    (
+        void
+    )
+{
+    static const struct {
+        uint64_t        Value;
+        uint32_t        Instructions;
+    } cases[] =
+    {
+        { 0x0000000000001234ULL, 1 },
+        { 0x00000000FFFF0000ULL, 1 },
+        { 0xFFFFFFFFFFFF1234ULL, 1 },
+        { 0xFFFFFFFFFFFFFFFFULL, 1 },
+        { 0x00007FAB12340000ULL, 2 },
+        { 0xFFFFFFFF00001234ULL, 2 },
+        { 0x0000007F12345678ULL, 3 },
+        { 0x12345678ABCDEF01ULL, 4 },
+    };
+
+    assembler_arena_t   arena;
+    assembler_t         assembler   = { 0 };
+    emulator_t          cpu         = { 0 };
+    size_t              i           = 0;
+
+    for( i = 0; i < ARRAY_LENGTH( cases ); i++ )
+    {
+        (void) Assembler_InitializeWithArena( &assembler, 0, &arena );
+
+        TEST_CHECK( ERROR_SUCCESS == Assembler_MOV( &assembler.Buffer, &gX1, cases[ i ].Value ) );
+        TEST_CHECK( ( cases[ i ].Instructions * 4 ) == assembler.Buffer.BufferSize );
+
+        memset( &cpu, 0xA5, sizeof( cpu ) );
+        cpu.PC = TEST_FIXED_ADDRESS;
+
+        TEST_CHECK( ( TEST_FIXED_ADDRESS + assembler.Buffer.BufferSize ) ==
+                    Emulator_Run( &cpu,
+                                  assembler.Buffer.Buffer,
+                                  TEST_FIXED_ADDRESS,
+                                  assembler.Buffer.BufferSize ) );
+        TEST_CHECK( cases[ i ].Value == cpu.X[ 1 ] );
+
+        (void) Assembler_Release( &assembler );
+    } // for()
+
+    // 32-bit registers only count their low halfwords
+    (void) Assembler_InitializeWithArena( &assembler, 0, &arena );
+
+    TEST_CHECK( ERROR_SUCCESS == Assembler_MOV( &assembler.Buffer, &gW2, 0xFFFF1234 ) );
+    TEST_CHECK( 4 == assembler.Buffer.BufferSize );
+
+    memset( &cpu, 0xA5, sizeof( cpu ) );
+    cpu.PC = TEST_FIXED_ADDRESS;
+
+    (void) Emulator_Run( &cpu,
+                         assembler.Buffer.Buffer,
+                         TEST_FIXED_ADDRESS,
+                         assembler.Buffer.BufferSize );
+    TEST_CHECK( 0xFFFF1234 == cpu.X[ 2 ] );
+
+    (void) Assembler_Release( &assembler );
+}
+
+/**
+ * \brief `Assembler_LoadAddress()` picks `ADR`, `ADRP` or `MOV` and always
+ * loads the address, wherever it is from the code.
+ */
+static
+void
+    Test_LoadAddress
+    (
+        void
+    )
+{
+    static const struct {
+        int64_t         Delta;
+        uint32_t        MaxInstructions;
+    } cases[] =
+    {
+        // `ADR`
+        {  0x800,           1 },
+        { -0x80000,         1 },
+        // `ADRP` alone, then with `ADD`
+        {  0x12345000,      1 },
+        {  0x12345678,      2 },
+        { -0x40000000,      1 },
+        // Out of `ADRP` range
+        {  0x200000000LL,   4 },
+        {  0x123456789ALL,  4 },
+    };
+
+    assembler_arena_t   arena;
+    assembler_t         assembler   = { 0 };
+    emulator_t          cpu         = { 0 };
+    uint64_t            target      = 0;
+    size_t              i           = 0;
+
+    for( i = 0; i < ARRAY_LENGTH( cases ); i++ )
+    {
+        target = TEST_FIXED_ADDRESS + (uint64_t) cases[ i ].Delta;
+
+        (void) Assembler_InitializeWithArena( &assembler, TEST_FIXED_ADDRESS, &arena );
+
+        TEST_CHECK( ERROR_SUCCESS == Assembler_LoadAddress( &assembler, &gX3, target ) );
+        TEST_CHECK( ( cases[ i ].MaxInstructions * 4 ) >= assembler.Buffer.BufferSize );
+
+        memset( &cpu, 0xA5, sizeof( cpu ) );
+        cpu.PC = TEST_FIXED_ADDRESS;
+
+        TEST_CHECK( ( TEST_FIXED_ADDRESS + assembler.Buffer.BufferSize ) ==
+                    Emulator_Run( &cpu,
+                                  assembler.Buffer.Buffer,
+                                  TEST_FIXED_ADDRESS,
+                                  assembler.Buffer.BufferSize ) );
+        TEST_CHECK( target == cpu.X[ 3 ] );
+
+        (void) Assembler_Release( &assembler );
+    } // for()
+
+    // Without a final address the code must be position independent
+    (void) Assembler_InitializeWithArena( &assembler, 0, &arena );
+
+    TEST_CHECK( ERROR_SUCCESS == Assembler_LoadAddress( &assembler, &gX3, TEST_FIXED_ADDRESS + 0x800 ) );
+
+    memset( &cpu, 0xA5, sizeof( cpu ) );
+    cpu.PC = 0x1000;
+
+    (void) Emulator_Run( &cpu,
+                         assembler.Buffer.Buffer,
+                         0x1000,
+                         assembler.Buffer.BufferSize );
+    TEST_CHECK( ( TEST_FIXED_ADDRESS + 0x800 ) == cpu.X[ 3 ] );
+
+    (void) Assembler_Release( &assembler );
+}
+
+/**
+ * \brief Literals holding the same value are shared up to
+ * `RELOCATION_MAX_REFERENCES` loads, and every load reads its value.
+ */
+static
+void
+    Test_RelocationData
+    (
+        void
+    )
+{
+    assembler_arena_t   arena;
+    assembler_t         assembler   = { 0 };
+    emulator_t          cpu         = { 0 };
+    relocation_data_t*  first       = NULL;
+    relocation_data_t*  second      = NULL;
+    relocation_data_t*  shared      = NULL;
+    relocation_data_t*  literal     = NULL;
+    uint32_t            codeSize    = 0;
+    size_t              i           = 0;
+
+    (void) Assembler_InitializeWithArena( &assembler, 0, &arena );
+
+    TEST_CHECK( ERROR_SUCCESS == Assembler_CreateRelocationData( &first,  &assembler, 0x1111 ) );
+    TEST_CHECK( ERROR_SUCCESS == Assembler_CreateRelocationData( &second, &assembler, 0x2222 ) );
+    TEST_CHECK( ERROR_SUCCESS == Assembler_CreateRelocationData( &shared, &assembler, 0x1111 ) );
+    TEST_CHECK( first == shared );
+    TEST_CHECK( first != second );
+    TEST_CHECK( 2 == assembler.RelocationDataSize );
+
+    // One past the references a literal holds starts another
+    for( i = 0; i <= RELOCATION_MAX_REFERENCES; i++ )
+    {
+        TEST_CHECK( ERROR_SUCCESS == Assembler_CreateRelocationData( &literal, &assembler, 0x3333 ) );
+        TEST_CHECK( ERROR_SUCCESS == Assembler_WriteInstruction_LDR( &assembler.Buffer, &gX17, literal ) );
+    } // for()
+
+    TEST_CHECK( 4 == assembler.RelocationDataSize );
+
+    TEST_CHECK( ERROR_SUCCESS == Assembler_WriteInstruction_LDR( &assembler.Buffer, &gX1, second ) );
+
+    codeSize = assembler.Buffer.BufferSize;
+
+    TEST_CHECK( ERROR_SUCCESS == Assembler_WriteRelocationDataToPageBuffer( &assembler ) );
+
+    memset( &cpu, 0xA5, sizeof( cpu ) );
+    cpu.PC = (uintptr_t) assembler.Buffer.Buffer;
+
+    TEST_CHECK( ( (uintptr_t) assembler.Buffer.Buffer + codeSize ) ==
+                Emulator_Run( &cpu,
+                              assembler.Buffer.Buffer,
+                              (uintptr_t) assembler.Buffer.Buffer,
+                              codeSize ) );
+    TEST_CHECK( 0x3333 == cpu.X[ 17 ] );
+    TEST_CHECK( 0x2222 == cpu.X[ 1 ] );
+
+    (void) Assembler_Release( &assembler );
+}
+
+/**
+ * \brief Code outgrowing the arena moves on to the heap and keeps what was
+ * already written.
+ */
+static
+void
+    Test_ArenaOverflow
+    (
+        void
+    )
+{
+    assembler_arena_t   arena;
+    assembler_t         assembler   = { 0 };
+    relocation_data_t*  literal     = NULL;
+    uint32_t            i           = 0;
+
+    (void) Assembler_InitializeWithArena( &assembler, 0, &arena );
+
+    for( i = 0; i < ( ASSEMBLER_ARENA_BUFFER_SIZE / 4 ) + 16; i++ )
+    {
+        TEST_CHECK( ERROR_SUCCESS == Assembler_Write32BitInstruction( &assembler.Buffer, i ) );
+    } // for()
+
+    TEST_CHECK( false == assembler.Buffer.Borrowed );
+
+    for( i = 0; i < ( ( ASSEMBLER_ARENA_BUFFER_SIZE / 4 ) + 16 ); i++ )
+    {
+        TEST_CHECK( i == ( (uint32_t*) assembler.Buffer.Buffer )[ i ] );
+    } // for()
+
+    for( i = 0; i < ( ASSEMBLER_ARENA_RELOCATION_COUNT * 2 ); i++ )
+    {
+        TEST_CHECK( ERROR_SUCCESS == Assembler_CreateRelocationData( &literal, &assembler, 0x1000 + i ) );
+    } // for()
+
+    TEST_CHECK( ( ASSEMBLER_ARENA_RELOCATION_COUNT * 2 ) == assembler.RelocationDataSize );
+
+    (void) Assembler_Release( &assembler );
+}
+
+// -----------------------------------------------------------------------------
+//  MAIN
+// -----------------------------------------------------------------------------
+
+int
+    main
+    (
+        void
+    )
+{
+    Test_MOV();
+    Test_LoadAddress();
+    Test_RelocationData();
+    Test_ArenaOverflow();
+
+#if defined( DEBUG_MODE )
+    TEST_CHECK( 0 == MemoryTracker_CheckForMemoryLeaks() );
+#endif
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,121 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+// The classifier is internal to the hook
+#include "Hook/InlineHook.c"
+
+#include "Tests/Test.h"
+
+// -----------------------------------------------------------------------------
+//  REFERENCE
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief The chain of mask comparisons `gInstructionClasses` replaced,
+ * in its original order.
+ * \return `InstructionClass` of `Instruction`.
+ */
+static
+InstructionClass
+    Test_ClassifyWithMasks
+    (
+        uint32_t        Instruction
+    )
+{
+    InstructionClass instructionClass = kInstructionCopy;
+
+    /**/ if( UnconditionalBranchFixed == ( Instruction & UnconditionalBranchFixedMask ) )
+    {
+        instructionClass = kInstructionUnconditionalBranch;
+    }
+    else if( LiteralLoadRegisterFixed == ( Instruction & LiteralLoadRegisterFixedMask ) )
+    {
+        instructionClass = kInstructionLiteralLoad;
+    }
+    else if( ( PCRelAddressingFixed == ( Instruction & PCRelAddressingFixedMask ) ) &&
+             ( ADR                  == ( Instruction & PCRelAddressingMask      ) ) )
+    {
+        instructionClass = kInstructionADR;
+    }
+    else if( ( PCRelAddressingFixed == ( Instruction & PCRelAddressingFixedMask ) ) &&
+             ( ADRP                 == ( Instruction & PCRelAddressingMask      ) ) )
+    {
+        instructionClass = kInstructionADRP;
+    }
+    else if( ConditionalBranchFixed == ( Instruction & ConditionalBranchFixedMask ) )
+    {
+        instructionClass = kInstructionConditionalBranch;
+    }
+    else if( CompareBranchFixed == ( Instruction & CompareBranchFixedMask ) )
+    {
+        instructionClass = kInstructionCompareBranch;
+    }
+    else if( TestBranchFixed == ( Instruction & TestBranchFixedMask ) )
+    {
+        instructionClass = kInstructionTestBranch;
+    } // Instruction
+
+    // Both are unallocated and copied by the table. The chain took `0x55`
+    // for `B.cond`, its mask ignores bit 24, and `0xDC` for `LDR` (literal),
+    // its mask ignores `opc` and `V`.
+    if( ( 0x55 == ( Instruction >> 24 ) ) ||
+        ( 0xDC == ( Instruction >> 24 ) ) )
+    {
+        instructionClass = kInstructionCopy;
+    }
+
+    return instructionClass;
+}
+
+// -----------------------------------------------------------------------------
+//  MAIN
+// -----------------------------------------------------------------------------
+
+int
+    main
+    (
+        void
+    )
+{
+    uint64_t            counts[ kInstructionADRP + 1 ]  = { 0 };
+    uint64_t            mismatches                      = 0;
+    uint64_t            encoding                        = 0;
+    uint32_t            instruction                     = 0;
+    InstructionClass    expected                        = kInstructionCopy;
+    InstructionClass    actual                          = kInstructionCopy;
+    int                 i                               = 0;
+
+    // Every one of the 2^32 encodings
+    for( encoding = 0; encoding <= UINT32_MAX; encoding++ )
+    {
+        instruction = (uint32_t) encoding;
+        expected    = Test_ClassifyWithMasks( instruction );
+        actual      = (InstructionClass) gInstructionClasses[ instruction >> 24 ];
+
+        if( expected != actual )
+        {
+            if( 0 == mismatches++ )
+            {
+                fprintf( stderr,
+                         "0x%08X: table %d, masks %d\n",
+                         instruction,
+                         actual,
+                         expected );
+            }
+        }
+
+        counts[ actual ]++;
+    } // for()
+
+    TEST_CHECK( 0 == mismatches );
+
+    for( i = 0; i <= kInstructionADRP; i++ )
+    {
+        printf( "Class %d: %llu encodings\n",
+                i,
+                (unsigned long long) counts[ i ] );
+    } // for()
+
+    return TEST_RESULT();
+}
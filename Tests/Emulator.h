@@ -0,0 +1,470 @@
+#ifndef __EMULATOR_H__
+#define __EMULATOR_H__
+
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Instructions run before the emulator gives up on a loop
+#define EMULATOR_MAX_STEPS      256
+
+// Flags in `emulator_t.NZCV`
+#define EMULATOR_N              ( 1U << 31 )
+#define EMULATOR_Z              ( 1U << 30 )
+#define EMULATOR_C              ( 1U << 29 )
+#define EMULATOR_V              ( 1U << 28 )
+
+// -----------------------------------------------------------------------------
+//  STRUCTURES
+// -----------------------------------------------------------------------------
+
+// Just enough of an A64 core to run what the assembler and the relocator
+// emit on a host of any architecture. Loads and stores use host memory
+// directly, system registers read as `0`.
+typedef struct emulator_t {
+    // x0 - x30. `X[ 31 ]` is `SP` for `ADD`/`SUB` (immediate) and as a
+    // base, and is never read as `XZR`.
+    uint64_t        X[ 32 ];
+    // v0 - v31, low 64 bits first
+    uint64_t        V[ 32 ][ 2 ];
+    // Condition flags, in the bits of `PSTATE`
+    uint32_t        NZCV;
+    uint64_t        PC;
+} emulator_t;
+
+// -----------------------------------------------------------------------------
+//  DECODING
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Sign extends the low `Bits` bits of `Value`.
+ * \return `int64_t` the extended value.
+ */
+static inline
+int64_t
+    Emulator_SignExtend
+    (
+        uint64_t        Value,
+        int             Bits
+    )
+{
+    uint64_t sign = ( 1ULL << ( Bits - 1 ) );
+
+    Value &= ( ( 1ULL << Bits ) - 1 );
+
+    return (int64_t)( ( Value ^ sign ) - sign );
+}
+
+/**
+ * \brief Evaluates the `cond` field of `B.cond` against `NZCV`.
+ * \return `bool` true if the branch is taken.
+ */
+static inline
+bool
+    Emulator_ConditionHolds
+    (
+        uint32_t        Condition,
+        uint32_t        NZCV
+    )
+{
+    bool    n       = ( 0 != ( NZCV & EMULATOR_N ) );
+    bool    z       = ( 0 != ( NZCV & EMULATOR_Z ) );
+    bool    c       = ( 0 != ( NZCV & EMULATOR_C ) );
+    bool    v       = ( 0 != ( NZCV & EMULATOR_V ) );
+    bool    holds   = true;
+
+    switch( Condition >> 1 )
+    {
+        case 0: holds = z;                  break;
+        case 1: holds = c;                  break;
+        case 2: holds = n;                  break;
+        case 3: holds = v;                  break;
+        case 4: holds = ( c && !z );        break;
+        case 5: holds = ( n == v );         break;
+        case 6: holds = ( ( n == v ) && !z ); break;
+        default: holds = true;              break;
+    } // switch()
+
+    // `NV` always branches, like `AL`
+    if( ( 1 == ( Condition & 1 ) ) &&
+        ( 0xF != Condition ) )
+    {
+        holds = !holds;
+    }
+
+    return holds;
+}
+
+/**
+ * \brief Applies the `shift` field of a shifted register operand.
+ * \return `uint64_t` the shifted value.
+ */
+static inline
+uint64_t
+    Emulator_Shift
+    (
+        uint64_t        Value,
+        uint32_t        Type,
+        uint32_t        Amount
+    )
+{
+    uint64_t    shifted = Value;
+
+    if( 0 != Amount )
+    {
+        switch( Type )
+        {
+            case 0: shifted = ( Value << Amount );                                      break;
+            case 1: shifted = ( Value >> Amount );                                      break;
+            case 2: shifted = (uint64_t)( (int64_t) Value >> Amount );                  break;
+            default: shifted = ( Value >> Amount ) | ( Value << ( 64 - Amount ) );      break;
+        } // switch()
+    }
+
+    return shifted;
+}
+
+// -----------------------------------------------------------------------------
+//  EXECUTION
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Runs one instruction at `Cpu->PC`, fetched from `Code`.
+ * \param[in,out]       Cpu                 Register state
+ * \param[in]           Instruction         Instruction at `Cpu->PC`
+ * \return `bool` false if the instruction is not emulated.
+ */
+static inline
+bool
+    Emulator_Step
+    (
+        emulator_t*     Cpu,
+        uint32_t        Instruction
+    )
+{
+    uint64_t    pc      = Cpu->PC;
+    uint64_t    next    = pc + 4;
+    uint32_t    rd      = ( Instruction & 0x1F );
+    uint32_t    rn      = ( ( Instruction >> 5 ) & 0x1F );
+    uint64_t    address = 0;
+    uint64_t    value   = 0;
+    uint32_t    word    = 0;
+    bool        known   = true;
+
+    uint32_t    rm      = ( ( Instruction >> 16 ) & 0x1F );
+    uint32_t    rt2     = ( ( Instruction >> 10 ) & 0x1F );
+
+    if( ( 0xD503201F == Instruction ) ||
+        ( 0xD5033FDF == Instruction ) )
+    {
+        // `NOP` and `ISB`
+    }
+    else if( 0xD5300000 == ( Instruction & 0xFFF00000 ) )
+    {
+        // `MRS`
+        Cpu->X[ rd ] = 0;
+    }
+    else if( 0x12800000 == ( Instruction & 0x1F800000 ) )
+    {
+        // `MOVN`, `MOVZ` and `MOVK`
+        uint32_t shift = ( ( Instruction >> 21 ) & 3 ) * 16;
+
+        value = ( (uint64_t)( ( Instruction >> 5 ) & 0xFFFF ) << shift );
+
+        switch( ( Instruction >> 29 ) & 3 )
+        {
+            case 0: value = ~value;                                             break;
+            case 2:                                                             break;
+            case 3: value |= ( Cpu->X[ rd ] & ~( 0xFFFFULL << shift ) );        break;
+            default: known = false;                                             break;
+        } // switch()
+
+        Cpu->X[ rd ] = ( 0 != ( Instruction >> 31 ) ) ? value : (uint32_t) value;
+    }
+    else if( 0x10000000 == ( Instruction & 0x1F000000 ) )
+    {
+        // `ADR` and `ADRP`
+        value = (uint64_t) Emulator_SignExtend( ( ( ( Instruction >> 5 ) & 0x7FFFF ) << 2 ) |
+                                                ( ( Instruction >> 29 ) & 3 ),
+                                                21 );
+
+        Cpu->X[ rd ] = ( 0 != ( Instruction >> 31 ) )
+                        ? ( ( pc & ~0xFFFULL ) + ( value << 12 ) )
+                        : ( pc + value );
+    }
+    else if( 0x11000000 == ( Instruction & 0x3F000000 ) )
+    {
+        // `ADD` and `SUB` (immediate), without flags
+        value = ( ( Instruction >> 10 ) & 0xFFF );
+        value <<= ( 0 != ( Instruction & ( 1 << 22 ) ) ) ? 12 : 0;
+        value = ( 0 != ( Instruction & ( 1 << 30 ) ) )
+                    ? ( Cpu->X[ rn ] - value )
+                    : ( Cpu->X[ rn ] + value );
+
+        Cpu->X[ rd ] = ( 0 != ( Instruction >> 31 ) ) ? value : (uint32_t) value;
+    }
+    else if( ( 0x8B000000 == ( Instruction & 0xFF200000 ) ) ||
+             ( 0xCA000000 == ( Instruction & 0xFF200000 ) ) )
+    {
+        // 64 bit `ADD` and `EOR` (shifted register)
+        value = Emulator_Shift( Cpu->X[ rm ],
+                                ( Instruction >> 22 ) & 3,
+                                ( Instruction >> 10 ) & 0x3F );
+
+        Cpu->X[ rd ] = ( 0x8B000000 == ( Instruction & 0xFF000000 ) )
+                        ? ( Cpu->X[ rn ] + value )
+                        : ( Cpu->X[ rn ] ^ value );
+    }
+    else if( 0xD3400000 == ( Instruction & 0xFFC00000 ) )
+    {
+        // 64 bit `UBFM`, `immr` and `imms`
+        uint32_t immr = ( ( Instruction >> 16 ) & 0x3F );
+        uint32_t imms = ( ( Instruction >> 10 ) & 0x3F );
+
+        value = ( 63 == imms ) ? ~0ULL : ( ( 1ULL << ( imms + 1 ) ) - 1 );
+
+        Cpu->X[ rd ] = ( imms >= immr )
+                        ? ( ( Cpu->X[ rn ] >> immr ) & ( value >> immr ) )
+                        : ( ( Cpu->X[ rn ] & value ) << ( 64 - immr ) );
+    }
+    else if( ( 0xA9000000 == ( Instruction & 0xFFC00000 ) ) ||
+             ( 0xA9400000 == ( Instruction & 0xFFC00000 ) ) )
+    {
+        // 64 bit `STP` and `LDP` (signed offset)
+        address = Cpu->X[ rn ] + (uint64_t)( Emulator_SignExtend( ( Instruction >> 15 ) & 0x7F, 7 ) * 8 );
+
+        if( 0 != ( Instruction & ( 1 << 22 ) ) )
+        {
+            memcpy( &Cpu->X[ rd ],  (void*) address,         8 );
+            memcpy( &Cpu->X[ rt2 ], (void*)( address + 8 ),  8 );
+        }
+        else {
+            memcpy( (void*) address,        &Cpu->X[ rd ],  8 );
+            memcpy( (void*)( address + 8 ), &Cpu->X[ rt2 ], 8 );
+        } // Load
+    }
+    else if( 0xC85F7C00 == ( Instruction & 0xFFFFFC00 ) )
+    {
+        // 64 bit `LDXR`
+        memcpy( &Cpu->X[ rd ], (void*) Cpu->X[ rn ], 8 );
+    }
+    else if( 0xC8007C00 == ( Instruction & 0xFFE0FC00 ) )
+    {
+        // 64 bit `STXR`, which always succeeds
+        memcpy( (void*) Cpu->X[ rn ], &Cpu->X[ rd ], 8 );
+
+        Cpu->X[ rm ] = 0;
+    }
+    else if( 0x18000000 == ( Instruction & 0x3B000000 ) )
+    {
+        // `LDR` (literal), `LDRSW` and `PRFM`. `opc:V` selects the load.
+        address = pc + (uint64_t) Emulator_SignExtend( ( ( Instruction >> 5 ) & 0x7FFFF ) << 2, 21 );
+
+        switch( ( ( Instruction >> 29 ) & 6 ) | ( ( Instruction >> 26 ) & 1 ) )
+        {
+            case 0: memcpy( &word, (void*) address, 4 ); Cpu->X[ rd ] = word;           break;
+            case 2: memcpy( &Cpu->X[ rd ], (void*) address, 8 );                        break;
+            case 4: memcpy( &word, (void*) address, 4 ); Cpu->X[ rd ] = (uint64_t)(int64_t)(int32_t) word; break;
+            case 6:                                                                     break;
+            case 1: memset( Cpu->V[ rd ], 0, 16 ); memcpy( Cpu->V[ rd ], (void*) address, 4 );  break;
+            case 3: memset( Cpu->V[ rd ], 0, 16 ); memcpy( Cpu->V[ rd ], (void*) address, 8 );  break;
+            case 5: memcpy( Cpu->V[ rd ], (void*) address, 16 );                        break;
+            default: known = false;                                                     break;
+        } // switch()
+    }
+    else if( 0x39000000 == ( Instruction & 0x3B000000 ) )
+    {
+        // Loads (unsigned offset). The offset is scaled by the access size,
+        // `size` is `00` for `Q`.
+        uint32_t size   = ( Instruction >> 30 );
+        uint32_t simd   = ( ( Instruction >> 26 ) & 1 );
+        uint32_t opc    = ( ( Instruction >> 22 ) & 3 );
+        uint32_t scale  = ( ( 1 == simd ) && ( 3 == opc ) ) ? 4 : size;
+
+        address = Cpu->X[ rn ] + ( (uint64_t)( ( Instruction >> 10 ) & 0xFFF ) << scale );
+
+        /**/ if( ( 0 == simd ) && ( 1 == opc ) && ( 3 == size ) )
+        {
+            memcpy( &Cpu->X[ rd ], (void*) address, 8 );
+        }
+        else if( ( 0 == simd ) && ( 1 == opc ) && ( 0 == size ) )
+        {
+            Cpu->X[ rd ] = *(const uint8_t*) address;
+        }
+        else if( ( 0 == simd ) && ( 1 == opc ) && ( 2 == size ) )
+        {
+            memcpy( &word, (void*) address, 4 );
+            Cpu->X[ rd ] = word;
+        }
+        else if( ( 0 == simd ) && ( 2 == opc ) && ( 2 == size ) )
+        {
+            memcpy( &word, (void*) address, 4 );
+            Cpu->X[ rd ] = (uint64_t)(int64_t)(int32_t) word;
+        }
+        else if( ( 0 == simd ) && ( 2 == opc ) && ( 3 == size ) )
+        {
+            // `PRFM`
+        }
+        else if( ( 1 == simd ) && ( 1 == opc ) && ( 2 <= size ) )
+        {
+            memset( Cpu->V[ rd ], 0, 16 );
+            memcpy( Cpu->V[ rd ], (void*) address, ( 2 == size ) ? 4 : 8 );
+        }
+        else if( ( 1 == simd ) && ( 3 == opc ) && ( 0 == size ) )
+        {
+            memcpy( Cpu->V[ rd ], (void*) address, 16 );
+        }
+        else {
+            known = false;
+        } // size, opc and V
+    }
+    else if( 0xD61F0000 == ( Instruction & 0xFFFFFC1F ) )
+    {
+        // `BR`
+        next = Cpu->X[ rn ];
+    }
+    else if( 0xD63F0000 == ( Instruction & 0xFFFFFC1F ) )
+    {
+        // `BLR`
+        next = Cpu->X[ rn ];
+        Cpu->X[ 30 ] = pc + 4;
+    }
+    else if( 0x14000000 == ( Instruction & 0x7C000000 ) )
+    {
+        // `B` and `BL`
+        if( 0 != ( Instruction >> 31 ) )
+        {
+            Cpu->X[ 30 ] = pc + 4;
+        }
+
+        next = pc + (uint64_t) Emulator_SignExtend( ( Instruction & 0x3FFFFFF ) << 2, 28 );
+    }
+    else if( 0x54000000 == ( Instruction & 0xFF000000 ) )
+    {
+        // `B.cond` and `BC.cond`
+        if( Emulator_ConditionHolds( Instruction & 0xF, Cpu->NZCV ) )
+        {
+            next = pc + (uint64_t) Emulator_SignExtend( ( ( Instruction >> 5 ) & 0x7FFFF ) << 2, 21 );
+        }
+    }
+    else if( 0x34000000 == ( Instruction & 0x7E000000 ) )
+    {
+        // `CBZ` and `CBNZ`
+        value = ( 0 != ( Instruction >> 31 ) ) ? Cpu->X[ rd ] : (uint32_t) Cpu->X[ rd ];
+
+        if( ( 0 == value ) != ( 0 != ( Instruction & ( 1 << 24 ) ) ) )
+        {
+            next = pc + (uint64_t) Emulator_SignExtend( ( ( Instruction >> 5 ) & 0x7FFFF ) << 2, 21 );
+        }
+    }
+    else if( 0x36000000 == ( Instruction & 0x7E000000 ) )
+    {
+        // `TBZ` and `TBNZ`, `b5:b40` is the bit tested
+        value = ( Cpu->X[ rd ] >> ( ( ( Instruction >> 26 ) & 0x20 ) | ( ( Instruction >> 19 ) & 0x1F ) ) ) & 1;
+
+        if( value == ( ( Instruction >> 24 ) & 1 ) )
+        {
+            next = pc + (uint64_t) Emulator_SignExtend( ( ( Instruction >> 5 ) & 0x3FFF ) << 2, 16 );
+        }
+    }
+    else {
+        known = false;
+    } // Instruction
+
+    if( false == known )
+    {
+        fprintf( stderr,
+                 "Emulator: unknown instruction 0x%08X at 0x%llX\n",
+                 Instruction,
+                 (unsigned long long) pc );
+    }
+
+    Cpu->PC = next;
+
+    return known;
+}
+
+/**
+ * \brief Runs code from `Cpu->PC` until it branches out of
+ * `[ Address, Address + Size )`.
+ * \param[in,out]       Cpu                 Register state
+ * \param[in]           Code                Where the code is stored
+ * \param[in]           Address             Where the code runs
+ * \param[in]           Size                Size of the code
+ * \return `uint64_t` the address the code left to, or `0` on an
+ * instruction that is not emulated or a loop.
+ */
+static inline
+uint64_t
+    Emulator_Run
+    (
+        emulator_t*     Cpu,
+        const void*     Code,
+        uint64_t        Address,
+        size_t          Size
+    )
+{
+    uint32_t    instruction     = 0;
+    size_t      steps           = 0;
+
+    while( ( Address <= Cpu->PC ) &&
+           ( ( Address + Size ) > Cpu->PC ) )
+    {
+        memcpy( &instruction,
+                (const uint8_t*) Code + ( Cpu->PC - Address ),
+                sizeof( instruction ) );
+
+        if( ( EMULATOR_MAX_STEPS <= steps++ ) ||
+            ( false == Emulator_Step( Cpu, instruction ) ) )
+        {
+            return 0;
+        }
+    } // while()
+
+    return Cpu->PC;
+}
+
+/**
+ * \brief Runs code in place from `Cpu->PC` until it reaches `Stop`,
+ * following branches anywhere in between.
+ * \param[in,out]       Cpu                 Register state
+ * \param[in]           Stop                Address the run ends at
+ * \return `bool` false on an instruction that is not emulated or a loop.
+ */
+static inline
+bool
+    Emulator_RunUntil
+    (
+        emulator_t*     Cpu,
+        uint64_t        Stop
+    )
+{
+    uint32_t    instruction     = 0;
+    size_t      steps           = 0;
+
+    while( Stop != Cpu->PC )
+    {
+        memcpy( &instruction,
+                (const void*) Cpu->PC,
+                sizeof( instruction ) );
+
+        if( ( EMULATOR_MAX_STEPS <= steps++ ) ||
+            ( false == Emulator_Step( Cpu, instruction ) ) )
+        {
+            return false;
+        }
+    } // while()
+
+    return true;
+}
+
+#endif // __EMULATOR_H__
@@ -0,0 +1,38 @@
+// Shared library the symbol benchmark resolves from. It exports
+// 4096 functions, `Fixture_000` to `Fixture_FFF`.
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+#define FIXTURE_FUNCTION( N )                               \
+    int Fixture_##N( void ) { return __COUNTER__; }
+
+#define FIXTURE_16( P )                                     \
+    FIXTURE_FUNCTION( P##0 ) FIXTURE_FUNCTION( P##1 )       \
+    FIXTURE_FUNCTION( P##2 ) FIXTURE_FUNCTION( P##3 )       \
+    FIXTURE_FUNCTION( P##4 ) FIXTURE_FUNCTION( P##5 )       \
+    FIXTURE_FUNCTION( P##6 ) FIXTURE_FUNCTION( P##7 )       \
+    FIXTURE_FUNCTION( P##8 ) FIXTURE_FUNCTION( P##9 )       \
+    FIXTURE_FUNCTION( P##A ) FIXTURE_FUNCTION( P##B )       \
+    FIXTURE_FUNCTION( P##C ) FIXTURE_FUNCTION( P##D )       \
+    FIXTURE_FUNCTION( P##E ) FIXTURE_FUNCTION( P##F )
+
+#define FIXTURE_256( P )                                    \
+    FIXTURE_16( P##0 ) FIXTURE_16( P##1 )                   \
+    FIXTURE_16( P##2 ) FIXTURE_16( P##3 )                   \
+    FIXTURE_16( P##4 ) FIXTURE_16( P##5 )                   \
+    FIXTURE_16( P##6 ) FIXTURE_16( P##7 )                   \
+    FIXTURE_16( P##8 ) FIXTURE_16( P##9 )                   \
+    FIXTURE_16( P##A ) FIXTURE_16( P##B )                   \
+    FIXTURE_16( P##C ) FIXTURE_16( P##D )                   \
+    FIXTURE_16( P##E ) FIXTURE_16( P##F )
+
+// -----------------------------------------------------------------------------
+//  EXPORTED FUNCTIONS
+// -----------------------------------------------------------------------------
+
+FIXTURE_256( 0 ) FIXTURE_256( 1 ) FIXTURE_256( 2 ) FIXTURE_256( 3 )
+FIXTURE_256( 4 ) FIXTURE_256( 5 ) FIXTURE_256( 6 ) FIXTURE_256( 7 )
+FIXTURE_256( 8 ) FIXTURE_256( 9 ) FIXTURE_256( A ) FIXTURE_256( B )
+FIXTURE_256( C ) FIXTURE_256( D ) FIXTURE_256( E ) FIXTURE_256( F )
@@ -0,0 +1,156 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include "utility/error.h"
+
+#include "Hook/InlineHook.h"
+
+#include "Tests/Test.h"
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Functions in the fake text, each padded to `HOOK_BENCH_STRIDE` bytes
+#define HOOK_BENCH_FUNCTIONS    4096
+#define HOOK_BENCH_STRIDE       32
+
+// Rounds measured, the best one is reported
+#define HOOK_BENCH_ROUNDS       5
+
+#define ARM64_NOP               0xD503201F
+
+// -----------------------------------------------------------------------------
+//  BENCHMARK
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Hooks then unhooks every function of the fake text, one call each
+ * or in a single transaction.
+ * \return `bool` false if a hook could not be installed or removed.
+ */
+static
+bool
+    Bench_Round
+    (
+        uint8_t*        Text,
+        void*           HookFunction,
+        bool            Transaction,
+        double*         HookSeconds,
+        double*         UnhookSeconds
+    )
+{
+    double  start       = 0;
+    bool    success     = true;
+    size_t  i           = 0;
+
+    start = Test_Seconds();
+
+    if( Transaction )
+    {
+        success = ( ERROR_SUCCESS == BWSR_BeginHookTransaction() );
+    }
+
+    for( i = 0; ( i < HOOK_BENCH_FUNCTIONS ) && success; i++ )
+    {
+        success = ( ERROR_SUCCESS == BWSR_InlineHook( Text + ( i * HOOK_BENCH_STRIDE ),
+                                                      HookFunction,
+                                                      NULL,
+                                                      NULL,
+                                                      NULL ) );
+    } // for()
+
+    if( Transaction && success )
+    {
+        success = ( ERROR_SUCCESS == BWSR_CommitHookTransaction() );
+    }
+
+    *HookSeconds    = Test_Seconds() - start;
+    start           = Test_Seconds();
+
+    for( i = 0; ( i < HOOK_BENCH_FUNCTIONS ) && success; i++ )
+    {
+        success = ( ERROR_SUCCESS == BWSR_DestroyHook( Text + ( i * HOOK_BENCH_STRIDE ) ) );
+    } // for()
+
+    *UnhookSeconds  = Test_Seconds() - start;
+
+    return success;
+}
+
+// -----------------------------------------------------------------------------
+//  MAIN
+// -----------------------------------------------------------------------------
+
+int
+    main
+    (
+        void
+    )
+{
+    uint8_t*    text        = NULL;
+    double      hook        = 0;
+    double      unhook      = 0;
+    double      bestHook    = 0;
+    double      bestUnhook  = 0;
+    size_t      size        = HOOK_BENCH_FUNCTIONS * HOOK_BENCH_STRIDE;
+    size_t      round       = 0;
+    size_t      i           = 0;
+    int         mode        = 0;
+
+    // Never run, the hooks only have to be written
+    text = (uint8_t*) mmap( NULL,
+                            size + HOOK_BENCH_STRIDE,
+                            PROT_READ | PROT_WRITE | PROT_EXEC,
+                            MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1,
+                            0 );
+
+    if( MAP_FAILED == text )
+    {
+        perror( "mmap" );
+        return EXIT_FAILURE;
+    }
+
+    for( i = 0; i < ( size + HOOK_BENCH_STRIDE ); i += sizeof( uint32_t ) )
+    {
+        *(uint32_t*)( text + i ) = ARM64_NOP;
+    } // for()
+
+    for( mode = 0; mode < 2; mode++ )
+    {
+        bestHook    = 0;
+        bestUnhook  = 0;
+
+        for( round = 0; round < HOOK_BENCH_ROUNDS; round++ )
+        {
+            if( false == Bench_Round( text,
+                                      text + size,
+                                      ( 1 == mode ),
+                                      &hook,
+                                      &unhook ) )
+            {
+                fprintf( stderr, "Hooking the fake text failed\n" );
+                return EXIT_FAILURE;
+            }
+
+            bestHook    = ( ( 0 == bestHook   ) || ( hook   < bestHook   ) ) ? hook   : bestHook;
+            bestUnhook  = ( ( 0 == bestUnhook ) || ( unhook < bestUnhook ) ) ? unhook : bestUnhook;
+        } // for()
+
+        printf( "%-28s %12.0f hooks/s %12.0f unhooks/s\n",
+                ( 0 == mode ) ? "BWSR_InlineHook()" : "BWSR_InlineHook() batched",
+                HOOK_BENCH_FUNCTIONS / bestHook,
+                HOOK_BENCH_FUNCTIONS / bestUnhook );
+    } // for()
+
+    BWSR_DestroyAllHooks();
+
+    (void) munmap( text, size + HOOK_BENCH_STRIDE );
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "utility/error.h"
+
+#include "Hook/InlineHook.h"
+
+#include "Tests/Test.h"
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Size of the fake text, never run
+#define CHAIN_TEXT_SIZE         64
+
+#define ARM64_NOP               0xD503201F
+
+// -----------------------------------------------------------------------------
+//  HANDLERS
+// -----------------------------------------------------------------------------
+
+// Never called, only their addresses are used
+static void Chain_First( void ) { }
+static void Chain_Second( void ) { }
+static void Chain_Callback( bwsr_cpu_context_t* Context, void* UserData ) { (void) Context; (void) UserData; }
+
+// -----------------------------------------------------------------------------
+//  TESTS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief `BWSR_DestroyHook` removes every handler on the address and
+ * restores the target.
+ */
+static
+void
+    Test_DestroyHook
+    (
+        uint8_t*        Text,
+        const uint8_t*  Original
+    )
+{
+    TEST_CHECK( ERROR_SUCCESS == BWSR_InlineHook( Text, (void*) Chain_First, NULL, NULL, NULL ) );
+    TEST_CHECK( ERROR_SUCCESS == BWSR_InlineHook( Text, (void*) Chain_Second, NULL, NULL, NULL ) );
+    TEST_CHECK( 0 != memcmp( Text, Original, CHAIN_TEXT_SIZE ) );
+
+    TEST_CHECK( ERROR_SUCCESS   == BWSR_DestroyHook( Text ) );
+    TEST_CHECK( ERROR_NOT_FOUND == BWSR_FindHook( Text, NULL ) );
+    TEST_CHECK( ERROR_NOT_FOUND == BWSR_DestroyHook( Text ) );
+    TEST_CHECK( 0 == memcmp( Text, Original, CHAIN_TEXT_SIZE ) );
+}
+
+/**
+ * \brief `BWSR_RemoveHookHandler` removes only the given handler, the
+ * target stays hooked until the last one is gone.
+ */
+static
+void
+    Test_RemoveHookHandler
+    (
+        uint8_t*        Text,
+        const uint8_t*  Original
+    )
+{
+    TEST_CHECK( ERROR_SUCCESS == BWSR_InlineHook( Text, (void*) Chain_First, NULL, NULL, NULL ) );
+    TEST_CHECK( ERROR_SUCCESS == BWSR_InlineHook( Text, (void*) Chain_Second, NULL, NULL, NULL ) );
+
+    // The older handler, installed by someone else
+    TEST_CHECK( ERROR_SUCCESS   == BWSR_RemoveHookHandler( Text, (void*) Chain_First ) );
+    TEST_CHECK( ERROR_NOT_FOUND == BWSR_RemoveHookHandler( Text, (void*) Chain_First ) );
+    TEST_CHECK( ERROR_SUCCESS   == BWSR_FindHook( Text, NULL ) );
+    TEST_CHECK( 0 != memcmp( Text, Original, CHAIN_TEXT_SIZE ) );
+
+    TEST_CHECK( ERROR_SUCCESS   == BWSR_RemoveHookHandler( Text, (void*) Chain_Second ) );
+    TEST_CHECK( ERROR_NOT_FOUND == BWSR_FindHook( Text, NULL ) );
+    TEST_CHECK( 0 == memcmp( Text, Original, CHAIN_TEXT_SIZE ) );
+}
+
+/**
+ * \brief Instrumentation removed and added again on the same address
+ * reuses its stub instead of taking more of the code cache.
+ */
+static
+void
+    Test_InstrumentationReuse
+    (
+        uint8_t*        Text
+    )
+{
+    bwsr_code_cache_stats_t     first       = { 0 };
+    bwsr_code_cache_stats_t     last        = { 0 };
+    size_t                      round       = 0;
+
+    TEST_CHECK( ERROR_SUCCESS == BWSR_InlineHook( Text, (void*) Chain_First, NULL, NULL, NULL ) );
+
+    for( round = 0; round < 8; round++ )
+    {
+        TEST_CHECK( ERROR_SUCCESS == BWSR_InstrumentFunction( Text, Chain_Callback, Chain_Callback, NULL ) );
+        TEST_CHECK( ERROR_SUCCESS == BWSR_RemoveInstrumentation( Text, Chain_Callback, Chain_Callback, NULL ) );
+        TEST_CHECK( ERROR_SUCCESS == BWSR_GetCodeCacheStatistics( ( 0 == round ) ? &first : &last ) );
+    } // for()
+
+    TEST_CHECK( first.BytesInUse == last.BytesInUse );
+    TEST_CHECK( ERROR_SUCCESS    == BWSR_DestroyHook( Text ) );
+}
+
+// -----------------------------------------------------------------------------
+//  MAIN
+// -----------------------------------------------------------------------------
+
+int
+    main
+    (
+        void
+    )
+{
+    uint8_t     original[ CHAIN_TEXT_SIZE ];
+    uint8_t*    text        = NULL;
+    size_t      i           = 0;
+
+    text = (uint8_t*) mmap( NULL,
+                            CHAIN_TEXT_SIZE,
+                            PROT_READ | PROT_WRITE | PROT_EXEC,
+                            MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1,
+                            0 );
+
+    if( MAP_FAILED == text )
+    {
+        perror( "mmap" );
+        return EXIT_FAILURE;
+    }
+
+    for( i = 0; i < CHAIN_TEXT_SIZE; i += sizeof( uint32_t ) )
+    {
+        *(uint32_t*)( text + i ) = ARM64_NOP;
+    } // for()
+
+    memcpy( original, text, CHAIN_TEXT_SIZE );
+
+    Test_DestroyHook( text, original );
+    Test_RemoveHookHandler( text, original );
+    Test_InstrumentationReuse( text );
+
+    BWSR_DestroyAllHooks();
+
+    (void) munmap( text, CHAIN_TEXT_SIZE );
+
+    return TEST_RESULT();
+}
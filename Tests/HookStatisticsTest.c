@@ -0,0 +1,206 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "utility/error.h"
+
+#include "Hook/InlineHook.h"
+
+#include "Tests/Test.h"
+#include "Tests/Emulator.h"
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Size of the fake text, only ever run by the emulator
+#define STATISTICS_TEXT_SIZE    64
+
+// Calls made through the hook
+#define STATISTICS_CALLS        5
+
+// Stack of the emulated calls, in 64 bit words
+#define STATISTICS_STACK_WORDS  64
+
+#define ARM64_NOP               0xD503201F
+
+// Left in `x0` and `x1`, which the stub borrows
+#define STATISTICS_X0           0x0123456789ABCDEFULL
+#define STATISTICS_X1           0xFEDCBA9876543210ULL
+
+// -----------------------------------------------------------------------------
+//  HANDLERS
+// -----------------------------------------------------------------------------
+
+// Never called, the emulated calls stop at its address
+static void Statistics_Handler( void ) { }
+
+// -----------------------------------------------------------------------------
+//  HELPERS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Emulates a call of `Text` up to the hook handler.
+ * \return `bool` true if it reached the handler with `x0`, `x1`
+ * and `sp` as they were.
+ */
+static
+bool
+    Statistics_Call
+    (
+        uint8_t*        Text
+    )
+{
+    uint64_t        stack[ STATISTICS_STACK_WORDS ];
+    emulator_t      cpu         = { 0 };
+    uint64_t        sp          = (uint64_t) &stack[ STATISTICS_STACK_WORDS ];
+
+    cpu.PC          = (uint64_t) Text;
+    cpu.X[ 0 ]      = STATISTICS_X0;
+    cpu.X[ 1 ]      = STATISTICS_X1;
+    cpu.X[ 31 ]     = sp;
+
+    return ( Emulator_RunUntil( &cpu, (uint64_t) Statistics_Handler ) ) &&
+           ( STATISTICS_X0 == cpu.X[ 0 ]  ) &&
+           ( STATISTICS_X1 == cpu.X[ 1 ]  ) &&
+           ( sp            == cpu.X[ 31 ] );
+}
+
+/**
+ * \brief Calls counted so far.
+ * \return `uint64_t` the count, `UINT64_MAX` if there are no statistics.
+ */
+static
+uint64_t
+    Statistics_Calls
+    (
+        uint8_t*        Text
+    )
+{
+    bwsr_hook_stats_t   stats   = { 0 };
+
+    return ( ERROR_SUCCESS == BWSR_GetHookStatistics( Text, &stats, 0 ) )
+            ? stats.Calls
+            : UINT64_MAX;
+}
+
+// -----------------------------------------------------------------------------
+//  TESTS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief The stub counts every call by itself and continues to the handler.
+ */
+static
+void
+    Test_CountCalls
+    (
+        uint8_t*        Text
+    )
+{
+    size_t      i           = 0;
+
+    TEST_CHECK( ERROR_SUCCESS == BWSR_EnableHookStatistics( Text, 0 ) );
+
+    for( i = 0; i < STATISTICS_CALLS; i++ )
+    {
+        TEST_CHECK( Statistics_Call( Text ) );
+    } // for()
+
+    TEST_CHECK( STATISTICS_CALLS == Statistics_Calls( Text ) );
+}
+
+/**
+ * \brief Disabled statistics are bypassed, their counts stay readable.
+ */
+static
+void
+    Test_DisableBypasses
+    (
+        uint8_t*        Text
+    )
+{
+    TEST_CHECK( ERROR_SUCCESS   == BWSR_DisableHookStatistics( Text ) );
+    TEST_CHECK( ERROR_NOT_FOUND == BWSR_DisableHookStatistics( Text ) );
+
+    TEST_CHECK( Statistics_Call( Text ) );
+    TEST_CHECK( STATISTICS_CALLS == Statistics_Calls( Text ) );
+
+    TEST_CHECK( ERROR_SUCCESS == BWSR_EnableHookStatistics( Text, 0 ) );
+    TEST_CHECK( Statistics_Call( Text ) );
+    TEST_CHECK( ( STATISTICS_CALLS + 1 ) == Statistics_Calls( Text ) );
+}
+
+/**
+ * \brief Enabling and disabling again keeps the one stub of the entry.
+ */
+static
+void
+    Test_ToggleKeepsStub
+    (
+        uint8_t*        Text
+    )
+{
+    bwsr_code_cache_stats_t     first       = { 0 };
+    bwsr_code_cache_stats_t     last        = { 0 };
+    size_t                      round       = 0;
+
+    for( round = 0; round < 8; round++ )
+    {
+        TEST_CHECK( ERROR_SUCCESS == BWSR_DisableHookStatistics( Text ) );
+        TEST_CHECK( ERROR_SUCCESS == BWSR_EnableHookStatistics( Text, 0 ) );
+        TEST_CHECK( ERROR_SUCCESS == BWSR_GetCodeCacheStatistics( ( 0 == round ) ? &first : &last ) );
+    } // for()
+
+    TEST_CHECK( first.BytesInUse == last.BytesInUse );
+}
+
+// -----------------------------------------------------------------------------
+//  MAIN
+// -----------------------------------------------------------------------------
+
+int
+    main
+    (
+        void
+    )
+{
+    uint8_t*    text        = NULL;
+    size_t      i           = 0;
+
+    text = (uint8_t*) mmap( NULL,
+                            STATISTICS_TEXT_SIZE,
+                            PROT_READ | PROT_WRITE | PROT_EXEC,
+                            MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1,
+                            0 );
+
+    if( MAP_FAILED == text )
+    {
+        perror( "mmap" );
+        return EXIT_FAILURE;
+    }
+
+    for( i = 0; i < STATISTICS_TEXT_SIZE; i += sizeof( uint32_t ) )
+    {
+        *(uint32_t*)( text + i ) = ARM64_NOP;
+    } // for()
+
+    TEST_CHECK( ERROR_SUCCESS == BWSR_InlineHook( text, (void*) Statistics_Handler, NULL, NULL, NULL ) );
+
+    Test_CountCalls( text );
+    Test_DisableBypasses( text );
+    Test_ToggleKeepsStub( text );
+
+    TEST_CHECK( ERROR_SUCCESS == BWSR_DestroyHook( text ) );
+
+    BWSR_DestroyAllHooks();
+
+    (void) munmap( text, STATISTICS_TEXT_SIZE );
+
+    return TEST_RESULT();
+}
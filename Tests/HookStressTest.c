@@ -0,0 +1,274 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "utility/error.h"
+
+#include "Hook/InlineHook.h"
+
+#if defined( DEBUG_MODE )
+    #include "Memory/MemoryTracker.h"
+#endif
+
+#include "Tests/Test.h"
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Threads calling the hot function while it is hooked and unhooked
+#define STRESS_CALLERS          4
+
+// Threads hooking and unhooking functions of their own at the same time
+#define STRESS_HOOKERS          4
+
+// Seconds spent hooking and unhooking. Every thread does at least one
+// cycle, parking the callers for safe patching can take a while on few cores.
+#define STRESS_SECONDS          1.0
+
+// Functions in the fake text, each padded to `STRESS_STRIDE` bytes.
+// The first one is the hot function, the next `STRESS_HOOKERS` belong
+// to one hooking thread each.
+#define STRESS_FUNCTIONS        ( 1 + STRESS_HOOKERS )
+#define STRESS_STRIDE           32
+
+#define ARM64_NOP               0xD503201F
+// mov x0, #1
+#define ARM64_MOV_X0_1          0xD2800020
+// ret
+#define ARM64_RET               0xD65F03C0
+
+// -----------------------------------------------------------------------------
+//  GLOBALS
+// -----------------------------------------------------------------------------
+
+static uint8_t*     gText       = NULL;
+static uint8_t      gOriginal[ STRESS_STRIDE ];
+static double       gDeadline   = 0;
+static bool         gStop       = false;
+
+// -----------------------------------------------------------------------------
+//  THREADS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Replaces the hot function, which returns `1`.
+ * \return `int` 2
+ */
+static
+int
+    Stress_Replacement
+    (
+        void
+    )
+{
+    return 2;
+}
+
+/**
+ * \brief Calls the hot function until `gStop` is set. Off `arm64` the
+ * text cannot run, so its first instruction is read instead and must be
+ * the original one or the first one of a trampoline.
+ * \return `void*` number of bad results.
+ */
+static
+void*
+    Stress_Caller
+    (
+        void*       Argument
+    )
+{
+    uintptr_t   failures    = 0;
+    uint32_t    instruction = 0;
+
+    (void) Argument;
+    (void) instruction;
+
+    while( false == __atomic_load_n( &gStop, __ATOMIC_ACQUIRE ) )
+    {
+#if defined( __aarch64__ )
+        int result = ( (int (*)( void )) gText )();
+
+        if( ( 1 != result ) &&
+            ( 2 != result ) )
+        {
+            failures++;
+        }
+#else
+        instruction = __atomic_load_n( (uint32_t*) gText, __ATOMIC_RELAXED );
+
+        // The original, `B`, `LDR` (literal) or `ADRP`
+        if( ( ARM64_MOV_X0_1 != instruction                 ) &&
+            ( 0x14000000     != ( instruction & 0xFC000000 ) ) &&
+            ( 0x58000000     != ( instruction & 0xFF000000 ) ) &&
+            ( 0x90000000     != ( instruction & 0x9F000000 ) ) )
+        {
+            failures++;
+        }
+#endif
+    } // while()
+
+    return (void*) failures;
+}
+
+/**
+ * \brief Hooks, looks up, toggles and unhooks its own function
+ * until `gDeadline`.
+ * \return `void*` number of failed calls.
+ */
+static
+void*
+    Stress_Hooker
+    (
+        void*       Argument
+    )
+{
+    uint8_t*    function    = gText + ( (uintptr_t) Argument * STRESS_STRIDE );
+    void*       original    = NULL;
+    uintptr_t   failures    = 0;
+
+    do
+    {
+        original = NULL;
+
+        if( ( ERROR_SUCCESS != BWSR_InlineHook( function,
+                                                (void*) Stress_Replacement,
+                                                &original,
+                                                NULL,
+                                                NULL ) ) ||
+            ( NULL          == original                         ) ||
+            ( ERROR_SUCCESS != BWSR_FindHook( function, NULL ) ) ||
+            ( ERROR_SUCCESS != BWSR_DisableHook( function )    ) ||
+            ( ERROR_SUCCESS != BWSR_EnableHook( function )     ) ||
+            ( ERROR_SUCCESS != BWSR_DestroyHook( function )    ) )
+        {
+            failures++;
+        }
+    } while( Test_Seconds() < gDeadline );
+
+    return (void*) failures;
+}
+
+// -----------------------------------------------------------------------------
+//  MAIN
+// -----------------------------------------------------------------------------
+
+int
+    main
+    (
+        void
+    )
+{
+    pthread_t   callers[ STRESS_CALLERS ];
+    pthread_t   hookers[ STRESS_HOOKERS ];
+    void*       failures    = NULL;
+    size_t      size        = STRESS_FUNCTIONS * STRESS_STRIDE;
+    size_t      round       = 0;
+    size_t      i           = 0;
+
+    gText = (uint8_t*) mmap( NULL,
+                             size,
+                             PROT_READ | PROT_WRITE | PROT_EXEC,
+                             MAP_PRIVATE | MAP_ANONYMOUS,
+                             -1,
+                             0 );
+
+    if( MAP_FAILED == gText )
+    {
+        perror( "mmap" );
+        return EXIT_FAILURE;
+    }
+
+    // Every function returns `1`
+    for( i = 0; i < size; i += sizeof( uint32_t ) )
+    {
+        *(uint32_t*)( gText + i ) = ARM64_NOP;
+    } // for()
+
+    for( i = 0; i < STRESS_FUNCTIONS; i++ )
+    {
+        *(uint32_t*)( gText + ( i * STRESS_STRIDE ) + 0 ) = ARM64_MOV_X0_1;
+        *(uint32_t*)( gText + ( i * STRESS_STRIDE ) + 4 ) = ARM64_RET;
+    } // for()
+
+    __builtin___clear_cache( (char*) gText, (char*) ( gText + size ) );
+
+    memcpy( gOriginal, gText, STRESS_STRIDE );
+
+    // Callers may sit in a patched range, they are moved out of it
+    TEST_CHECK( ERROR_SUCCESS == BWSR_SetSafePatching( 1 ) );
+
+    gDeadline = Test_Seconds() + STRESS_SECONDS;
+
+    for( i = 0; i < STRESS_CALLERS; i++ )
+    {
+        TEST_CHECK( 0 == pthread_create( &callers[ i ], NULL, Stress_Caller, NULL ) );
+    } // for()
+
+    for( i = 0; i < STRESS_HOOKERS; i++ )
+    {
+        TEST_CHECK( 0 == pthread_create( &hookers[ i ], NULL, Stress_Hooker, (void*)( i + 1 ) ) );
+    } // for()
+
+    // Hooks and unhooks the hot function under the callers, every other
+    // time in a transaction
+    do
+    {
+        if( 1 == ( round & 1 ) )
+        {
+            TEST_CHECK( ERROR_SUCCESS == BWSR_BeginHookTransaction() );
+        }
+
+        TEST_CHECK( ERROR_SUCCESS == BWSR_InlineHook( gText,
+                                                      (void*) Stress_Replacement,
+                                                      NULL,
+                                                      NULL,
+                                                      NULL ) );
+
+        if( 1 == ( round & 1 ) )
+        {
+            TEST_CHECK( ERROR_SUCCESS == BWSR_CommitHookTransaction() );
+        }
+
+        TEST_CHECK( ERROR_SUCCESS == BWSR_DestroyHook( gText ) );
+
+        round++;
+    } while( Test_Seconds() < gDeadline );
+
+    printf( "Hooked the hot function %zu times\n", round );
+
+    for( i = 0; i < STRESS_HOOKERS; i++ )
+    {
+        TEST_CHECK( 0 == pthread_join( hookers[ i ], &failures ) );
+        TEST_CHECK( NULL == failures );
+    } // for()
+
+    __atomic_store_n( &gStop, true, __ATOMIC_RELEASE );
+
+    for( i = 0; i < STRESS_CALLERS; i++ )
+    {
+        TEST_CHECK( 0 == pthread_join( callers[ i ], &failures ) );
+        TEST_CHECK( NULL == failures );
+    } // for()
+
+    // Every function is back to its original instructions
+    for( i = 0; i < STRESS_FUNCTIONS; i++ )
+    {
+        TEST_CHECK( 0 == memcmp( gText + ( i * STRESS_STRIDE ), gOriginal, STRESS_STRIDE ) );
+    } // for()
+
+    BWSR_DestroyAllHooks();
+
+    (void) munmap( gText, size );
+
+#if defined( DEBUG_MODE )
+    TEST_CHECK( 0 == MemoryTracker_CheckForMemoryLeaks() );
+#endif
+
+    return TEST_RESULT();
+}
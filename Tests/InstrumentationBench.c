@@ -0,0 +1,215 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include "utility/error.h"
+
+#include "Hook/InlineHook.h"
+
+#include "Tests/Test.h"
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Calls per round
+#define INSTRUMENTATION_BENCH_CALLS     10000000
+
+// Rounds measured, the best one is reported
+#define INSTRUMENTATION_BENCH_ROUNDS    5
+
+// Functions in the fake text, each padded to `INSTRUMENTATION_BENCH_STRIDE` bytes
+#define INSTRUMENTATION_BENCH_FUNCTIONS 5
+#define INSTRUMENTATION_BENCH_STRIDE    32
+
+#define ARM64_NOP               0xD503201F
+// mov x0, #1
+#define ARM64_MOV_X0_1          0xD2800020
+// ret
+#define ARM64_RET               0xD65F03C0
+
+#if defined( __aarch64__ )
+
+// -----------------------------------------------------------------------------
+//  GLOBALS
+// -----------------------------------------------------------------------------
+
+// Original of the hooked function
+static int  ( *gOriginal )( void )  = NULL;
+
+// -----------------------------------------------------------------------------
+//  HANDLERS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Replacement that only calls the original.
+ * \return `int` the original's result.
+ */
+static
+int
+    Bench_Replacement
+    (
+        void
+    )
+{
+    return gOriginal();
+}
+
+/**
+ * \brief Instrumentation callback that does nothing.
+ */
+static
+void
+    Bench_Callback
+    (
+        bwsr_cpu_context_t*     Context,
+        void*                   UserData
+    )
+{
+    (void) Context;
+    (void) UserData;
+}
+
+// -----------------------------------------------------------------------------
+//  BENCHMARK
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Calls `Function` `INSTRUMENTATION_BENCH_CALLS` times per round and
+ * prints the best time per call, and how much of it `Direct` did not take.
+ * \return `double` best nanoseconds per call.
+ */
+static
+double
+    Bench_Calls
+    (
+        const char*     Name,
+        void*           Function,
+        double          Direct
+    )
+{
+    int         ( *volatile function )( void )  = (int (*)( void )) Function;
+    double      start                           = 0;
+    double      elapsed                         = 0;
+    double      best                            = 0;
+    size_t      round                           = 0;
+    size_t      i                               = 0;
+    int         sum                             = 0;
+
+    for( round = 0; round < INSTRUMENTATION_BENCH_ROUNDS; round++ )
+    {
+        start = Test_Seconds();
+
+        for( i = 0; i < INSTRUMENTATION_BENCH_CALLS; i++ )
+        {
+            sum += function();
+        } // for()
+
+        elapsed = Test_Seconds() - start;
+        best    = ( ( 0 == best ) || ( elapsed < best ) ) ? elapsed : best;
+    } // for()
+
+    best = ( best * 1e9 ) / INSTRUMENTATION_BENCH_CALLS;
+
+    printf( "%-36s %8.2f ns/call %8.2f ns overhead%s\n",
+            Name,
+            best,
+            ( 0 == Direct ) ? 0 : ( best - Direct ),
+            ( ( INSTRUMENTATION_BENCH_CALLS * INSTRUMENTATION_BENCH_ROUNDS ) == sum ) ? "" : ", wrong result" );
+
+    return best;
+}
+
+#endif // __aarch64__
+
+// -----------------------------------------------------------------------------
+//  MAIN
+// -----------------------------------------------------------------------------
+
+int
+    main
+    (
+        void
+    )
+{
+#if defined( __aarch64__ )
+    uint8_t*    text    = NULL;
+    double      direct  = 0;
+    size_t      size    = INSTRUMENTATION_BENCH_FUNCTIONS * INSTRUMENTATION_BENCH_STRIDE;
+    size_t      i       = 0;
+    int         retVal  = EXIT_FAILURE;
+
+    text = (uint8_t*) mmap( NULL,
+                            size,
+                            PROT_READ | PROT_WRITE | PROT_EXEC,
+                            MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1,
+                            0 );
+
+    if( MAP_FAILED == text )
+    {
+        perror( "mmap" );
+        return EXIT_FAILURE;
+    }
+
+    // Every function returns `1`
+    for( i = 0; i < size; i += sizeof( uint32_t ) )
+    {
+        *(uint32_t*)( text + i ) = ARM64_NOP;
+    } // for()
+
+    for( i = 0; i < INSTRUMENTATION_BENCH_FUNCTIONS; i++ )
+    {
+        *(uint32_t*)( text + ( i * INSTRUMENTATION_BENCH_STRIDE ) + 0 ) = ARM64_MOV_X0_1;
+        *(uint32_t*)( text + ( i * INSTRUMENTATION_BENCH_STRIDE ) + 4 ) = ARM64_RET;
+    } // for()
+
+    __builtin___clear_cache( (char*) text, (char*) ( text + size ) );
+
+    if( ( ERROR_SUCCESS != BWSR_InlineHook( text + ( 1 * INSTRUMENTATION_BENCH_STRIDE ),
+                                            (void*) Bench_Replacement,
+                                            (void**) &gOriginal,
+                                            NULL,
+                                            NULL ) ) ||
+        ( ERROR_SUCCESS != BWSR_InstrumentFunction( text + ( 2 * INSTRUMENTATION_BENCH_STRIDE ),
+                                                    Bench_Callback,
+                                                    NULL,
+                                                    NULL ) ) ||
+        ( ERROR_SUCCESS != BWSR_InstrumentFunction( text + ( 3 * INSTRUMENTATION_BENCH_STRIDE ),
+                                                    Bench_Callback,
+                                                    Bench_Callback,
+                                                    NULL ) ) ||
+        ( ERROR_SUCCESS != BWSR_InlineHook( text + ( 4 * INSTRUMENTATION_BENCH_STRIDE ),
+                                            (void*) Bench_Replacement,
+                                            NULL,
+                                            NULL,
+                                            NULL ) ) ||
+        ( ERROR_SUCCESS != BWSR_EnableHookStatistics( text + ( 4 * INSTRUMENTATION_BENCH_STRIDE ),
+                                                      0 ) ) )
+    {
+        fprintf( stderr, "Hooking the fake text failed\n" );
+    }
+    else {
+        direct = Bench_Calls( "Direct call",                        text + ( 0 * INSTRUMENTATION_BENCH_STRIDE ), 0      );
+        (void)   Bench_Calls( "BWSR_InlineHook()",                  text + ( 1 * INSTRUMENTATION_BENCH_STRIDE ), direct );
+        (void)   Bench_Calls( "BWSR_InstrumentFunction() enter",    text + ( 2 * INSTRUMENTATION_BENCH_STRIDE ), direct );
+        (void)   Bench_Calls( "BWSR_InstrumentFunction() both",     text + ( 3 * INSTRUMENTATION_BENCH_STRIDE ), direct );
+        (void)   Bench_Calls( "BWSR_EnableHookStatistics() count",  text + ( 4 * INSTRUMENTATION_BENCH_STRIDE ), direct );
+
+        retVal = EXIT_SUCCESS;
+    } // BWSR_InlineHook()
+
+    BWSR_DestroyAllHooks();
+
+    (void) munmap( text, size );
+
+    return retVal;
+#else
+    printf( "Skipped, hooked code only runs on arm64\n" );
+
+    return EXIT_SUCCESS;
+#endif // __aarch64__
+}
@@ -0,0 +1,163 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+// The relocator is internal to the hook
+#include "Hook/InlineHook.c"
+
+#include <sys/mman.h>
+
+#include "Tests/Test.h"
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Relocations per round
+#define RELOCATION_BENCH_COUNT      100000
+
+// Rounds measured, the best one is reported
+#define RELOCATION_BENCH_ROUNDS     5
+
+// -----------------------------------------------------------------------------
+//  BENCHMARK
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Relocates `Count` instructions `RELOCATION_BENCH_COUNT` times,
+ * freeing each block, and prints the best rate.
+ * \return `bool` false if a relocation failed.
+ */
+static
+bool
+    Bench_Relocate
+    (
+        const char*         Name,
+        uintptr_t           Code,
+        const uint32_t*     Instructions,
+        size_t              Count
+    )
+{
+    intercept_routing_t     routing     = { 0 };
+    memory_range_t          base        = { 0 };
+    memory_range_t          relocated   = { 0 };
+    memory_range_t          pinned      = { 0 };
+    double                  start       = 0;
+    double                  elapsed     = 0;
+    double                  best        = 0;
+    size_t                  round       = 0;
+    size_t                  i           = 0;
+
+    (void) INTERNAL_SetMemoryProtectionFunction( (uintptr_t*) &routing.MemoryProtectFn );
+
+    memcpy( (void*) Code, Instructions, Count * sizeof( uint32_t ) );
+
+    base.Start  = Code;
+    base.Size   = Count * sizeof( uint32_t );
+
+    // Keeps the code page mapped, only the relocator is measured
+    if( ERROR_SUCCESS != INTERNAL_CodeBuilder_AssembleAndPatch( &routing,
+                                                                &base,
+                                                                &pinned,
+                                                                true ) )
+    {
+        fprintf( stderr, "%s: relocation failed\n", Name );
+        return false;
+    }
+
+    for( round = 0; round < RELOCATION_BENCH_ROUNDS; round++ )
+    {
+        start = Test_Seconds();
+
+        for( i = 0; i < RELOCATION_BENCH_COUNT; i++ )
+        {
+            base.Start  = Code;
+            base.Size   = Count * sizeof( uint32_t );
+
+            if( ERROR_SUCCESS != INTERNAL_CodeBuilder_AssembleAndPatch( &routing,
+                                                                        &base,
+                                                                        &relocated,
+                                                                        true ) )
+            {
+                fprintf( stderr, "%s: relocation failed\n", Name );
+                (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator, &pinned );
+                return false;
+            }
+
+            (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator, &relocated );
+        } // for()
+
+        elapsed = Test_Seconds() - start;
+        best    = ( ( 0 == best ) || ( elapsed < best ) ) ? elapsed : best;
+    } // for()
+
+    (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator, &pinned );
+
+    printf( "%-28s %12.0f relocations/s %12.0f instructions/s\n",
+            Name,
+            RELOCATION_BENCH_COUNT / best,
+            ( RELOCATION_BENCH_COUNT * Count ) / best );
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+//  MAIN
+// -----------------------------------------------------------------------------
+
+int
+    main
+    (
+        void
+    )
+{
+    // A typical prologue, copied as is
+    static const uint32_t prologue[] =
+    {
+        // stp x29, x30, [sp, #-0x10]!
+        0xA9BF7BFD,
+        // mov x29, sp
+        0x910003FD,
+        // sub sp, sp, #0x20
+        0xD10083FF,
+        // str x19, [sp, #0x10]
+        0xF9000BF3,
+    };
+
+    // Every instruction is PC-relative
+    static const uint32_t pcRelative[] =
+    {
+        // adrp x8, #0x1000
+        0xB0000008,
+        // ldr x2, #0x100
+        0x58000802,
+        // cbz x0, #0x40
+        0xB4000200,
+        // bl #0x200
+        0x94000080,
+    };
+
+    uint8_t*    text    = NULL;
+    bool        success = false;
+
+    text = (uint8_t*) mmap( NULL,
+                            0x1000,
+                            PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1,
+                            0 );
+
+    if( MAP_FAILED == text )
+    {
+        perror( "mmap" );
+        return EXIT_FAILURE;
+    }
+
+    success = ( Bench_Relocate( "Prologue",    (uintptr_t) text, prologue,   ARRAY_LENGTH( prologue   ) ) &&
+                Bench_Relocate( "PC-relative", (uintptr_t) text, pcRelative, ARRAY_LENGTH( pcRelative ) ) );
+
+    (void) MemoryAllocator_Release( &gMemoryAllocator );
+    (void) munmap( text, 0x1000 );
+
+    return ( success ? EXIT_SUCCESS : EXIT_FAILURE );
+}
@@ -0,0 +1,438 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+// The relocator is internal to the hook
+#include "Hook/InlineHook.c"
+
+#include <sys/mman.h>
+
+#include "Tests/Test.h"
+#include "Tests/Emulator.h"
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Fake text, the relocated code is placed in its middle page, off the page
+// start so `ADRP` has to truncate
+#define TEST_TEXT_SIZE          ( 3 * 0x1000 )
+#define TEST_CODE_OFFSET        0x1010
+
+// Data loaded by the literal loads, past the code
+#define TEST_LITERAL_OFFSET     0x800
+#define TEST_LITERAL_LOW        0x1122334480000001ULL
+#define TEST_LITERAL_HIGH       0x99AABBCCDDEEFF00ULL
+
+// -----------------------------------------------------------------------------
+//  GLOBALS
+// -----------------------------------------------------------------------------
+
+static uint8_t*             gText       = NULL;
+static uintptr_t            gCode       = 0;
+static intercept_routing_t  gRouting    = { 0 };
+
+// -----------------------------------------------------------------------------
+//  HELPERS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Writes `Count` instructions at `gCode` and relocates them.
+ * The relocated code branches back to the instruction after them.
+ * \return `bool` true if the relocation succeeded.
+ */
+static
+bool
+    Test_Relocate
+    (
+        const uint32_t*     Instructions,
+        size_t              Count,
+        memory_range_t*     Relocated
+    )
+{
+    memory_range_t  base    = { 0 };
+    BWSR_STATUS     retVal  = ERROR_FAILURE;
+
+    memcpy( (void*) gCode, Instructions, Count * sizeof( uint32_t ) );
+
+    base.Start  = gCode;
+    base.Size   = Count * sizeof( uint32_t );
+
+    memset( Relocated, 0, sizeof( memory_range_t ) );
+
+    retVal = INTERNAL_CodeBuilder_AssembleAndPatch( &gRouting,
+                                                    &base,
+                                                    Relocated,
+                                                    true );
+    TEST_CHECK( ERROR_SUCCESS == retVal );
+    TEST_CHECK( ( Count * sizeof( uint32_t ) ) == base.Size );
+
+    return ( ERROR_SUCCESS == retVal );
+}
+
+/**
+ * \brief Relocates one instruction and runs it from the relocated code.
+ * \return `uint64_t` the address the relocated code branched to.
+ */
+static
+uint64_t
+    Test_RelocateAndRun
+    (
+        uint32_t            Instruction,
+        emulator_t*         Cpu
+    )
+{
+    memory_range_t  relocated   = { 0 };
+    uint64_t        exit        = 0;
+
+    if( Test_Relocate( &Instruction, 1, &relocated ) )
+    {
+        Cpu->PC = relocated.Start;
+        exit    = Emulator_Run( Cpu,
+                                (void*) relocated.Start,
+                                relocated.Start,
+                                relocated.Size );
+
+        (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator, &relocated );
+    }
+
+    return exit;
+}
+
+// -----------------------------------------------------------------------------
+//  TESTS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Instructions that are not PC-relative run unchanged.
+ */
+static
+void
+    Test_Copy
+    (
+        void
+    )
+{
+    emulator_t cpu = { 0 };
+
+    // add x0, x0, #1
+    cpu.X[ 0 ] = 41;
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0x91000400, &cpu ) );
+    TEST_CHECK( 42 == cpu.X[ 0 ] );
+}
+
+/**
+ * \brief `B` and `BL` reach their target, `BL` returns into the relocated
+ * code and on to the next instruction.
+ */
+static
+void
+    Test_UnconditionalBranch
+    (
+        void
+    )
+{
+    emulator_t      cpu         = { 0 };
+    memory_range_t  relocated   = { 0 };
+    uint32_t        bl          = 0x94000080;
+
+    // b #0x100, b #-0x10
+    TEST_CHECK( ( gCode + 0x100 ) == Test_RelocateAndRun( 0x14000040, &cpu ) );
+    TEST_CHECK( ( gCode - 0x10  ) == Test_RelocateAndRun( 0x17FFFFFC, &cpu ) );
+
+    // bl #0x200
+    if( Test_Relocate( &bl, 1, &relocated ) )
+    {
+        cpu.PC = relocated.Start;
+
+        TEST_CHECK( ( gCode + 0x200 ) == Emulator_Run( &cpu,
+                                                       (void*) relocated.Start,
+                                                       relocated.Start,
+                                                       relocated.Size ) );
+        TEST_CHECK( ( relocated.Start <  cpu.X[ 30 ] ) &&
+                    ( ( relocated.Start + relocated.Size ) > cpu.X[ 30 ] ) );
+
+        cpu.PC = cpu.X[ 30 ];
+
+        TEST_CHECK( ( gCode + 4 ) == Emulator_Run( &cpu,
+                                                   (void*) relocated.Start,
+                                                   relocated.Start,
+                                                   relocated.Size ) );
+
+        (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator, &relocated );
+    } // Test_Relocate()
+}
+
+/**
+ * \brief `B.cond` and `BC.cond` branch on the same flags once relocated,
+ * `AL` and `NV` always branch.
+ */
+static
+void
+    Test_ConditionalBranch
+    (
+        void
+    )
+{
+    emulator_t cpu = { 0 };
+
+    // b.eq #0x40
+    cpu.NZCV = EMULATOR_Z;
+    TEST_CHECK( ( gCode + 0x40 ) == Test_RelocateAndRun( 0x54000200, &cpu ) );
+    cpu.NZCV = 0;
+    TEST_CHECK( ( gCode + 4    ) == Test_RelocateAndRun( 0x54000200, &cpu ) );
+
+    // b.ne #-0x40
+    cpu.NZCV = 0;
+    TEST_CHECK( ( gCode - 0x40 ) == Test_RelocateAndRun( 0x54FFFE01, &cpu ) );
+    cpu.NZCV = EMULATOR_Z;
+    TEST_CHECK( ( gCode + 4    ) == Test_RelocateAndRun( 0x54FFFE01, &cpu ) );
+
+    // b.ge #0x40
+    cpu.NZCV = ( EMULATOR_N | EMULATOR_V );
+    TEST_CHECK( ( gCode + 0x40 ) == Test_RelocateAndRun( 0x5400020A, &cpu ) );
+    cpu.NZCV = EMULATOR_N;
+    TEST_CHECK( ( gCode + 4    ) == Test_RelocateAndRun( 0x5400020A, &cpu ) );
+
+    // bc.ne #0x40
+    cpu.NZCV = 0;
+    TEST_CHECK( ( gCode + 0x40 ) == Test_RelocateAndRun( 0x54000211, &cpu ) );
+    cpu.NZCV = EMULATOR_Z;
+    TEST_CHECK( ( gCode + 4    ) == Test_RelocateAndRun( 0x54000211, &cpu ) );
+
+    // b.al and b.nv #0x40
+    cpu.NZCV = 0;
+    TEST_CHECK( ( gCode + 0x40 ) == Test_RelocateAndRun( 0x5400020E, &cpu ) );
+    TEST_CHECK( ( gCode + 0x40 ) == Test_RelocateAndRun( 0x5400020F, &cpu ) );
+}
+
+/**
+ * \brief `CBZ`, `CBNZ`, `TBZ` and `TBNZ` test the same register bits once
+ * relocated.
+ */
+static
+void
+    Test_CompareAndTestBranch
+    (
+        void
+    )
+{
+    emulator_t cpu = { 0 };
+
+    // cbz x3, #0x20
+    cpu.X[ 3 ] = 0;
+    TEST_CHECK( ( gCode + 0x20 ) == Test_RelocateAndRun( 0xB4000103, &cpu ) );
+    cpu.X[ 3 ] = 1;
+    TEST_CHECK( ( gCode + 4    ) == Test_RelocateAndRun( 0xB4000103, &cpu ) );
+
+    // cbnz w3, #0x20, only the low 32 bits count
+    cpu.X[ 3 ] = 0x100000000ULL;
+    TEST_CHECK( ( gCode + 4    ) == Test_RelocateAndRun( 0x35000103, &cpu ) );
+    cpu.X[ 3 ] = 1;
+    TEST_CHECK( ( gCode + 0x20 ) == Test_RelocateAndRun( 0x35000103, &cpu ) );
+
+    // tbz x5, #33, #0x30
+    cpu.X[ 5 ] = ( 1ULL << 33 );
+    TEST_CHECK( ( gCode + 4    ) == Test_RelocateAndRun( 0xB6080185, &cpu ) );
+    cpu.X[ 5 ] = ~( 1ULL << 33 );
+    TEST_CHECK( ( gCode + 0x30 ) == Test_RelocateAndRun( 0xB6080185, &cpu ) );
+
+    // tbnz w5, #2, #-0x30
+    cpu.X[ 5 ] = 4;
+    TEST_CHECK( ( gCode - 0x30 ) == Test_RelocateAndRun( 0x3717FE85, &cpu ) );
+    cpu.X[ 5 ] = 0;
+    TEST_CHECK( ( gCode + 4    ) == Test_RelocateAndRun( 0x3717FE85, &cpu ) );
+}
+
+/**
+ * \brief Every `LDR` (literal) form loads the same data once relocated,
+ * with the width and extension of the original.
+ */
+static
+void
+    Test_LiteralLoad
+    (
+        void
+    )
+{
+    emulator_t      cpu         = { 0 };
+    memory_range_t  relocated   = { 0 };
+    uint32_t        unallocated = 0xDC004000;
+
+    // ldr x2, #0x800
+    cpu.X[ 2 ] = 0;
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0x58004002, &cpu ) );
+    TEST_CHECK( TEST_LITERAL_LOW == cpu.X[ 2 ] );
+
+    // ldr w2, #0x800
+    cpu.X[ 2 ] = ~0ULL;
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0x18004002, &cpu ) );
+    TEST_CHECK( (uint32_t) TEST_LITERAL_LOW == cpu.X[ 2 ] );
+
+    // ldrsw x2, #0x800
+    cpu.X[ 2 ] = 0;
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0x98004002, &cpu ) );
+    TEST_CHECK( (uint64_t)(int64_t)(int32_t) TEST_LITERAL_LOW == cpu.X[ 2 ] );
+
+    // ldr s7, #0x800
+    memset( cpu.V[ 7 ], 0xFF, sizeof( cpu.V[ 7 ] ) );
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0x1C004007, &cpu ) );
+    TEST_CHECK( ( (uint32_t) TEST_LITERAL_LOW == cpu.V[ 7 ][ 0 ] ) &&
+                ( 0                           == cpu.V[ 7 ][ 1 ] ) );
+
+    // ldr d7, #0x800
+    memset( cpu.V[ 7 ], 0xFF, sizeof( cpu.V[ 7 ] ) );
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0x5C004007, &cpu ) );
+    TEST_CHECK( ( TEST_LITERAL_LOW == cpu.V[ 7 ][ 0 ] ) &&
+                ( 0                == cpu.V[ 7 ][ 1 ] ) );
+
+    // ldr q7, #0x800
+    memset( cpu.V[ 7 ], 0, sizeof( cpu.V[ 7 ] ) );
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0x9C004007, &cpu ) );
+    TEST_CHECK( ( TEST_LITERAL_LOW  == cpu.V[ 7 ][ 0 ] ) &&
+                ( TEST_LITERAL_HIGH == cpu.V[ 7 ][ 1 ] ) );
+
+    // prfm pldl1keep, #0x800
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0xD8004000, &cpu ) );
+
+    // Unallocated `opc:V`, copied as is
+    if( Test_Relocate( &unallocated, 1, &relocated ) )
+    {
+        TEST_CHECK( unallocated == *(uint32_t*) relocated.Start );
+
+        (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator, &relocated );
+    }
+}
+
+/**
+ * \brief `ADR` and `ADRP` compute the original address once relocated.
+ */
+static
+void
+    Test_PCRelAddressing
+    (
+        void
+    )
+{
+    emulator_t cpu = { 0 };
+
+    // adr x3, #0x100
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0x10000803, &cpu ) );
+    TEST_CHECK( ( gCode + 0x100 ) == cpu.X[ 3 ] );
+
+    // adr x3, #-4
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0x10FFFFE3, &cpu ) );
+    TEST_CHECK( ( gCode - 4 ) == cpu.X[ 3 ] );
+
+    // adrp x4, #0x1000
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0xB0000004, &cpu ) );
+    TEST_CHECK( ( ( gCode & ~0xFFFULL ) + 0x1000 ) == cpu.X[ 4 ] );
+
+    // adrp x4, #-0x5000
+    TEST_CHECK( ( gCode + 4 ) == Test_RelocateAndRun( 0xF0FFFFC4, &cpu ) );
+    TEST_CHECK( ( ( gCode & ~0xFFFULL ) - 0x5000 ) == cpu.X[ 4 ] );
+}
+
+/**
+ * \brief Each relocated instruction keeps the offsets of its own original
+ * address, and the code returns after the last one.
+ */
+static
+void
+    Test_Sequence
+    (
+        void
+    )
+{
+    static const uint32_t code[] =
+    {
+        // add x0, x0, #1
+        0x91000400,
+        // adr x3, #0x100
+        0x10000803,
+        // ldr x2, #0x7F8, the literal data
+        0x58003FC2,
+        // cbz x9, #0x40
+        0xB4000209,
+        // nop
+        0xD503201F,
+    };
+
+    emulator_t      cpu         = { 0 };
+    memory_range_t  relocated   = { 0 };
+
+    cpu.X[ 0 ] = 1;
+    cpu.X[ 9 ] = 1;
+
+    if( Test_Relocate( code, ARRAY_LENGTH( code ), &relocated ) )
+    {
+        cpu.PC = relocated.Start;
+
+        TEST_CHECK( ( gCode + sizeof( code ) ) == Emulator_Run( &cpu,
+                                                                (void*) relocated.Start,
+                                                                relocated.Start,
+                                                                relocated.Size ) );
+        TEST_CHECK( 2 == cpu.X[ 0 ] );
+        TEST_CHECK( ( gCode + 4 + 0x100 ) == cpu.X[ 3 ] );
+        TEST_CHECK( TEST_LITERAL_LOW == cpu.X[ 2 ] );
+
+        cpu.PC      = relocated.Start;
+        cpu.X[ 9 ]  = 0;
+
+        TEST_CHECK( ( gCode + 12 + 0x40 ) == Emulator_Run( &cpu,
+                                                           (void*) relocated.Start,
+                                                           relocated.Start,
+                                                           relocated.Size ) );
+
+        (void) MemoryAllocator_FreeExecutionBlock( &gMemoryAllocator, &relocated );
+    } // Test_Relocate()
+}
+
+// -----------------------------------------------------------------------------
+//  MAIN
+// -----------------------------------------------------------------------------
+
+int
+    main
+    (
+        void
+    )
+{
+    uint64_t literal[ 2 ] = { TEST_LITERAL_LOW, TEST_LITERAL_HIGH };
+
+    gText = (uint8_t*) mmap( NULL,
+                             TEST_TEXT_SIZE,
+                             PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS,
+                             -1,
+                             0 );
+
+    if( MAP_FAILED == gText )
+    {
+        perror( "mmap" );
+        return EXIT_FAILURE;
+    }
+
+    gCode = (uintptr_t)( gText + TEST_CODE_OFFSET );
+
+    memcpy( (void*)( gCode + TEST_LITERAL_OFFSET ), literal, sizeof( literal ) );
+
+    (void) INTERNAL_SetMemoryProtectionFunction( (uintptr_t*) &gRouting.MemoryProtectFn );
+
+    Test_Copy();
+    Test_UnconditionalBranch();
+    Test_ConditionalBranch();
+    Test_CompareAndTestBranch();
+    Test_LiteralLoad();
+    Test_PCRelAddressing();
+    Test_Sequence();
+
+    (void) MemoryAllocator_Release( &gMemoryAllocator );
+    (void) munmap( gText, TEST_TEXT_SIZE );
+
+#if defined( DEBUG_MODE )
+    TEST_CHECK( 0 == MemoryTracker_CheckForMemoryLeaks() );
+#endif
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,216 @@
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <limits.h>
+#include <dlfcn.h>
+
+#include "utility/error.h"
+
+#include "SymbolResolve/Linux/Elf.h"
+
+#include "Tests/Test.h"
+
+// -----------------------------------------------------------------------------
+//  DEFINITIONS
+// -----------------------------------------------------------------------------
+
+// Functions exported by the fixture, `Fixture_000` to `Fixture_FFF`
+#define FIXTURE_SYMBOL_COUNT    4096
+#define FIXTURE_NAME_SIZE       16
+
+// Rounds measured, the best one is reported
+#define SYMBOL_BENCH_ROUNDS     5
+
+// -----------------------------------------------------------------------------
+//  GLOBALS
+// -----------------------------------------------------------------------------
+
+static char                     gNames[ FIXTURE_SYMBOL_COUNT ][ FIXTURE_NAME_SIZE ];
+static bwsr_symbol_request_t    gRequests[ FIXTURE_SYMBOL_COUNT ];
+static uintptr_t                gExpected[ FIXTURE_SYMBOL_COUNT ];
+static uintptr_t                gAddresses[ FIXTURE_SYMBOL_COUNT ];
+static int                      gStatuses[ FIXTURE_SYMBOL_COUNT ];
+static void*                    gFixture    = NULL;
+
+// -----------------------------------------------------------------------------
+//  BENCHMARKS
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Resolves every fixture symbol with one call each.
+ * \return `bool` false if a symbol resolved to the wrong address.
+ */
+static
+bool
+    Bench_ResolveSymbol
+    (
+        void
+    )
+{
+    uintptr_t   address = 0;
+    size_t      i       = 0;
+
+    for( i = 0; i < FIXTURE_SYMBOL_COUNT; i++ )
+    {
+        if( ( ERROR_SUCCESS != BWSR_ResolveSymbol( gRequests[ i ].SymbolName,
+                                                   gRequests[ i ].ImageName,
+                                                   &address ) ) ||
+            ( gExpected[ i ] != address ) )
+        {
+            return false;
+        }
+    } // for()
+
+    return true;
+}
+
+/**
+ * \brief Resolves every fixture symbol with a single batch.
+ * \return `bool` false if a symbol resolved to the wrong address.
+ */
+static
+bool
+    Bench_ResolveSymbols
+    (
+        void
+    )
+{
+    size_t i = 0;
+
+    if( ERROR_SUCCESS != BWSR_ResolveSymbols( gRequests,
+                                              FIXTURE_SYMBOL_COUNT,
+                                              gAddresses,
+                                              gStatuses ) )
+    {
+        return false;
+    }
+
+    for( i = 0; i < FIXTURE_SYMBOL_COUNT; i++ )
+    {
+        if( ( ERROR_SUCCESS  != gStatuses[ i ]  ) ||
+            ( gExpected[ i ] != gAddresses[ i ] ) )
+        {
+            return false;
+        }
+    } // for()
+
+    return true;
+}
+
+/**
+ * \brief Resolves every fixture symbol with `dlsym()`, for reference.
+ * \return `bool` true
+ */
+static
+bool
+    Bench_DlSym
+    (
+        void
+    )
+{
+    size_t i = 0;
+
+    for( i = 0; i < FIXTURE_SYMBOL_COUNT; i++ )
+    {
+        gAddresses[ i ] = (uintptr_t) dlsym( gFixture, gRequests[ i ].SymbolName );
+    } // for()
+
+    return true;
+}
+
+/**
+ * \brief Runs `Bench` `SYMBOL_BENCH_ROUNDS` times and prints its best rate.
+ * The module index is released before each round when `Cold` is set.
+ * \return `bool` false if `Bench` failed.
+ */
+static
+bool
+    Bench_Report
+    (
+        const char*     Name,
+        bool            ( *Bench )( void ),
+        bool            Cold
+    )
+{
+    double  start   = 0;
+    double  elapsed = 0;
+    double  best    = 0;
+    size_t  round   = 0;
+
+    for( round = 0; round < SYMBOL_BENCH_ROUNDS; round++ )
+    {
+        if( Cold )
+        {
+            BWSR_ReleaseModuleIndex();
+        }
+
+        start = Test_Seconds();
+
+        if( false == Bench() )
+        {
+            fprintf( stderr, "%s resolved a wrong address\n", Name );
+            return false;
+        }
+
+        elapsed = Test_Seconds() - start;
+        best    = ( ( 0 == best ) || ( elapsed < best ) ) ? elapsed : best;
+    } // for()
+
+    printf( "%-36s %12.0f symbols/s\n",
+            Name,
+            FIXTURE_SYMBOL_COUNT / best );
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+//  MAIN
+// -----------------------------------------------------------------------------
+
+int
+    main
+    (
+        int         argc,
+        char**      argv
+    )
+{
+    static char     path[ PATH_MAX ]    = { 0 };
+    bool            success             = true;
+    size_t          i                   = 0;
+
+    if( 2 != argc )
+    {
+        fprintf( stderr, "Usage: %s <fixture library>\n", argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    // The resolver names images by the path they are mapped from
+    if( ( NULL == realpath( argv[ 1 ], path ) ) ||
+        ( NULL == ( gFixture = dlopen( path, RTLD_NOW ) ) ) )
+    {
+        fprintf( stderr, "Cannot load %s\n", argv[ 1 ] );
+        return EXIT_FAILURE;
+    }
+
+    for( i = 0; i < FIXTURE_SYMBOL_COUNT; i++ )
+    {
+        snprintf( gNames[ i ], FIXTURE_NAME_SIZE, "Fixture_%03zX", i );
+
+        gRequests[ i ].SymbolName   = gNames[ i ];
+        gRequests[ i ].ImageName    = path;
+        gExpected[ i ]              = (uintptr_t) dlsym( gFixture, gNames[ i ] );
+    } // for()
+
+    success = ( Bench_Report( "BWSR_ResolveSymbol()",              Bench_ResolveSymbol,  false ) &&
+                Bench_Report( "BWSR_ResolveSymbols()",             Bench_ResolveSymbols, false ) &&
+                Bench_Report( "BWSR_ResolveSymbols(), new index",  Bench_ResolveSymbols, true  ) &&
+                Bench_Report( "dlsym()",                           Bench_DlSym,          false ) );
+
+    BWSR_ReleaseModuleIndex();
+
+    (void) dlclose( gFixture );
+
+    return ( success ? EXIT_SUCCESS : EXIT_FAILURE );
+}
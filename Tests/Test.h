@@ -0,0 +1,68 @@
+#ifndef __TEST_H__
+#define __TEST_H__
+
+// -----------------------------------------------------------------------------
+//  INCLUDES
+// -----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+// -----------------------------------------------------------------------------
+//  GLOBALS
+// -----------------------------------------------------------------------------
+
+// Checks failed so far by the test binary. Benchmarks check nothing.
+static size_t gTestFailures __attribute__( ( unused ) ) = 0;
+
+// -----------------------------------------------------------------------------
+//  CHECKS
+// -----------------------------------------------------------------------------
+
+// Reports a failed check and carries on with the test
+#define TEST_CHECK( CONDITION )                             \
+    do                                                      \
+    {                                                       \
+        if( !( CONDITION ) )                                \
+        {                                                   \
+            fprintf( stderr,                                \
+                     "%s:%d: %s(): check failed: %s\n",     \
+                     __FILE__,                              \
+                     __LINE__,                              \
+                     __FUNCTION__,                          \
+                     #CONDITION );                          \
+            gTestFailures++;                                \
+        }                                                   \
+    }                                                       \
+    while( 0 )
+
+// Exit status of the test binary
+#define TEST_RESULT()                                       \
+    ( ( 0 == gTestFailures ) ? EXIT_SUCCESS : EXIT_FAILURE )
+
+// -----------------------------------------------------------------------------
+//  TIMING
+// -----------------------------------------------------------------------------
+
+/**
+ * \brief Reads the monotonic clock, for benchmarks.
+ * \return `double` seconds since an arbitrary point.
+ */
+static inline
+double
+    Test_Seconds
+    (
+        void
+    )
+{
+    struct timespec now = { 0 };
+
+    (void) clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( (double) now.tv_sec + ( (double) now.tv_nsec / 1e9 ) );
+}
+
+#endif // __TEST_H__
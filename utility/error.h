@@ -44,6 +44,8 @@
 #define ERROR_SYMBOL_SIZE                   ( 0x00010000 )
 #define ERROR_TASK_INFO                     ( 0x00010001 )
 #define ERROR_ROUTING_FAILURE               ( 0x00010002 )
+#define ERROR_HOOK_TRANSACTION              ( 0x00010003 )
+#define ERROR_THREAD_SUSPEND                ( 0x00010004 )
 
 // -----------------------------------------------------------------------------
 //  ERROR STRING CONVERSION
@@ -72,7 +74,9 @@
     /* --- OS --- */                                                                \
     E( ERROR_SYMBOL_SIZE,               "Invalid symbol size"                   )   \
     E( ERROR_TASK_INFO,                 "Need to summarize"                     )   \
-    E( ERROR_ROUTING_FAILURE,           "Failed to setup VirtualPage routing"   )
+    E( ERROR_ROUTING_FAILURE,           "Failed to setup VirtualPage routing"   )   \
+    E( ERROR_HOOK_TRANSACTION,          "Invalid hook transaction state"        )   \
+    E( ERROR_THREAD_SUSPEND,            "Failed to suspend other threads"       )
 
 #define ERROR_TEXT( ERROR_CODE, TEXT ) \
     case ERROR_CODE: return #ERROR_CODE " (" TEXT ")";
@@ -19,6 +19,11 @@
 
 #define BWSR_API __attribute__( ( visibility( "default" ) ) )
 
+// GCC has no `__has_feature`, none of the features checked exist there
+#ifndef __has_feature
+    #define __has_feature( x ) 0
+#endif
+
 #define ARRAY_LENGTH( ARRAY ) ( sizeof( ARRAY ) / sizeof( ARRAY[ 0 ] ) )
 
 // -----------------------------------------------------------------------------
@@ -33,6 +38,10 @@
 #define ALIGN_FLOOR( ADDRESS, RANGE ) \
     ( (uintptr_t) ADDRESS & ~( (uintptr_t) RANGE - 1 ) )
 
+// Round up to the next multiple of `RANGE`
+#define ALIGN_CEIL( ADDRESS, RANGE ) \
+    ( ( (uintptr_t) ADDRESS + (uintptr_t) RANGE - 1 ) & ~( (uintptr_t)RANGE - 1 ) )
+
 // Left shift `Bits` after masking with `BitMaskShift` least significant bits,
 // then shift left by `BitShift` positions.
 #define BIT_SHIFT( Bits, BitMaskShift, BitShift ) \